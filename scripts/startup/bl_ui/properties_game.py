@@ -551,6 +551,7 @@ class SCENE_PT_game_physics(SceneButtonsPanel, Panel):
         layout.prop(gs, "physics_engine", text="Engine")
         if gs.physics_engine != 'NONE':
             layout.prop(gs, "physics_solver")
+            layout.prop(gs, "physics_threads")
             layout.prop(gs, "physics_gravity", text="Gravity")
 
             split = layout.split()
@@ -569,6 +570,8 @@ class SCENE_PT_game_physics(SceneButtonsPanel, Panel):
             row.prop(gs, "fps", text="FPS")
             row.prop(gs, "time_scale")
 
+            layout.prop(gs, "use_parallel_scenes")
+
             col = layout.column()
             col.label(text="Physics Deactivation:")
             sub = col.row(align=True)
@@ -1945,7 +1945,10 @@ void ED_screen_refresh_blenderplayer(wmWindow *win)
 {
   bScreen *screen = WM_window_get_active_screen(win);
 
-  WM_window_set_dpi(win);
+  /* No GHOST window in headless blenderplayer. */
+  if (win->ghostwin) {
+    WM_window_set_dpi(win);
+  }
 
   ED_screen_global_areas_refresh(win);
 
@@ -934,7 +934,10 @@ typedef struct GameData {
   short matmode DNA_DEPRECATED;
   short occlusionRes; /* resolution of occlusion Z buffer in pixel */
   short physicsEngine;
-  short solverType, _pad[3];
+  short solverType;
+  /* Number of threads used to step the physics world, 0 and 1 mean single threaded. */
+  short physicsThreads;
+  short _pad[2];
   short exitkey;
   short pythonkeys[4];
   short vsync; /* Controls vsync: off, on, or adaptive (if supported) */
@@ -1010,6 +1013,7 @@ enum {
 // #define GAME_USE_UI_ANTI_FLICKER (1 << 20) /* deprecated */
 #define GAME_USE_VIEWPORT_RENDER (1 << 21)
 #define GAME_PYTHON_CONSOLE (1 << 22)
+#define GAME_USE_PARALLEL_SCENES (1 << 23)
 /* Note: GameData.flag is now an int (max 32 flags). A short could only take 16 flags */
 
 /* GameData.playerflag */
@@ -6020,6 +6020,17 @@ static void rna_def_scene_game_data(BlenderRNA *brna)
   RNA_def_property_ui_text(prop, "Physics Solver", "Physics constraint solver");
   RNA_def_property_update(prop, NC_SCENE, NULL);
 
+  prop = RNA_def_property(srna, "physics_threads", PROP_INT, PROP_NONE);
+  RNA_def_property_int_sdna(prop, NULL, "physicsThreads");
+  RNA_def_property_range(prop, 0, 64);
+  RNA_def_property_ui_range(prop, 0, 16, 1, 1);
+  RNA_def_property_ui_text(prop,
+                           "Physics Threads",
+                           "Number of threads used to solve the physics simulation islands, "
+                           "0 or 1 keeps the single threaded world (scenes using soft bodies "
+                           "are always single threaded)");
+  RNA_def_property_update(prop, NC_SCENE, NULL);
+
   prop = RNA_def_property(srna, "occlusion_culling_resolution", PROP_INT, PROP_PIXEL);
   RNA_def_property_int_sdna(prop, NULL, "occlusionRes");
   RNA_def_property_range(prop, 128.0, 1024.0);
@@ -6223,6 +6234,14 @@ static void rna_def_scene_game_data(BlenderRNA *brna)
       "Restrict the number of animation updates to the animation FPS (this is "
       "better for performance, but can cause issues with smooth playback)");
 
+  prop = RNA_def_property(srna, "use_parallel_scenes", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", GAME_USE_PARALLEL_SCENES);
+  RNA_def_property_ui_text(prop,
+                           "Parallel Scenes",
+                           "Update the scene graph and physics of each scene in a thread while "
+                           "the logic of the next scenes is processed, the scenes are updated "
+                           "one after the other when python controllers or components are used");
+
   prop = RNA_def_property(srna, "use_python_console", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_sdna(prop, NULL, "flag", GAME_PYTHON_CONSOLE);
   RNA_def_property_ui_text(prop, "Python Console", "Create a python interpreter console in game");
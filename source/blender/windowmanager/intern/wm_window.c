@@ -2748,6 +2748,22 @@ void wm_window_ghostwindow_blenderplayer_ensure(wmWindowManager *wm,
   }
 }
 
+void wm_window_headless_blenderplayer_ensure(wmWindowManager *wm,
+                                             wmWindow *win,
+                                             bool first_time_window)
+{
+  win->ghostwin = NULL;
+  win->gpuctx = NULL;
+
+  if (first_time_window) {
+    wm->message_bus = WM_msgbus_create();
+    runtime_msgbus = wm->message_bus;
+  }
+  else {
+    wm->message_bus = runtime_msgbus;
+  }
+}
+
 void wm_window_ghostwindow_embedded_ensure(wmWindowManager *wm, wmWindow *win)
 {
   wm_window_clear_drawable(wm);
@@ -143,6 +143,10 @@ void wm_window_ghostwindow_blenderplayer_ensure(struct wmWindowManager *wm,
                                                 struct wmWindow *win,
                                                 void *ghostwin,
                                                 bool first_time_window);
+/** Headless blenderplayer: keep the window data without any GHOST window nor GPU context. */
+void wm_window_headless_blenderplayer_ensure(struct wmWindowManager *wm,
+                                             struct wmWindow *win,
+                                             bool first_time_window);
 
 void wm_window_ghostwindow_embedded_ensure(struct wmWindowManager *wm, struct wmWindow *win);
 /* End of UPBGE */
@@ -0,0 +1,261 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file CM_Trace.cpp
+ *  \ingroup common
+ */
+
+#include "CM_Trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "BLI_fileops.h"
+#include "BLI_string.h"
+
+#include "CM_Message.h"
+#include "CM_Thread.h"
+
+/// Number of events stored for each thread.
+static const size_t TRACE_BUFFER_SIZE = 1 << 15;
+
+struct CM_TraceEvent {
+  double begin;
+  double duration;
+  const char *category;
+  char name[CM_Trace::MaxNameLength + 1];
+};
+
+/// The ring buffer of events of a thread.
+struct CM_TraceBuffer {
+  unsigned int tid;
+  /// Number of events recorded since the last clear, can exceed the buffer size.
+  size_t count;
+  std::vector<CM_TraceEvent> events;
+  /// Only contended when the events are written or cleared by an other thread.
+  CM_ThreadSpinLock lock;
+};
+
+static std::vector<std::unique_ptr<CM_TraceBuffer>> traceBuffers;
+static CM_ThreadMutex traceBuffersMutex;
+static thread_local CM_TraceBuffer *threadTraceBuffer = nullptr;
+
+static const std::chrono::steady_clock::time_point traceStartTime =
+    std::chrono::steady_clock::now();
+static std::string traceFilePath;
+static double traceFrameThreshold = 0.0;
+static double traceFrameBegin = -1.0;
+static unsigned int traceNumFrameWrites = 0;
+
+std::atomic<bool> CM_Trace::m_enabled(false);
+
+static CM_TraceBuffer *get_thread_buffer()
+{
+  if (!threadTraceBuffer) {
+    CM_TraceBuffer *buffer = new CM_TraceBuffer();
+    buffer->count = 0;
+    buffer->events.resize(TRACE_BUFFER_SIZE);
+
+    traceBuffersMutex.Lock();
+    buffer->tid = traceBuffers.size();
+    traceBuffers.emplace_back(buffer);
+    traceBuffersMutex.Unlock();
+
+    threadTraceBuffer = buffer;
+  }
+
+  return threadTraceBuffer;
+}
+
+static void write_json_string(FILE *file, const char *str)
+{
+  fputc('"', file);
+  for (const char *c = str; *c; ++c) {
+    if (*c == '"' || *c == '\\') {
+      fputc('\\', file);
+      fputc(*c, file);
+    }
+    else if ((unsigned char)*c < 0x20) {
+      fprintf(file, "\\u%04x", (unsigned int)*c);
+    }
+    else {
+      fputc(*c, file);
+    }
+  }
+  fputc('"', file);
+}
+
+void CM_Trace::SetEnabled(bool enabled)
+{
+  m_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void CM_Trace::SetFilePath(const std::string &filepath)
+{
+  traceFilePath = filepath;
+}
+
+const std::string &CM_Trace::GetFilePath()
+{
+  return traceFilePath;
+}
+
+void CM_Trace::SetFrameThreshold(double threshold)
+{
+  traceFrameThreshold = threshold;
+}
+
+double CM_Trace::GetTime()
+{
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() -
+                                                   traceStartTime)
+      .count();
+}
+
+void CM_Trace::AddEvent(const char *category, const char *name, double begin, double end)
+{
+  CM_TraceBuffer *buffer = get_thread_buffer();
+
+  buffer->lock.Lock();
+  CM_TraceEvent &event = buffer->events[buffer->count++ % TRACE_BUFFER_SIZE];
+  event.begin = begin;
+  event.duration = end - begin;
+  event.category = category;
+  BLI_strncpy(event.name, name, sizeof(event.name));
+  buffer->lock.Unlock();
+}
+
+void CM_Trace::EndFrame()
+{
+  if (!IsEnabled()) {
+    traceFrameBegin = -1.0;
+    return;
+  }
+
+  const double time = GetTime();
+  const double begin = traceFrameBegin;
+  traceFrameBegin = time;
+  if (begin < 0.0) {
+    return;
+  }
+
+  AddEvent("frame", "Frame", begin, time);
+
+  const double duration = (time - begin) * 1.0e-6;
+  if (traceFrameThreshold <= 0.0 || duration <= traceFrameThreshold) {
+    return;
+  }
+
+  // Number the files of each slow frame, e.g trace_1.json.
+  const std::string base = traceFilePath.empty() ? "trace.json" : traceFilePath;
+  const size_t sep = base.find_last_of("/\\");
+  size_t ext = base.find_last_of('.');
+  if (ext == std::string::npos || (sep != std::string::npos && ext < sep)) {
+    ext = base.size();
+  }
+  const std::string filepath = base.substr(0, ext) + "_" +
+                               std::to_string(++traceNumFrameWrites) + base.substr(ext);
+
+  if (Write(filepath)) {
+    CM_Message("frame of " << duration * 1.0e3 << " ms over the trace threshold, trace written to "
+                           << filepath);
+  }
+  // The next slow frame only writes the events recorded after this one.
+  Clear();
+  // Don't account the writing in the next frame.
+  traceFrameBegin = GetTime();
+}
+
+bool CM_Trace::Write(const std::string &filepath)
+{
+  // Copy the events of each thread from the oldest to the newest.
+  std::vector<CM_TraceEvent> events;
+  std::vector<unsigned int> tids;
+
+  traceBuffersMutex.Lock();
+  for (const std::unique_ptr<CM_TraceBuffer> &buffer : traceBuffers) {
+    buffer->lock.Lock();
+    const size_t count = std::min(buffer->count, TRACE_BUFFER_SIZE);
+    const size_t first = (buffer->count > TRACE_BUFFER_SIZE) ?
+                             buffer->count % TRACE_BUFFER_SIZE :
+                             0;
+    for (size_t i = 0; i < count; ++i) {
+      events.push_back(buffer->events[(first + i) % TRACE_BUFFER_SIZE]);
+      tids.push_back(buffer->tid);
+    }
+    buffer->lock.Unlock();
+  }
+  traceBuffersMutex.Unlock();
+
+  FILE *file = BLI_fopen(filepath.c_str(), "w");
+  if (!file) {
+    CM_Error("unable to open trace file: " << filepath);
+    return false;
+  }
+
+  fputs("{\"traceEvents\":[\n", file);
+  for (size_t i = 0, size = events.size(); i < size; ++i) {
+    const CM_TraceEvent &event = events[i];
+    fputs("{\"name\":", file);
+    write_json_string(file, event.name);
+    fputs(",\"cat\":", file);
+    write_json_string(file, event.category);
+    fprintf(file,
+            ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}%s\n",
+            event.begin,
+            event.duration,
+            tids[i],
+            (i + 1 < size) ? "," : "");
+  }
+  fputs("],\"displayTimeUnit\":\"ms\"}\n", file);
+
+  if (fclose(file) != 0) {
+    CM_Error("unable to write trace file: " << filepath);
+    return false;
+  }
+
+  return true;
+}
+
+void CM_Trace::Clear()
+{
+  traceBuffersMutex.Lock();
+  for (const std::unique_ptr<CM_TraceBuffer> &buffer : traceBuffers) {
+    buffer->lock.Lock();
+    buffer->count = 0;
+    buffer->lock.Unlock();
+  }
+  traceBuffersMutex.Unlock();
+}
+
+void CM_TraceScope::Begin(const char *name)
+{
+  BLI_strncpy(m_name, name, sizeof(m_name));
+  m_begin = CM_Trace::GetTime();
+}
+
+void CM_TraceScope::End()
+{
+  CM_Trace::AddEvent(m_category, m_name, m_begin, CM_Trace::GetTime());
+}
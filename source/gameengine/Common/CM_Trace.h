@@ -0,0 +1,135 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file CM_Trace.h
+ *  \ingroup common
+ */
+
+#pragma once
+
+#include <atomic>
+#include <string>
+
+/** Engine wide tracing of timed scopes, written in the Chrome trace JSON format readable by
+ * chrome://tracing or Perfetto. Each thread records its events in its own ring buffer where
+ * the oldest events are overwritten, recording is skipped when tracing is disabled.
+ */
+class CM_Trace {
+ public:
+  /// Maximum length of an event name, longer names are truncated.
+  static const unsigned int MaxNameLength = 47;
+
+  static void SetEnabled(bool enabled);
+  static inline bool IsEnabled()
+  {
+    return m_enabled.load(std::memory_order_relaxed);
+  }
+
+  /// Set the file written at exit and base name of the files written for slow frames.
+  static void SetFilePath(const std::string &filepath);
+  static const std::string &GetFilePath();
+
+  /** Set the duration of a frame above which the trace is written and cleared.
+   * \param threshold The duration in seconds, 0 to disable.
+   */
+  static void SetFrameThreshold(double threshold);
+
+  /// Return the time in microseconds since the start of the program.
+  static double GetTime();
+
+  /** Record a completed scope for the current thread.
+   * \param category A category name, must be a static string.
+   * \param name The name of the scope, copied.
+   * \param begin, end The bounds of the scope returned by GetTime.
+   */
+  static void AddEvent(const char *category, const char *name, double begin, double end);
+
+  /** Record the end of a frame, called once per engine frame with logic. The trace is written
+   * if the frame is slower than the threshold.
+   */
+  static void EndFrame();
+
+  /// Write the events of all the threads, return false on failure.
+  static bool Write(const std::string &filepath);
+  /// Remove the events of all the threads.
+  static void Clear();
+
+ private:
+  static std::atomic<bool> m_enabled;
+};
+
+/// Record the lifetime of this object as a trace event when tracing is enabled.
+class CM_TraceScope {
+ private:
+  const char *m_category;
+  bool m_active;
+  double m_begin;
+  char m_name[CM_Trace::MaxNameLength + 1];
+
+  void End();
+
+ public:
+  /** Construct an inactive scope started by Begin.
+   * \param category A category name, must be a static string.
+   */
+  CM_TraceScope(const char *category) : m_category(category), m_active(CM_Trace::IsEnabled())
+  {
+  }
+
+  /** Construct and start a scope.
+   * \param category A category name, must be a static string.
+   * \param name The name of the scope, copied.
+   */
+  CM_TraceScope(const char *category, const char *name) : CM_TraceScope(category)
+  {
+    if (m_active) {
+      Begin(name);
+    }
+  }
+
+  ~CM_TraceScope()
+  {
+    if (m_active) {
+      End();
+    }
+  }
+
+  bool IsActive() const
+  {
+    return m_active;
+  }
+
+  /// Start the scope, must be called once when the scope is active.
+  void Begin(const char *name);
+  void Begin(const std::string &name)
+  {
+    Begin(name.c_str());
+  }
+};
+
+/// Trace the rest of the current block, the name is only evaluated when tracing is enabled.
+#define CM_TRACE_SCOPE(category, name) \
+  CM_TraceScope _traceScope(category); \
+  if (_traceScope.IsActive()) { \
+    _traceScope.Begin(name); \
+  } \
+  (void)0
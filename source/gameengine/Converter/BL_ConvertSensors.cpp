@@ -447,8 +447,11 @@ void BL_ConvertSensors(struct Object *blenderobject,
           bRaySensor *blenderraysensor = (bRaySensor *)sens->data;
 
           // blenderradarsensor->angle;
-          SCA_EventManager *eventmgr = logicmgr->FindEventManager(
-              SCA_EventManager::BASIC_EVENTMGR);
+          // The ray sensors are batched by the ray event manager, only available with physics.
+          SCA_EventManager *eventmgr = logicmgr->FindEventManager(SCA_EventManager::RAY_EVENTMGR);
+          if (!eventmgr) {
+            eventmgr = logicmgr->FindEventManager(SCA_EventManager::BASIC_EVENTMGR);
+          }
           if (eventmgr) {
             bool bFindMaterial = (blenderraysensor->mode & SENS_COLLISION_MATERIAL);
             bool bXRay = (blenderraysensor->mode & SENS_RAY_XRAY);
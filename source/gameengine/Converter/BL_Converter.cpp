@@ -49,13 +49,16 @@
 #include "DNA_scene_types.h"
 
 #include "BL_DataConversion.h"
+#include "BL_MeshCache.h"
 #include "BL_SceneConverter.h"
+#include "CM_Trace.h"
 #include "DummyPhysicsEnvironment.h"
 #include "EXP_StringValue.h"
 #include "KX_GameObject.h"
 #include "KX_LibLoadStatus.h"
 #include "KX_PythonInit.h"  // So we can handle adding new text datablocks for Python to import
 #include "LA_SystemCommandLine.h"
+#include "PIL_time.h"
 #include "RAS_BucketManager.h"
 #include "SCA_ActionActuator.h"
 
@@ -101,8 +104,12 @@ void BL_Converter::SceneSlot::Merge(const BL_SceneConverter *converter)
 }
 
 BL_Converter::BL_Converter(Main *maggie, KX_KetsjiEngine *engine)
-    : m_maggie(maggie), m_ketsjiEngine(engine), m_alwaysUseExpandFraming(false)
+    : m_mergeBudget(0.0),
+      m_maggie(maggie),
+      m_ketsjiEngine(engine),
+      m_alwaysUseExpandFraming(false)
 {
+  m_mergeinfo.m_sceneIndex = 0;
   BKE_main_id_tag_all(maggie, LIB_TAG_DOIT, false);  // avoid re-tagging later on
   m_threadinfo.m_pool = BLI_task_pool_create(nullptr, TASK_PRIORITY_LOW);
 }
@@ -230,6 +237,8 @@ void BL_Converter::ConvertScene(KX_Scene *destinationscene,
  */
 void BL_Converter::RemoveScene(KX_Scene *scene)
 {
+  // The libraries merged in this scene must not refer to it after its deletion.
+  AbortAsyncLoads(scene);
 
 #ifdef WITH_PYTHON
   Texture::FreeAllTextures(scene);
@@ -292,32 +301,130 @@ Main *BL_Converter::GetMainDynamicPath(const std::string &path) const
   return nullptr;
 }
 
-void BL_Converter::MergeAsyncLoads()
+bool BL_Converter::MergeAsyncLoad(KX_LibLoadStatus *status, double deadline)
 {
-  std::vector<KX_Scene *> *merge_scenes;
+  CM_TRACE_SCOPE("libload", status->GetLibraryName());
+  std::vector<KX_Scene *> *merge_scenes = (std::vector<KX_Scene *> *)status->GetData();
+  const unsigned int numScenes = merge_scenes->size();
+
+  while (m_mergeinfo.m_sceneIndex < numScenes) {
+    KX_Scene *scene = (*merge_scenes)[m_mergeinfo.m_sceneIndex];
+    float progress;
+    const bool merged = status->GetMergeScene()->MergeSceneStep(
+        scene, m_mergeinfo.m_state, deadline, progress);
+
+    // Conversion is the first 90% of the progress and merging the 10% left.
+    status->SetProgress(0.9f + 0.1f * (m_mergeinfo.m_sceneIndex + progress) / numScenes);
 
-  std::vector<KX_LibLoadStatus *>::iterator mit;
-  std::vector<KX_Scene *>::iterator sit;
+    if (!merged) {
+      return false;
+    }
 
+    delete scene;
+    m_mergeinfo.m_state = KX_Scene::MergeState();
+    ++m_mergeinfo.m_sceneIndex;
+
+    if (m_mergeinfo.m_sceneIndex < numScenes && PIL_check_seconds_timer() >= deadline) {
+      return false;
+    }
+  }
+
+  delete merge_scenes;
+  status->SetData(nullptr);
+  m_mergeinfo.m_sceneIndex = 0;
+
+  status->Finish();
+
+  return true;
+}
+
+void BL_Converter::MergeAsyncLoads(double deadline)
+{
   m_threadinfo.m_mutex.Lock();
 
-  for (mit = m_mergequeue.begin(); mit != m_mergequeue.end(); ++mit) {
-    merge_scenes = (std::vector<KX_Scene *> *)(*mit)->GetData();
+  while (!m_mergequeue.empty() && MergeAsyncLoad(m_mergequeue.front(), deadline)) {
+    m_mergequeue.erase(m_mergequeue.begin());
 
-    for (sit = merge_scenes->begin(); sit != merge_scenes->end(); ++sit) {
-      (*mit)->GetMergeScene()->MergeScene(*sit);
-      delete (*sit);
+    if (PIL_check_seconds_timer() >= deadline) {
+      break;
     }
+  }
 
-    delete merge_scenes;
-    (*mit)->SetData(nullptr);
+  m_threadinfo.m_mutex.Unlock();
+}
 
-    (*mit)->Finish();
+void BL_Converter::AbortAsyncLoads(KX_Scene *scene)
+{
+  bool converting = false;
+  m_threadinfo.m_mutex.Lock();
+  for (const std::pair<const std::string, KX_LibLoadStatus *> &pair : m_status_map) {
+    KX_LibLoadStatus *status = pair.second;
+    if (status->GetMergeScene() == scene && !status->IsFinished()) {
+      converting = true;
+    }
   }
+  m_threadinfo.m_mutex.Unlock();
 
-  m_mergequeue.clear();
+  // Wait for the libraries in conversion, they are then in the merge queue.
+  if (converting) {
+    BLI_task_pool_work_and_wait(m_threadinfo.m_pool);
+  }
 
+  std::vector<KX_Scene *> unmergedScenes;
+
+  m_threadinfo.m_mutex.Lock();
+  for (std::vector<KX_LibLoadStatus *>::iterator it = m_mergequeue.begin();
+       it != m_mergequeue.end();)
+  {
+    KX_LibLoadStatus *status = *it;
+    if (status->GetMergeScene() != scene) {
+      ++it;
+      continue;
+    }
+
+    std::vector<KX_Scene *> *merge_scenes = (std::vector<KX_Scene *> *)status->GetData();
+    unsigned int firstUnmerged = 0;
+
+    // The first library of the queue can have a scene partially merged.
+    if (it == m_mergequeue.begin()) {
+      if (m_mergeinfo.m_state.m_stage != KX_Scene::MergeState::MERGE_BEGIN) {
+        /* The merged objects already refer to the removed scene, finish the merge so that
+         * they are freed with it. */
+        KX_Scene *mergingScene = (*merge_scenes)[m_mergeinfo.m_sceneIndex];
+        float progress;
+        scene->MergeSceneStep(mergingScene, m_mergeinfo.m_state, DBL_MAX, progress);
+        delete mergingScene;
+        ++m_mergeinfo.m_sceneIndex;
+      }
+
+      firstUnmerged = m_mergeinfo.m_sceneIndex;
+      m_mergeinfo.m_sceneIndex = 0;
+      m_mergeinfo.m_state = KX_Scene::MergeState();
+    }
+
+    unmergedScenes.insert(
+        unmergedScenes.end(), merge_scenes->begin() + firstUnmerged, merge_scenes->end());
+
+    delete merge_scenes;
+    status->SetData(nullptr);
+    status->Finish();
+
+    it = m_mergequeue.erase(it);
+  }
   m_threadinfo.m_mutex.Unlock();
+
+  // The scenes not merged yet are still owned by the converter.
+  for (KX_Scene *unmergedScene : unmergedScenes) {
+    RemoveScene(unmergedScene);
+  }
+}
+
+void BL_Converter::MergeAsyncLoads()
+{
+  // The merge of a library not finished within the budget continues the next frame.
+  const double deadline = (m_mergeBudget > 0.0) ? PIL_check_seconds_timer() + m_mergeBudget :
+                                                  DBL_MAX;
+  MergeAsyncLoads(deadline);
 }
 
 void BL_Converter::FinalizeAsyncLoads()
@@ -325,7 +432,17 @@ void BL_Converter::FinalizeAsyncLoads()
   // Finish all loading libraries.
   BLI_task_pool_work_and_wait(m_threadinfo.m_pool);
   // Merge all libraries data in the current scene, to avoid memory leak of unmerged scenes.
-  MergeAsyncLoads();
+  MergeAsyncLoads(DBL_MAX);
+}
+
+void BL_Converter::SetMergeBudget(double budget)
+{
+  m_mergeBudget = budget;
+}
+
+double BL_Converter::GetMergeBudget() const
+{
+  return m_mergeBudget;
 }
 
 void BL_Converter::AddScenesToMergeQueue(KX_LibLoadStatus *status)
@@ -339,6 +456,7 @@ static void async_convert(TaskPool *pool, void *ptr, int /*threadid*/)
 {
   KX_Scene *new_scene = nullptr;
   KX_LibLoadStatus *status = (KX_LibLoadStatus *)ptr;
+  CM_TRACE_SCOPE("libload", status->GetLibraryName());
   std::vector<Scene *> *scenes = (std::vector<Scene *> *)status->GetData();
   std::vector<KX_Scene *> *merge_scenes =
       new std::vector<KX_Scene *>();  // Deleted in MergeAsyncLoads
@@ -368,6 +486,8 @@ KX_LibLoadStatus *BL_Converter::LinkBlendFileMemory(void *data,
                                                            char **err_str,
                                                            short options)
 {
+  CM_TRACE_SCOPE("libload", path);
+
   BlendHandle *bpy_openlib = BLO_blendhandle_from_memory(data, length, nullptr);
 
   // Error checking is done in LinkBlendFile
@@ -766,14 +886,20 @@ bool BL_Converter::FreeBlendFile(const std::string &path)
   return FreeBlendFile(GetMainDynamicPath(path));
 }
 
+unsigned int BL_Converter::GetSceneMaterialCount(KX_Scene *scene)
+{
+  return m_sceneSlots[scene].m_materials.size();
+}
+
+void BL_Converter::MergeSceneMaterial(KX_Scene *to, KX_Scene *from, unsigned int index)
+{
+  m_sceneSlots[from].m_materials[index]->ReplaceScene(to);
+}
+
 void BL_Converter::MergeScene(KX_Scene *to, KX_Scene *from)
 {
   SceneSlot &sceneSlotFrom = m_sceneSlots[from];
 
-  for (std::unique_ptr<KX_BlenderMaterial> &mat : sceneSlotFrom.m_materials) {
-    mat->ReplaceScene(to);
-  }
-
   m_sceneSlots[to].Merge(sceneSlotFrom);
   m_sceneSlots.erase(from);
 }
@@ -897,4 +1023,20 @@ void BL_Converter::PrintStats()
   CM_Message("\t materials: " << nummat);
   CM_Message("\t meshes: " << nummesh);
   CM_Message("\t interpolators: " << numinter);
+
+  unsigned int cacheHits;
+  unsigned int cacheMisses;
+  BL_MeshCache::GetStats(cacheHits, cacheMisses);
+  CM_Message(std::endl << "Mesh cache:");
+  CM_Message("\t hits: " << cacheHits);
+  CM_Message("\t misses: " << cacheMisses);
+
+#ifdef WITH_BULLET
+  unsigned int numSharedShapes;
+  size_t savedShapeMemory;
+  CcdShapeConstructionInfo::GetSharingStats(numSharedShapes, savedShapeMemory);
+  CM_Message(std::endl << "Shared collision shapes:");
+  CM_Message("\t reused: " << numSharedShapes);
+  CM_Message("\t memory saved: " << savedShapeMemory / 1024 << " KB");
+#endif
 }
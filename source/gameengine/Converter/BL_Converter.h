@@ -38,6 +38,7 @@
 #include "CM_Thread.h"
 #include "EXP_ListValue.h"
 #include "KX_BlenderMaterial.h"
+#include "KX_Scene.h"
 #include "RAS_MeshObject.h"
 
 class EXP_StringValue;
@@ -85,12 +86,31 @@ class BL_Converter {
   std::map<std::string, KX_LibLoadStatus *> m_status_map;
   std::vector<KX_LibLoadStatus *> m_mergequeue;
 
+  /// State of the merge of the first library in the merge queue, kept between frames.
+  struct MergeInfo {
+    /// Index of the merged scene in the scenes of the library.
+    unsigned int m_sceneIndex;
+    KX_Scene::MergeState m_state;
+  } m_mergeinfo;
+  /// Time in seconds spent merging libraries per frame, zero for no limit.
+  double m_mergeBudget;
+
   Main *m_maggie;
   std::vector<Main *> m_DynamicMaggie;
 
   KX_KetsjiEngine *m_ketsjiEngine;
   bool m_alwaysUseExpandFraming;
 
+  /** Merge the scenes of an asynchronously loaded library until the time deadline is passed.
+   * \return True when the library is entirely merged.
+   */
+  bool MergeAsyncLoad(KX_LibLoadStatus *status, double deadline);
+  void MergeAsyncLoads(double deadline);
+  /** Stop the merge of the libraries loaded asynchronously in a scene, used before its removal.
+   * The partially merged scene is merged entirely, the other scenes are freed.
+   */
+  void AbortAsyncLoads(KX_Scene *scene);
+
  public:
   BL_Converter(Main *maggie, KX_KetsjiEngine *engine);
   virtual ~BL_Converter();
@@ -141,10 +161,19 @@ class BL_Converter {
 
   RAS_MeshObject *ConvertMeshSpecial(KX_Scene *kx_scene, Main *maggie, const std::string &name);
 
+  /// Return the number of materials converted for a scene.
+  unsigned int GetSceneMaterialCount(KX_Scene *scene);
+  /// Construct the material of index in the scene from for the scene to, see MergeScene.
+  void MergeSceneMaterial(KX_Scene *to, KX_Scene *from, unsigned int index);
+  /// Move the converted data of the scene from to the scene to, its materials must be merged.
   void MergeScene(KX_Scene *to, KX_Scene *from);
 
+  /// Merge the asynchronously loaded libraries within the merge budget of a frame.
   void MergeAsyncLoads();
   void FinalizeAsyncLoads();
+  /// Set the time in seconds spent merging libraries per frame, zero for no limit.
+  void SetMergeBudget(double budget);
+  double GetMergeBudget() const;
   void AddScenesToMergeQueue(KX_LibLoadStatus *status);
 
   void PrintStats();
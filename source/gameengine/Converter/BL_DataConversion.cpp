@@ -83,6 +83,7 @@
 #include "BL_ConvertControllers.h"
 #include "BL_ConvertProperties.h"
 #include "BL_ConvertSensors.h"
+#include "BL_MeshCache.h"
 #include "KX_BlenderMaterial.h"
 #include "KX_BoneParentNodeRelationship.h"
 #include "KX_Camera.h"
@@ -99,6 +100,7 @@
 #include "KX_PythonComponent.h"
 #include "RAS_ICanvas.h"
 #include "RAS_Vertex.h"
+#include "SCA_PythonController.h"
 #ifdef WITH_BULLET
 #  include "CcdPhysicsEnvironment.h"
 #endif
@@ -349,34 +351,23 @@ static int GetPolygonMaterialIndex(const VArray<int> mat_indices, const Mesh *me
   return r;
 }
 
-/* blenderobj can be nullptr, make sure its checked for */
-RAS_MeshObject *BL_ConvertMesh(Mesh *mesh,
-                               Object *blenderobj,
-                               KX_Scene *scene,
-                               RAS_Rasterizer *rasty,
-                               BL_SceneConverter *converter,
-                               bool libloading,
-                               bool converting_during_runtime)
-{
-  RAS_MeshObject *meshobj;
-  int lightlayer = blenderobj ? blenderobj->lay : (1 << 20) - 1;  // all layers if no object.
-
-  // Without checking names, we get some reuse we don't want that can cause
-  // problems with material LoDs.
-  if (blenderobj && ((meshobj = converter->FindGameMesh(mesh /*, ob->lay*/)) != nullptr)) {
-    const std::string bge_name = meshobj->GetName();
-    const std::string blender_name = ((ID *)blenderobj->data)->name + 2;
-    if (bge_name == blender_name) {
-      return meshobj;
-    }
-  }
-
-  // Get Mesh data
-  bContext *C = KX_GetActiveEngine()->GetContext();
-  Depsgraph *depsgraph = CTX_data_depsgraph_on_load(C);
-  Object *ob_eval = DEG_get_evaluated_object(depsgraph, blenderobj);
-  Mesh *final_me = (Mesh *)ob_eval->data;
+struct ConvertedMaterial {
+  Material *ma;
+  RAS_MeshMaterial *meshmat;
+  bool visible;
+  bool twoside;
+  bool collider;
+  bool wire;
+};
 
+/// Convert the vertices and the polygons of a mesh in the display arrays of its materials.
+static void BL_ConvertMeshArrays(Mesh *final_me,
+                                 RAS_MeshObject *meshobj,
+                                 const RAS_MeshObject::LayersInfo &layersInfo,
+                                 const std::vector<ConvertedMaterial> &convertedMats,
+                                 unsigned short uvLayers,
+                                 unsigned short colorLayers)
+{
   BKE_mesh_tessface_ensure(final_me);
 
   const float(*positions)[3] = BKE_mesh_vert_positions(final_me);
@@ -386,31 +377,6 @@ RAS_MeshObject *BL_ConvertMesh(Mesh *mesh,
   const int totfaces = final_me->totface;
   const int *mfaceToMpoly = (int *)CustomData_get_layer(&final_me->fdata, CD_ORIGINDEX);
 
-  /* Extract available layers.
-   * Get the active color and uv layer. */
-  const short activeUv = CustomData_get_active_layer(&final_me->ldata, CD_PROP_FLOAT2);
-  const short activeColor = CustomData_get_active_layer(&final_me->ldata, CD_PROP_BYTE_COLOR);
-
-  RAS_MeshObject::LayersInfo layersInfo;
-  layersInfo.activeUv = (activeUv == -1) ? 0 : activeUv;
-  layersInfo.activeColor = (activeColor == -1) ? 0 : activeColor;
-
-  const unsigned short uvLayers = CustomData_number_of_layers(&final_me->ldata, CD_PROP_FLOAT2);
-  const unsigned short colorLayers = CustomData_number_of_layers(&final_me->ldata, CD_PROP_BYTE_COLOR);
-
-  // Extract UV loops.
-  for (unsigned short i = 0; i < uvLayers; ++i) {
-    const std::string name = CustomData_get_layer_name(&final_me->ldata, CD_PROP_FLOAT2, i);
-    const float(*uv)[2] = (const float(*)[2])CustomData_get_layer_n(&final_me->ldata, CD_PROP_FLOAT2, i);
-    layersInfo.layers.push_back({uv, nullptr, i, name});
-  }
-  // Extract color loops.
-  for (unsigned short i = 0; i < colorLayers; ++i) {
-    const std::string name = CustomData_get_layer_name(&final_me->ldata, CD_PROP_BYTE_COLOR, i);
-    MLoopCol *col = (MLoopCol *)CustomData_get_layer_n(&final_me->ldata, CD_PROP_BYTE_COLOR, i);
-    layersInfo.layers.push_back({nullptr, col, i, name});
-  }
-
   float3 *loop_nors_dst = nullptr;
   float(*loop_normals)[3] = (float(*)[3])CustomData_get_layer(&final_me->ldata, CD_NORMAL);
   const bool do_loop_nors = (loop_normals == nullptr);
@@ -476,52 +442,6 @@ RAS_MeshObject *BL_ConvertMesh(Mesh *mesh,
     tangent = (float(*)[4])CustomData_get_layer(&final_me->ldata, CD_TANGENT);
   }
 
-  meshobj = new RAS_MeshObject(mesh, final_me->totvert, blenderobj, layersInfo);
-  meshobj->m_sharedvertex_map.resize(totverts);
-
-  // Initialize vertex format with used uv and color layers.
-  RAS_VertexFormat vertformat;
-  vertformat.uvSize = max_ii(1, uvLayers);
-  vertformat.colorSize = max_ii(1, colorLayers);
-
-  struct ConvertedMaterial {
-    Material *ma;
-    RAS_MeshMaterial *meshmat;
-    bool visible;
-    bool twoside;
-    bool collider;
-    bool wire;
-  };
-
-  const unsigned short totmat = max_ii(final_me->totcol, 1);
-  std::vector<ConvertedMaterial> convertedMats(totmat);
-
-  // Convert all the materials contained in the mesh.
-  for (unsigned short i = 0; i < totmat; ++i) {
-    Material *ma = nullptr;
-    if (blenderobj) {
-      ma = BKE_object_material_get(ob_eval, i + 1);
-    }
-    else {
-      ma = final_me->mat ? final_me->mat[i] : nullptr;
-    }
-    // Check for blender material
-    if (!ma) {
-      ma = BKE_material_default_empty();
-    }
-
-    RAS_MaterialBucket *bucket = BL_material_from_mesh(
-        ma, lightlayer, scene, rasty, converter, converting_during_runtime);
-    RAS_MeshMaterial *meshmat = meshobj->AddMaterial(bucket, i, vertformat);
-
-    convertedMats[i] = {ma,
-                        meshmat,
-                        ((ma->game.flag & GEMAT_INVISIBLE) == 0),
-                        ((ma->game.flag & GEMAT_BACKCULL) == 0),
-                        ((ma->game.flag & GEMAT_NOPHYSICS) == 0),
-                        bucket->IsWire()};
-  }
-
   std::vector<std::vector<unsigned int>> mpolyToMface(final_me->polys().size());
   // Generate a list of all mfaces wrapped by a mpoly.
   for (unsigned int i = 0; i < totfaces; ++i) {
@@ -596,6 +516,114 @@ RAS_MeshObject *BL_ConvertMesh(Mesh *mesh,
       meshobj->AddPolygon(meshmat, nverts, indices, mat.visible, mat.collider, mat.twoside);
     }
   }
+}
+
+/* blenderobj can be nullptr, make sure its checked for */
+RAS_MeshObject *BL_ConvertMesh(Mesh *mesh,
+                               Object *blenderobj,
+                               KX_Scene *scene,
+                               RAS_Rasterizer *rasty,
+                               BL_SceneConverter *converter,
+                               bool libloading,
+                               bool converting_during_runtime)
+{
+  RAS_MeshObject *meshobj;
+  int lightlayer = blenderobj ? blenderobj->lay : (1 << 20) - 1;  // all layers if no object.
+
+  // Without checking names, we get some reuse we don't want that can cause
+  // problems with material LoDs.
+  if (blenderobj && ((meshobj = converter->FindGameMesh(mesh /*, ob->lay*/)) != nullptr)) {
+    const std::string bge_name = meshobj->GetName();
+    const std::string blender_name = ((ID *)blenderobj->data)->name + 2;
+    if (bge_name == blender_name) {
+      return meshobj;
+    }
+  }
+
+  // Get Mesh data
+  bContext *C = KX_GetActiveEngine()->GetContext();
+  Depsgraph *depsgraph = CTX_data_depsgraph_on_load(C);
+  Object *ob_eval = DEG_get_evaluated_object(depsgraph, blenderobj);
+  Mesh *final_me = (Mesh *)ob_eval->data;
+
+  /* Extract available layers.
+   * Get the active color and uv layer. */
+  const short activeUv = CustomData_get_active_layer(&final_me->ldata, CD_PROP_FLOAT2);
+  const short activeColor = CustomData_get_active_layer(&final_me->ldata, CD_PROP_BYTE_COLOR);
+
+  RAS_MeshObject::LayersInfo layersInfo;
+  layersInfo.activeUv = (activeUv == -1) ? 0 : activeUv;
+  layersInfo.activeColor = (activeColor == -1) ? 0 : activeColor;
+
+  const unsigned short uvLayers = CustomData_number_of_layers(&final_me->ldata, CD_PROP_FLOAT2);
+  const unsigned short colorLayers = CustomData_number_of_layers(&final_me->ldata, CD_PROP_BYTE_COLOR);
+
+  // Extract UV loops.
+  for (unsigned short i = 0; i < uvLayers; ++i) {
+    const std::string name = CustomData_get_layer_name(&final_me->ldata, CD_PROP_FLOAT2, i);
+    const float(*uv)[2] = (const float(*)[2])CustomData_get_layer_n(&final_me->ldata, CD_PROP_FLOAT2, i);
+    layersInfo.layers.push_back({uv, nullptr, i, name});
+  }
+  // Extract color loops.
+  for (unsigned short i = 0; i < colorLayers; ++i) {
+    const std::string name = CustomData_get_layer_name(&final_me->ldata, CD_PROP_BYTE_COLOR, i);
+    MLoopCol *col = (MLoopCol *)CustomData_get_layer_n(&final_me->ldata, CD_PROP_BYTE_COLOR, i);
+    layersInfo.layers.push_back({nullptr, col, i, name});
+  }
+
+  meshobj = new RAS_MeshObject(mesh, final_me->totvert, blenderobj, layersInfo);
+  meshobj->m_sharedvertex_map.resize(final_me->totvert);
+
+  // Initialize vertex format with used uv and color layers.
+  RAS_VertexFormat vertformat;
+  vertformat.uvSize = max_ii(1, uvLayers);
+  vertformat.colorSize = max_ii(1, colorLayers);
+
+  const unsigned short totmat = max_ii(final_me->totcol, 1);
+  std::vector<ConvertedMaterial> convertedMats(totmat);
+
+  // Convert all the materials contained in the mesh.
+  for (unsigned short i = 0; i < totmat; ++i) {
+    Material *ma = nullptr;
+    if (blenderobj) {
+      ma = BKE_object_material_get(ob_eval, i + 1);
+    }
+    else {
+      ma = final_me->mat ? final_me->mat[i] : nullptr;
+    }
+    // Check for blender material
+    if (!ma) {
+      ma = BKE_material_default_empty();
+    }
+
+    RAS_MaterialBucket *bucket = BL_material_from_mesh(
+        ma, lightlayer, scene, rasty, converter, converting_during_runtime);
+    RAS_MeshMaterial *meshmat = meshobj->AddMaterial(bucket, i, vertformat);
+
+    convertedMats[i] = {ma,
+                        meshmat,
+                        ((ma->game.flag & GEMAT_INVISIBLE) == 0),
+                        ((ma->game.flag & GEMAT_BACKCULL) == 0),
+                        ((ma->game.flag & GEMAT_NOPHYSICS) == 0),
+                        bucket->IsWire()};
+  }
+
+  // The material settings changing the conversion, part of the cache key.
+  std::vector<unsigned short> materialFlags(totmat);
+  for (unsigned short i = 0; i < totmat; ++i) {
+    const ConvertedMaterial &mat = convertedMats[i];
+    materialFlags[i] = (mat.visible << 0) | (mat.twoside << 1) | (mat.collider << 2) |
+                       (mat.wire << 3);
+  }
+
+  const std::string cacheKey = BL_MeshCache::GetKey(final_me, materialFlags.data(), totmat);
+  if (cacheKey.empty() || !BL_MeshCache::Load(cacheKey, meshobj)) {
+    BL_ConvertMeshArrays(final_me, meshobj, layersInfo, convertedMats, uvLayers, colorLayers);
+
+    if (!cacheKey.empty()) {
+      BL_MeshCache::Store(cacheKey, meshobj);
+    }
+  }
 
   // keep meshobj->m_sharedvertex_map for reinstance phys mesh.
   // 2.49a and before it did: meshobj->m_sharedvertex_map.clear();
@@ -1181,7 +1209,8 @@ static void bl_ConvertBlenderObject_Single(BL_SceneConverter *converter,
                           nullptr,
                           nullptr,
                           KX_Scene::KX_ScenegraphUpdateFunc,
-                          KX_Scene::KX_ScenegraphRescheduleFunc);
+                          KX_Scene::KX_ScenegraphRescheduleFunc,
+                          nullptr);
     SG_Node *parentinversenode = new SG_Node(nullptr, kxscene, callback);
 
     // Define a normal parent relationship for this node.
@@ -1825,6 +1854,18 @@ void BL_ConvertBlenderObjects(struct Main *maggie,
       }
     }
     BL_ConvertComponentsObject(gameobj, blenderobj);
+
+#ifdef WITH_PYTHON
+    // The parallel scenes can't be used with python, see KX_KetsjiEngine::NextFrame.
+    if (gameobj->GetPrototype() || gameobj->GetComponents()) {
+      kxscene->SetHasPythonLogic();
+    }
+    for (SCA_IController *controller : gameobj->GetControllers()) {
+      if (controller->GetType() == &SCA_PythonController::Type) {
+        kxscene->SetHasPythonLogic();
+      }
+    }
+#endif  // WITH_PYTHON
   }
 
   for (KX_GameObject *gameobj : objectlist) {
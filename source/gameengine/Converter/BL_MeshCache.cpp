@@ -0,0 +1,438 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file BL_MeshCache.cpp
+ *  \ingroup bgeconv
+ */
+
+#include "BL_MeshCache.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <functional>
+#include <map>
+#include <thread>
+#include <vector>
+
+#include "BKE_customdata.h"
+#include "BKE_main.h"
+#include "BLI_fileops.h"
+#include "BLI_hash_md5.h"
+#include "BLI_mmap.h"
+#include "BLI_path_util.h"
+#include "DNA_mesh_types.h"
+
+#include "BL_Converter.h"
+#include "CM_Message.h"
+#include "KX_Globals.h"
+#include "KX_KetsjiEngine.h"
+#include "LA_SystemCommandLine.h"
+#include "RAS_IDisplayArray.h"
+#include "RAS_MeshObject.h"
+#include "RAS_Polygon.h"
+
+/// Increase when the layout of the cache entries changes.
+static const unsigned int CACHE_VERSION = 1;
+/// Meshes with less face corners are faster to convert than to load.
+static const int CACHE_MIN_LOOPS = 2048;
+/// Mesh layers hashed in the key, the other layers hold pointers or don't change the conversion.
+static const uint64_t CACHE_LAYERS_MASK = CD_MASK_PROP_ALL | CD_MASK_NORMAL |
+                                          CD_MASK_CUSTOMLOOPNORMAL | CD_MASK_ORCO;
+
+/// Header of a cache entry, followed by the arrays, the polygons and the arrays data.
+struct BL_MeshCacheHeader {
+  char magic[4];
+  unsigned int version;
+  unsigned int numMaterials;
+  unsigned int numPolygons;
+};
+
+/// Display array of a material, its data is the vertices, their infos and the indices.
+struct BL_MeshCacheArray {
+  unsigned int uvSize;
+  unsigned int colorSize;
+  unsigned int vertexDataSize;
+  unsigned int vertexCount;
+  unsigned int indexCount;
+};
+
+struct BL_MeshCachePolygon {
+  unsigned int material;
+  unsigned int numVertices;
+  unsigned int flags;
+  unsigned int offsets[4];
+};
+
+/// Settings and mesh properties changing the conversion, part of the key.
+struct BL_MeshCacheSettings {
+  unsigned int version;
+  unsigned int vertexInfoSize;
+  int flag;
+  float smoothResolution;
+  int totvert;
+  int totedge;
+  int totpoly;
+  int totloop;
+  unsigned char polyOffsetsHash[16];
+};
+
+/// A hashed mesh layer, part of the key.
+struct BL_MeshCacheLayer {
+  int type;
+  int active;
+  char name[68];
+  unsigned char hash[16];
+};
+
+static const char cacheMagic[4] = {'B', 'G', 'E', 'M'};
+
+static std::atomic<unsigned int> cacheHits(0);
+static std::atomic<unsigned int> cacheMisses(0);
+
+template<class T> static void append_data(std::vector<char> &data, const T &value)
+{
+  const char *bytes = (const char *)&value;
+  data.insert(data.end(), bytes, bytes + sizeof(T));
+}
+
+static void append_layers(std::vector<char> &data, const CustomData &customData, int count)
+{
+  for (int i = 0; i < customData.totlayer; ++i) {
+    const CustomDataLayer &layer = customData.layers[i];
+    if (!layer.data || !((1ULL << layer.type) & CACHE_LAYERS_MASK)) {
+      continue;
+    }
+
+    BL_MeshCacheLayer info;
+    memset(&info, 0, sizeof(info));
+    info.type = layer.type;
+    info.active = layer.active;
+    memcpy(info.name, layer.name, sizeof(info.name));
+    BLI_hash_md5_buffer((const char *)layer.data,
+                        (size_t)CustomData_sizeof(eCustomDataType(layer.type)) * count,
+                        info.hash);
+    append_data(data, info);
+  }
+}
+
+static size_t get_array_data_size(const BL_MeshCacheArray &array)
+{
+  return (size_t)array.vertexCount * (array.vertexDataSize + sizeof(RAS_VertexInfo)) +
+         (size_t)array.indexCount * sizeof(unsigned int);
+}
+
+/// Return the directory of the cache entries, empty if the .blend was never saved.
+static std::string get_cache_directory()
+{
+  const char *blendpath = BKE_main_blendfile_path(
+      KX_GetActiveEngine()->GetConverter()->GetMain());
+  if (blendpath[0] == '\0') {
+    return "";
+  }
+
+  char path[FILE_MAX];
+  BLI_path_split_dir_part(blendpath, path, sizeof(path));
+  BLI_path_append(path, sizeof(path), "bge_cache");
+  return path;
+}
+
+static std::string get_entry_path(const std::string &directory, const std::string &key)
+{
+  char path[FILE_MAX];
+  BLI_path_join(path, sizeof(path), directory.c_str(), (key + ".mesh").c_str());
+  return path;
+}
+
+static bool load_mesh(const char *data, size_t size, RAS_MeshObject *meshobj)
+{
+  if (!data || size < sizeof(BL_MeshCacheHeader)) {
+    return false;
+  }
+
+  const BL_MeshCacheHeader *header = (const BL_MeshCacheHeader *)data;
+  const unsigned int numMaterials = meshobj->NumMaterials();
+  if (memcmp(header->magic, cacheMagic, sizeof(cacheMagic)) != 0 ||
+      header->version != CACHE_VERSION || header->numMaterials != numMaterials)
+  {
+    return false;
+  }
+
+  const BL_MeshCacheArray *arrays = (const BL_MeshCacheArray *)(header + 1);
+  const BL_MeshCachePolygon *polygons = (const BL_MeshCachePolygon *)(arrays + numMaterials);
+  const size_t dataOffset = sizeof(BL_MeshCacheHeader) + numMaterials * sizeof(BL_MeshCacheArray) +
+                            header->numPolygons * sizeof(BL_MeshCachePolygon);
+  if (dataOffset > size) {
+    return false;
+  }
+
+  // Check the whole entry before modifying the mesh.
+  const unsigned int numOrigVertices = meshobj->m_sharedvertex_map.size();
+  size_t offset = dataOffset;
+  for (unsigned int i = 0; i < numMaterials; ++i) {
+    const BL_MeshCacheArray &array = arrays[i];
+    const RAS_IDisplayArray *darray = meshobj->GetDisplayArray(i);
+    const RAS_VertexFormat &format = darray->GetFormat();
+    if (array.uvSize != format.uvSize || array.colorSize != format.colorSize ||
+        array.vertexDataSize != darray->GetVertexDataSize() || darray->GetVertexCount() != 0 ||
+        offset + get_array_data_size(array) > size)
+    {
+      return false;
+    }
+
+    const RAS_VertexInfo *infos = (const RAS_VertexInfo *)(data + offset +
+                                                           array.vertexCount *
+                                                               array.vertexDataSize);
+    for (unsigned int j = 0; j < array.vertexCount; ++j) {
+      if (infos[j].getOrigIndex() >= numOrigVertices) {
+        return false;
+      }
+    }
+
+    offset += get_array_data_size(array);
+  }
+
+  if (offset != size) {
+    return false;
+  }
+
+  for (unsigned int i = 0; i < header->numPolygons; ++i) {
+    const BL_MeshCachePolygon &poly = polygons[i];
+    if (poly.material >= numMaterials || poly.numVertices < 3 || poly.numVertices > 4) {
+      return false;
+    }
+    for (unsigned int j = 0; j < poly.numVertices; ++j) {
+      if (poly.offsets[j] >= arrays[poly.material].vertexCount) {
+        return false;
+      }
+    }
+  }
+
+  offset = dataOffset;
+  for (unsigned int i = 0; i < numMaterials; ++i) {
+    const BL_MeshCacheArray &array = arrays[i];
+    const char *vertexData = data + offset;
+    const char *infos = vertexData + array.vertexCount * array.vertexDataSize;
+    const char *indices = infos + array.vertexCount * sizeof(RAS_VertexInfo);
+
+    RAS_IDisplayArray *darray = meshobj->GetDisplayArray(i);
+    darray->SetData(vertexData,
+                    (const RAS_VertexInfo *)infos,
+                    array.vertexCount,
+                    (const unsigned int *)indices,
+                    array.indexCount);
+
+    // Any vertex of an original vertex gives its location, the order doesn't matter.
+    for (unsigned int j = 0; j < array.vertexCount; ++j) {
+      const unsigned int origIndex = darray->GetVertexInfo(j).getOrigIndex();
+      meshobj->m_sharedvertex_map[origIndex].push_back({darray, (int)j});
+    }
+
+    offset += get_array_data_size(array);
+  }
+
+  for (unsigned int i = 0; i < header->numPolygons; ++i) {
+    const BL_MeshCachePolygon &poly = polygons[i];
+    meshobj->AddPolygonNoIndices(meshobj->GetMeshMaterial(poly.material),
+                                 poly.numVertices,
+                                 poly.offsets,
+                                 (poly.flags & RAS_Polygon::VISIBLE),
+                                 (poly.flags & RAS_Polygon::COLLIDER),
+                                 (poly.flags & RAS_Polygon::TWOSIDE));
+  }
+
+  return true;
+}
+
+static void write_entry(const std::string &directory,
+                        const std::string &path,
+                        const std::vector<char> &buffer)
+{
+  if (!BLI_dir_create_recursive(directory.c_str())) {
+    CM_Warning("unable to create the mesh cache directory: " << directory);
+    return;
+  }
+
+  // Other threads or players may store the same entry, each one uses its own temporary file.
+  const size_t unique = std::hash<std::thread::id>()(std::this_thread::get_id()) ^
+                        std::chrono::steady_clock::now().time_since_epoch().count();
+  const std::string tmpPath = path + "." + std::to_string(unique) + ".tmp";
+
+  FILE *file = BLI_fopen(tmpPath.c_str(), "wb");
+  if (!file) {
+    return;
+  }
+
+  bool written = (fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size());
+  written = (fclose(file) == 0) && written;
+  if (!written || BLI_rename_overwrite(tmpPath.c_str(), path.c_str()) != 0) {
+    BLI_delete(tmpPath.c_str(), false, false);
+  }
+}
+
+std::string BL_MeshCache::GetKey(const Mesh *mesh,
+                                 const unsigned short *materialFlags,
+                                 unsigned int numMaterials)
+{
+  if (mesh->totloop < CACHE_MIN_LOOPS ||
+      SYS_GetCommandLineInt(SYS_GetSystem(), "mesh_cache", 0) == 0)
+  {
+    return "";
+  }
+
+  BL_MeshCacheSettings settings;
+  memset(&settings, 0, sizeof(settings));
+  settings.version = CACHE_VERSION;
+  settings.vertexInfoSize = sizeof(RAS_VertexInfo);
+  settings.flag = mesh->flag;
+  settings.smoothResolution = mesh->smoothresh;
+  settings.totvert = mesh->totvert;
+  settings.totedge = mesh->totedge;
+  settings.totpoly = mesh->totpoly;
+  settings.totloop = mesh->totloop;
+  const blender::Span<int> polyOffsets = mesh->poly_offsets();
+  BLI_hash_md5_buffer(
+      (const char *)polyOffsets.data(), polyOffsets.size_in_bytes(), settings.polyOffsetsHash);
+
+  std::vector<char> data;
+  append_data(data, settings);
+  append_layers(data, mesh->vdata, mesh->totvert);
+  append_layers(data, mesh->edata, mesh->totedge);
+  append_layers(data, mesh->pdata, mesh->totpoly);
+  append_layers(data, mesh->ldata, mesh->totloop);
+  data.insert(data.end(),
+              (const char *)materialFlags,
+              (const char *)(materialFlags + numMaterials));
+
+  unsigned char hash[16];
+  BLI_hash_md5_buffer(data.data(), data.size(), hash);
+
+  char key[33];
+  return BLI_hash_md5_to_hexdigest(hash, key);
+}
+
+bool BL_MeshCache::Load(const std::string &key, RAS_MeshObject *meshobj)
+{
+  const std::string directory = get_cache_directory();
+  if (directory.empty()) {
+    return false;
+  }
+
+  bool loaded = false;
+  const int file = BLI_open(get_entry_path(directory, key).c_str(), O_BINARY | O_RDONLY, 0);
+  if (file != -1) {
+    const size_t size = BLI_file_descriptor_size(file);
+    BLI_mmap_file *mmapFile = BLI_mmap_open(file);
+    close(file);
+
+    if (mmapFile) {
+      loaded = load_mesh((const char *)BLI_mmap_get_pointer(mmapFile), size, meshobj);
+      BLI_mmap_free(mmapFile);
+    }
+  }
+
+  if (loaded) {
+    ++cacheHits;
+  }
+  else {
+    ++cacheMisses;
+  }
+
+  return loaded;
+}
+
+void BL_MeshCache::Store(const std::string &key, RAS_MeshObject *meshobj)
+{
+  const std::string directory = get_cache_directory();
+  if (directory.empty()) {
+    return;
+  }
+
+  const unsigned int numMaterials = meshobj->NumMaterials();
+  const unsigned int numPolygons = meshobj->NumPolygons();
+
+  std::vector<BL_MeshCacheArray> arrays(numMaterials);
+  std::map<const RAS_IDisplayArray *, unsigned int> arrayMaterials;
+  size_t size = sizeof(BL_MeshCacheHeader) + numMaterials * sizeof(BL_MeshCacheArray) +
+                numPolygons * sizeof(BL_MeshCachePolygon);
+  for (unsigned int i = 0; i < numMaterials; ++i) {
+    const RAS_IDisplayArray *darray = meshobj->GetDisplayArray(i);
+    const RAS_VertexFormat &format = darray->GetFormat();
+    arrays[i] = {format.uvSize,
+                 format.colorSize,
+                 darray->GetVertexDataSize(),
+                 darray->GetVertexCount(),
+                 darray->GetIndexCount()};
+    arrayMaterials[darray] = i;
+    size += get_array_data_size(arrays[i]);
+  }
+
+  std::vector<char> buffer(size);
+  BL_MeshCacheHeader *header = (BL_MeshCacheHeader *)buffer.data();
+  memcpy(header->magic, cacheMagic, sizeof(cacheMagic));
+  header->version = CACHE_VERSION;
+  header->numMaterials = numMaterials;
+  header->numPolygons = numPolygons;
+  memcpy(header + 1, arrays.data(), numMaterials * sizeof(BL_MeshCacheArray));
+
+  BL_MeshCachePolygon *polygons = (BL_MeshCachePolygon *)((BL_MeshCacheArray *)(header + 1) +
+                                                          numMaterials);
+  for (unsigned int i = 0; i < numPolygons; ++i) {
+    const RAS_Polygon *poly = meshobj->GetPolygon(i);
+    BL_MeshCachePolygon &cachePoly = polygons[i];
+    memset(&cachePoly, 0, sizeof(cachePoly));
+    cachePoly.material = arrayMaterials[poly->GetDisplayArray()];
+    cachePoly.numVertices = poly->VertexCount();
+    cachePoly.flags = (poly->IsVisible() ? RAS_Polygon::VISIBLE : 0) |
+                      (poly->IsCollider() ? RAS_Polygon::COLLIDER : 0) |
+                      (poly->IsTwoside() ? RAS_Polygon::TWOSIDE : 0);
+    for (unsigned int j = 0; j < cachePoly.numVertices; ++j) {
+      cachePoly.offsets[j] = poly->GetVertexOffset(j);
+    }
+  }
+
+  char *data = (char *)(polygons + numPolygons);
+  for (unsigned int i = 0; i < numMaterials; ++i) {
+    const RAS_IDisplayArray *darray = meshobj->GetDisplayArray(i);
+    const BL_MeshCacheArray &array = arrays[i];
+
+    darray->GetVertexData(data);
+    data += array.vertexCount * array.vertexDataSize;
+    if (array.vertexCount > 0) {
+      memcpy(data, &darray->GetVertexInfo(0), array.vertexCount * sizeof(RAS_VertexInfo));
+      data += array.vertexCount * sizeof(RAS_VertexInfo);
+    }
+    if (array.indexCount > 0) {
+      memcpy(data, darray->GetIndexPointer(), array.indexCount * sizeof(unsigned int));
+      data += array.indexCount * sizeof(unsigned int);
+    }
+  }
+
+  write_entry(directory, get_entry_path(directory, key), buffer);
+}
+
+void BL_MeshCache::GetStats(unsigned int &hits, unsigned int &misses)
+{
+  hits = cacheHits;
+  misses = cacheMisses;
+}
@@ -0,0 +1,62 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file BL_MeshCache.h
+ *  \ingroup bgeconv
+ */
+
+#pragma once
+
+#include <string>
+
+class RAS_MeshObject;
+struct Mesh;
+
+/** A persistent cache of the converted meshes, stored in a "bge_cache" directory next to the
+ * .blend and enabled with the "mesh_cache" game engine option. The entries are keyed on a
+ * hash of the evaluated mesh data and the material flags changing the conversion, they hold
+ * the display arrays and polygons of a RAS_MeshObject and are memory mapped when loaded.
+ */
+class BL_MeshCache {
+ public:
+  /** Compute the key of a converted mesh.
+   * \param mesh The evaluated mesh converted.
+   * \param materialFlags The conversion flags of each material of the mesh.
+   * \param numMaterials The number of materials.
+   * \return An empty key when the cache is disabled or the mesh is too small to be worth
+   * caching.
+   */
+  static std::string GetKey(const Mesh *mesh,
+                            const unsigned short *materialFlags,
+                            unsigned int numMaterials);
+
+  /** Load the display arrays and the polygons of a mesh object.
+   * \param meshobj The mesh object with all its materials added and no vertices.
+   * \return False when the entry is missing or doesn't match the mesh object.
+   */
+  static bool Load(const std::string &key, RAS_MeshObject *meshobj);
+  /// Store the display arrays and the polygons of a converted mesh object.
+  static void Store(const std::string &key, RAS_MeshObject *meshobj);
+
+  /// Return the number of meshes loaded from the cache and converted for a missing entry.
+  static void GetStats(unsigned int &hits, unsigned int &misses);
+};
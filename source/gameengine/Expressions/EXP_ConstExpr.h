@@ -31,6 +31,8 @@ class EXP_ConstExpr : public EXP_Expression {
   virtual double GetNumber();
   virtual EXP_Value *Calculate();
 
+  EXP_Value *GetValue() const;
+
  private:
   EXP_Value *m_value;
 };
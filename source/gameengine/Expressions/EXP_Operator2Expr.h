@@ -30,6 +30,10 @@ class EXP_Operator2Expr : public EXP_Expression {
   virtual unsigned char GetExpressionID();
   virtual EXP_Value *Calculate();
 
+  VALUE_OPERATOR GetOperator() const;
+  EXP_Expression *GetLhs() const;
+  EXP_Expression *GetRhs() const;
+
  protected:
   EXP_Expression *m_rhs;
   EXP_Expression *m_lhs;
@@ -0,0 +1,63 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file EXP_PropertyHandle.h
+ *  \ingroup expressions
+ */
+
+#pragma once
+
+#include <string>
+
+/** Property name resolved once to access a property without hashing the name.
+ * The slot is a hint valid for all the values sharing the same property layout, e.g. an
+ * object and its replicas. On mismatch the lookup falls back to the hashed name.
+ */
+class EXP_PropertyHandle {
+  friend class EXP_Value;
+
+ private:
+  /// Interned name, nullptr for an unresolved handle.
+  const std::string *m_name;
+  /// Last slot the property was found at.
+  int m_slot;
+
+ public:
+  EXP_PropertyHandle();
+  explicit EXP_PropertyHandle(const std::string &name);
+  EXP_PropertyHandle(const EXP_PropertyHandle &other);
+  ~EXP_PropertyHandle();
+
+  EXP_PropertyHandle &operator=(const EXP_PropertyHandle &other);
+
+  bool IsValid() const;
+  const std::string &GetName() const;
+
+  /** Return the unique instance of a property name shared by all the property tables.
+   * The name is reference counted, each call must be balanced by a call to ReleaseName().
+   */
+  static const std::string *InternName(const std::string &name);
+  /// Add a reference to an already interned name.
+  static void AcquireName(const std::string *name);
+  /// Remove a reference to an interned name, the name is freed with its last reference.
+  static void ReleaseName(const std::string *name);
+};
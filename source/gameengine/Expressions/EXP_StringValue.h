@@ -39,6 +39,8 @@ class EXP_StringValue : public EXP_PropValue {
   virtual void SetValue(EXP_Value *newval);
   virtual EXP_Value *GetReplica();
 
+  const std::string &GetString() const;
+
 #ifdef WITH_PYTHON
   virtual PyObject *ConvertValueToPython()
   {
@@ -22,11 +22,15 @@
 #  pragma warning(disable : 4786)
 #endif
 
-#include <map>     // Array functionality for the property list.
+#include <map>
 #include <string>  // std::string class.
 #include <vector>
 
+#include "BLI_map.hh"
+#include "BLI_string_ref.hh"
+
 #include "CM_RefCount.h"
+#include "EXP_PropertyHandle.h"
 
 #ifndef GEN_NO_TRACE
 #  undef trace
@@ -125,6 +129,10 @@ class EXP_Value : public EXP_PyObjectPlus, public CM_RefCount<EXP_Value> {
   /// needed.
   virtual void SetProperty(const std::string &name, EXP_Value *ioProperty);
   virtual EXP_Value *GetProperty(const std::string &inName);
+  /// Set property pointed by a pre-resolved handle, same as SetProperty() by name.
+  void SetProperty(EXP_PropertyHandle &handle, EXP_Value *ioProperty);
+  /// Get property pointed by a pre-resolved handle, returns nullptr if there is no such property.
+  EXP_Value *GetProperty(EXP_PropertyHandle &handle);
   /// Get text description of property with name <inName>, returns an empty string if there is no
   /// property named <inName>.
   const std::string GetPropertyText(const std::string &inName);
@@ -167,8 +175,19 @@ class EXP_Value : public EXP_PyObjectPlus, public CM_RefCount<EXP_Value> {
   virtual void DestructFromPython();
 
  private:
-  /// Properties for user/game etc.
-  std::map<std::string, EXP_Value *> m_properties;
+  struct PropertySlot {
+    /// Interned name, see EXP_PropertyHandle::InternName().
+    const std::string *m_name;
+    EXP_Value *m_value;
+  };
+
+  /// Find the slot of a property by handle, updating the handle hint, returns -1 if not found.
+  int FindPropertySlot(EXP_PropertyHandle &handle) const;
+
+  /// Properties for user/game etc, in creation order, copied in one block by replicas.
+  std::vector<PropertySlot> m_properties;
+  /// Slot of each property, keys reference the interned names.
+  blender::Map<blender::StringRef, int> m_propertySlots;
 };
 
 /** EXP_PropValue is a EXP_Value derived class, that implements the identification (String name)
@@ -39,6 +39,11 @@ unsigned char EXP_ConstExpr::GetExpressionID()
   return CCONSTEXPRESSIONID;
 }
 
+EXP_Value *EXP_ConstExpr::GetValue() const
+{
+  return m_value;
+}
+
 EXP_Value *EXP_ConstExpr::Calculate()
 {
   return m_value->AddRef();
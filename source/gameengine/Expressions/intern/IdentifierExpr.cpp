@@ -63,3 +63,8 @@ unsigned char EXP_IdentifierExpr::GetExpressionID()
 {
   return CIDENTIFIEREXPRESSIONID;
 }
+
+const std::string &EXP_IdentifierExpr::GetIdentifier() const
+{
+  return m_identifier;
+}
@@ -39,6 +39,16 @@ unsigned char EXP_Operator1Expr::GetExpressionID()
   return COPERATOR1EXPRESSIONID;
 }
 
+VALUE_OPERATOR EXP_Operator1Expr::GetOperator() const
+{
+  return m_op;
+}
+
+EXP_Expression *EXP_Operator1Expr::GetLhs() const
+{
+  return m_lhs;
+}
+
 EXP_Value *EXP_Operator1Expr::Calculate()
 {
   EXP_Value *temp = m_lhs->Calculate();
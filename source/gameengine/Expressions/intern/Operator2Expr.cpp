@@ -41,6 +41,21 @@ unsigned char EXP_Operator2Expr::GetExpressionID()
   return COPERATOR2EXPRESSIONID;
 }
 
+VALUE_OPERATOR EXP_Operator2Expr::GetOperator() const
+{
+  return m_op;
+}
+
+EXP_Expression *EXP_Operator2Expr::GetLhs() const
+{
+  return m_lhs;
+}
+
+EXP_Expression *EXP_Operator2Expr::GetRhs() const
+{
+  return m_rhs;
+}
+
 EXP_Value *EXP_Operator2Expr::Calculate()
 {
 
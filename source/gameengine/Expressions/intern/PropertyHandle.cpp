@@ -0,0 +1,113 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file PropertyHandle.cpp
+ *  \ingroup expressions
+ */
+
+#include "EXP_PropertyHandle.h"
+
+#include <unordered_map>
+
+#include "CM_Thread.h"
+
+/// Interned names with their number of users, node based to keep the names addresses stable.
+static std::unordered_map<std::string, unsigned int> names;
+// Properties can be created from the asynchronous conversion thread.
+static CM_ThreadMutex namesMutex;
+
+EXP_PropertyHandle::EXP_PropertyHandle() : m_name(nullptr), m_slot(-1)
+{
+}
+
+EXP_PropertyHandle::EXP_PropertyHandle(const std::string &name)
+    : m_name(InternName(name)), m_slot(-1)
+{
+}
+
+EXP_PropertyHandle::EXP_PropertyHandle(const EXP_PropertyHandle &other)
+    : m_name(other.m_name), m_slot(other.m_slot)
+{
+  if (m_name) {
+    AcquireName(m_name);
+  }
+}
+
+EXP_PropertyHandle::~EXP_PropertyHandle()
+{
+  if (m_name) {
+    ReleaseName(m_name);
+  }
+}
+
+EXP_PropertyHandle &EXP_PropertyHandle::operator=(const EXP_PropertyHandle &other)
+{
+  if (other.m_name) {
+    AcquireName(other.m_name);
+  }
+  if (m_name) {
+    ReleaseName(m_name);
+  }
+
+  m_name = other.m_name;
+  m_slot = other.m_slot;
+
+  return *this;
+}
+
+bool EXP_PropertyHandle::IsValid() const
+{
+  return (m_name != nullptr);
+}
+
+const std::string &EXP_PropertyHandle::GetName() const
+{
+  return *m_name;
+}
+
+const std::string *EXP_PropertyHandle::InternName(const std::string &name)
+{
+  namesMutex.Lock();
+  auto it = names.emplace(name, 0).first;
+  ++it->second;
+  const std::string *interned = &it->first;
+  namesMutex.Unlock();
+
+  return interned;
+}
+
+void EXP_PropertyHandle::AcquireName(const std::string *name)
+{
+  namesMutex.Lock();
+  ++names.find(*name)->second;
+  namesMutex.Unlock();
+}
+
+void EXP_PropertyHandle::ReleaseName(const std::string *name)
+{
+  namesMutex.Lock();
+  auto it = names.find(*name);
+  if (--it->second == 0) {
+    names.erase(it);
+  }
+  namesMutex.Unlock();
+}
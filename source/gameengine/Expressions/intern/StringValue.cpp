@@ -103,6 +103,11 @@ int EXP_StringValue::GetValueType()
   return VALUE_STRING_TYPE;
 }
 
+const std::string &EXP_StringValue::GetString() const
+{
+  return m_strString;
+}
+
 std::string EXP_StringValue::GetText()
 {
   return m_strString;
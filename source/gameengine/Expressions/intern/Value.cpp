@@ -20,6 +20,8 @@
 
 #include "EXP_Value.h"
 
+#include <algorithm>
+
 #include "EXP_BoolValue.h"
 #include "EXP_ErrorValue.h"
 #include "EXP_FloatValue.h"
@@ -155,26 +157,80 @@ void EXP_Value::SetProperty(const std::string &name, EXP_Value *ioProperty)
   }
 
   // Try to replace property (if so -> exit as soon as we replaced it).
-  EXP_Value *oldval = m_properties[name];
-  if (oldval) {
-    oldval->Release();
+  const int slot = m_propertySlots.lookup_default(name, -1);
+  if (slot != -1) {
+    EXP_Value *&value = m_properties[slot].m_value;
+    value->Release();
+    value = ioProperty->AddRef();
+    return;
   }
 
   // Add property at end of array.
-  m_properties[name] = ioProperty->AddRef();
+  const std::string *internedName = EXP_PropertyHandle::InternName(name);
+  m_propertySlots.add_new(*internedName, m_properties.size());
+  m_properties.push_back({internedName, ioProperty->AddRef()});
+}
+
+void EXP_Value::SetProperty(EXP_PropertyHandle &handle, EXP_Value *ioProperty)
+{
+  if (ioProperty == nullptr) {
+    trace("Warning:trying to set empty property!");
+    return;
+  }
+
+  const int slot = FindPropertySlot(handle);
+  if (slot != -1) {
+    EXP_Value *&value = m_properties[slot].m_value;
+    value->Release();
+    value = ioProperty->AddRef();
+    return;
+  }
+
+  EXP_PropertyHandle::AcquireName(handle.m_name);
+  handle.m_slot = m_properties.size();
+  m_propertySlots.add_new(*handle.m_name, handle.m_slot);
+  m_properties.push_back({handle.m_name, ioProperty->AddRef()});
 }
 
 /// Get pointer to a property with name <inName>, returns nullptr if there is no property named
 /// <inName>.
 EXP_Value *EXP_Value::GetProperty(const std::string &inName)
 {
-  std::map<std::string, EXP_Value *>::iterator it = m_properties.find(inName);
-  if (it != m_properties.end()) {
-    return it->second;
+  const int slot = m_propertySlots.lookup_default(inName, -1);
+  if (slot != -1) {
+    return m_properties[slot].m_value;
   }
   return nullptr;
 }
 
+EXP_Value *EXP_Value::GetProperty(EXP_PropertyHandle &handle)
+{
+  const int slot = FindPropertySlot(handle);
+  if (slot != -1) {
+    return m_properties[slot].m_value;
+  }
+  return nullptr;
+}
+
+int EXP_Value::FindPropertySlot(EXP_PropertyHandle &handle) const
+{
+  if (!handle.m_name) {
+    return -1;
+  }
+
+  // Fast path when the table has the same layout as the last one the handle was used on.
+  const int hint = handle.m_slot;
+  if (hint >= 0 && hint < (int)m_properties.size() && m_properties[hint].m_name == handle.m_name) {
+    return hint;
+  }
+
+  const int slot = m_propertySlots.lookup_default(*handle.m_name, -1);
+  if (slot != -1) {
+    handle.m_slot = slot;
+  }
+  return slot;
+}
+
 /// Get text description of property with name <inName>, returns an empty string if there is no
 /// property named <inName>.
 const std::string EXP_Value::GetPropertyText(const std::string &inName)
@@ -203,14 +259,23 @@ float EXP_Value::GetPropertyNumber(const std::string &inName, float defnumber)
 /// if property was not found or could not be removed.
 bool EXP_Value::RemoveProperty(const std::string &inName)
 {
-  std::map<std::string, EXP_Value *>::iterator it = m_properties.find(inName);
-  if (it != m_properties.end()) {
-    (*it).second->Release();
-    m_properties.erase(it);
-    return true;
+  const int slot = m_propertySlots.lookup_default(inName, -1);
+  if (slot == -1) {
+    return false;
   }
 
-  return false;
+  const PropertySlot &prop = m_properties[slot];
+  prop.m_value->Release();
+  m_propertySlots.remove(inName);
+  EXP_PropertyHandle::ReleaseName(prop.m_name);
+  m_properties.erase(m_properties.begin() + slot);
+
+  // Shift the slots of the following properties.
+  for (int i = slot, size = m_properties.size(); i < size; ++i) {
+    m_propertySlots.lookup(*m_properties[i].m_name) = i;
+  }
+
+  return true;
 }
 
 /// Get Property Names.
@@ -220,9 +285,11 @@ std::vector<std::string> EXP_Value::GetPropertyNames()
   std::vector<std::string> result(size);
 
   unsigned short i = 0;
-  for (const auto &pair : m_properties) {
-    result[i++] = pair.first;
+  for (const PropertySlot &prop : m_properties) {
+    result[i++] = *prop.m_name;
   }
+  // The slots are in creation order, keep returning the names sorted.
+  std::sort(result.begin(), result.end());
   return result;
 }
 
@@ -230,25 +297,23 @@ std::vector<std::string> EXP_Value::GetPropertyNames()
 void EXP_Value::ClearProperties()
 {
   // Remove all properties.
-  for (const auto &pair : m_properties) {
-    pair.second->Release();
+  for (const PropertySlot &prop : m_properties) {
+    prop.m_value->Release();
+    EXP_PropertyHandle::ReleaseName(prop.m_name);
   }
 
   // Delete property array.
   m_properties.clear();
+  m_propertySlots.clear();
 }
 
 /// Get property number <inIndex>.
 EXP_Value *EXP_Value::GetProperty(int inIndex)
 {
-  int count = 0;
-
-  for (const auto &pair : m_properties) {
-    if (count++ == inIndex) {
-      return pair.second;
-    }
+  if (inIndex < 0 || inIndex >= (int)m_properties.size()) {
+    return nullptr;
   }
-  return nullptr;
+  return m_properties[inIndex].m_value;
 }
 
 /// Get the amount of properties assiocated with this value.
@@ -270,9 +335,10 @@ void EXP_Value::ProcessReplica()
 {
   EXP_PyObjectPlus::ProcessReplica();
 
-  // Copy all props.
-  for (auto &pair : m_properties) {
-    pair.second = pair.second->GetReplica();
+  // Copy all props, the table itself was copied with the value.
+  for (PropertySlot &prop : m_properties) {
+    prop.m_value = prop.m_value->GetReplica();
+    EXP_PropertyHandle::AcquireName(prop.m_name);
   }
 }
 
@@ -372,11 +438,12 @@ EXP_Value *EXP_Value::ConvertPythonToValue(PyObject *pyobj,
 
 PyObject *EXP_Value::ConvertKeysToPython(void)
 {
-  PyObject *pylist = PyList_New(m_properties.size());
+  const std::vector<std::string> names = GetPropertyNames();
+  PyObject *pylist = PyList_New(names.size());
 
   Py_ssize_t i = 0;
-  for (const auto &pair : m_properties) {
-    PyList_SET_ITEM(pylist, i++, PyUnicode_FromStdString(pair.first));
+  for (const std::string &name : names) {
+    PyList_SET_ITEM(pylist, i++, PyUnicode_FromStdString(name));
   }
 
   return pylist;
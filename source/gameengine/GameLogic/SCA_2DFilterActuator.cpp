@@ -117,6 +117,9 @@ bool SCA_2DFilterActuator::Update()
     }
   }
 
+  // The filters are applied after the scene render, changing them must render again.
+  m_scene->RequestRender();
+
   // once the filter is in place, no need to update it again => disable the actuator
   return false;
 }
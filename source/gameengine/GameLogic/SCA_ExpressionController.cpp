@@ -34,8 +34,17 @@
 
 #include "SCA_ExpressionController.h"
 
+#include <algorithm>
+
 #include "CM_Message.h"
+#include "EXP_BoolValue.h"
+#include "EXP_ConstExpr.h"
+#include "EXP_FloatValue.h"
+#include "EXP_IdentifierExpr.h"
 #include "EXP_InputParser.h"
+#include "EXP_Operator1Expr.h"
+#include "EXP_Operator2Expr.h"
+#include "EXP_StringValue.h"
 #include "SCA_ISensor.h"
 #include "SCA_LogicManager.h"
 
@@ -45,7 +54,10 @@
 
 SCA_ExpressionController::SCA_ExpressionController(SCA_IObject *gameobj,
                                                    const std::string &exprtext)
-    : SCA_IController(gameobj), m_exprText(exprtext), m_exprCache(nullptr)
+    : SCA_IController(gameobj),
+      m_exprText(exprtext),
+      m_exprCache(nullptr),
+      m_programCompiled(false)
 {
 }
 
@@ -60,6 +72,10 @@ EXP_Value *SCA_ExpressionController::GetReplica()
   SCA_ExpressionController *replica = new SCA_ExpressionController(*this);
   replica->m_exprText = m_exprText;
   replica->m_exprCache = nullptr;
+  // The program references the sensors of this controller.
+  replica->m_program.clear();
+  replica->m_stack.clear();
+  replica->m_programCompiled = false;
   // this will copy properties and so on...
   replica->ProcessReplica();
 
@@ -74,19 +90,30 @@ void SCA_ExpressionController::Delete()
     m_exprCache->Release();
     m_exprCache = nullptr;
   }
+  m_program.clear();
+  m_programCompiled = false;
   Release();
 }
 
-void SCA_ExpressionController::Trigger(SCA_LogicManager *logicmgr)
+bool SCA_ExpressionController::Evaluate()
 {
-
   bool expressionresult = false;
   if (!m_exprCache) {
     EXP_Parser parser;
     parser.SetContext(this->AddRef());
     m_exprCache = parser.ProcessText(m_exprText);
   }
-  if (m_exprCache) {
+  if (m_exprCache && !m_programCompiled) {
+    CompileProgram();
+  }
+
+  bool evaluated = false;
+  if (!m_program.empty()) {
+    evaluated = RunProgram(expressionresult);
+  }
+
+  // Fall back to the expression tree for anything the program doesn't handle.
+  if (!evaluated && m_exprCache) {
     EXP_Value *value = m_exprCache->Calculate();
     if (value) {
       if (value->IsError()) {
@@ -100,6 +127,13 @@ void SCA_ExpressionController::Trigger(SCA_LogicManager *logicmgr)
     }
   }
 
+  return expressionresult;
+}
+
+void SCA_ExpressionController::Trigger(SCA_LogicManager *logicmgr)
+{
+  const bool expressionresult = Evaluate();
+
   for (std::vector<SCA_IActuator *>::const_iterator i = m_linkedactuators.begin();
        !(i == m_linkedactuators.end());
        i++) {
@@ -108,6 +142,30 @@ void SCA_ExpressionController::Trigger(SCA_LogicManager *logicmgr)
   }
 }
 
+void SCA_ExpressionController::LinkToSensor(SCA_ISensor *sensor)
+{
+  SCA_IController::LinkToSensor(sensor);
+  m_programCompiled = false;
+}
+
+void SCA_ExpressionController::UnlinkAllSensors()
+{
+  SCA_IController::UnlinkAllSensors();
+  m_programCompiled = false;
+}
+
+void SCA_ExpressionController::UnlinkSensor(SCA_ISensor *sensor)
+{
+  SCA_IController::UnlinkSensor(sensor);
+  m_programCompiled = false;
+}
+
+void SCA_ExpressionController::Relink(std::map<SCA_IObject *, SCA_IObject *> &obj_map)
+{
+  SCA_IController::Relink(obj_map);
+  m_programCompiled = false;
+}
+
 EXP_Value *SCA_ExpressionController::FindIdentifier(const std::string &identifiername)
 {
 
@@ -135,3 +193,400 @@ EXP_Value *SCA_ExpressionController::FindIdentifier(const std::string &identifie
 
   return GetParent()->FindIdentifier(identifiername);
 }
+
+bool SCA_ExpressionController::CompileProgram()
+{
+  m_program.clear();
+  m_stack.clear();
+  m_programCompiled = true;
+
+  unsigned int maxDepth = 0;
+  if (!CompileExpression(m_exprCache, 0, maxDepth)) {
+    m_program.clear();
+    return false;
+  }
+
+  m_stack.resize(maxDepth);
+  return true;
+}
+
+bool SCA_ExpressionController::CompileExpression(EXP_Expression *expr,
+                                                 unsigned int depth,
+                                                 unsigned int &maxDepth)
+{
+  Instruction instr;
+  instr.m_sensor = nullptr;
+
+  switch (expr->GetExpressionID()) {
+    case EXP_Expression::CCONSTEXPRESSIONID: {
+      EXP_Value *value = static_cast<EXP_ConstExpr *>(expr)->GetValue();
+      Operand &operand = instr.m_const;
+      operand.m_type = (VALUE_DATA_TYPE)value->GetValueType();
+      operand.m_string = nullptr;
+      switch (operand.m_type) {
+        case VALUE_INT_TYPE: {
+          operand.m_int = static_cast<EXP_IntValue *>(value)->GetInt();
+          break;
+        }
+        case VALUE_FLOAT_TYPE: {
+          operand.m_float = static_cast<EXP_FloatValue *>(value)->GetFloat();
+          break;
+        }
+        case VALUE_BOOL_TYPE: {
+          operand.m_bool = static_cast<EXP_BoolValue *>(value)->GetBool();
+          break;
+        }
+        case VALUE_STRING_TYPE: {
+          instr.m_string = static_cast<EXP_StringValue *>(value)->GetString();
+          break;
+        }
+        default: {
+          return false;
+        }
+      }
+      instr.m_code = OP_PUSH_CONST;
+      break;
+    }
+    case EXP_Expression::CIDENTIFIEREXPRESSIONID: {
+      const std::string &name = static_cast<EXP_IdentifierExpr *>(expr)->GetIdentifier();
+      // Same lookup order as FindIdentifier: linked sensors first, then object properties.
+      for (SCA_ISensor *sensor : m_linkedsensors) {
+        if (sensor->GetName() == name) {
+          instr.m_sensor = sensor;
+          break;
+        }
+      }
+
+      if (instr.m_sensor) {
+        instr.m_code = OP_PUSH_SENSOR;
+      }
+      // Sub-context identifiers are left to the tree.
+      else if (name.find('.') == std::string::npos) {
+        instr.m_code = OP_PUSH_PROPERTY;
+        instr.m_property = EXP_PropertyHandle(name);
+      }
+      else {
+        return false;
+      }
+      break;
+    }
+    case EXP_Expression::COPERATOR1EXPRESSIONID: {
+      EXP_Operator1Expr *opexpr = static_cast<EXP_Operator1Expr *>(expr);
+      if (!CompileExpression(opexpr->GetLhs(), depth, maxDepth)) {
+        return false;
+      }
+      instr.m_code = OP_UNARY;
+      instr.m_op = opexpr->GetOperator();
+      switch (instr.m_op) {
+        case VALUE_NOT_OPERATOR:
+        case VALUE_NEG_OPERATOR:
+        case VALUE_POS_OPERATOR: {
+          break;
+        }
+        default: {
+          return false;
+        }
+      }
+      m_program.push_back(instr);
+      return true;
+    }
+    case EXP_Expression::COPERATOR2EXPRESSIONID: {
+      EXP_Operator2Expr *opexpr = static_cast<EXP_Operator2Expr *>(expr);
+      if (!CompileExpression(opexpr->GetLhs(), depth, maxDepth) ||
+          !CompileExpression(opexpr->GetRhs(), depth + 1, maxDepth))
+      {
+        return false;
+      }
+      instr.m_code = OP_BINARY;
+      instr.m_op = opexpr->GetOperator();
+      switch (instr.m_op) {
+        case VALUE_ADD_OPERATOR:
+        case VALUE_SUB_OPERATOR:
+        case VALUE_MUL_OPERATOR:
+        case VALUE_DIV_OPERATOR:
+        case VALUE_AND_OPERATOR:
+        case VALUE_OR_OPERATOR:
+        case VALUE_EQL_OPERATOR:
+        case VALUE_NEQ_OPERATOR:
+        case VALUE_GRE_OPERATOR:
+        case VALUE_LES_OPERATOR:
+        case VALUE_GEQ_OPERATOR:
+        case VALUE_LEQ_OPERATOR: {
+          break;
+        }
+        default: {
+          return false;
+        }
+      }
+      m_program.push_back(instr);
+      return true;
+    }
+    default: {
+      // If expressions and unknown nodes are evaluated by the tree.
+      return false;
+    }
+  }
+
+  // Leaf instructions push one operand.
+  maxDepth = std::max(maxDepth, depth + 1);
+  m_program.push_back(instr);
+  return true;
+}
+
+template <class Type>
+static bool compare_values(VALUE_OPERATOR op, const Type &lhs, const Type &rhs, bool &result)
+{
+  switch (op) {
+    case VALUE_EQL_OPERATOR: {
+      result = (lhs == rhs);
+      return true;
+    }
+    case VALUE_NEQ_OPERATOR: {
+      result = (lhs != rhs);
+      return true;
+    }
+    case VALUE_GRE_OPERATOR: {
+      result = (lhs > rhs);
+      return true;
+    }
+    case VALUE_LES_OPERATOR: {
+      result = (lhs < rhs);
+      return true;
+    }
+    case VALUE_GEQ_OPERATOR: {
+      result = (lhs >= rhs);
+      return true;
+    }
+    case VALUE_LEQ_OPERATOR: {
+      result = (lhs <= rhs);
+      return true;
+    }
+    default: {
+      return false;
+    }
+  }
+}
+
+bool SCA_ExpressionController::RunProgram(bool &result)
+{
+  Operand *stack = m_stack.data();
+  unsigned int top = 0;
+
+  for (Instruction &instr : m_program) {
+    switch (instr.m_code) {
+      case OP_PUSH_CONST: {
+        Operand &operand = stack[top++];
+        operand = instr.m_const;
+        if (operand.m_type == VALUE_STRING_TYPE) {
+          operand.m_string = &instr.m_string;
+        }
+        break;
+      }
+      case OP_PUSH_SENSOR: {
+        Operand &operand = stack[top++];
+        operand.m_type = VALUE_BOOL_TYPE;
+        operand.m_bool = instr.m_sensor->GetState();
+        break;
+      }
+      case OP_PUSH_PROPERTY: {
+        EXP_Value *prop = GetParent()->GetProperty(instr.m_property);
+        if (!prop) {
+          return false;
+        }
+
+        Operand &operand = stack[top++];
+        operand.m_type = (VALUE_DATA_TYPE)prop->GetValueType();
+        switch (operand.m_type) {
+          case VALUE_INT_TYPE: {
+            operand.m_int = static_cast<EXP_IntValue *>(prop)->GetInt();
+            break;
+          }
+          case VALUE_FLOAT_TYPE: {
+            operand.m_float = static_cast<EXP_FloatValue *>(prop)->GetFloat();
+            break;
+          }
+          case VALUE_BOOL_TYPE: {
+            operand.m_bool = static_cast<EXP_BoolValue *>(prop)->GetBool();
+            break;
+          }
+          case VALUE_STRING_TYPE: {
+            operand.m_string = &static_cast<EXP_StringValue *>(prop)->GetString();
+            break;
+          }
+          default: {
+            return false;
+          }
+        }
+        break;
+      }
+      case OP_UNARY: {
+        Operand &operand = stack[top - 1];
+        switch (instr.m_op) {
+          case VALUE_NOT_OPERATOR: {
+            if (operand.m_type == VALUE_INT_TYPE) {
+              operand.m_bool = (operand.m_int == 0);
+            }
+            else if (operand.m_type == VALUE_FLOAT_TYPE) {
+              operand.m_bool = (operand.m_float == 0.0f);
+            }
+            else if (operand.m_type == VALUE_BOOL_TYPE) {
+              operand.m_bool = !operand.m_bool;
+            }
+            else {
+              return false;
+            }
+            operand.m_type = VALUE_BOOL_TYPE;
+            break;
+          }
+          case VALUE_NEG_OPERATOR: {
+            if (operand.m_type == VALUE_INT_TYPE) {
+              operand.m_int = -operand.m_int;
+            }
+            else if (operand.m_type == VALUE_FLOAT_TYPE) {
+              operand.m_float = -operand.m_float;
+            }
+            else {
+              return false;
+            }
+            break;
+          }
+          default: {
+            if (operand.m_type != VALUE_INT_TYPE && operand.m_type != VALUE_FLOAT_TYPE) {
+              return false;
+            }
+            break;
+          }
+        }
+        break;
+      }
+      case OP_BINARY: {
+        const Operand &rhs = stack[--top];
+        Operand &lhs = stack[top - 1];
+        const VALUE_OPERATOR op = instr.m_op;
+
+        const bool lnumber = (lhs.m_type == VALUE_INT_TYPE || lhs.m_type == VALUE_FLOAT_TYPE);
+        const bool rnumber = (rhs.m_type == VALUE_INT_TYPE || rhs.m_type == VALUE_FLOAT_TYPE);
+
+        if (lhs.m_type == VALUE_INT_TYPE && rhs.m_type == VALUE_INT_TYPE) {
+          switch (op) {
+            case VALUE_ADD_OPERATOR: {
+              lhs.m_int += rhs.m_int;
+              break;
+            }
+            case VALUE_SUB_OPERATOR: {
+              lhs.m_int -= rhs.m_int;
+              break;
+            }
+            case VALUE_MUL_OPERATOR: {
+              lhs.m_int *= rhs.m_int;
+              break;
+            }
+            case VALUE_DIV_OPERATOR: {
+              // Let the tree report the division error.
+              if (rhs.m_int == 0) {
+                return false;
+              }
+              lhs.m_int /= rhs.m_int;
+              break;
+            }
+            default: {
+              if (!compare_values(op, lhs.m_int, rhs.m_int, lhs.m_bool)) {
+                return false;
+              }
+              lhs.m_type = VALUE_BOOL_TYPE;
+              break;
+            }
+          }
+        }
+        else if (lnumber && rnumber) {
+          // Mixed operations are computed in single precision like EXP_FloatValue.
+          const float lvalue = (lhs.m_type == VALUE_INT_TYPE) ? lhs.m_int : lhs.m_float;
+          const float rvalue = (rhs.m_type == VALUE_INT_TYPE) ? rhs.m_int : rhs.m_float;
+          switch (op) {
+            case VALUE_ADD_OPERATOR: {
+              lhs.m_float = lvalue + rvalue;
+              break;
+            }
+            case VALUE_SUB_OPERATOR: {
+              lhs.m_float = lvalue - rvalue;
+              break;
+            }
+            case VALUE_MUL_OPERATOR: {
+              lhs.m_float = lvalue * rvalue;
+              break;
+            }
+            case VALUE_DIV_OPERATOR: {
+              if (rvalue == 0.0f) {
+                return false;
+              }
+              lhs.m_float = lvalue / rvalue;
+              break;
+            }
+            default: {
+              if (!compare_values(op, lvalue, rvalue, lhs.m_bool)) {
+                return false;
+              }
+              lhs.m_type = VALUE_BOOL_TYPE;
+              break;
+            }
+          }
+          if (lhs.m_type != VALUE_BOOL_TYPE) {
+            lhs.m_type = VALUE_FLOAT_TYPE;
+          }
+        }
+        else if (lhs.m_type == VALUE_BOOL_TYPE && rhs.m_type == VALUE_BOOL_TYPE) {
+          switch (op) {
+            case VALUE_AND_OPERATOR: {
+              lhs.m_bool = lhs.m_bool && rhs.m_bool;
+              break;
+            }
+            case VALUE_OR_OPERATOR: {
+              lhs.m_bool = lhs.m_bool || rhs.m_bool;
+              break;
+            }
+            case VALUE_EQL_OPERATOR: {
+              lhs.m_bool = (lhs.m_bool == rhs.m_bool);
+              break;
+            }
+            case VALUE_NEQ_OPERATOR: {
+              lhs.m_bool = (lhs.m_bool != rhs.m_bool);
+              break;
+            }
+            default: {
+              return false;
+            }
+          }
+        }
+        else if (lhs.m_type == VALUE_STRING_TYPE && rhs.m_type == VALUE_STRING_TYPE) {
+          if (!compare_values(op, *lhs.m_string, *rhs.m_string, lhs.m_bool)) {
+            return false;
+          }
+          lhs.m_type = VALUE_BOOL_TYPE;
+        }
+        else {
+          return false;
+        }
+        break;
+      }
+    }
+  }
+
+  const Operand &operand = stack[0];
+  switch (operand.m_type) {
+    case VALUE_BOOL_TYPE: {
+      result = operand.m_bool;
+      return true;
+    }
+    case VALUE_INT_TYPE: {
+      result = !MT_fuzzyZero((float)operand.m_int);
+      return true;
+    }
+    case VALUE_FLOAT_TYPE: {
+      result = !MT_fuzzyZero(operand.m_float);
+      return true;
+    }
+    default: {
+      return false;
+    }
+  }
+}
@@ -34,22 +34,77 @@
 
 #pragma once
 
+#include "EXP_IntValue.h"
+#include "EXP_PropertyHandle.h"
 #include "SCA_IController.h"
 
 class EXP_Expression;
+class SCA_ISensor;
 
 class SCA_ExpressionController : public SCA_IController {
   //	Py_Header
+ private:
+  /// Instruction kinds of the compiled expression program.
+  enum OpCode { OP_PUSH_CONST, OP_PUSH_SENSOR, OP_PUSH_PROPERTY, OP_UNARY, OP_BINARY };
+
+  /// Typed value stored on the program stack, no reference counting involved.
+  struct Operand {
+    VALUE_DATA_TYPE m_type;
+    cInt m_int;
+    float m_float;
+    bool m_bool;
+    const std::string *m_string;
+  };
+
+  struct Instruction {
+    OpCode m_code;
+    /// Operator applied by OP_UNARY and OP_BINARY.
+    VALUE_OPERATOR m_op;
+    /// Value pushed by OP_PUSH_CONST, string constants are stored in m_string.
+    Operand m_const;
+    std::string m_string;
+    /// Sensor read by OP_PUSH_SENSOR.
+    SCA_ISensor *m_sensor;
+    /// Property read by OP_PUSH_PROPERTY.
+    EXP_PropertyHandle m_property;
+  };
+
   std::string m_exprText;
   EXP_Expression *m_exprCache;
 
+  /** Flat postfix form of m_exprCache evaluated without allocating values,
+   * empty when the expression uses constructs not supported by the fast path.
+   */
+  std::vector<Instruction> m_program;
+  /// Evaluation stack of m_program, sized at compilation.
+  std::vector<Operand> m_stack;
+  /// True when m_program was built from the current m_exprCache and linked sensors.
+  bool m_programCompiled;
+
+  /// Compile m_exprCache into m_program, return false if the tree can't be flattened.
+  bool CompileProgram();
+  bool CompileExpression(EXP_Expression *expr, unsigned int depth, unsigned int &maxDepth);
+  /** Evaluate m_program, return false if an operand has a type not handled by the
+   * fast path, the caller must then fall back to m_exprCache.
+   */
+  bool RunProgram(bool &result);
+
  public:
   SCA_ExpressionController(SCA_IObject *gameobj, const std::string &exprtext);
 
   virtual ~SCA_ExpressionController();
   virtual EXP_Value *GetReplica();
+  /// Evaluate the expression, with the compiled program when it handles it.
+  bool Evaluate();
   virtual void Trigger(SCA_LogicManager *logicmgr);
   virtual EXP_Value *FindIdentifier(const std::string &identifiername);
+
+  /// The program references the linked sensors, it is compiled again when they change.
+  virtual void LinkToSensor(SCA_ISensor *sensor);
+  virtual void UnlinkAllSensors();
+  virtual void UnlinkSensor(SCA_ISensor *sensor);
+  virtual void Relink(std::map<SCA_IObject *, SCA_IObject *> &obj_map);
+
   /**
    *  used to release the expression cache
    *  so that self references are removed before the controller itself is released
@@ -54,14 +54,14 @@ class SCA_IController : public SCA_ILogicBrick {
 
   virtual void Trigger(SCA_LogicManager *logicmgr) = 0;
 
-  void LinkToSensor(SCA_ISensor *sensor);
+  virtual void LinkToSensor(SCA_ISensor *sensor);
   void LinkToActuator(SCA_IActuator *);
   std::vector<SCA_ISensor *> &GetLinkedSensors();
   std::vector<SCA_IActuator *> &GetLinkedActuators();
-  void UnlinkAllSensors();
+  virtual void UnlinkAllSensors();
   void UnlinkAllActuators();
   void UnlinkActuator(SCA_IActuator *actua);
-  void UnlinkSensor(SCA_ISensor *sensor);
+  virtual void UnlinkSensor(SCA_ISensor *sensor);
   void SetState(unsigned int state);
   void ApplyState(unsigned int state);
   void Deactivate();
@@ -36,6 +36,8 @@
 #include "SCA_InputEvent.h"
 
 class SCA_IInputDevice {
+  friend class SCA_InputRecord;
+
  public:
   SCA_IInputDevice();
   virtual ~SCA_IInputDevice();
@@ -159,6 +159,19 @@ bool SCA_IObject::UnlinkObject(SCA_IObject *clientobj)
   return false;
 }
 
+void SCA_IObject::UnlinkClients()
+{
+  for (SCA_IActuator *actuator : m_registeredActuators) {
+    actuator->UnlinkObject(this);
+  }
+  for (SCA_IObject *object : m_registeredObjects) {
+    object->UnlinkObject(this);
+  }
+
+  m_registeredActuators.clear();
+  m_registeredObjects.clear();
+}
+
 void SCA_IObject::ReParentLogic()
 {
   SCA_ActuatorList &oldactuators = GetActuators();
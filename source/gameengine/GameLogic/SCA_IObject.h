@@ -126,6 +126,8 @@ class SCA_IObject : public KX_PythonProxy {
    * returns true if there was indeed a reference.
    */
   virtual bool UnlinkObject(SCA_IObject *clientobj);
+  /// Inform all the actuators and objects holding a reference to this object that it is removed.
+  void UnlinkClients();
 
   SCA_ISensor *FindSensor(const std::string &sensorname);
   SCA_IActuator *FindActuator(const std::string &actuatorname);
@@ -59,4 +59,7 @@ class SCA_IScene {
   void AddDebugProperty(SCA_IObject *gameobj, const std::string &name);
   void RemoveDebugProperty(SCA_IObject *gameobj, const std::string &name);
   void RemoveObjectDebugProperties(SCA_IObject *gameobj);
+
+  /// Notify that a change not tracked by the scene graph needs the scene to be rendered again.
+  virtual void RequestRender() = 0;
 };
@@ -170,6 +170,11 @@ bool SCA_ISensor::IsNoLink() const
   return !m_links;
 }
 
+bool SCA_ISensor::IsEvaluated() const
+{
+  return (m_links && !m_suspended);
+}
+
 void SCA_ISensor::Init()
 {
   CM_LogicBrickError(
@@ -254,7 +259,7 @@ void SCA_ISensor::Activate(class SCA_LogicManager *logicmgr)
   /* Calculate if a __triggering__ is wanted
    * don't evaluate a sensor that is not connected to any controller
    */
-  if (m_links && !m_suspended) {
+  if (IsEvaluated()) {
     bool result = this->Evaluate();
     // store the state for the rest of the logic system
     m_prev_state = m_state;
@@ -166,6 +166,10 @@ class SCA_ISensor : public SCA_ILogicBrick {
   void IncLink();
   void DecLink();
   bool IsNoLink() const;
+  /** Return true if the sensor is evaluated by the next Activate() call, the sensors are
+   * evaluated every frame, the pulse frequency only delays the triggering of the controllers.
+   */
+  bool IsEvaluated() const;
 
 #ifdef WITH_PYTHON
   EXP_PYMETHOD_DOC_NOARGS(SCA_ISensor, reset);
@@ -0,0 +1,243 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/GameLogic/SCA_InputRecord.cpp
+ *  \ingroup gamelogic
+ */
+
+/* Record file layout, in native byte order:
+ *   header: "BGEI", uint32 version
+ *   frame: double clock time, uint16 number of inputs, uint16 text length,
+ *     per input: uint16 input, uint16 status, queue and values count, uint32 unicode,
+ *       uint8 status[], uint8 queue[], int32 values[]
+ *     uint32 text[]
+ */
+
+#include "SCA_InputRecord.h"
+
+#include <cstring>
+
+#include "BLI_fileops.h"
+
+#include "CM_Message.h"
+#include "SCA_IInputDevice.h"
+
+static const char recordMagic[4] = {'B', 'G', 'E', 'I'};
+static const unsigned int recordVersion = 1;
+
+template <class Type> static void write_value(std::vector<unsigned char> &buffer, Type value)
+{
+  const unsigned char *data = (const unsigned char *)&value;
+  buffer.insert(buffer.end(), data, data + sizeof(Type));
+}
+
+template <class Type> static bool read_value(FILE *file, Type &value)
+{
+  return (fread(&value, sizeof(Type), 1, file) == 1);
+}
+
+SCA_InputRecord::SCA_InputRecord() : m_file(nullptr), m_mode(RECORD_NONE), m_numFrames(0)
+{
+}
+
+SCA_InputRecord::~SCA_InputRecord()
+{
+  Close();
+}
+
+bool SCA_InputRecord::Open(const std::string &path, Mode mode)
+{
+  Close();
+
+  m_file = BLI_fopen(path.c_str(), (mode == RECORD_WRITE) ? "wb" : "rb");
+  if (!m_file) {
+    CM_Error("unable to open the input record: " << path);
+    return false;
+  }
+
+  if (mode == RECORD_WRITE) {
+    fwrite(recordMagic, 1, sizeof(recordMagic), m_file);
+    fwrite(&recordVersion, sizeof(recordVersion), 1, m_file);
+  }
+  else {
+    char magic[4];
+    unsigned int version;
+    if (fread(magic, 1, sizeof(magic), m_file) != sizeof(magic) ||
+        memcmp(magic, recordMagic, sizeof(magic)) != 0 || !read_value(m_file, version) ||
+        version != recordVersion)
+    {
+      CM_Error("invalid input record: " << path);
+      fclose(m_file);
+      m_file = nullptr;
+      return false;
+    }
+  }
+
+  m_mode = mode;
+  m_numFrames = 0;
+
+  return true;
+}
+
+void SCA_InputRecord::Close()
+{
+  if (m_file) {
+    fclose(m_file);
+    m_file = nullptr;
+  }
+  m_mode = RECORD_NONE;
+}
+
+SCA_InputRecord::Mode SCA_InputRecord::GetMode() const
+{
+  return m_mode;
+}
+
+unsigned int SCA_InputRecord::GetNumFrames() const
+{
+  return m_numFrames;
+}
+
+void SCA_InputRecord::WriteFrame(const SCA_IInputDevice *device, double clockTime)
+{
+  m_buffer.clear();
+  write_value(m_buffer, clockTime);
+  // Number of inputs, written once known.
+  write_value(m_buffer, (unsigned short)0);
+
+  const std::wstring &text = device->m_text;
+  write_value(m_buffer, (unsigned short)text.size());
+
+  unsigned short numInputs = 0;
+  for (unsigned short i = 0; i < SCA_IInputDevice::MAX_KEYS; ++i) {
+    const SCA_InputEvent &event = device->m_inputsTable[i];
+    // Skip the inputs without events since the last clear.
+    if (event.m_status.size() == 1 && event.m_queue.empty() && event.m_values.size() == 1) {
+      continue;
+    }
+
+    write_value(m_buffer, i);
+    write_value(m_buffer, (unsigned short)event.m_status.size());
+    write_value(m_buffer, (unsigned short)event.m_queue.size());
+    write_value(m_buffer, (unsigned short)event.m_values.size());
+    write_value(m_buffer, event.m_unicode);
+    for (SCA_InputEvent::SCA_EnumInputs status : event.m_status) {
+      write_value(m_buffer, (unsigned char)status);
+    }
+    for (SCA_InputEvent::SCA_EnumInputs status : event.m_queue) {
+      write_value(m_buffer, (unsigned char)status);
+    }
+    for (int value : event.m_values) {
+      write_value(m_buffer, value);
+    }
+    ++numInputs;
+  }
+
+  for (wchar_t c : text) {
+    write_value(m_buffer, (unsigned int)c);
+  }
+
+  memcpy(&m_buffer[sizeof(double)], &numInputs, sizeof(numInputs));
+
+  if (fwrite(m_buffer.data(), 1, m_buffer.size(), m_file) != m_buffer.size()) {
+    CM_Error("failed to write the input record, recording stopped");
+    Close();
+    return;
+  }
+
+  ++m_numFrames;
+}
+
+bool SCA_InputRecord::ReadFrame(SCA_IInputDevice *device, double &clockTime)
+{
+  unsigned short numInputs;
+  unsigned short textLength;
+  if (!read_value(m_file, clockTime) || !read_value(m_file, numInputs) ||
+      !read_value(m_file, textLength))
+  {
+    return false;
+  }
+
+  /* Discard the live events received since the last clear, only the first status and value
+   * are left by SCA_InputEvent::Clear. */
+  for (unsigned short i = 0; i < SCA_IInputDevice::MAX_KEYS; ++i) {
+    SCA_InputEvent &event = device->m_inputsTable[i];
+    event.m_status.resize(1);
+    event.m_queue.clear();
+    event.m_values.resize(1);
+  }
+
+  for (unsigned short i = 0; i < numInputs; ++i) {
+    unsigned short input;
+    unsigned short numStatus;
+    unsigned short numQueue;
+    unsigned short numValues;
+    unsigned int unicode;
+    if (!read_value(m_file, input) || !read_value(m_file, numStatus) ||
+        !read_value(m_file, numQueue) || !read_value(m_file, numValues) ||
+        !read_value(m_file, unicode) || input >= SCA_IInputDevice::MAX_KEYS || numStatus == 0 ||
+        numValues == 0)
+    {
+      return false;
+    }
+
+    SCA_InputEvent &event = device->m_inputsTable[input];
+    event.m_unicode = unicode;
+
+    event.m_status.resize(numStatus);
+    event.m_queue.resize(numQueue);
+    event.m_values.resize(numValues);
+    for (SCA_InputEvent::SCA_EnumInputs &status : event.m_status) {
+      unsigned char value;
+      if (!read_value(m_file, value)) {
+        return false;
+      }
+      status = (SCA_InputEvent::SCA_EnumInputs)value;
+    }
+    for (SCA_InputEvent::SCA_EnumInputs &status : event.m_queue) {
+      unsigned char value;
+      if (!read_value(m_file, value)) {
+        return false;
+      }
+      status = (SCA_InputEvent::SCA_EnumInputs)value;
+    }
+    for (int &value : event.m_values) {
+      if (!read_value(m_file, value)) {
+        return false;
+      }
+    }
+  }
+
+  std::wstring &text = device->m_text;
+  text.resize(textLength);
+  for (wchar_t &c : text) {
+    unsigned int value;
+    if (!read_value(m_file, value)) {
+      return false;
+    }
+    c = (wchar_t)value;
+  }
+
+  ++m_numFrames;
+
+  return true;
+}
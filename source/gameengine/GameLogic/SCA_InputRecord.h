@@ -0,0 +1,70 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file SCA_InputRecord.h
+ *  \ingroup gamelogic
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+class SCA_IInputDevice;
+
+/** A recording of the inputs of a device and of the engine clock for each proceeded frame,
+ * stored in a compact binary file. Replaying a record restores the inputs and the clock time
+ * of each frame in place of the live events to run a game session deterministically.
+ */
+class SCA_InputRecord {
+ public:
+  enum Mode { RECORD_NONE = 0, RECORD_WRITE, RECORD_READ };
+
+  SCA_InputRecord();
+  ~SCA_InputRecord();
+
+  /** Open a record file to write or to read.
+   * \return False when the file can't be opened or is not a valid record.
+   */
+  bool Open(const std::string &path, Mode mode);
+  /// Close the record file, the record is finished.
+  void Close();
+
+  Mode GetMode() const;
+  /// Return the number of frames written or read.
+  unsigned int GetNumFrames() const;
+
+  /// Write the clock time and the inputs changed during the frame.
+  void WriteFrame(const SCA_IInputDevice *device, double clockTime);
+  /** Replace the inputs of the frame by the recorded ones and return the recorded clock time.
+   * \return False at the end of the record.
+   */
+  bool ReadFrame(SCA_IInputDevice *device, double &clockTime);
+
+ private:
+  FILE *m_file;
+  Mode m_mode;
+  unsigned int m_numFrames;
+  /// Frame data serialized before being written at once.
+  std::vector<unsigned char> m_buffer;
+};
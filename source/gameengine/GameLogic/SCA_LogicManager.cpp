@@ -32,6 +32,7 @@
 
 #include "SCA_LogicManager.h"
 
+#include "CM_Trace.h"
 #include "SCA_ISensor.h"
 #include "SCA_PythonController.h"
 
@@ -144,6 +145,7 @@ void SCA_LogicManager::BeginFrame(double curtime, double fixedtime)
        obj = (SG_QList *)m_triggeredControllerSet.Remove()) {
     for (SCA_IController *contr = (SCA_IController *)obj->QRemove(); contr != nullptr;
          contr = (SCA_IController *)obj->QRemove()) {
+      CM_TRACE_SCOPE("controller", contr->GetName());
       contr->Trigger(this);
       contr->ClrJustActivated();
     }
@@ -34,6 +34,8 @@
 
 #include "SCA_NearSensor.h"
 
+#include <algorithm>
+
 #include "KX_CollisionEventManager.h"
 #include "PHY_IMotionState.h"
 #include "PHY_IPhysicsController.h"
@@ -51,7 +53,8 @@ SCA_NearSensor::SCA_NearSensor(SCA_EventManager *eventmgr,
 
 {
 
-  gameobj->getClientInfo()->m_sensors.remove(this);
+  std::vector<SCA_ISensor *> &sensors = gameobj->getClientInfo()->m_sensors;
+  sensors.erase(std::remove(sensors.begin(), sensors.end(), this), sensors.end());
   m_client_info = new KX_ClientObjectInfo(gameobj, KX_ClientObjectInfo::SENSOR);
   m_client_info->m_sensors.push_back(this);
 
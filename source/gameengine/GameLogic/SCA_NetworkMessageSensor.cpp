@@ -96,11 +96,10 @@ bool SCA_NetworkMessageSensor::Evaluate()
     m_SubjectList = nullptr;
   }
 
-  std::string toname = GetParent()->GetName();
-  std::string &subject = this->m_subject;
+  const std::string toname = GetParent()->GetName();
 
-  const std::vector<KX_NetworkMessageManager::Message> messages = m_NetworkScene->FindMessages(
-      toname, subject);
+  const KX_NetworkMessageManager::MessageView messages = m_NetworkScene->FindMessages(toname,
+                                                                                      m_subject);
 
   m_frame_message_count = messages.size();
 
@@ -113,20 +112,20 @@ bool SCA_NetworkMessageSensor::Evaluate()
     m_SubjectList = new EXP_ListValue<EXP_StringValue>();
   }
 
-  std::vector<KX_NetworkMessageManager::Message>::const_iterator mesit;
-  for (mesit = messages.begin(); mesit != messages.end(); mesit++) {
-    // save the body
-    const std::string &body = (*mesit).body;
-    // save the subject
-    const std::string &messub = (*mesit).subject;
+  const KX_NetworkMessageManager::MessageSpan spans[] = {messages.broadcast, messages.receiver};
+  for (const KX_NetworkMessageManager::MessageSpan &span : spans) {
+    for (const KX_NetworkMessageManager::Message &message : span) {
+      // save the body
+      const std::string body(message.body);
+      // save the subject
+      const std::string &messub = m_NetworkScene->GetSubject(message);
 #ifdef NAN_NET_DEBUG
-    if (body) {
-      cout << "body [" << body << "]\n";
-    }
+      std::cout << "body [" << body << "]\n";
 #endif
-    m_BodyList->Add(new EXP_StringValue(body, "body"));
-    // Store Subject
-    m_SubjectList->Add(new EXP_StringValue(messub, "subject"));
+      m_BodyList->Add(new EXP_StringValue(body, "body"));
+      // Store Subject
+      m_SubjectList->Add(new EXP_StringValue(messub, "subject"));
+    }
   }
 
   result = (WasUp != m_IsUp);
@@ -48,6 +48,8 @@ class SCA_PropertyActuator : public SCA_IActuator {
 
   int m_type;
   std::string m_propname;
+  /// Pre-resolved m_propname.
+  EXP_PropertyHandle m_prophandle;
   std::string m_exprtxt;
   SCA_IObject *m_sourceObj;  // for copy property actuator
 
@@ -71,4 +73,9 @@ class SCA_PropertyActuator : public SCA_IActuator {
   /* --------------------------------------------------------------------- */
   /* Python interface ---------------------------------------------------- */
   /* --------------------------------------------------------------------- */
+
+#ifdef WITH_PYTHON
+  /// Check the property name and update the property handle.
+  static int CheckPropertyName(EXP_PyObjectPlus *self, const PyAttributeDef *attrdef);
+#endif
 };
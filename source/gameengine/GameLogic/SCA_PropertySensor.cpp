@@ -57,11 +57,13 @@ SCA_PropertySensor::SCA_PropertySensor(SCA_EventManager *eventmgr,
   // pars.SetContext(this->AddRef());
   // EXP_Value* resultval = m_rightexpr->Calculate();
 
-  EXP_Value *orgprop = GetParent()->FindIdentifier(m_checkpropname);
-  if (!orgprop->IsError()) {
+  UpdatePropertyHandle();
+
+  EXP_Value *orgprop = FindCheckProperty();
+  if (orgprop) {
     m_previoustext = orgprop->GetText();
+    orgprop->Release();
   }
-  orgprop->Release();
 
   Init();
 }
@@ -119,8 +121,8 @@ bool SCA_PropertySensor::CheckPropertyCondition()
       reverse = true;
       ATTR_FALLTHROUGH;
     case KX_PROPSENSOR_EQUAL: {
-      EXP_Value *orgprop = GetParent()->FindIdentifier(m_checkpropname);
-      if (!orgprop->IsError()) {
+      EXP_Value *orgprop = FindCheckProperty();
+      if (orgprop) {
         const std::string &testprop = orgprop->GetText();
         // Force strings to upper case, to avoid confusion in
         // bool tests. It's stupid the prop's identity is lost
@@ -142,8 +144,8 @@ bool SCA_PropertySensor::CheckPropertyCondition()
           }
         }
         /* end patch */
+        orgprop->Release();
       }
-      orgprop->Release();
 
       if (reverse)
         result = !result;
@@ -154,8 +156,8 @@ bool SCA_PropertySensor::CheckPropertyCondition()
       break;
     }
     case KX_PROPSENSOR_INTERVAL: {
-      EXP_Value *orgprop = GetParent()->FindIdentifier(m_checkpropname);
-      if (!orgprop->IsError()) {
+      EXP_Value *orgprop = FindCheckProperty();
+      if (orgprop) {
         float min;
         float max;
         float val;
@@ -170,21 +172,21 @@ bool SCA_PropertySensor::CheckPropertyCondition()
         }
 
         result = (min <= val) && (val <= max);
+        orgprop->Release();
       }
-      orgprop->Release();
 
       break;
     }
     case KX_PROPSENSOR_CHANGED: {
-      EXP_Value *orgprop = GetParent()->FindIdentifier(m_checkpropname);
+      EXP_Value *orgprop = FindCheckProperty();
 
-      if (!orgprop->IsError()) {
+      if (orgprop) {
         if (m_previoustext != orgprop->GetText()) {
           m_previoustext = orgprop->GetText();
           result = true;
         }
+        orgprop->Release();
       }
-      orgprop->Release();
 
       break;
     }
@@ -192,8 +194,8 @@ bool SCA_PropertySensor::CheckPropertyCondition()
       reverse = true;
       ATTR_FALLTHROUGH;
     case KX_PROPSENSOR_GREATERTHAN: {
-      EXP_Value *orgprop = GetParent()->FindIdentifier(m_checkpropname);
-      if (!orgprop->IsError()) {
+      EXP_Value *orgprop = FindCheckProperty();
+      if (orgprop) {
         float ref;
         CM_StringTo(m_checkpropval, ref);
         float val;
@@ -211,8 +213,8 @@ bool SCA_PropertySensor::CheckPropertyCondition()
         else {
           result = val > ref;
         }
+        orgprop->Release();
       }
-      orgprop->Release();
 
       break;
     }
@@ -231,6 +233,32 @@ EXP_Value *SCA_PropertySensor::FindIdentifier(const std::string &identifiername)
   return GetParent()->FindIdentifier(identifiername);
 }
 
+void SCA_PropertySensor::UpdatePropertyHandle()
+{
+  // Sub-context names are resolved through FindIdentifier.
+  if (m_checkpropname.find('.') == std::string::npos) {
+    m_checkprophandle = EXP_PropertyHandle(m_checkpropname);
+  }
+  else {
+    m_checkprophandle = EXP_PropertyHandle();
+  }
+}
+
+EXP_Value *SCA_PropertySensor::FindCheckProperty()
+{
+  if (m_checkprophandle.IsValid()) {
+    EXP_Value *prop = GetParent()->GetProperty(m_checkprophandle);
+    return (prop) ? prop->AddRef() : nullptr;
+  }
+
+  EXP_Value *prop = GetParent()->FindIdentifier(m_checkpropname);
+  if (prop->IsError()) {
+    prop->Release();
+    return nullptr;
+  }
+  return prop;
+}
+
 #ifdef WITH_PYTHON
 
 /* ------------------------------------------------------------------------- */
@@ -247,6 +275,16 @@ int SCA_PropertySensor::validValueForProperty(EXP_PyObjectPlus *self, const PyAt
   return 0;
 }
 
+int SCA_PropertySensor::CheckPropertyName(EXP_PyObjectPlus *self, const PyAttributeDef *attrdef)
+{
+  if (CheckProperty(self, attrdef) != 0) {
+    return 1;
+  }
+
+  static_cast<SCA_PropertySensor *>(self)->UpdatePropertyHandle();
+  return 0;
+}
+
 /* Integration hooks ------------------------------------------------------- */
 PyTypeObject SCA_PropertySensor::Type = {PyVarObject_HEAD_INIT(nullptr, 0) "SCA_PropertySensor",
                                          sizeof(EXP_PyObjectPlus_Proxy),
@@ -297,8 +335,13 @@ PyAttributeDef SCA_PropertySensor::Attributes[] = {
                            false,
                            SCA_PropertySensor,
                            m_checktype),
-    EXP_PYATTRIBUTE_STRING_RW_CHECK(
-        "propName", 0, MAX_PROP_NAME, false, SCA_PropertySensor, m_checkpropname, CheckProperty),
+    EXP_PYATTRIBUTE_STRING_RW_CHECK("propName",
+                                    0,
+                                    MAX_PROP_NAME,
+                                    false,
+                                    SCA_PropertySensor,
+                                    m_checkpropname,
+                                    CheckPropertyName),
     EXP_PYATTRIBUTE_STRING_RW_CHECK(
         "value", 0, 100, false, SCA_PropertySensor, m_checkpropval, validValueForProperty),
     EXP_PYATTRIBUTE_STRING_RW_CHECK(
@@ -41,6 +41,8 @@ class SCA_PropertySensor : public SCA_ISensor {
   std::string m_checkpropval;
   std::string m_checkpropmaxval;
   std::string m_checkpropname;
+  /// Pre-resolved m_checkpropname, invalid for sub-context names.
+  EXP_PropertyHandle m_checkprophandle;
   std::string m_previoustext;
   bool m_lastresult;
   bool m_recentresult;
@@ -77,6 +79,11 @@ class SCA_PropertySensor : public SCA_ISensor {
   virtual bool IsPositiveTrigger();
   virtual EXP_Value *FindIdentifier(const std::string &identifiername);
 
+  /// Resolve m_checkprophandle from m_checkpropname.
+  void UpdatePropertyHandle();
+  /// Return a new reference to the checked property or nullptr if it doesn't exist.
+  EXP_Value *FindCheckProperty();
+
 #ifdef WITH_PYTHON
 
   /* --------------------------------------------------------------------- */
@@ -87,6 +94,8 @@ class SCA_PropertySensor : public SCA_ISensor {
    * Test whether this is a sensible value (type check)
    */
   static int validValueForProperty(EXP_PyObjectPlus *self, const PyAttributeDef *);
+  /// Check the property name and update the property handle.
+  static int CheckPropertyName(EXP_PyObjectPlus *self, const PyAttributeDef *attrdef);
 
 #endif
 };
@@ -70,6 +70,7 @@ void SCA_RaySensor::Init()
   m_rayHit = false;
   m_hitObject = nullptr;
   m_reset = true;
+  m_rayBatched = false;
 }
 
 SCA_RaySensor::~SCA_RaySensor()
@@ -182,10 +183,8 @@ bool SCA_RaySensor::NeedRayCast(KX_ClientObjectInfo *client, void */*data*/)
   return true;
 }
 
-bool SCA_RaySensor::Evaluate()
+PHY_IPhysicsController *SCA_RaySensor::ComputeRay(MT_Vector3 &frompoint, MT_Vector3 &topoint)
 {
-  bool result = false;
-  bool reset = m_reset && m_level;
   m_rayHit = false;
   m_hitObject = nullptr;
   m_hitPosition[0] = 0;
@@ -197,12 +196,11 @@ bool SCA_RaySensor::Evaluate()
   m_hitNormal[2] = 0;
 
   KX_GameObject *obj = (KX_GameObject *)GetParent();
-  MT_Vector3 frompoint = obj->NodeGetWorldPosition();
+  frompoint = obj->NodeGetWorldPosition();
   MT_Matrix3x3 matje = obj->NodeGetWorldOrientation();
   MT_Matrix3x3 invmat = matje.inverse();
 
   MT_Vector3 todir;
-  m_reset = false;
   switch (m_axis) {
     case SENS_RAY_X_AXIS:  // X
     {
@@ -252,23 +250,45 @@ bool SCA_RaySensor::Evaluate()
   m_rayDirection[1] = todir[1];
   m_rayDirection[2] = todir[2];
 
-  MT_Vector3 topoint = frompoint + (m_distance)*todir;
-  PHY_IPhysicsEnvironment *pe = m_scene->GetPhysicsEnvironment();
-
-  if (!pe) {
-    CM_LogicBrickWarning(this, "there is no physics environment! Check universe for malfunction.");
-    return false;
-  }
+  topoint = frompoint + (m_distance)*todir;
 
   PHY_IPhysicsController *spc = obj->GetPhysicsController();
   KX_GameObject *parent = obj->GetParent();
   if (!spc && parent)
     spc = parent->GetPhysicsController();
 
-  PHY_IPhysicsEnvironment *physics_environment = this->m_scene->GetPhysicsEnvironment();
+  return spc;
+}
+
+void SCA_RaySensor::SetRayBatched()
+{
+  m_rayBatched = true;
+}
+
+bool SCA_RaySensor::Evaluate()
+{
+  bool result = false;
+  bool reset = m_reset && m_level;
+  m_reset = false;
 
-  KX_RayCast::Callback<SCA_RaySensor, void> callback(this, spc);
-  KX_RayCast::RayTest(physics_environment, frompoint, topoint, callback);
+  // The ray was cast with the rays of the other sensors of the scene.
+  if (m_rayBatched) {
+    m_rayBatched = false;
+  }
+  else {
+    MT_Vector3 frompoint, topoint;
+    PHY_IPhysicsController *spc = ComputeRay(frompoint, topoint);
+    PHY_IPhysicsEnvironment *physics_environment = m_scene->GetPhysicsEnvironment();
+
+    if (!physics_environment) {
+      CM_LogicBrickWarning(this,
+                           "there is no physics environment! Check universe for malfunction.");
+      return false;
+    }
+
+    KX_RayCast::Callback<SCA_RaySensor, void> callback(this, spc);
+    KX_RayCast::RayTest(physics_environment, frompoint, topoint, callback);
+  }
 
   /* now pass this result to some controller */
 
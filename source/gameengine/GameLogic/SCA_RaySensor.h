@@ -41,6 +41,7 @@
 
 struct KX_ClientObjectInfo;
 class KX_RayCast;
+class PHY_IPhysicsController;
 
 class SCA_RaySensor : public SCA_ISensor {
   Py_Header std::string m_propertyname;
@@ -57,6 +58,8 @@ class SCA_RaySensor : public SCA_ISensor {
   float m_hitNormal[3];
   float m_rayDirection[3];
   std::string m_hitMaterial;
+  /// The ray of the next evaluation was already cast by the ray event manager.
+  bool m_rayBatched;
 
  public:
   SCA_RaySensor(class SCA_EventManager *eventmgr,
@@ -75,6 +78,13 @@ class SCA_RaySensor : public SCA_ISensor {
   virtual bool IsPositiveTrigger();
   virtual void Init();
 
+  /** Reset the hit state and compute the ray of the current frame.
+   * \return The physics controller ignored by the ray.
+   */
+  PHY_IPhysicsController *ComputeRay(MT_Vector3 &frompoint, MT_Vector3 &topoint);
+  /// Use the hit state set by a batch of rays in the next evaluation instead of casting the ray.
+  void SetRayBatched();
+
   /// \see KX_RayCast
   bool RayHit(KX_ClientObjectInfo *client, KX_RayCast *result, void */*data*/);
   /// \see KX_RayCast
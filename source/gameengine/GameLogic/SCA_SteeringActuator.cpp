@@ -133,6 +133,7 @@ bool SCA_SteeringActuator::UnlinkObject(SCA_IObject *clientobj)
   }
   else if (clientobj == m_navmesh) {
     m_navmesh = nullptr;
+    m_pathCorridor.Reset();
     return true;
   }
   return false;
@@ -154,6 +155,7 @@ void SCA_SteeringActuator::Relink(std::map<SCA_IObject *, SCA_IObject *> &obj_ma
       m_navmesh->UnregisterActuator(this);
     m_navmesh = navobj;
     m_navmesh->RegisterActuator(this);
+    m_pathCorridor.Reset();
   }
 }
 
@@ -165,6 +167,7 @@ bool SCA_SteeringActuator::Update(double curtime)
   if (m_posevent && !m_isActive) {
     delta = 0.0;
     m_pathUpdateTime = -1.0;
+    m_pathCorridor.Reset();
     m_updateTime = curtime;
     m_isActive = true;
   }
@@ -217,7 +220,8 @@ bool SCA_SteeringActuator::Update(double curtime)
             (m_pathUpdatePeriod >= 0 &&
              curtime - m_pathUpdateTime > ((double)m_pathUpdatePeriod / 1000.0))) {
           m_pathUpdateTime = curtime;
-          m_pathLen = m_navmesh->FindPath(mypos, targpos, m_path, MAX_PATH_LENGTH);
+          m_pathLen = m_navmesh->FindPath(
+              mypos, targpos, m_path, MAX_PATH_LENGTH, m_pathCorridor);
           m_wayPointIdx = m_pathLen > 1 ? 1 : -1;
         }
 
@@ -340,6 +344,17 @@ inline void flipAxes(float *vec)
   std::swap(vec[1], vec[2]);
 }
 
+static void getTriNormal(const float *v[3], MT_Vector3 &normal)
+{
+  MT_Vector3 tri[3];
+  for (size_t j = 0; j < 3; j++)
+    tri[j].setValue(v[j][0], v[j][2], v[j][1]);
+  MT_Vector3 a, b;
+  a = tri[1] - tri[0];
+  b = tri[2] - tri[0];
+  normal = b.cross(a).safe_normalized();
+}
+
 static bool getNavmeshNormal(dtStatNavMesh *navmesh, const MT_Vector3 &pos, MT_Vector3 &normal)
 {
   static const float polyPickExt[3] = {2, 4, 2};
@@ -379,13 +394,50 @@ static bool getNavmeshNormal(dtStatNavMesh *navmesh, const MT_Vector3 &pos, MT_V
       else
         v[j] = navmesh->getDetailVertex(pd->vbase + (t[j] - p->nv));
     }
-    MT_Vector3 tri[3];
-    for (size_t j = 0; j < 3; j++)
-      tri[j].setValue(v[j][0], v[j][2], v[j][1]);
-    MT_Vector3 a, b;
-    a = tri[1] - tri[0];
-    b = tri[2] - tri[0];
-    normal = b.cross(a).safe_normalized();
+    getTriNormal(v, normal);
+    return true;
+  }
+
+  return false;
+}
+
+static bool getTiledNavmeshNormal(dtTiledNavMesh *navmesh,
+                                  const MT_Vector3 &pos,
+                                  MT_Vector3 &normal)
+{
+  static const float polyPickExt[3] = {2, 4, 2};
+  float spos[3];
+  pos.getValue(spos);
+  flipAxes(spos);
+  dtTilePolyRef sPolyRef = navmesh->findNearestPoly(spos, polyPickExt);
+  if (sPolyRef == 0)
+    return false;
+  unsigned int salt, it, ip;
+  dtDecodeTileId(sPolyRef, salt, it, ip);
+  const dtTileHeader *header = navmesh->getTile(it)->header;
+  const dtTilePoly *p = &header->polys[ip];
+  const dtTilePolyDetail *pd = &header->dmeshes[ip];
+
+  float distMin = FLT_MAX;
+  const float *vMin[3] = {nullptr, nullptr, nullptr};
+  for (int i = 0; i < pd->ntris; ++i) {
+    const unsigned char *t = &header->dtris[(pd->tbase + i) * 4];
+    const float *v[3];
+    for (int j = 0; j < 3; ++j) {
+      if (t[j] < p->nv)
+        v[j] = &header->verts[p->v[t[j]] * 3];
+      else
+        v[j] = &header->dverts[(pd->vbase + (t[j] - p->nv)) * 3];
+    }
+    float dist = barDistSqPointToTri(spos, v[0], v[1], v[2]);
+    if (dist < distMin) {
+      distMin = dist;
+      std::copy(v, v + 3, vMin);
+    }
+  }
+
+  if (vMin[0]) {
+    getTriNormal(vMin, normal);
     return true;
   }
 
@@ -407,9 +459,12 @@ void SCA_SteeringActuator::HandleActorFace(MT_Vector3 &velocity)
 
   if (m_navmesh && m_normalUp) {
     dtStatNavMesh *navmesh = m_navmesh->GetNavMesh();
+    dtTiledNavMesh *tiledNavmesh = m_navmesh->GetTiledNavMesh();
     MT_Vector3 normal;
     MT_Vector3 trpos = m_navmesh->TransformToLocalCoords(curobj->NodeGetWorldPosition());
-    if (getNavmeshNormal(navmesh, trpos, normal)) {
+    if ((navmesh && getNavmeshNormal(navmesh, trpos, normal)) ||
+        (tiledNavmesh && getTiledNavmeshNormal(tiledNavmesh, trpos, normal)))
+    {
 
       left = (dir.cross(up)).safe_normalized();
       dir = (-left.cross(normal)).safe_normalized();
@@ -623,6 +678,7 @@ int SCA_SteeringActuator::pyattr_set_navmesh(EXP_PyObjectPlus *self,
     actuator->m_navmesh->UnregisterActuator(actuator);
 
   actuator->m_navmesh = static_cast<KX_NavMeshObject *>(gameobj);
+  actuator->m_pathCorridor.Reset();
 
   if (actuator->m_navmesh)
     actuator->m_navmesh->RegisterActuator(actuator);
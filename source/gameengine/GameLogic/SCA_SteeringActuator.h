@@ -26,12 +26,12 @@
 
 #pragma once
 
+#include "KX_NavMeshObject.h"
 #include "MT_Matrix3x3.h"
 #include "SCA_IActuator.h"
 #include "SCA_LogicManager.h"
 
 class KX_GameObject;
-class KX_NavMeshObject;
 struct KX_Obstacle;
 class KX_ObstacleSimulation;
 const int MAX_PATH_LENGTH = 128;
@@ -58,6 +58,8 @@ class SCA_SteeringActuator : public SCA_IActuator {
   bool m_normalUp;
   float m_path[MAX_PATH_LENGTH * 3];
   int m_pathLen;
+  /// Polygon corridor of m_path, repaired on each path update.
+  KX_NavMeshCorridor m_pathCorridor;
   int m_pathUpdatePeriod;
   double m_pathUpdateTime;
   bool m_lockzvel;
@@ -0,0 +1,126 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file SCA_ExpressionController_performance_test.cc
+ *  \ingroup gamelogic
+ */
+
+/* Compare the compiled program of SCA_ExpressionController with the evaluation of the
+ * expression tree it replaces: both must give the same result, the program is timed against
+ * EXP_Expression::Calculate(). */
+
+#include "testing/testing.h"
+
+#include "BLI_utildefines.h"
+
+#include "EXP_BoolValue.h"
+#include "EXP_FloatValue.h"
+#include "EXP_InputParser.h"
+#include "EXP_IntValue.h"
+#include "EXP_StringValue.h"
+#include "MT_Scalar.h"
+#include "PIL_time_utildefines.h"
+#include "SCA_ExpressionController.h"
+#include "SCA_IObject.h"
+
+#define NUM_CHECKS 1000
+#define NUM_EVALUATIONS 1000000
+
+static const char *expressions[] = {
+    "health > 10 and ammo <= 3",
+    "speed * 2.0 - 1.5 >= limit or not alive",
+    "team == \"red\" and health + ammo != 0",
+    "(health - ammo) / 2 < speed and (team != \"blue\" or alive)",
+};
+
+class TestObject : public SCA_IObject {
+ public:
+  virtual KX_PythonProxy *NewInstance()
+  {
+    return new TestObject();
+  }
+};
+
+static void set_properties(SCA_IObject *obj, int i)
+{
+  const char *teams[] = {"red", "blue", "green"};
+  EXP_Value *props[] = {new EXP_IntValue(i % 20),
+                        new EXP_IntValue(i % 7),
+                        new EXP_FloatValue((i % 13) * 0.5f),
+                        new EXP_FloatValue(2.5f),
+                        new EXP_BoolValue((i % 2) == 0),
+                        new EXP_StringValue(teams[i % 3], "")};
+  const char *names[] = {"health", "ammo", "speed", "limit", "alive", "team"};
+  for (unsigned int j = 0; j < ARRAY_SIZE(names); ++j) {
+    obj->SetProperty(names[j], props[j]);
+    props[j]->Release();
+  }
+}
+
+static bool evaluate_tree(EXP_Expression *expr)
+{
+  EXP_Value *value = expr->Calculate();
+  const bool result = !value->IsError() && !MT_fuzzyZero((float)value->GetNumber());
+  value->Release();
+  return result;
+}
+
+TEST(sca_expression_controller, ProgramVsTree)
+{
+  for (const char *text : expressions) {
+    SCA_IObject *obj = new TestObject();
+    set_properties(obj, 0);
+
+    SCA_ExpressionController *controller = new SCA_ExpressionController(obj, text);
+    // The same tree as the one used by the controller when the program can't be used.
+    EXP_Parser parser;
+    parser.SetContext(controller->AddRef());
+    EXP_Expression *expr = parser.ProcessText(text);
+    ASSERT_NE(expr, nullptr);
+
+    for (int i = 0; i < NUM_CHECKS; ++i) {
+      set_properties(obj, i);
+      EXPECT_EQ(controller->Evaluate(), evaluate_tree(expr)) << text << " values " << i;
+    }
+
+    set_properties(obj, 11);
+    int count = 0;
+
+    printf("\n%s\n", text);
+    TIMEIT_START(program);
+    for (int i = 0; i < NUM_EVALUATIONS; ++i) {
+      count += controller->Evaluate();
+    }
+    TIMEIT_END(program);
+
+    TIMEIT_START(tree);
+    for (int i = 0; i < NUM_EVALUATIONS; ++i) {
+      count -= evaluate_tree(expr);
+    }
+    TIMEIT_END(tree);
+    EXPECT_EQ(count, 0);
+
+    expr->Release();
+    controller->Delete();
+    obj->Release();
+  }
+}
@@ -180,6 +180,11 @@ void GPG_Canvas::GetDisplayDimensions(int &width, int &height)
 
 void GPG_Canvas::ResizeWindow(int width, int height)
 {
+  if (!m_window) {
+    Resize(width, height);
+    return;
+  }
+
   if (m_window->getState() == GHOST_kWindowStateFullScreen) {
     GHOST_ISystem *system = GHOST_ISystem::getSystem();
     GHOST_DisplaySetting setting;
@@ -199,6 +204,10 @@ void GPG_Canvas::ResizeWindow(int width, int height)
 
 void GPG_Canvas::SetFullScreen(bool enable)
 {
+  if (!m_window) {
+    return;
+  }
+
   if (enable) {
     m_window->setState(GHOST_kWindowStateFullScreen);
   }
@@ -209,7 +218,7 @@ void GPG_Canvas::SetFullScreen(bool enable)
 
 bool GPG_Canvas::GetFullScreen()
 {
-  return (m_window->getState() == GHOST_kWindowStateFullScreen);
+  return (m_window && m_window->getState() == GHOST_kWindowStateFullScreen);
 }
 
 void GPG_Canvas::ConvertMousePosition(int x, int y, int &r_x, int &r_y, bool /*screen*/)
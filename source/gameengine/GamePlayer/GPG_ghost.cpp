@@ -119,6 +119,7 @@
 #include "windowmanager/intern/wm_window_private.h"
 
 #include "CM_Message.h"
+#include "CM_Trace.h"
 #include "KX_Globals.h"
 #include "KX_PythonInit.h"
 #include "LA_PlayerLauncher.h"
@@ -489,7 +490,7 @@ static void usage(const std::string &program, bool isBlenderPlayer)
       CM_Message("usage:   " << program << " [--options] " << example_filename << std::endl);
   CM_Message("Available options are: [-w [w h l t]] [-f [fw fh fb ff]] "
              << consoleoption << "[-g gamengineoptions] "
-             << "[-s stereomode] [-m aasamples]");
+             << "[-s stereomode] [-m aasamples] [-t tracefile] [-T milliseconds] [--headless]");
   CM_Message("Optional parameters must be passed in order.");
   CM_Message("Default values are set in the blend file." << std::endl);
   CM_Message("  -h: Prints this command summary" << std::endl);
@@ -546,9 +547,23 @@ static void usage(const std::string &program, bool isBlenderPlayer)
   CM_Message("       show_camera_frustum            0         Show debug camera frustum volume");
   CM_Message(
       "       show_shadow_frustum            0         Show debug light shadow frustum volume");
+  CM_Message("       mesh_cache                     0         Cache the converted meshes");
+  CM_Message("       frame_pacing                   0         Frame pacing: 0 capped,");
+  CM_Message("                                                1 uncapped render,");
+  CM_Message("                                                2 render on change");
+  CM_Message("       input_record                   -         Record the inputs to a file");
+  CM_Message("       input_replay                   -         Replay a record of the inputs");
+  CM_Message("                                                and print frame statistics");
   CM_Message("       ignore_deprecation_warnings    1         Ignore deprecation warnings"
              << std::endl);
-  CM_Message("  -p: override python main loop script");
+  CM_Message("  -p: override python main loop script" << std::endl);
+  CM_Message("  --headless: run the logic, physics and python without window nor render");
+  CM_Message("       The game reads no input, for dedicated servers" << std::endl);
+  CM_Message("  -t: record a trace of the engine written at exit in the Chrome trace format");
+  CM_Message("       Example: -t trace.json" << std::endl);
+  CM_Message("  -T: write the trace when a frame takes longer than the given milliseconds");
+  CM_Message("       The files are named after the -t file with a number suffix");
+  CM_Message("       Example: -t trace.json -T 33 writes trace_1.json, trace_2.json...");
   CM_Message(std::endl);
   CM_Message(
       "  - : all arguments after this are ignored, allowing python to access them from sys.argv");
@@ -758,6 +773,7 @@ int main(int argc,
   bool fullScreen = false;
   bool fullScreenParFound = false;
   bool windowParFound = false;
+  bool headless = false;
 #ifdef WIN32
   bool closeConsole = false; // Changed for testing (best to leave console opened for debugging)
 #endif
@@ -1360,6 +1376,44 @@ int main(int argc,
           pythonControllerFile = argv[i++];
           break;
         }
+        case 't':  // trace file written at exit
+        {
+          ++i;
+          if ((i + 1) <= validArguments) {
+            CM_Trace::SetFilePath(argv[i++]);
+            CM_Trace::SetEnabled(true);
+          }
+          else {
+            error = true;
+            CM_Error("no argument supplied for -t");
+          }
+          break;
+        }
+        case 'T':  // frame time in milliseconds above which the trace is written
+        {
+          ++i;
+          if ((i + 1) <= validArguments) {
+            CM_Trace::SetFrameThreshold(atof(argv[i++]) * 1.0e-3);
+            CM_Trace::SetEnabled(true);
+          }
+          else {
+            error = true;
+            CM_Error("no argument supplied for -T");
+          }
+          break;
+        }
+        case '-':  // long options
+        {
+          if (strcmp(argv[i], "--headless") == 0) {
+            headless = true;
+            SYS_WriteCommandLineInt(syshandle, "headless", 1);
+          }
+          else {
+            CM_Warning("unknown argument: " << argv[i]);
+          }
+          i++;
+          break;
+        }
         default:  // not recognized
         {
           CM_Warning("unknown argument: " << argv[i++]);
@@ -1386,8 +1440,11 @@ int main(int argc,
   if (scr_saver_mode != SCREEN_SAVER_MODE_CONFIGURATION)
 #endif
   {
-    // Create the system
-    if (GHOST_ISystem::createSystem(true, false) == GHOST_kSuccess) {
+    /* Create the system, a headless player only needs an off-screen GPU context and falls back
+     * to a system without display. */
+    const GHOST_TSuccess systemCreated = headless ? GHOST_ISystem::createSystemBackground() :
+                                                    GHOST_ISystem::createSystem(true, false);
+    if (systemCreated == GHOST_kSuccess) {
       system = GHOST_ISystem::getSystem();
       BLI_assert(system);
 
@@ -1616,7 +1673,10 @@ int main(int argc,
             if (firstTimeRunning) {
               firstTimeRunning = false;
 
-              if (fullScreen) {
+              if (headless) {
+                // No window, the game runs until it quits or the process is terminated.
+              }
+              else if (fullScreen) {
 #ifdef WIN32
                 if (scr_saver_mode == SCREEN_SAVER_MODE_SAVER) {
                   window = startScreenSaverFullScreen(system,
@@ -1707,7 +1767,12 @@ int main(int argc,
             CTX_wm_manager_set(C, wm);
             CTX_wm_window_set(C, win);
             InitBlenderContextVariables(C, wm, bfd->curscene);
-            wm_window_ghostwindow_blenderplayer_ensure(wm, win, window, first_time_window);
+            if (headless) {
+              wm_window_headless_blenderplayer_ensure(wm, win, first_time_window);
+            }
+            else {
+              wm_window_ghostwindow_blenderplayer_ensure(wm, win, window, first_time_window);
+            }
 
             /* Get rid of windows which are not the 3D view windows */
             LISTBASE_FOREACH (wmWindow *, win_in_list, &wm->windows) {
@@ -1727,10 +1792,12 @@ int main(int argc,
                */
               WM_init_opengl_blenderplayer(system);
 
-              UI_theme_init_default();
-              UI_init();
-              /* To have blf_monofont_render available for generated textures checkerboard */
-              UI_reinit_font();
+              if (!headless) {
+                UI_theme_init_default();
+                UI_init();
+                /* To have blf_monofont_render available for generated textures checkerboard */
+                UI_reinit_font();
+              }
 
               /* Set Viewport render mode and shading type for the whole runtime */
               useViewportRender = scene->gm.flag & GAME_USE_VIEWPORT_RENDER;
@@ -1764,6 +1831,10 @@ int main(int argc,
             // Enter main loop
             launcher.EngineMainLoop();
 
+            if (CM_Trace::IsEnabled() && !CM_Trace::GetFilePath().empty()) {
+              CM_Trace::Write(CM_Trace::GetFilePath());
+            }
+
             exitcode = launcher.GetExitRequested();
             exitstring = launcher.GetExitString();
             gs = *launcher.GetGlobalSettings();
@@ -1907,7 +1978,9 @@ int main(int argc,
   ED_file_exit(); /* for fsmenu */
 
   DRW_opengl_context_enable_ex(false);
-  UI_exit();
+  if (!headless) {
+    UI_exit();
+  }
   GPU_pass_cache_free();
   GPU_exit();
   DRW_opengl_context_disable_ex(false);
@@ -403,12 +403,8 @@ void BL_Action::Update(float curtime, bool applyToObject)
     return;
   }
 
-  // Update controllers time. The controllers list is cleared when action is done
-  for (SG_Controller *cont : m_sg_contr_list) {
-    cont->SetSimulatedTime(m_localframe);  // update spatial controllers
-    cont->Update(m_localframe);
-    m_requestIpo = true;
-  }
+  // The controllers modify the scene graph, they are updated in UpdateIPOs.
+  m_requestIpo = !m_sg_contr_list.empty();
 
   Object *ob = m_obj->GetBlenderObject();  // eevee
 
@@ -622,10 +618,6 @@ void BL_Action::Update(float curtime, bool applyToObject)
       }
     }
   }
-  // If the action is done we can remove its scene graph IPO controller.
-  if (m_done) {
-    ClearControllerList();
-  }
 }
 
 /* To sync m_obj and children in SceneGraph after potential m_obj transform update in SG_Controller actions */
@@ -634,7 +626,18 @@ void BL_Action::Update(float curtime, bool applyToObject)
 void BL_Action::UpdateIPOs()
 {
   if (m_requestIpo) {
+    // Update controllers time. The controllers list is cleared when action is done
+    for (SG_Controller *cont : m_sg_contr_list) {
+      cont->SetSimulatedTime(m_localframe);  // update spatial controllers
+      cont->Update(m_localframe);
+    }
+
     m_obj->GetSGNode()->UpdateWorldData(0.0);
     m_requestIpo = false;
+
+    // If the action is done we can remove its scene graph IPO controller.
+    if (m_done) {
+      ClearControllerList();
+    }
   }
 }
@@ -111,10 +111,13 @@ class BL_Action {
    * \param curtime The current time used to compute the action's' frame.
    * \param applyToObject Set to true when the action must be applied to the object,
    * else it only manages action's' time/end.
+   * The scene graph controllers are updated later in UpdateIPOs, an armature action can then
+   * be updated from any thread.
    */
   void Update(float curtime, bool applyToObject);
   /**
-   * Sync m_obj and children in SceneGraph if fcurve transform action
+   * Update the scene graph controllers and sync m_obj and children in SceneGraph if fcurve
+   * transform action
    */
   void UpdateIPOs();
 
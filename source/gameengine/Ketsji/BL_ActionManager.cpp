@@ -152,6 +152,16 @@ bool BL_ActionManager::IsActionDone(short layer)
   return action ? action->IsDone() : true;
 }
 
+bool BL_ActionManager::HasPlayingActions()
+{
+  for (const auto &pair : m_layers) {
+    if (!pair.second->IsDone()) {
+      return true;
+    }
+  }
+  return false;
+}
+
 void BL_ActionManager::Suspend()
 {
   m_suspended = true;
@@ -168,10 +178,20 @@ bool BL_ActionManager::IsSuspended() const
 }
 
 void BL_ActionManager::Update(float curtime, bool applyToObject)
+{
+  UpdateActions(curtime, applyToObject);
+  UpdateIPOs();
+}
+
+void BL_ActionManager::UpdateActions(float curtime, bool applyToObject)
 {
   for (const auto &pair : m_layers) {
     pair.second->Update(curtime, applyToObject);
   }
+}
+
+void BL_ActionManager::UpdateIPOs()
+{
   /* It's to sync children with parent SGNode after fcurve update */
   for (const auto &pair : m_layers) {
     pair.second->UpdateIPOs();
@@ -108,6 +108,8 @@ class BL_ActionManager {
    * Check if an action has finished playing
    */
   bool IsActionDone(short layer);
+  /// Check if an action of any layer is still playing.
+  bool HasPlayingActions();
 
   void Suspend();
   void Resume();
@@ -120,4 +122,12 @@ class BL_ActionManager {
    * manages actions' frames.
    */
   void Update(float curtime, bool applyToObject);
+
+  /**
+   * First part of Update: update the actions' frames and evaluate the actions.
+   * It can be called from any thread for an armature object.
+   */
+  void UpdateActions(float curtime, bool applyToObject);
+  /// Second part of Update: update the scene graph from the actions, main thread only.
+  void UpdateIPOs();
 };
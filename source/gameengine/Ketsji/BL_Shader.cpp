@@ -28,6 +28,8 @@
 
 #include "CM_Message.h"
 #include "KX_GameObject.h"
+#include "KX_Globals.h"
+#include "KX_KetsjiEngine.h"
 #include "KX_PyMath.h"
 
 #ifdef WITH_PYTHON
@@ -191,6 +193,8 @@ int BL_Shader::pyattr_set_enabled(EXP_PyObjectPlus *self_v,
                                   const EXP_PYATTRIBUTE_DEF *attrdef,
                                   PyObject *value)
 {
+  KX_GetActiveEngine()->RequestRender();
+
   BL_Shader *self = static_cast<BL_Shader *>(self_v);
   int param = PyObject_IsTrue(value);
   if (param == -1) {
@@ -220,6 +224,8 @@ int BL_Shader::pyattr_set_callbacks(EXP_PyObjectPlus *self_v,
                                     const EXP_PYATTRIBUTE_DEF *attrdef,
                                     PyObject *value)
 {
+  KX_GetActiveEngine()->RequestRender();
+
   BL_Shader *self = static_cast<BL_Shader *>(self_v);
   if (!PyList_CheckExact(value)) {
     PyErr_Format(PyExc_AttributeError,
@@ -234,6 +240,8 @@ int BL_Shader::pyattr_set_callbacks(EXP_PyObjectPlus *self_v,
 
 EXP_PYMETHODDEF_DOC(BL_Shader, setSource, " setSource(vertexProgram, fragmentProgram, apply)")
 {
+  KX_GetActiveEngine()->RequestRender();
+
   if (m_shader) {
     // already set...
     Py_RETURN_NONE;
@@ -263,6 +271,8 @@ EXP_PYMETHODDEF_DOC(BL_Shader, setSource, " setSource(vertexProgram, fragmentPro
 
 EXP_PYMETHODDEF_DOC(BL_Shader, setSourceList, " setSourceList(sources, apply)")
 {
+  KX_GetActiveEngine()->RequestRender();
+
   if (m_shader) {
     // already set...
     Py_RETURN_NONE;
@@ -321,6 +331,8 @@ EXP_PYMETHODDEF_DOC(BL_Shader, setSourceList, " setSourceList(sources, apply)")
 
 EXP_PYMETHODDEF_DOC(BL_Shader, delSource, "delSource( )")
 {
+  KX_GetActiveEngine()->RequestRender();
+
   ClearUniforms();
   DeleteShader();
   Py_RETURN_NONE;
@@ -359,6 +371,8 @@ EXP_PYMETHODDEF_DOC(BL_Shader, validate, "validate()")
 
 EXP_PYMETHODDEF_DOC(BL_Shader, setSampler, "setSampler(name, index)")
 {
+  KX_GetActiveEngine()->RequestRender();
+
   if (!m_shader) {
     Py_RETURN_NONE;
   }
@@ -387,6 +401,8 @@ EXP_PYMETHODDEF_DOC(BL_Shader, setSampler, "setSampler(name, index)")
 /// access functions
 EXP_PYMETHODDEF_DOC(BL_Shader, setUniform1f, "setUniform1f(name, fx)")
 {
+  KX_GetActiveEngine()->RequestRender();
+
   if (!m_shader) {
     Py_RETURN_NONE;
   }
@@ -411,6 +427,8 @@ EXP_PYMETHODDEF_DOC(BL_Shader, setUniform1f, "setUniform1f(name, fx)")
 
 EXP_PYMETHODDEF_DOC(BL_Shader, setUniform2f, "setUniform2f(name, fx, fy)")
 {
+  KX_GetActiveEngine()->RequestRender();
+
   if (!m_shader) {
     Py_RETURN_NONE;
   }
@@ -435,6 +453,8 @@ EXP_PYMETHODDEF_DOC(BL_Shader, setUniform2f, "setUniform2f(name, fx, fy)")
 
 EXP_PYMETHODDEF_DOC(BL_Shader, setUniform3f, "setUniform3f(name, fx,fy,fz) ")
 {
+  KX_GetActiveEngine()->RequestRender();
+
   if (!m_shader) {
     Py_RETURN_NONE;
   }
@@ -459,6 +479,8 @@ EXP_PYMETHODDEF_DOC(BL_Shader, setUniform3f, "setUniform3f(name, fx,fy,fz) ")
 
 EXP_PYMETHODDEF_DOC(BL_Shader, setUniform4f, "setUniform4f(name, fx,fy,fz, fw) ")
 {
+  KX_GetActiveEngine()->RequestRender();
+
   if (!m_shader) {
     Py_RETURN_NONE;
   }
@@ -484,6 +506,8 @@ EXP_PYMETHODDEF_DOC(BL_Shader, setUniform4f, "setUniform4f(name, fx,fy,fz, fw) "
 
 EXP_PYMETHODDEF_DOC(BL_Shader, setUniformEyef, "setUniformEyef(name)")
 {
+  KX_GetActiveEngine()->RequestRender();
+
   if (!m_shader) {
     Py_RETURN_NONE;
   }
@@ -516,6 +540,8 @@ EXP_PYMETHODDEF_DOC(BL_Shader, setUniformEyef, "setUniformEyef(name)")
 
 EXP_PYMETHODDEF_DOC(BL_Shader, setUniform1i, "setUniform1i(name, ix)")
 {
+  KX_GetActiveEngine()->RequestRender();
+
   if (!m_shader) {
     Py_RETURN_NONE;
   }
@@ -540,6 +566,8 @@ EXP_PYMETHODDEF_DOC(BL_Shader, setUniform1i, "setUniform1i(name, ix)")
 
 EXP_PYMETHODDEF_DOC(BL_Shader, setUniform2i, "setUniform2i(name, ix, iy)")
 {
+  KX_GetActiveEngine()->RequestRender();
+
   if (!m_shader) {
     Py_RETURN_NONE;
   }
@@ -564,6 +592,8 @@ EXP_PYMETHODDEF_DOC(BL_Shader, setUniform2i, "setUniform2i(name, ix, iy)")
 
 EXP_PYMETHODDEF_DOC(BL_Shader, setUniform3i, "setUniform3i(name, ix,iy,iz) ")
 {
+  KX_GetActiveEngine()->RequestRender();
+
   if (!m_shader) {
     Py_RETURN_NONE;
   }
@@ -588,6 +618,8 @@ EXP_PYMETHODDEF_DOC(BL_Shader, setUniform3i, "setUniform3i(name, ix,iy,iz) ")
 
 EXP_PYMETHODDEF_DOC(BL_Shader, setUniform4i, "setUniform4i(name, ix,iy,iz, iw) ")
 {
+  KX_GetActiveEngine()->RequestRender();
+
   if (!m_shader) {
     Py_RETURN_NONE;
   }
@@ -613,6 +645,8 @@ EXP_PYMETHODDEF_DOC(BL_Shader, setUniform4i, "setUniform4i(name, ix,iy,iz, iw) "
 
 EXP_PYMETHODDEF_DOC(BL_Shader, setUniformfv, "setUniformfv(float (list2 or list3 or list4))")
 {
+  KX_GetActiveEngine()->RequestRender();
+
   if (!m_shader) {
     Py_RETURN_NONE;
   }
@@ -682,6 +716,8 @@ EXP_PYMETHODDEF_DOC(BL_Shader,
                     setUniformiv,
                     "setUniformiv(uniform_name, (list2 or list3 or list4))")
 {
+  KX_GetActiveEngine()->RequestRender();
+
   if (!m_shader) {
     Py_RETURN_NONE;
   }
@@ -773,6 +809,8 @@ EXP_PYMETHODDEF_DOC(
     setUniformMatrix4,
     "setUniformMatrix4(uniform_name, mat-4x4, transpose(row-major=true, col-major=false)")
 {
+  KX_GetActiveEngine()->RequestRender();
+
   if (!m_shader) {
     Py_RETURN_NONE;
   }
@@ -835,6 +873,8 @@ EXP_PYMETHODDEF_DOC(
     setUniformMatrix3,
     "setUniformMatrix3(uniform_name, list[3x3], transpose(row-major=true, col-major=false)")
 {
+  KX_GetActiveEngine()->RequestRender();
+
   if (!m_shader) {
     Py_RETURN_NONE;
   }
@@ -888,6 +928,8 @@ EXP_PYMETHODDEF_DOC(
 
 EXP_PYMETHODDEF_DOC(BL_Shader, setAttrib, "setAttrib(enum)")
 {
+  KX_GetActiveEngine()->RequestRender();
+
   if (!m_shader) {
     Py_RETURN_NONE;
   }
@@ -912,6 +954,8 @@ EXP_PYMETHODDEF_DOC(BL_Shader, setAttrib, "setAttrib(enum)")
 
 EXP_PYMETHODDEF_DOC(BL_Shader, setUniformDef, "setUniformDef(name, enum)")
 {
+  KX_GetActiveEngine()->RequestRender();
+
   if (!m_shader) {
     Py_RETURN_NONE;
   }
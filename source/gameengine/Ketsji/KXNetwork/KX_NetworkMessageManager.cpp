@@ -32,8 +32,32 @@
 
 #include "KX_NetworkMessageManager.h"
 
+#include <algorithm>
+
+/// Order the messages by subject rank, also compares to a rank for the searches.
+struct SubjectCompare {
+  using Message = KX_NetworkMessageManager::Message;
+
+  const std::vector<unsigned int> &ranks;
+
+  bool operator()(const Message &a, const Message &b) const
+  {
+    return ranks[a.subject] < ranks[b.subject];
+  }
+  bool operator()(const Message &a, unsigned int rank) const
+  {
+    return ranks[a.subject] < rank;
+  }
+  bool operator()(unsigned int rank, const Message &b) const
+  {
+    return rank < ranks[b.subject];
+  }
+};
+
 KX_NetworkMessageManager::KX_NetworkMessageManager() : m_currentList(0)
 {
+  ResetList(m_messages[0]);
+  ResetList(m_messages[1]);
 }
 
 KX_NetworkMessageManager::~KX_NetworkMessageManager()
@@ -41,49 +65,156 @@ KX_NetworkMessageManager::~KX_NetworkMessageManager()
   ClearMessages();
 }
 
-void KX_NetworkMessageManager::AddMessage(KX_NetworkMessageManager::Message message)
+KX_NetworkMessageManager::NameId KX_NetworkMessageManager::InternName(MessageList &list,
+                                                                     const std::string &name)
 {
-  // Put the new message in map for the given receiver and subject.
-  m_messages[m_currentList][message.to][message.subject].push_back(message);
+  const auto it = list.nameIds.emplace(name, list.names.size());
+  if (it.second) {
+    list.names.push_back(&it.first->first);
+  }
+  return it.first->second;
 }
 
-const std::vector<KX_NetworkMessageManager::Message> KX_NetworkMessageManager::GetMessages(
-    std::string to, std::string subject)
+KX_NetworkMessageManager::NameId KX_NetworkMessageManager::FindNameId(const MessageList &list,
+                                                                     const std::string &name)
 {
-  std::vector<KX_NetworkMessageManager::Message> messages;
-
-  // look at messages without receiver.
-  std::map<std::string, std::vector<Message>> &messagesNoReceiver =
-      m_messages[1 - m_currentList][""];
-  std::map<std::string, std::vector<Message>> &messagesReceiver =
-      m_messages[1 - m_currentList][to];
-  if (subject.empty()) {
-    // Add all message without receiver and subject.
-    for (const auto &pair : messagesNoReceiver) {
-      messages.insert(messages.end(), pair.second.begin(), pair.second.end());
-    }
-    // Add all message with the given receiver and no subject.
-    for (const auto &pair : messagesReceiver) {
-      messages.insert(messages.end(), pair.second.begin(), pair.second.end());
+  const auto it = list.nameIds.find(name);
+  return (it == list.nameIds.end()) ? InvalidId : it->second;
+}
+
+void KX_NetworkMessageManager::ResetList(MessageList &list)
+{
+  list.messages.clear();
+  list.bodies.clear();
+  list.nameIds.clear();
+  list.names.clear();
+  list.nameRanks.clear();
+  list.receiverRanges.clear();
+
+  // The empty name is used for the messages without receiver or subject.
+  InternName(list, "");
+}
+
+const std::string &KX_NetworkMessageManager::GetName(NameId id) const
+{
+  return *m_messages[1 - m_currentList].names[id];
+}
+
+void KX_NetworkMessageManager::AddMessage(const std::string &to,
+                                          SCA_IObject *from,
+                                          const std::string &subject,
+                                          const std::string &body)
+{
+  MessageList &list = m_messages[m_currentList];
+
+  Message message;
+  message.to = InternName(list, to);
+  message.from = from;
+  message.subject = InternName(list, subject);
+  message.bodyOffset = list.bodies.size();
+  message.bodyLength = body.size();
+  list.messages.push_back(message);
+
+  list.bodies.append(body);
+}
+
+void KX_NetworkMessageManager::GroupMessages(MessageList &list)
+{
+  // Only the names used by the messages of this frame are ranked and get a range.
+  const unsigned int numNames = list.names.size();
+
+  m_sortedNames.resize(numNames);
+  for (NameId id = 0; id < numNames; ++id) {
+    m_sortedNames[id] = id;
+  }
+  std::sort(m_sortedNames.begin(), m_sortedNames.end(), [&list](NameId a, NameId b) {
+    return *list.names[a] < *list.names[b];
+  });
+  list.nameRanks.resize(numNames);
+  for (unsigned int rank = 0; rank < numNames; ++rank) {
+    list.nameRanks[m_sortedNames[rank]] = rank;
+  }
+
+  std::vector<std::pair<unsigned int, unsigned int>> &ranges = list.receiverRanges;
+  ranges.assign(numNames, {0, 0});
+
+  // Count the messages of each receiver and compute where its messages start.
+  for (const Message &message : list.messages) {
+    ++ranges[message.to].second;
+  }
+  unsigned int start = 0;
+  for (std::pair<unsigned int, unsigned int> &range : ranges) {
+    const unsigned int count = range.second;
+    range.first = range.second = start;
+    start += count;
+  }
+
+  // Move the messages in their receiver range, keeping the sending order.
+  m_groupBuffer.resize(list.messages.size());
+  for (const Message &message : list.messages) {
+    m_groupBuffer[ranges[message.to].second++] = message;
+  }
+  list.messages.swap(m_groupBuffer);
+
+  for (const std::pair<unsigned int, unsigned int> &range : ranges) {
+    if (range.second - range.first > 1) {
+      std::stable_sort(list.messages.begin() + range.first,
+                       list.messages.begin() + range.second,
+                       SubjectCompare{list.nameRanks});
     }
   }
-  else {
-    std::vector<KX_NetworkMessageManager::Message> &messagesNoReceiverSubject =
-        messagesNoReceiver[subject];
-    messages.insert(
-        messages.end(), messagesNoReceiverSubject.begin(), messagesNoReceiverSubject.end());
-    std::vector<KX_NetworkMessageManager::Message> &messagesReceiverSubject =
-        messagesReceiver[subject];
-    messages.insert(
-        messages.end(), messagesReceiverSubject.begin(), messagesReceiverSubject.end());
+
+  const char *bodies = list.bodies.data();
+  for (Message &message : list.messages) {
+    message.body = std::string_view(bodies + message.bodyOffset, message.bodyLength);
   }
+}
 
-  return messages;
+KX_NetworkMessageManager::MessageView KX_NetworkMessageManager::GetMessages(
+    const std::string &to, const std::string &subject) const
+{
+  const MessageList &list = m_messages[1 - m_currentList];
+  const Message *messages = list.messages.data();
+  MessageView view = {{messages, messages}, {messages, messages}};
+
+  const NameId subjectId = FindNameId(list, subject);
+  // No message was sent with this subject in the last frame.
+  if (subjectId == InvalidId) {
+    return view;
+  }
+
+  const NameId toIds[2] = {0, FindNameId(list, to)};
+  MessageSpan *spans[2] = {&view.broadcast, &view.receiver};
+  for (unsigned short i = 0; i < 2; ++i) {
+    const NameId toId = toIds[i];
+    // No message was sent to this receiver in the last frame, or the list isn't grouped yet.
+    if (toId >= list.receiverRanges.size() || (i == 1 && toId == 0)) {
+      continue;
+    }
+
+    const std::pair<unsigned int, unsigned int> &range = list.receiverRanges[toId];
+    MessageSpan &span = *spans[i];
+    span.first = messages + range.first;
+    span.last = messages + range.second;
+
+    // Messages with a subject when the subject is not empty, all messages otherwise.
+    if (subjectId != 0) {
+      const auto subjectRange = std::equal_range(
+          span.first, span.last, list.nameRanks[subjectId], SubjectCompare{list.nameRanks});
+      span.first = subjectRange.first;
+      span.last = subjectRange.second;
+    }
+  }
+
+  return view;
 }
 
 void KX_NetworkMessageManager::ClearMessages()
 {
-  // Clear previous list.
-  m_messages[1 - m_currentList].clear();
+  // Clear previous list, its memory is reused by the next frame.
+  ResetList(m_messages[1 - m_currentList]);
+
+  // The current list becomes readable by the sensors.
+  GroupMessages(m_messages[m_currentList]);
   m_currentList = 1 - m_currentList;
 }
@@ -34,50 +34,137 @@ conflicts with KX_NetworkMessageManager::SendMessage */
 #  undef SendMessage
 #endif
 
-#include <map>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 class SCA_IObject;
 
 class KX_NetworkMessageManager {
  public:
+  /// Identifier of a receiver or subject name interned in a message list, 0 is the empty name.
+  using NameId = unsigned int;
+
+  static const NameId InvalidId = (NameId)-1;
+
   struct Message {
-    /// Receiver object(s) name.
-    std::string to;
+    /// Receiver object(s) name, 0 to send to all objects.
+    NameId to;
     /// Sender game object.
     SCA_IObject *from;
     /// Message subject, used as filter.
-    std::string subject;
-    /// Message body.
-    std::string body;
+    NameId subject;
+    /// Message body, pointing in the bodies of the list. Set once the list is readable.
+    std::string_view body;
+    /// Offset of the body in the bodies of the list.
+    unsigned int bodyOffset;
+    unsigned int bodyLength;
+  };
+
+  /// Contiguous messages of the last frame.
+  struct MessageSpan {
+    const Message *first;
+    const Message *last;
+
+    const Message *begin() const
+    {
+      return first;
+    }
+    const Message *end() const
+    {
+      return last;
+    }
+    unsigned int size() const
+    {
+      return last - first;
+    }
+  };
+
+  /** Messages received by an object for a subject, the view is valid until the next call to
+   * ClearMessages.
+   */
+  struct MessageView {
+    /// Messages sent to all objects.
+    MessageSpan broadcast;
+    /// Messages sent to the object.
+    MessageSpan receiver;
+
+    unsigned int size() const
+    {
+      return broadcast.size() + receiver.size();
+    }
+    bool empty() const
+    {
+      return size() == 0;
+    }
   };
 
  private:
-  /** List of all messages, filtered by receiver object(s) name and subject name.
-   * We use two lists, one handle sended message in the current frame and the other
-   * is used for handle message sended in the last frame for sensors.
+  struct MessageList {
+    std::vector<Message> messages;
+    /// Bodies of all the messages, appended one after the other.
+    std::string bodies;
+    /** Identifiers of the receiver and subject names used by the messages, the names are
+     * cleared with the messages.
+     */
+    std::unordered_map<std::string, NameId> nameIds;
+    /// Interned names indexed by identifier, pointing to the keys of nameIds.
+    std::vector<const std::string *> names;
+    /** Alphabetical rank of each name and range of the messages of each receiver, indexed by
+     * name identifier. Only for the readable list where the messages are grouped by receiver then
+     * subject in alphabetical order.
+     */
+    std::vector<unsigned int> nameRanks;
+    std::vector<std::pair<unsigned int, unsigned int>> receiverRanges;
+  };
+
+  /** List of all messages. We use two lists, one handle sended message in the current frame and
+   * the other is used for handle message sended in the last frame for sensors.
    */
-  std::map<std::string, std::map<std::string, std::vector<Message>>> m_messages[2];
+  MessageList m_messages[2];
 
   /** Since we use two list for the current and last frame we have to switch of
    * current message list each frame. This value is only 0 or 1.
    */
   unsigned short m_currentList;
 
+  /// Temporary storage used to group the messages.
+  std::vector<Message> m_groupBuffer;
+  std::vector<NameId> m_sortedNames;
+
+  static NameId InternName(MessageList &list, const std::string &name);
+  /// Return the identifier of a name of a list or InvalidId, the name is not added.
+  static NameId FindNameId(const MessageList &list, const std::string &name);
+  /// Clear the messages and the names of a list.
+  static void ResetList(MessageList &list);
+  /** Group the messages of a list by receiver then subject, the receivers are grouped in linear
+   * time and the subjects are ordered alphabetically like the sensors always received them.
+   */
+  void GroupMessages(MessageList &list);
+
  public:
   KX_NetworkMessageManager();
   virtual ~KX_NetworkMessageManager();
 
+  /// Return the name of an identifier of the messages returned by GetMessages().
+  const std::string &GetName(NameId id) const;
+
   /** Add a message in the next message list.
-   * \param message The given message to add.
+   * \param to The receiver object(s) name, empty for all objects.
+   * \param from The sender game object.
+   * \param subject The message subject.
+   * \param body The message body, copied in the list.
    */
-  void AddMessage(Message message);
+  void AddMessage(const std::string &to,
+                  SCA_IObject *from,
+                  const std::string &subject,
+                  const std::string &body);
   /** Get all messages for a given receiver object name and message subject.
    * \param to The object(s) name.
    * \param subject The message subject/filter.
    */
-  const std::vector<Message> GetMessages(std::string to, std::string subject);
+  MessageView GetMessages(const std::string &to, const std::string &subject) const;
 
   /// Clear all messages
   void ClearMessages();
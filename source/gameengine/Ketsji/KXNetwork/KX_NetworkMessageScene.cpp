@@ -41,23 +41,22 @@ KX_NetworkMessageScene::~KX_NetworkMessageScene()
 {
 }
 
-void KX_NetworkMessageScene::SendMessage(std::string to,
+void KX_NetworkMessageScene::SendMessage(const std::string &to,
                                          SCA_IObject *from,
-                                         std::string subject,
-                                         std::string body)
+                                         const std::string &subject,
+                                         const std::string &body)
 {
-  KX_NetworkMessageManager::Message message;
-  message.to = to;
-  message.from = from;
-  message.subject = subject;
-  message.body = body;
-
-  // Put the new message in map for the given receiver and subject.
-  m_messageManager->AddMessage(message);
+  m_messageManager->AddMessage(to, from, subject, body);
 }
 
-const std::vector<KX_NetworkMessageManager::Message> KX_NetworkMessageScene::FindMessages(
-    std::string to, std::string subject)
+KX_NetworkMessageManager::MessageView KX_NetworkMessageScene::FindMessages(
+    const std::string &to, const std::string &subject) const
 {
   return m_messageManager->GetMessages(to, subject);
 }
+
+const std::string &KX_NetworkMessageScene::GetSubject(
+    const KX_NetworkMessageManager::Message &message) const
+{
+  return m_messageManager->GetName(message.subject);
+}
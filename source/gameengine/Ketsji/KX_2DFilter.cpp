@@ -27,6 +27,8 @@
 #include "KX_2DFilter.h"
 
 #include "KX_2DFilterFrameBuffer.h"
+#include "KX_Globals.h"
+#include "KX_KetsjiEngine.h"
 
 KX_2DFilter::KX_2DFilter(RAS_2DFilterData &data) : RAS_2DFilter(data)
 {
@@ -151,6 +153,8 @@ int KX_2DFilter::pyattr_set_mipmap(EXP_PyObjectPlus *self_v,
                                    const EXP_PYATTRIBUTE_DEF *attrdef,
                                    PyObject *value)
 {
+  KX_GetActiveEngine()->RequestRender();
+
   KX_2DFilter *self = static_cast<KX_2DFilter *>(self_v);
   int param = PyObject_IsTrue(value);
   if (param == -1) {
@@ -173,6 +177,8 @@ PyObject *KX_2DFilter::pyattr_get_frameBuffer(EXP_PyObjectPlus *self_v,
 
 EXP_PYMETHODDEF_DOC(KX_2DFilter, setTexture, "setTexture(index, bindCode, samplerName)")
 {
+  KX_GetActiveEngine()->RequestRender();
+
   int index = 0;
   int bindCode = 0;
   char *samplerName = nullptr;
@@ -195,6 +201,8 @@ EXP_PYMETHODDEF_DOC(KX_2DFilter, setTexture, "setTexture(index, bindCode, sample
 
 EXP_PYMETHODDEF_DOC(KX_2DFilter, setCubeMap, "setCubeMap(index, bindCode, samplerName)")
 {
+  KX_GetActiveEngine()->RequestRender();
+
   int index = 0;
   int bindCode = 0;
   char *samplerName = nullptr;
@@ -217,6 +225,8 @@ EXP_PYMETHODDEF_DOC(KX_2DFilter, setCubeMap, "setCubeMap(index, bindCode, sample
 
 EXP_PYMETHODDEF_DOC(KX_2DFilter, addOffScreen, " addOffScreen(slots, width, height, mipmap)")
 {
+  KX_GetActiveEngine()->RequestRender();
+
   int slots;
   int width = -1;
   int height = -1;
@@ -275,6 +285,8 @@ EXP_PYMETHODDEF_DOC(KX_2DFilter, addOffScreen, " addOffScreen(slots, width, heig
 
 EXP_PYMETHODDEF_DOC_NOARGS(KX_2DFilter, removeOffScreen, " removeOffScreen()")
 {
+  KX_GetActiveEngine()->RequestRender();
+
   SetOffScreen(nullptr);
   Py_RETURN_NONE;
 }
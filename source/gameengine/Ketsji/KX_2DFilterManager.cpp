@@ -28,6 +28,8 @@
 
 #include "CM_Message.h"
 #include "KX_2DFilter.h"
+#include "KX_Globals.h"
+#include "KX_KetsjiEngine.h"
 
 KX_2DFilterManager::KX_2DFilterManager()
 {
@@ -112,6 +114,8 @@ EXP_PYMETHODDEF_DOC(KX_2DFilterManager, getFilter, " getFilter(index)")
 
 EXP_PYMETHODDEF_DOC(KX_2DFilterManager, addFilter, " addFilter(index, type, fragmentProgram)")
 {
+  KX_GetActiveEngine()->RequestRender();
+
   int index = 0;
   int type = 0;
   const char *frag = "";
@@ -153,6 +157,8 @@ EXP_PYMETHODDEF_DOC(KX_2DFilterManager, addFilter, " addFilter(index, type, frag
 
 EXP_PYMETHODDEF_DOC(KX_2DFilterManager, removeFilter, " removeFilter(index)")
 {
+  KX_GetActiveEngine()->RequestRender();
+
   int index = 0;
 
   if (!PyArg_ParseTuple(args, "i:removeFilter", &index)) {
@@ -64,7 +64,9 @@ KX_BlenderMaterial::KX_BlenderMaterial(RAS_Rasterizer *rasty,
    */
   bool using_eevee_next = is_eevee_next(scene->GetBlenderScene());
   if (m_material->use_nodes && m_material->nodetree && !converting_during_runtime && !using_eevee_next) {
-    if (!KX_GetActiveEngine()->UseViewportRender()) {
+    if (!KX_GetActiveEngine()->UseViewportRender() &&
+        !KX_GetActiveEngine()->GetFlag(KX_KetsjiEngine::HEADLESS))
+    {
       EEVEE_Data *vedata = EEVEE_engine_data_get();
       EEVEE_EffectsInfo *effects = vedata->stl->effects;
       const bool use_ssrefract = ((m_material->blend_flag & MA_BL_SS_REFRACTION) != 0) &&
@@ -401,6 +403,7 @@ EXP_PYMETHODDEF_DOC(KX_BlenderMaterial, setBlending, "setBlending(bge.logic.src,
       return nullptr;
     }
     m_userDefBlend = true;
+    KX_GetActiveEngine()->RequestRender();
     Py_RETURN_NONE;
   }
   return nullptr;
@@ -33,7 +33,7 @@
 
 /* Note, the way this works with/without sumo is a bit odd */
 
-#include <list>
+#include <vector>
 
 class SCA_ISensor;
 class KX_GameObject;
@@ -44,7 +44,7 @@ class KX_GameObject;
 struct KX_ClientObjectInfo {
   enum clienttype { STATIC, ACTOR, RESERVED1, SENSOR, OBSENSOR, OBACTORSENSOR } m_type;
   KX_GameObject *m_gameobject;
-  std::list<SCA_ISensor *> m_sensors;
+  std::vector<SCA_ISensor *> m_sensors;
 
  public:
   KX_ClientObjectInfo(KX_GameObject *gameobject, clienttype type = STATIC)
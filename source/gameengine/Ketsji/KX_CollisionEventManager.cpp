@@ -37,7 +37,10 @@
 
 KX_CollisionEventManager::KX_CollisionEventManager(class SCA_LogicManager *logicmgr,
                                                    PHY_IPhysicsEnvironment *physEnv)
-    : SCA_EventManager(logicmgr, TOUCH_EVENTMGR), m_physEnv(physEnv)
+    : SCA_EventManager(logicmgr, TOUCH_EVENTMGR),
+      m_physEnv(physEnv),
+      m_numDispatchedCollisions(0),
+      m_numSkippedCollisions(0)
 {
   m_physEnv->AddCollisionCallback(
       PHY_OBJECT_RESPONSE, KX_CollisionEventManager::newCollisionResponse, this);
@@ -104,7 +107,7 @@ bool KX_CollisionEventManager::newBroadphaseResponse(void *client_data,
 
   // Consider callbacks for broadphase inclusion if it's a sensor object type
   if (gobj1 && gobj2) {
-    has_py_callbacks = gobj1->m_collisionCallbacks || gobj2->m_collisionCallbacks;
+    has_py_callbacks = gobj1->HasCollisionCallbacks() || gobj2->HasCollisionCallbacks();
   }
 #endif
 
@@ -113,7 +116,7 @@ bool KX_CollisionEventManager::newBroadphaseResponse(void *client_data,
       if (info1->m_sensors.size() == 1) {
         // only one sensor for this type of object
         SCA_CollisionSensor *collisionsensor = static_cast<SCA_CollisionSensor *>(
-            *info1->m_sensors.begin());
+            info1->m_sensors.front());
         return collisionsensor->BroadPhaseFilterCollision(ctrl1, ctrl2);
       }
       break;
@@ -179,12 +182,13 @@ void KX_CollisionEventManager::NextFrame()
     static_cast<SCA_CollisionSensor *>(sensor)->SynchronizeTransform();
   }
 
+  m_numDispatchedCollisions = 0;
+  m_numSkippedCollisions = 0;
+
   for (const NewCollision &collision : m_newCollisions) {
     // Controllers
     PHY_IPhysicsController *ctrl1 = collision.first;
     PHY_IPhysicsController *ctrl2 = collision.second;
-    // Sensor iterator
-    std::list<SCA_ISensor *>::iterator sit;
 
     // First client info
     KX_ClientObjectInfo *client_info = static_cast<KX_ClientObjectInfo *>(
@@ -193,8 +197,8 @@ void KX_CollisionEventManager::NextFrame()
     KX_GameObject *kxObj1 = KX_GameObject::GetClientObject(client_info);
     // Invoke sensor response for each object
     if (client_info) {
-      for (sit = client_info->m_sensors.begin(); sit != client_info->m_sensors.end(); ++sit) {
-        static_cast<SCA_CollisionSensor *>(*sit)->NewHandleCollision(ctrl1, ctrl2, nullptr);
+      for (SCA_ISensor *sensor : client_info->m_sensors) {
+        static_cast<SCA_CollisionSensor *>(sensor)->NewHandleCollision(ctrl1, ctrl2, nullptr);
       }
     }
 
@@ -203,16 +207,30 @@ void KX_CollisionEventManager::NextFrame()
     // Second gameobject
     KX_GameObject *kxObj2 = KX_GameObject::GetClientObject(client_info);
     if (client_info) {
-      for (sit = client_info->m_sensors.begin(); sit != client_info->m_sensors.end(); ++sit) {
-        static_cast<SCA_CollisionSensor *>(*sit)->NewHandleCollision(ctrl2, ctrl1, nullptr);
+      for (SCA_ISensor *sensor : client_info->m_sensors) {
+        static_cast<SCA_CollisionSensor *>(sensor)->NewHandleCollision(ctrl2, ctrl1, nullptr);
       }
     }
-    // Run python callbacks
+
+    ++m_numDispatchedCollisions;
+
+    // Run python callbacks, the contact points are only built for objects listening to them.
+    const bool callbacks1 = kxObj1 && kxObj1->HasCollisionCallbacks();
+    const bool callbacks2 = kxObj2 && kxObj2->HasCollisionCallbacks();
+    if (!callbacks1 && !callbacks2) {
+      ++m_numSkippedCollisions;
+      continue;
+    }
+
     const PHY_ICollData *colldata = collision.colldata;
-    KX_CollisionContactPointList contactPointList0 = KX_CollisionContactPointList(colldata, collision.isFirst);
-    KX_CollisionContactPointList contactPointList1 = KX_CollisionContactPointList(colldata, !collision.isFirst);
-    kxObj1->RunCollisionCallbacks(kxObj2, contactPointList0);
-    kxObj2->RunCollisionCallbacks(kxObj1, contactPointList1);
+    if (callbacks1) {
+      KX_CollisionContactPointList contactPointList0(colldata, collision.isFirst);
+      kxObj1->RunCollisionCallbacks(kxObj2, contactPointList0);
+    }
+    if (callbacks2) {
+      KX_CollisionContactPointList contactPointList1(colldata, !collision.isFirst);
+      kxObj2->RunCollisionCallbacks(kxObj1, contactPointList1);
+    }
   }
 
   for (SCA_ISensor *sensor : m_sensors) {
@@ -222,6 +240,16 @@ void KX_CollisionEventManager::NextFrame()
   RemoveNewCollisions();
 }
 
+int KX_CollisionEventManager::GetNumDispatchedCollisions() const
+{
+  return m_numDispatchedCollisions;
+}
+
+int KX_CollisionEventManager::GetNumSkippedCollisions() const
+{
+  return m_numSkippedCollisions;
+}
+
 SCA_LogicManager *KX_CollisionEventManager::GetLogicManager()
 {
   return m_logicmgr;
@@ -53,8 +53,8 @@ class KX_CollisionEventManager : public SCA_EventManager {
     bool isFirst;
 
     /**
-     * Creates a copy of the given PHY_ICollData; freeing that copy should be done by the owner of
-     * the NewCollision object.
+     * Stores the given PHY_ICollData pointer, the data is owned by the physics environment and
+     * remains valid until its next step.
      *
      * This allows us to efficiently store NewCollision objects in a std::set without creating more
      * copies of colldata, as the NewCollision copy constructor reuses the pointer and doesn't
@@ -71,6 +71,11 @@ class KX_CollisionEventManager : public SCA_EventManager {
 
   std::set<NewCollision> m_newCollisions;
 
+  /// Number of collisions dispatched to the sensors and callbacks during the last frame.
+  int m_numDispatchedCollisions;
+  /// Number of dispatched collisions for which no contact points were built.
+  int m_numSkippedCollisions;
+
   static bool newCollisionResponse(void *client_data,
                                    PHY_IPhysicsController *ctrl1,
                                    PHY_IPhysicsController *ctrl2,
@@ -101,4 +106,7 @@ class KX_CollisionEventManager : public SCA_EventManager {
 
   SCA_LogicManager *GetLogicManager();
   PHY_IPhysicsEnvironment *GetPhysicsEnvironment();
+
+  int GetNumDispatchedCollisions() const;
+  int GetNumSkippedCollisions() const;
 };
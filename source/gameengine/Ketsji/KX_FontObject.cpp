@@ -35,6 +35,9 @@
 #include "DNA_curve_types.h"
 #include "MEM_guardedalloc.h"
 
+#include "KX_Globals.h"
+#include "KX_KetsjiEngine.h"
+
 static std::vector<std::string> split_string(std::string str)
 {
   std::vector<std::string> text = std::vector<std::string>();
@@ -79,6 +82,12 @@ void KX_FontObject::SetText(const std::string &text)
 {
   m_text = text;
   m_texts = split_string(text);
+
+  // The text isn't part of the scene graph, notify the engine to render the new text.
+  KX_KetsjiEngine *engine = KX_GetActiveEngine();
+  if (engine) {
+    engine->RequestRender();
+  }
 }
 
 void KX_FontObject::UpdateCurveText(std::string newText)  // eevee
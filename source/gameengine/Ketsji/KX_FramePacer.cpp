@@ -0,0 +1,79 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Ketsji/KX_FramePacer.cpp
+ *  \ingroup ketsji
+ */
+
+#include "KX_FramePacer.h"
+
+#include <chrono>
+#include <thread>
+
+#include "BLI_math_base.h"
+#include "BLI_utildefines.h"
+
+#include "CM_Clock.h"
+
+/// Bounds of the spin margin, the sleep resolution is around 1ms on most systems.
+static const double minSpinMargin = 0.2e-3;
+static const double maxSpinMargin = 4.0e-3;
+
+KX_FramePacer::KX_FramePacer() : m_spinMargin(1.0e-3), m_averageError(0.0)
+{
+}
+
+double KX_FramePacer::WaitUntil(const CM_Clock &clock, double target)
+{
+  double now = clock.GetTimeSecond();
+
+  const double sleeptime = target - now - m_spinMargin;
+  if (sleeptime > 0.0) {
+    std::this_thread::sleep_for(std::chrono::duration<double>(sleeptime));
+    now = clock.GetTimeSecond();
+
+    /* Raise the margin at once to the sleep overshoot and lower it slowly to keep the spin
+     * short without waking up late. */
+    const double overshoot = max_dd(now - (target - m_spinMargin), 0.0) * 1.25;
+    if (overshoot > m_spinMargin) {
+      m_spinMargin = overshoot;
+    }
+    else {
+      m_spinMargin = m_spinMargin * 0.99 + overshoot * 0.01;
+    }
+    CLAMP(m_spinMargin, minSpinMargin, maxSpinMargin);
+  }
+
+  while (now < target) {
+    std::this_thread::yield();
+    now = clock.GetTimeSecond();
+  }
+
+  m_averageError = m_averageError * 0.9 + (now - target) * 0.1;
+
+  return now;
+}
+
+double KX_FramePacer::GetAverageError() const
+{
+  return m_averageError;
+}
@@ -0,0 +1,62 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file KX_FramePacer.h
+ *  \ingroup ketsji
+ */
+
+#pragma once
+
+class CM_Clock;
+
+/** Wait for the next fixed frame without pinning a core: the thread sleeps until a margin
+ * before the target time and spins the remaining time. The margin follows the measured sleep
+ * overshoot of the system.
+ */
+class KX_FramePacer {
+ public:
+  enum Mode {
+    /// Render after each logic frame, sleep between the frames.
+    PACING_CAPPED = 0,
+    /// Fixed logic frames but render as often as possible without sleeping.
+    PACING_UNCAPPED_RENDER,
+    /// Sleep between the frames and render only when the scenes changed.
+    PACING_RENDER_ON_CHANGE
+  };
+
+ private:
+  /// Time before the target when the sleep stops and the spin starts.
+  double m_spinMargin;
+  /// Average time by which the target time was missed.
+  double m_averageError;
+
+ public:
+  KX_FramePacer();
+
+  /** Wait until the clock reaches the target time.
+   * \return The clock time at the end of the wait.
+   */
+  double WaitUntil(const CM_Clock &clock, double target);
+
+  /// Return the average time in seconds between the target time and the end of the wait.
+  double GetAverageError() const;
+};
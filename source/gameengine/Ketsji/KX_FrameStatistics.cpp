@@ -0,0 +1,103 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Ketsji/KX_FrameStatistics.cpp
+ *  \ingroup ketsji
+ */
+
+#include "KX_FrameStatistics.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+#include "CM_Message.h"
+#include "KX_TimeCategoryLogger.h"
+
+KX_FrameStatistics::KX_FrameStatistics()
+{
+}
+
+void KX_FrameStatistics::AddFrame(KX_TimeCategoryLogger &logger, unsigned int numCategories)
+{
+  if (m_times.empty()) {
+    m_times.resize(numCategories + 1);
+  }
+
+  double total = 0.0;
+  for (unsigned int i = 0; i < numCategories; ++i) {
+    const double time = logger.GetLast(i);
+    m_times[i].push_back(time);
+    total += time;
+  }
+  m_times[numCategories].push_back(total);
+}
+
+unsigned int KX_FrameStatistics::GetNumFrames() const
+{
+  return m_times.empty() ? 0 : m_times[0].size();
+}
+
+/// Return the value of the percentile in a sorted list.
+static float percentile(const std::vector<float> &sorted, float ratio)
+{
+  const unsigned int index = (unsigned int)(ratio * (sorted.size() - 1) + 0.5f);
+  return sorted[index];
+}
+
+void KX_FrameStatistics::Print(const std::string *labels) const
+{
+  const unsigned int numFrames = GetNumFrames();
+  if (numFrames == 0) {
+    return;
+  }
+
+  CM_Message("Frame statistics over " << numFrames << " frames (ms):");
+  std::stringstream header;
+  header << std::setw(17) << std::left << "Category:" << std::right;
+  for (const char *column : {"mean", "median", "p95", "p99", "max"}) {
+    header << std::setw(10) << column;
+  }
+  CM_Message(header.str());
+
+  const unsigned int numCategories = m_times.size() - 1;
+  for (unsigned int i = 0; i <= numCategories; ++i) {
+    std::vector<float> sorted = m_times[i];
+    std::sort(sorted.begin(), sorted.end());
+
+    double sum = 0.0;
+    for (float time : sorted) {
+      sum += time;
+    }
+
+    std::stringstream line;
+    line << std::fixed << std::setprecision(3);
+    line << std::setw(17) << std::left << ((i == numCategories) ? "Total:" : labels[i])
+         << std::right;
+    line << std::setw(10) << sum / numFrames * 1000.0;
+    line << std::setw(10) << percentile(sorted, 0.5f) * 1000.0f;
+    line << std::setw(10) << percentile(sorted, 0.95f) * 1000.0f;
+    line << std::setw(10) << percentile(sorted, 0.99f) * 1000.0f;
+    line << std::setw(10) << sorted.back() * 1000.0f;
+    CM_Message(line.str());
+  }
+}
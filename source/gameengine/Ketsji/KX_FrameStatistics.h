@@ -0,0 +1,54 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file KX_FrameStatistics.h
+ *  \ingroup ketsji
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+class KX_TimeCategoryLogger;
+
+/** Keep the time spent in each profiling category for every frame of a run to summarize them
+ * at the end, used to benchmark the replay of an input record.
+ */
+class KX_FrameStatistics {
+ private:
+  /// Times in seconds of each frame, one list per category and a last one for the total.
+  std::vector<std::vector<float>> m_times;
+
+ public:
+  KX_FrameStatistics();
+
+  /// Add the last complete measurement of the categories as a frame.
+  void AddFrame(KX_TimeCategoryLogger &logger, unsigned int numCategories);
+
+  unsigned int GetNumFrames() const;
+
+  /** Print the mean, median, 95th and 99th percentiles and maximum time of each category.
+   * \param labels The label of each category.
+   */
+  void Print(const std::string *labels) const;
+};
@@ -49,6 +49,7 @@
 #include "BL_Action.h"
 #include "BL_ActionManager.h"
 #include "BL_SceneConverter.h"
+#include "CM_Trace.h"
 #include "KX_ClientObjectInfo.h"
 #include "KX_CollisionContactPoints.h"
 #include "KX_Globals.h"
@@ -99,6 +100,7 @@ KX_GameObject::KX_GameObject()
       m_pSGNode(nullptr),
       m_pInstanceObjects(nullptr),
       m_pDupliGroupObject(nullptr),
+      m_poolOriginal(nullptr),
       m_actionManager(nullptr)
 #ifdef WITH_PYTHON
       ,
@@ -248,9 +250,14 @@ void KX_GameObject::SyncTransformWithDepsgraph()
 void KX_GameObject::ForceIgnoreParentTx()
 {
   m_forceIgnoreParentTx = true;
+  // Make sure the object is visited at the next depsgraph sync even if it didn't move.
+  GetSGNode()->SetRenderDirty();
 }
 
-void KX_GameObject::TagForTransformUpdate(bool is_overlay_pass, bool is_last_render_pass)
+void KX_GameObject::TagForTransformUpdate(Main *bmain,
+                                          Depsgraph *depsgraph,
+                                          bool is_overlay_pass,
+                                          bool is_last_render_pass)
 {
   float object_to_world[4][4];
   NodeGetWorldTransform().getValue(&object_to_world[0][0]);
@@ -267,11 +274,11 @@ void KX_GameObject::TagForTransformUpdate(bool is_overlay_pass, bool is_last_ren
     }
   }
 
-  bContext *C = KX_GetActiveEngine()->GetContext();
-  Main *bmain = CTX_data_main(C);
-  Depsgraph *depsgraph = CTX_data_depsgraph_on_load(C);
-
   Object *ob_orig = GetBlenderObject();
+  if (!ob_orig) {
+    m_forceIgnoreParentTx = false;
+    return;
+  }
 
   bool skip_transform = ob_orig->transflag & OB_TRANSFLAG_OVERRIDE_GAME_PRIORITY;
   /* Don't tag non overlay collection objects in overlay collection render pass */
@@ -281,7 +288,7 @@ void KX_GameObject::TagForTransformUpdate(bool is_overlay_pass, bool is_last_ren
   skip_transform = skip_transform ||
                    (ob_orig->gameflag & OB_OVERLAY_COLLECTION && !is_overlay_pass);
 
-  if (ob_orig && !skip_transform) {
+  if (!skip_transform) {
 
     bool applyTransformToOrig = GetScene()->OrigObCanBeTransformedInRealtime(ob_orig);
 
@@ -326,27 +333,22 @@ void KX_GameObject::TagForTransformUpdate(bool is_overlay_pass, bool is_last_ren
   m_forceIgnoreParentTx = false;
 }
 
-void KX_GameObject::TagForTransformUpdateEvaluated()
+void KX_GameObject::TagForTransformUpdateEvaluated(Depsgraph *depsgraph)
 {
-  float object_to_world[4][4];
-  NodeGetWorldTransform().getValue(&object_to_world[0][0]);
-
-  bContext *C = KX_GetActiveEngine()->GetContext();
-  Depsgraph *depsgraph = CTX_data_depsgraph_on_load(C);
-
   Object *ob_orig = GetBlenderObject();
 
-  bool skip_transform = ob_orig->transflag & OB_TRANSFLAG_OVERRIDE_GAME_PRIORITY;
-
-  if (skip_transform) {
-    SyncTransformWithDepsgraph();
+  /* Objects overriding the game transform are synced from blender,
+   * see KX_Scene::SyncTransformsEvaluated. */
+  if (!ob_orig || (ob_orig->transflag & OB_TRANSFLAG_OVERRIDE_GAME_PRIORITY)) {
+    return;
   }
 
-  if (ob_orig && !skip_transform) {
-    Object *ob_eval = DEG_get_evaluated_object(depsgraph, ob_orig);
-    copy_m4_m4(ob_eval->object_to_world, object_to_world);
-    BKE_object_apply_mat4(ob_eval, ob_eval->object_to_world, false, true);
-  }
+  float object_to_world[4][4];
+  NodeGetWorldTransform().getValue(&object_to_world[0][0]);
+
+  Object *ob_eval = DEG_get_evaluated_object(depsgraph, ob_orig);
+  copy_m4_m4(ob_eval->object_to_world, object_to_world);
+  BKE_object_apply_mat4(ob_eval, ob_eval->object_to_world, false, true);
 }
 
 void KX_GameObject::ReplicateBlenderObject()
@@ -698,6 +700,44 @@ void KX_GameObject::SetDupliGroupObject(KX_GameObject *obj)
   m_pDupliGroupObject = obj;
 }
 
+KX_GameObject *KX_GameObject::GetPoolOriginal() const
+{
+  return m_poolOriginal;
+}
+
+void KX_GameObject::SetPoolOriginal(KX_GameObject *original)
+{
+  m_poolOriginal = original;
+}
+
+void KX_GameObject::ResetPooledState()
+{
+  // Actuators and objects refering to this object must forget it as for a deleted object.
+  UnlinkClients();
+
+  if (m_actionManager) {
+    delete m_actionManager;
+    m_actionManager = nullptr;
+  }
+
+#ifdef WITH_PYTHON
+  RunOnRemoveCallbacks();
+  Py_CLEAR(m_removeCallbacks);
+
+  if (m_collisionCallbacks) {
+    UnregisterCollisionCallbacks();
+    Py_CLEAR(m_collisionCallbacks);
+  }
+
+  if (m_attr_dict) {
+    PyDict_Clear(m_attr_dict);
+    if (m_poolOriginal && m_poolOriginal->m_attr_dict) {
+      PyDict_Update(m_attr_dict, m_poolOriginal->m_attr_dict);
+    }
+  }
+#endif  // WITH_PYTHON
+}
+
 void KX_GameObject::AddConstraint(bRigidBodyJointConstraint *cons)
 {
   m_constraints.push_back(cons);
@@ -944,6 +984,7 @@ void KX_GameObject::ProcessReplica()
    * See KX_Scene::DupliGroupRecurse. */
   m_pDupliGroupObject = nullptr;
   m_pInstanceObjects = nullptr;
+  m_poolOriginal = nullptr;
   m_pClient_info = new KX_ClientObjectInfo(*m_pClient_info);
   m_pClient_info->m_gameobject = this;
   m_actionManager = nullptr;
@@ -1782,11 +1823,20 @@ void KX_GameObject::RegisterCollisionCallbacks()
       pe->AddSensor(spc);
   }
 }
+bool KX_GameObject::HasCollisionCallbacks() const
+{
+#ifdef WITH_PYTHON
+  return m_collisionCallbacks && PyList_GET_SIZE(m_collisionCallbacks) > 0;
+#else
+  return false;
+#endif
+}
+
 void KX_GameObject::RunCollisionCallbacks(KX_GameObject *collider,
                                           KX_CollisionContactPointList &contactPointList)
 {
 #ifdef WITH_PYTHON
-  if (!m_collisionCallbacks || PyList_GET_SIZE(m_collisionCallbacks) == 0) {
+  if (!HasCollisionCallbacks()) {
     return;
   }
 
@@ -1909,6 +1959,7 @@ void KX_GameObject::Update()
   if (!m_logicSuspended) {
     if (m_components) {
       for (KX_PythonComponent *comp : m_components) {
+        CM_TRACE_SCOPE("component", comp->GetName());
         comp->Update();
       }
     }
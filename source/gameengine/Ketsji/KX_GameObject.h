@@ -138,6 +138,9 @@ class KX_GameObject : public SCA_IObject {
   EXP_ListValue<KX_GameObject> *m_pInstanceObjects;
   KX_GameObject *m_pDupliGroupObject;
 
+  /// The inactive object this replica was added from when its scene pools it, see KX_Scene.
+  KX_GameObject *m_poolOriginal;
+
   // The action manager is used to play/stop/update actions
   BL_ActionManager *m_actionManager;
 
@@ -152,8 +155,12 @@ class KX_GameObject : public SCA_IObject {
  public:
   /* EEVEE INTEGRATION */
 
-  void TagForTransformUpdate(bool is_overlay_pass, bool is_last_render_pass);
-  void TagForTransformUpdateEvaluated();
+  void TagForTransformUpdate(struct Main *bmain,
+                             struct Depsgraph *depsgraph,
+                             bool is_overlay_pass,
+                             bool is_last_render_pass);
+  /// Copy the world transform to the evaluated object, can be called from any thread.
+  void TagForTransformUpdateEvaluated(struct Depsgraph *depsgraph);
   void ReplicateBlenderObject();
   void HideOriginalObject();
   void RemoveReplicaObject();
@@ -267,6 +274,20 @@ class KX_GameObject : public SCA_IObject {
   void RemoveDupliGroupObject();
 
   void RemoveInstanceObject(KX_GameObject *);
+
+  /*********************************
+   * Object pool API
+   *********************************/
+
+  KX_GameObject *GetPoolOriginal() const;
+
+  void SetPoolOriginal(KX_GameObject *original);
+
+  /**
+   * Release the state owned by the current life of a pooled replica: clients references,
+   * actions and python callbacks. The python attributes are reset to the ones of the original.
+   */
+  void ResetPooledState();
   /*********************************
    * Animation API
    *********************************/
@@ -737,6 +758,8 @@ class KX_GameObject : public SCA_IObject {
 
   void RegisterCollisionCallbacks();
   void UnregisterCollisionCallbacks();
+  /// Return true if python callbacks are registered in collisionCallbacks.
+  bool HasCollisionCallbacks() const;
   void RunCollisionCallbacks(KX_GameObject *collider,
                              KX_CollisionContactPointList &contactPointList);
 
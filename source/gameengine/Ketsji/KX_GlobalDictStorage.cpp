@@ -0,0 +1,495 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Ketsji/KX_GlobalDictStorage.cpp
+ *  \ingroup ketsji
+ */
+
+#ifdef WITH_PYTHON
+
+#  include "KX_GlobalDictStorage.h"
+
+#  include <algorithm>
+#  include <cstdint>
+#  include <cstring>
+#  include <new>
+#  include <zstd.h>
+
+#  include "BLI_fileops.h"
+#  include "BLI_hash_md5.h"
+#  include "BLI_task.h"
+#  include "marshal.h"
+
+#  include "CM_Message.h"
+
+/// Marshal version without references, the bytes of a value don't depend on its users.
+#  define MARSHAL_VERSION 2
+#  define COMPRESSION_LEVEL 3
+/// Number of delta snapshots after which a full snapshot is written.
+#  define MAX_DELTAS 32
+/// Largest raw to compressed size ratio of a zstd frame, reached with RLE blocks.
+#  define MAX_COMPRESSION_RATIO 32768
+/// Largest raw size of a snapshot, far above any sensible globalDict.
+#  define MAX_RAW_SIZE ((uint64_t)1 << 30)
+/// Largest zstd frame header, ZSTD_FRAMEHEADERSIZE_MAX is only defined for static linking.
+#  define MAX_FRAME_HEADER_SIZE 18
+
+static const char SNAPSHOT_MAGIC[4] = {'B', 'G', 'E', 'D'};
+
+enum SnapshotType : uint32_t { SNAPSHOT_FULL = 0, SNAPSHOT_DELTA };
+
+enum EntryType : uint8_t { ENTRY_SET = 0, ENTRY_REMOVE };
+
+/** Header of a snapshot, followed by its zstd compressed entries. An entry is its type, the
+ * size and marshal data of the key and for ENTRY_SET the size and marshal data of the value.
+ */
+struct SnapshotHeader {
+  char magic[4];
+  uint32_t type;
+  uint64_t rawSize;
+  uint64_t compressedSize;
+};
+
+/// Return true if the sizes of a snapshot header at offset match the file and the zstd frame.
+static bool snapshot_sizes_valid(FILE *file,
+                                 const SnapshotHeader &header,
+                                 size_t offset,
+                                 size_t fileSize)
+{
+  if (header.rawSize == 0) {
+    return true;
+  }
+
+  const size_t dataOffset = offset + sizeof(header);
+  if (header.compressedSize == 0 || dataOffset > fileSize ||
+      header.compressedSize > fileSize - dataOffset || header.rawSize > MAX_RAW_SIZE ||
+      header.rawSize / MAX_COMPRESSION_RATIO > header.compressedSize)
+  {
+    return false;
+  }
+
+  // The saved frames don't store their content size, but check it when present.
+  char frameHeader[MAX_FRAME_HEADER_SIZE];
+  const size_t frameHeaderSize = std::min<uint64_t>(sizeof(frameHeader), header.compressedSize);
+  if (fseek(file, dataOffset, SEEK_SET) != 0 ||
+      fread(frameHeader, 1, frameHeaderSize, file) != frameHeaderSize)
+  {
+    return false;
+  }
+
+  const unsigned long long contentSize = ZSTD_getFrameContentSize(frameHeader, frameHeaderSize);
+  return (contentSize == ZSTD_CONTENTSIZE_UNKNOWN || contentSize == header.rawSize);
+}
+
+static void append_data(std::vector<char> &buffer, const void *data, size_t size)
+{
+  const char *cdata = (const char *)data;
+  buffer.insert(buffer.end(), cdata, cdata + size);
+}
+
+static void append_bytes(std::vector<char> &buffer, PyObject *bytes)
+{
+  const uint32_t size = PyBytes_GET_SIZE(bytes);
+  append_data(buffer, &size, sizeof(size));
+  append_data(buffer, PyBytes_AS_STRING(bytes), size);
+}
+
+/// Read a sized block of data, return false when it overflows the buffer.
+static bool read_block(const char *&data, const char *end, const char *&block, uint32_t &size)
+{
+  if (end - data < (ptrdiff_t)sizeof(size)) {
+    return false;
+  }
+  memcpy(&size, data, sizeof(size));
+  data += sizeof(size);
+  if ((uint64_t)(end - data) < size) {
+    return false;
+  }
+  block = data;
+  data += size;
+  return true;
+}
+
+static std::string value_digest(const char *data, size_t size)
+{
+  char digest[16];
+  BLI_hash_md5_buffer(data, size, digest);
+  return std::string(digest, sizeof(digest));
+}
+
+KX_GlobalDictStorage::KX_GlobalDictStorage()
+    : m_hasBase(false),
+      m_numDeltas(0),
+      m_pool(nullptr),
+      m_finished(false),
+      m_success(false),
+      m_fullSnapshot(true),
+      m_callback(nullptr)
+{
+}
+
+KX_GlobalDictStorage::~KX_GlobalDictStorage()
+{
+  Finish();
+  if (m_pool) {
+    BLI_task_pool_free(m_pool);
+  }
+}
+
+bool KX_GlobalDictStorage::Serialize(PyObject *dict, bool delta, bool &empty)
+{
+  m_buffer.clear();
+  empty = true;
+
+  std::map<std::string, std::string> digests;
+  PyObject *key;
+  PyObject *value;
+  Py_ssize_t pos = 0;
+  while (PyDict_Next(dict, &pos, &key, &value)) {
+    PyObject *keyData = PyMarshal_WriteObjectToString(key, MARSHAL_VERSION);
+    PyObject *valueData = keyData ? PyMarshal_WriteObjectToString(value, MARSHAL_VERSION) :
+                                    nullptr;
+    if (!valueData) {
+      Py_XDECREF(keyData);
+      PyErr_Print();
+      PyErr_Clear();
+      return false;
+    }
+
+    const std::string keyStr(PyBytes_AS_STRING(keyData), PyBytes_GET_SIZE(keyData));
+    const std::string digest = value_digest(PyBytes_AS_STRING(valueData),
+                                            PyBytes_GET_SIZE(valueData));
+
+    const auto it = m_digests.find(keyStr);
+    if (!delta || it == m_digests.end() || it->second != digest) {
+      const EntryType type = ENTRY_SET;
+      append_data(m_buffer, &type, sizeof(type));
+      append_bytes(m_buffer, keyData);
+      append_bytes(m_buffer, valueData);
+      empty = false;
+    }
+    digests.emplace(keyStr, digest);
+
+    Py_DECREF(keyData);
+    Py_DECREF(valueData);
+  }
+
+  if (delta) {
+    for (const auto &item : m_digests) {
+      if (digests.find(item.first) == digests.end()) {
+        const EntryType type = ENTRY_REMOVE;
+        const uint32_t size = item.first.size();
+        append_data(m_buffer, &type, sizeof(type));
+        append_data(m_buffer, &size, sizeof(size));
+        append_data(m_buffer, item.first.data(), size);
+        empty = false;
+      }
+    }
+  }
+
+  m_digests.swap(digests);
+
+  return true;
+}
+
+bool KX_GlobalDictStorage::Write()
+{
+  // A full snapshot replaces the file once completely written, a delta is appended.
+  const std::string tmpPath = m_path + ".tmp";
+  FILE *file = m_fullSnapshot ? BLI_fopen(tmpPath.c_str(), "wb") :
+                                BLI_fopen(m_path.c_str(), "r+b");
+  if (!file) {
+    CM_Error("could not open '" << (m_fullSnapshot ? tmpPath : m_path) << "'");
+    return false;
+  }
+
+  fseek(file, 0, SEEK_END);
+  const long offset = ftell(file);
+
+  SnapshotHeader header;
+  memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+  header.type = m_fullSnapshot ? SNAPSHOT_FULL : SNAPSHOT_DELTA;
+  header.rawSize = m_buffer.size();
+  header.compressedSize = 0;
+
+  bool written = (offset != -1 && fwrite(&header, sizeof(header), 1, file) == 1);
+  if (written && !m_buffer.empty()) {
+    header.compressedSize = BLI_file_zstd_from_mem_at_pos(
+        m_buffer.data(), m_buffer.size(), file, offset + sizeof(header), COMPRESSION_LEVEL);
+    // Patch the header with the size of the compressed entries.
+    written = header.compressedSize != 0 && fseek(file, offset, SEEK_SET) == 0 &&
+              fwrite(&header, sizeof(header), 1, file) == 1;
+  }
+  written = (fclose(file) == 0) && written;
+
+  if (m_fullSnapshot) {
+    if (!written || BLI_rename_overwrite(tmpPath.c_str(), m_path.c_str()) != 0) {
+      BLI_delete(tmpPath.c_str(), false, false);
+      written = false;
+    }
+  }
+
+  if (!written) {
+    CM_Error("could not write globalDict snapshot to '" << m_path << "'");
+  }
+
+  return written;
+}
+
+void KX_GlobalDictStorage::SaveTaskFunc(TaskPool *__restrict pool, void *taskdata)
+{
+  KX_GlobalDictStorage *storage = static_cast<KX_GlobalDictStorage *>(taskdata);
+  const bool success = storage->Write();
+
+  storage->m_mutex.Lock();
+  storage->m_success = success;
+  storage->m_finished = true;
+  storage->m_mutex.Unlock();
+}
+
+void KX_GlobalDictStorage::Complete()
+{
+  m_finished = false;
+  // The file doesn't match the digests anymore, the next save must be a full snapshot.
+  if (!m_success) {
+    m_hasBase = false;
+  }
+
+  if (m_callback) {
+    PyObject *callback = m_callback;
+    m_callback = nullptr;
+
+    PyObject *args = Py_BuildValue("(O)", m_success ? Py_True : Py_False);
+    if (!PyObject_Call(callback, args, nullptr)) {
+      PyErr_Print();
+      PyErr_Clear();
+    }
+    Py_DECREF(args);
+    Py_DECREF(callback);
+  }
+}
+
+void KX_GlobalDictStorage::Finish()
+{
+  if (m_pool) {
+    BLI_task_pool_work_and_wait(m_pool);
+  }
+
+  if (m_finished) {
+    Complete();
+  }
+}
+
+bool KX_GlobalDictStorage::Save(
+    PyObject *dict, const std::string &path, bool delta, bool asynchronous, PyObject *callback)
+{
+  // The buffer is used by the previous save until it is written.
+  Finish();
+
+  if (path != m_path) {
+    m_path = path;
+    m_hasBase = false;
+  }
+
+  m_fullSnapshot = !delta || !m_hasBase || m_numDeltas >= MAX_DELTAS ||
+                   !BLI_exists(m_path.c_str());
+
+  bool empty;
+  if (!Serialize(dict, !m_fullSnapshot, empty)) {
+    CM_Error("bge.logic.globalDict could not be marshal'd");
+    m_hasBase = false;
+    return false;
+  }
+
+  m_hasBase = true;
+
+  Py_XINCREF(callback);
+  m_callback = callback;
+
+  // Nothing changed since the previous save.
+  if (empty && !m_fullSnapshot) {
+    m_success = true;
+    m_finished = true;
+    Complete();
+    return true;
+  }
+
+  m_numDeltas = m_fullSnapshot ? 0 : m_numDeltas + 1;
+
+  if (asynchronous) {
+    if (!m_pool) {
+      m_pool = BLI_task_pool_create(nullptr, TASK_PRIORITY_LOW);
+    }
+    BLI_task_pool_push(m_pool, SaveTaskFunc, this, false, nullptr);
+    return true;
+  }
+
+  m_success = Write();
+  m_finished = true;
+  Complete();
+
+  return m_success;
+}
+
+bool KX_GlobalDictStorage::Load(PyObject *dict, const std::string &path)
+{
+  // The file may still be written by a background save.
+  Finish();
+
+  FILE *file = BLI_fopen(path.c_str(), "rb");
+  if (!file) {
+    return false;
+  }
+
+  const size_t fileSize = BLI_file_size(path.c_str());
+  SnapshotHeader header;
+  if (fread(&header, sizeof(header), 1, file) != 1 ||
+      memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0)
+  {
+    fclose(file);
+    return false;
+  }
+
+  PyObject *items = PyDict_New();
+  std::map<std::string, std::string> digests;
+  unsigned int numDeltas = 0;
+  bool valid = true;
+
+  for (long offset = 0;;) {
+    if (memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0 ||
+        !snapshot_sizes_valid(file, header, offset, fileSize))
+    {
+      valid = false;
+      break;
+    }
+
+    try {
+      m_buffer.resize(header.rawSize);
+    }
+    catch (const std::bad_alloc &) {
+      valid = false;
+      break;
+    }
+    if (header.rawSize != 0 && BLI_file_unzstd_to_mem_at_pos(m_buffer.data(),
+                                                             m_buffer.size(),
+                                                             file,
+                                                             offset + sizeof(header)) !=
+                                   header.rawSize)
+    {
+      valid = false;
+      break;
+    }
+
+    if (header.type == SNAPSHOT_FULL) {
+      PyDict_Clear(items);
+      digests.clear();
+      numDeltas = 0;
+    }
+    else {
+      ++numDeltas;
+    }
+
+    const char *data = m_buffer.data();
+    const char *end = data + m_buffer.size();
+    while (valid && data < end) {
+      const EntryType type = (EntryType)*data++;
+      const char *keyData;
+      uint32_t keySize;
+      if (!read_block(data, end, keyData, keySize)) {
+        valid = false;
+        break;
+      }
+
+      PyObject *key = PyMarshal_ReadObjectFromString(keyData, keySize);
+      if (!key) {
+        PyErr_Clear();
+        valid = false;
+        break;
+      }
+
+      const std::string keyStr(keyData, keySize);
+      if (type == ENTRY_SET) {
+        const char *valueData;
+        uint32_t valueSize;
+        PyObject *value = read_block(data, end, valueData, valueSize) ?
+                              PyMarshal_ReadObjectFromString(valueData, valueSize) :
+                              nullptr;
+        if (value && PyDict_SetItem(items, key, value) == 0) {
+          digests[keyStr] = value_digest(valueData, valueSize);
+        }
+        else {
+          PyErr_Clear();
+          valid = false;
+        }
+        Py_XDECREF(value);
+      }
+      else {
+        if (PyDict_DelItem(items, key) != 0) {
+          PyErr_Clear();
+        }
+        digests.erase(keyStr);
+      }
+      Py_DECREF(key);
+    }
+
+    if (!valid) {
+      break;
+    }
+
+    offset += sizeof(header) + header.compressedSize;
+    if (fseek(file, offset, SEEK_SET) != 0 || fread(&header, sizeof(header), 1, file) != 1) {
+      break;
+    }
+  }
+
+  fclose(file);
+
+  if (!valid) {
+    CM_Warning("the globalDict file '" << path << "' is truncated or corrupted, "
+                                       << "only the valid snapshots are loaded");
+  }
+
+  PyDict_Clear(dict);
+  PyDict_Update(dict, items);
+  Py_DECREF(items);
+
+  // A corrupted file is replaced by the next save.
+  m_path = path;
+  m_digests.swap(digests);
+  m_hasBase = valid;
+  m_numDeltas = numDeltas;
+
+  return true;
+}
+
+void KX_GlobalDictStorage::Update()
+{
+  m_mutex.Lock();
+  const bool finished = m_finished;
+  m_mutex.Unlock();
+
+  if (finished) {
+    Complete();
+  }
+}
+
+#endif  // WITH_PYTHON
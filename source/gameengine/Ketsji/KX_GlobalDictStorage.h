@@ -0,0 +1,108 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file KX_GlobalDictStorage.h
+ *  \ingroup ketsji
+ */
+
+#pragma once
+
+#ifdef WITH_PYTHON
+
+#  include <map>
+#  include <string>
+#  include <vector>
+
+#  include "CM_Thread.h"
+#  include "EXP_Python.h"
+
+struct TaskPool;
+
+/** Save and load bge.logic.globalDict as a file of zstd compressed snapshots.
+ * A full snapshot holds every item of the dictionary, a delta snapshot appended to the file
+ * holds only the items changed or removed since the previous save or load. The dictionary is
+ * serialized on the game thread into a reused buffer, the compression and the file writing
+ * can be done by a background task which completion is reported to a Python callback from
+ * Update.
+ */
+class KX_GlobalDictStorage {
+ private:
+  /// Serialized items of the snapshot being saved or loaded.
+  std::vector<char> m_buffer;
+  /// Digest of the serialized value per serialized key, as saved or loaded in the file.
+  std::map<std::string, std::string> m_digests;
+  /// True when m_digests matches the content of the file at m_path.
+  bool m_hasBase;
+  /// Number of delta snapshots following the last full snapshot in the file.
+  unsigned int m_numDeltas;
+  std::string m_path;
+
+  /// Pool of the background save, created on first use.
+  TaskPool *m_pool;
+  /// Protect the result of the background save.
+  CM_ThreadMutex m_mutex;
+  /// True when the last save finished and its completion is not yet handled.
+  bool m_finished;
+  bool m_success;
+  /// True when m_buffer holds a full snapshot, false for a delta.
+  bool m_fullSnapshot;
+  /// Python callback of the pending save.
+  PyObject *m_callback;
+
+  /// Serialize the items of the dictionary in m_buffer, return false on marshal failure.
+  bool Serialize(PyObject *dict, bool delta, bool &empty);
+  /// Compress and write m_buffer to the file, call from any thread.
+  bool Write();
+  /// Handle the completion of the last save on the game thread and run its callback.
+  void Complete();
+  /// Wait for the background save and complete it.
+  void Finish();
+
+  static void SaveTaskFunc(TaskPool *__restrict pool, void *taskdata);
+
+ public:
+  KX_GlobalDictStorage();
+  ~KX_GlobalDictStorage();
+
+  /** Save a dictionary to a file.
+   * \param delta Append only the items changed since the previous save or load, a full
+   * snapshot is written instead when there is no previous save of this file or after too
+   * many deltas.
+   * \param asynchronous Compress and write the file from a background task.
+   * \param callback Python callable receiving the success of the save, can be nullptr.
+   */
+  bool Save(PyObject *dict,
+            const std::string &path,
+            bool delta,
+            bool asynchronous,
+            PyObject *callback);
+  /** Load a dictionary from a file, waiting for a pending save first.
+   * \return False when the file is not a snapshot file, for example a file in the previous
+   * single marshal format.
+   */
+  bool Load(PyObject *dict, const std::string &path);
+
+  /// Run the callback of a finished background save, called every frame.
+  void Update();
+};
+
+#endif  // WITH_PYTHON
@@ -91,6 +91,7 @@ void KX_RasterizerDrawDebugLine(const MT_Vector3 &from,
                                 const MT_Vector4 &color)
 {
   g_engine->GetRasterizer()->GetDebugDraw().DrawLine(from, to, color);
+  g_engine->RequestRender();
 }
 
 void KX_RasterizerDrawDebugCircle(const MT_Vector3 &center,
@@ -100,4 +101,5 @@ void KX_RasterizerDrawDebugCircle(const MT_Vector3 &center,
                                   int nsector)
 {
   g_engine->GetRasterizer()->GetDebugDraw().DrawCircle(center, radius, color, normal, nsector);
+  g_engine->RequestRender();
 }
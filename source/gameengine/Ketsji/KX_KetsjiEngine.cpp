@@ -41,8 +41,12 @@
 #include "DRW_render.h"
 #include "GPU_matrix.h"
 
+#include "BLI_task.h"
+
 #include "BL_Converter.h"
 #include "BL_SceneConverter.h"
+#include "CM_Message.h"
+#include "CM_Trace.h"
 #include "DEV_Joystick.h"  // for DEV_Joystick::HandleEvents
 #include "KX_Camera.h"
 #include "KX_Globals.h"
@@ -52,6 +56,7 @@
 #include "PHY_IPhysicsEnvironment.h"
 #include "RAS_ICanvas.h"
 #include "SCA_IInputDevice.h"
+#include "SCA_InputRecord.h"
 
 #define DEFAULT_LOGIC_TIC_RATE 60.0
 
@@ -99,17 +104,18 @@ KX_KetsjiEngine::FrameRenderData::FrameRenderData(RAS_Rasterizer::FrameBufferTyp
 }
 
 const std::string KX_KetsjiEngine::m_profileLabels[tc_numCategories] = {
-    "Physics:",     // tc_physics
-    "Logic:",       // tc_logic
-    "Animations:",  // tc_animations
-    "Depsgraph:",   // tc_depsgraph
-    "Network:",     // tc_network
-    "Scenegraph:",  // tc_scenegraph
-    "Rasterizer:",  // tc_rasterizer
-    "Services:",    // tc_services
-    "Overhead:",    // tc_overhead
-    "Outside:",     // tc_outside
-    "GPU Latency:"  // tc_latency
+    "Physics:",      // tc_physics
+    "Logic:",        // tc_logic
+    "Animations:",   // tc_animations
+    "Depsgraph:",    // tc_depsgraph
+    "Network:",      // tc_network
+    "Scenegraph:",   // tc_scenegraph
+    "Rasterizer:",   // tc_rasterizer
+    "Services:",     // tc_services
+    "Overhead:",     // tc_overhead
+    "Outside:",      // tc_outside
+    "GPU Latency:",  // tc_latency
+    "Sleep:"         // tc_sleep
 };
 
 /**
@@ -139,6 +145,9 @@ KX_KetsjiEngine::KX_KetsjiEngine(KX_ISystem *system,
       m_ticrate(DEFAULT_LOGIC_TIC_RATE),
       m_anim_framerate(25.0),
       m_doRender(true),
+      m_framePacing(KX_FramePacer::PACING_CAPPED),
+      m_renderRequested(true),
+      m_inputRecord(nullptr),
       m_exitkey(130),
       m_exitcode(KX_ExitRequest::NO_REQUEST),
       m_exitstring(""),
@@ -161,6 +170,8 @@ KX_KetsjiEngine::KX_KetsjiEngine(KX_ISystem *system,
 
   m_scenes = new EXP_ListValue<KX_Scene>();
   m_renderingCameras = {};
+
+  m_scenesTaskPool = BLI_task_pool_create(nullptr, TASK_PRIORITY_HIGH);
 }
 
 /**
@@ -173,6 +184,8 @@ KX_KetsjiEngine::~KX_KetsjiEngine()
 #endif
 
   m_scenes->Release();
+
+  BLI_task_pool_free(m_scenesTaskPool);
 }
 
 /* EEVEE integration */
@@ -240,6 +253,41 @@ PyObject *KX_KetsjiEngine::GetPyProfileDict()
   Py_INCREF(m_pyprofiledict);
   return m_pyprofiledict;
 }
+
+PyObject *KX_KetsjiEngine::GetPySceneProfileDict()
+{
+  static const std::string labels[KX_Scene::tc_numCategories] = {
+      "Logic:",       // tc_logic
+      "Scenegraph:",  // tc_scenegraph
+      "Physics:"      // tc_physics
+  };
+
+  double tottime = m_logger.GetAverage();
+  if (tottime < 1e-6) {
+    tottime = 1e-6;
+  }
+
+  PyObject *dict = PyDict_New();
+  for (KX_Scene *scene : m_scenes) {
+    KX_TimeCategoryLogger &sceneLogger = scene->GetTimeLogger();
+    PyObject *scenedict = PyDict_New();
+
+    for (int i = 0; i < KX_Scene::tc_numCategories; ++i) {
+      const double time = sceneLogger.GetAverage(i);
+      PyObject *val = PyTuple_New(2);
+      PyTuple_SetItem(val, 0, PyFloat_FromDouble(time * 1000.0));
+      PyTuple_SetItem(val, 1, PyFloat_FromDouble(time / tottime * 100.0));
+
+      PyDict_SetItemString(scenedict, labels[i].c_str(), val);
+      Py_DECREF(val);
+    }
+
+    PyDict_SetItemString(dict, scene->GetName().c_str(), scenedict);
+    Py_DECREF(scenedict);
+  }
+
+  return dict;
+}
 #endif
 
 void KX_KetsjiEngine::SetConverter(BL_Converter *converter)
@@ -252,6 +300,7 @@ void KX_KetsjiEngine::StartEngine()
 {
   // Reset the clock to start at 0.0.
   m_clock.Reset();
+  m_renderRequested = true;
 
   m_bInitialized = true;
 }
@@ -295,12 +344,28 @@ void KX_KetsjiEngine::EndFrame()
     PyDict_SetItemString(m_pyprofiledict, m_profileLabels[i].c_str(), val);
     Py_DECREF(val);
   }
+
+  if (m_flags & FIXED_FRAMERATE) {
+    const double error = m_framePacer.GetAverageError();
+    PyObject *val = PyTuple_New(2);
+    PyTuple_SetItem(val, 0, PyFloat_FromDouble(error * 1000.0));
+    PyTuple_SetItem(val, 1, PyFloat_FromDouble(error * m_ticrate * 100.0));
+
+    PyDict_SetItemString(m_pyprofiledict, "Pacing Error:", val);
+    Py_DECREF(val);
+  }
 #endif
 
   m_average_framerate = 1.0 / tottime;
 
   // Go to next profiling measurement, time spent after this call is shown in the next frame.
   m_logger.NextMeasurement();
+  if (m_inputRecord && m_inputRecord->GetMode() == SCA_InputRecord::RECORD_READ) {
+    m_frameStatistics.AddFrame(m_logger, tc_numCategories);
+  }
+  for (KX_Scene *scene : m_scenes) {
+    scene->GetTimeLogger().NextMeasurement();
+  }
 
   m_logger.StartLog(tc_rasterizer);
   m_rasterizer->EndFrame();
@@ -340,12 +405,28 @@ void KX_KetsjiEngine::EndFrameViewportRender()
     PyDict_SetItemString(m_pyprofiledict, m_profileLabels[i].c_str(), val);
     Py_DECREF(val);
   }
+
+  if (m_flags & FIXED_FRAMERATE) {
+    const double error = m_framePacer.GetAverageError();
+    PyObject *val = PyTuple_New(2);
+    PyTuple_SetItem(val, 0, PyFloat_FromDouble(error * 1000.0));
+    PyTuple_SetItem(val, 1, PyFloat_FromDouble(error * m_ticrate * 100.0));
+
+    PyDict_SetItemString(m_pyprofiledict, "Pacing Error:", val);
+    Py_DECREF(val);
+  }
 #endif
 
   m_average_framerate = 1.0 / tottime;
 
   // Go to next profiling measurement, time spent after this call is shown in the next frame.
   m_logger.NextMeasurement();
+  if (m_inputRecord && m_inputRecord->GetMode() == SCA_InputRecord::RECORD_READ) {
+    m_frameStatistics.AddFrame(m_logger, tc_numCategories);
+  }
+  for (KX_Scene *scene : m_scenes) {
+    scene->GetTimeLogger().NextMeasurement();
+  }
 
   m_logger.StartLog(tc_rasterizer);
   // m_rasterizer->EndFrame();
@@ -388,7 +469,7 @@ KX_KetsjiEngine::FrameTimes KX_KetsjiEngine::GetFrameTimes()
   }
 
   // Get elapsed time.
-  const double dt = m_clockTime - m_previousRealTime;
+  double dt = m_clockTime - m_previousRealTime;
 
   // Time of a frame (without scale).
   double timestep;
@@ -401,6 +482,17 @@ KX_KetsjiEngine::FrameTimes KX_KetsjiEngine::GetFrameTimes()
     timestep = dt;
   }
 
+  /* In fixed framerate wait the next frame instead of returning zero frame to a main loop
+   * spinning on NextFrame, except to render in between the frames. */
+  if ((m_flags & FIXED_FRAMERATE) && !(m_flags & USE_EXTERNAL_CLOCK) && dt < timestep &&
+      m_framePacing != KX_FramePacer::PACING_UNCAPPED_RENDER)
+  {
+    m_logger.StartLog(tc_sleep);
+    m_clockTime = m_framePacer.WaitUntil(m_clock, m_previousRealTime + timestep);
+    m_logger.StartLog(tc_services);
+    dt = m_clockTime - m_previousRealTime;
+  }
+
   // Number of frames to proceed.
   int frames;
   if (m_flags & FIXED_FRAMERATE) {
@@ -414,25 +506,24 @@ KX_KetsjiEngine::FrameTimes KX_KetsjiEngine::GetFrameTimes()
 
   // Fix timestep to not exceed max physics and logic frames.
   int maxFrames = max_ii(m_maxLogicFrame, m_maxPhysicsFrame);
+  bool clamped = false;
   if (frames > maxFrames) {
     timestep = dt / maxFrames;
     frames = maxFrames;
+    clamped = true;
   }
 
-  // If the number of frame is non-zero, update previous time.
+  /* If the number of frame is non-zero, update previous time. In fixed framerate only the
+   * proceeded frames are consumed to not accumulate the remaining time as drift, unless the
+   * frames were clamped and the late time is dropped. */
   if (frames > 0) {
-    m_previousRealTime = m_clockTime;
-  }
-  //// Else in case of fixed framerate, try to sleep until the next frame.
-  // else if (m_flags & FIXED_FRAMERATE) {
-  //  const double sleeptime = timestep - dt - 1.0e-3;
-  //  /* If the remaining time is greather than 1ms (sleep resolution) sleep this thread.
-  //   * The other 1ms will be busy wait.
-  //   */
-  //  if (sleeptime > 0.0) {
-  //    std::this_thread::sleep_for(std::chrono::nanoseconds((long)(sleeptime * 1.0e9)));
-  //  }
-  //}
+    if ((m_flags & FIXED_FRAMERATE) && !clamped) {
+      m_previousRealTime += frames * timestep;
+    }
+    else {
+      m_previousRealTime = m_clockTime;
+    }
+  }
 
   // Frame time with time scale.
   const double framestep = timestep * m_timescale;
@@ -449,20 +540,45 @@ bool KX_KetsjiEngine::NextFrame()
 {
   m_logger.StartLog(tc_services);
 
+  const bool replay = (m_inputRecord &&
+                       m_inputRecord->GetMode() == SCA_InputRecord::RECORD_READ);
+  // Restore the recorded inputs and clock time in place of the live ones.
+  if (replay && !m_inputRecord->ReadFrame(m_inputDevice, m_clockTime)) {
+    CM_Message("Input replay finished after " << m_inputRecord->GetNumFrames() << " frames");
+    RequestExit(KX_ExitRequest::QUIT_GAME);
+    m_logger.StartLog(tc_outside);
+    return false;
+  }
+
   const FrameTimes times = GetFrameTimes();
 
-  // Exit if zero frame is sheduled.
+  // Record the inputs of the frames before they are consumed and cleared.
+  if (times.frames > 0 && m_inputRecord &&
+      m_inputRecord->GetMode() == SCA_InputRecord::RECORD_WRITE)
+  {
+    m_inputRecord->WriteFrame(m_inputDevice, m_clockTime);
+  }
+
+  // Exit if zero frame is sheduled, render again only in uncapped render pacing.
   if (times.frames == 0) {
     // Start logging time spent outside main loop
     m_logger.StartLog(tc_outside);
 
-    return false;
+    return (m_framePacing == KX_FramePacer::PACING_UNCAPPED_RENDER) && m_doRender &&
+           !(m_flags & HEADLESS);
   }
 
+  /* The traced frame spans from the previous frame with logic to this one, including the render
+   * when there is one. */
+  CM_Trace::EndFrame();
+
   for (unsigned short i = 0; i < times.frames; ++i) {
     m_frameTime += times.framestep;
 
     m_converter->MergeAsyncLoads();
+#ifdef WITH_PYTHON
+    updateGamePythonConfig();
+#endif
 
     m_inputDevice->ReleaseMoveEvent();
 
@@ -484,77 +600,190 @@ bool KX_KetsjiEngine::NextFrame()
     }
 #endif  // WITH_SDL
 
-    // for each scene, call the proceed functions
-    for (KX_Scene *scene : m_scenes) {
-      /* Suspension holds the physics and logic processing for an
-       * entire scene. Objects can be suspended individually, and
-       * the settings for that precede the logic and physics
-       * update. */
-      m_logger.StartLog(tc_logic);
-
-      if (i == 0) {  // No need to UpdateObjectActivity several times
-        scene->UpdateObjectActivity();
+    if ((m_flags & PARALLEL_SCENES) && CanProceedScenesInParallel()) {
+      ParallelScenes(times, (i == 0), (i == times.frames - 1));
+    }
+    else {
+      // for each scene, call the proceed functions
+      for (KX_Scene *scene : m_scenes) {
+        LogicScene(scene, times, (i == 0));
+        PhysicsScene(scene, times, (i == times.frames - 1), true);
       }
+    }
 
-      m_logger.StartLog(tc_physics);
+    m_logger.StartLog(tc_network);
+    m_networkMessageManager->ClearMessages();
 
-      // set Python hooks for each scene
-      KX_SetActiveScene(scene);
+    // update system devices
+    m_logger.StartLog(tc_logic);
+    m_inputDevice->ClearInputs();
 
-      // Process sensors, and controllers
-      m_logger.StartLog(tc_logic);
-      scene->LogicBeginFrame(m_frameTime, times.framestep);
+    // scene management
+    ProcessScheduledScenes();
+  }
 
-      // Scenegraph needs to be updated again, because Logic Controllers
-      // can affect the local matrices.
-      m_logger.StartLog(tc_scenegraph);
-      scene->UpdateParents(m_frameTime);
+  bool render = m_doRender && !(m_flags & HEADLESS);
+  if (m_framePacing == KX_FramePacer::PACING_RENDER_ON_CHANGE) {
+    bool changed = m_renderRequested;
+    for (KX_Scene *scene : m_scenes) {
+      changed = changed || scene->GetSceneChanged();
+      scene->SetSceneChanged(false);
+    }
+    render = render && changed;
+  }
+  m_renderRequested = false;
 
-      // Process actuators
+  // Without render the profiling measurement of the replayed frame is not ended by EndFrame.
+  if (replay && !render) {
+    m_logger.NextMeasurement();
+    m_frameStatistics.AddFrame(m_logger, tc_numCategories);
+  }
 
-      // Do some cleanup work for this logic frame
-      m_logger.StartLog(tc_logic);
-      scene->LogicUpdateFrame(m_frameTime);
+  // Start logging time spent outside main loop
+  m_logger.StartLog(tc_outside);
 
-      scene->LogicEndFrame();
+  return render;
+}
 
-      // Actuators can affect the scenegraph
-      m_logger.StartLog(tc_scenegraph);
-      scene->UpdateParents(m_frameTime);
+void KX_KetsjiEngine::LogicScene(KX_Scene *scene, const FrameTimes &times, bool firstFrame)
+{
+  CM_TRACE_SCOPE("logic", scene->GetName());
 
-      m_logger.StartLog(tc_physics);
+  KX_TimeCategoryLogger &sceneLogger = scene->GetTimeLogger();
 
-      // Perform physics calculations on the scene. This can involve
-      // many iterations of the physics solver.
-      scene->GetPhysicsEnvironment()->ProceedDeltaTime(
-          m_frameTime, times.timestep, times.framestep);  // m_deltatimerealDeltaTime);
+  /* Suspension holds the physics and logic processing for an
+   * entire scene. Objects can be suspended individually, and
+   * the settings for that precede the logic and physics
+   * update. */
+  m_logger.StartLog(tc_logic);
+  sceneLogger.StartLog(KX_Scene::tc_logic);
 
-      /* No need to call sofbody update more than 1 time */
-      if (i == times.frames - 1) {
-        scene->GetPhysicsEnvironment()->UpdateSoftBodies();
-      }
+  if (firstFrame) {  // No need to UpdateObjectActivity several times
+    scene->UpdateObjectActivity();
+  }
+
+  m_logger.StartLog(tc_physics);
+
+  // set Python hooks for each scene
+  KX_SetActiveScene(scene);
+
+  // Process sensors, and controllers
+  m_logger.StartLog(tc_logic);
+  scene->LogicBeginFrame(m_frameTime, times.framestep);
+
+  // Scenegraph needs to be updated again, because Logic Controllers
+  // can affect the local matrices.
+  m_logger.StartLog(tc_scenegraph);
+  sceneLogger.StartLog(KX_Scene::tc_scenegraph);
+  scene->UpdateParents(m_frameTime);
+
+  // Process actuators
+
+  // Do some cleanup work for this logic frame
+  m_logger.StartLog(tc_logic);
+  sceneLogger.StartLog(KX_Scene::tc_logic);
+  scene->LogicUpdateFrame(m_frameTime);
+
+  scene->LogicEndFrame();
+
+  sceneLogger.EndLog();
+}
+
+void KX_KetsjiEngine::PhysicsScene(KX_Scene *scene,
+                                   const FrameTimes &times,
+                                   bool lastFrame,
+                                   bool mainThread)
+{
+  CM_TRACE_SCOPE("physics", scene->GetName());
+
+  KX_TimeCategoryLogger &sceneLogger = scene->GetTimeLogger();
+
+  // Actuators can affect the scenegraph
+  if (mainThread) {
+    m_logger.StartLog(tc_scenegraph);
+  }
+  sceneLogger.StartLog(KX_Scene::tc_scenegraph);
+  scene->UpdateParents(m_frameTime);
 
-      m_logger.StartLog(tc_scenegraph);
-      scene->UpdateParents(m_frameTime);
+  if (mainThread) {
+    m_logger.StartLog(tc_physics);
+  }
+  sceneLogger.StartLog(KX_Scene::tc_physics);
+
+  // Perform physics calculations on the scene. This can involve
+  // many iterations of the physics solver.
+  scene->GetPhysicsEnvironment()->ProceedDeltaTime(
+      m_frameTime, times.timestep, times.framestep);  // m_deltatimerealDeltaTime);
+
+  /* No need to call sofbody update more than 1 time */
+  if (lastFrame) {
+    scene->GetPhysicsEnvironment()->UpdateSoftBodies();
+  }
+
+  if (mainThread) {
+    m_logger.StartLog(tc_scenegraph);
+  }
+  sceneLogger.StartLog(KX_Scene::tc_scenegraph);
+  scene->UpdateParents(m_frameTime);
 
-      m_logger.StartLog(tc_services);
+  if (mainThread) {
+    m_logger.StartLog(tc_services);
+  }
+  sceneLogger.EndLog();
+}
+
+void KX_KetsjiEngine::PhysicsSceneTaskFunc(TaskPool *__restrict /*pool*/, void *taskdata)
+{
+  SceneTaskData *data = (SceneTaskData *)taskdata;
+  data->m_engine->PhysicsScene(data->m_scene, *data->m_times, data->m_lastFrame, false);
+}
+
+bool KX_KetsjiEngine::CanProceedScenesInParallel() const
+{
+  for (KX_Scene *scene : m_scenes) {
+    if (scene->HasPythonLogic()) {
+      return false;
     }
+  }
 
-    m_logger.StartLog(tc_network);
-    m_networkMessageManager->ClearMessages();
+  return true;
+}
 
-    // update system devices
-    m_logger.StartLog(tc_logic);
-    m_inputDevice->ClearInputs();
+void KX_KetsjiEngine::ParallelScenes(const FrameTimes &times, bool firstFrame, bool lastFrame)
+{
+  /* The scenes are processed in the same order as serially: the logic of a scene first and
+   * then its scenegraph and physics. Sensors, controllers and actuators are processed on the
+   * main thread while the scenegraph and physics of the previous scenes are updated in tasks,
+   * python is never used, see CanProceedScenesInParallel. A scene whose physics environment
+   * can't be stepped at the same time as the running tasks (e.g sharing global state with
+   * different settings) waits for them to finish. */
+  std::vector<SceneTaskData> tasksData;
+  tasksData.reserve(m_scenes->GetCount());
+  // Index of the first task still running.
+  unsigned int firstRunning = 0;
 
-    // scene management
-    ProcessScheduledScenes();
+  for (KX_Scene *scene : m_scenes) {
+    LogicScene(scene, times, firstFrame);
+
+    PHY_IPhysicsEnvironment *physEnv = scene->GetPhysicsEnvironment();
+    for (unsigned int i = firstRunning, size = tasksData.size(); i < size; ++i) {
+      if (!physEnv->CanProceedConcurrently(tasksData[i].m_scene->GetPhysicsEnvironment())) {
+        m_logger.StartLog(tc_physics);
+        BLI_task_pool_work_and_wait(m_scenesTaskPool);
+        firstRunning = size;
+        break;
+      }
+    }
+
+    physEnv->ApplyGlobalSettings();
+    tasksData.push_back({this, scene, &times, lastFrame});
+    BLI_task_pool_push(m_scenesTaskPool, PhysicsSceneTaskFunc, &tasksData.back(), false, nullptr);
   }
 
-  // Start logging time spent outside main loop
-  m_logger.StartLog(tc_outside);
+  m_logger.StartLog(tc_physics);
+  BLI_task_pool_work_and_wait(m_scenesTaskPool);
 
-  return m_doRender;
+  m_logger.StartLog(tc_services);
 }
 
 KX_KetsjiEngine::CameraRenderData KX_KetsjiEngine::GetCameraRenderData(
@@ -740,6 +969,8 @@ bool KX_KetsjiEngine::GetFrameRenderData(std::vector<FrameRenderData> &frameData
 
 void KX_KetsjiEngine::Render()
 {
+  CM_TraceScope traceScope("render", "Render");
+
   m_logger.StartLog(tc_rasterizer);
 
   BeginFrame();
@@ -799,6 +1030,9 @@ void KX_KetsjiEngine::Render()
   else {
     EndFrameViewportRender();
   }
+
+  // The changes made while rendering, e.g by the shader callbacks, are part of this frame.
+  m_renderRequested = false;
 }
 
 void KX_KetsjiEngine::RequestExit(KX_ExitRequest exitrequestmode)
@@ -1103,6 +1337,10 @@ void KX_KetsjiEngine::StopEngine()
 
     // cleanup all the stuff
     m_rasterizer->Exit();
+
+    if (m_inputRecord && m_inputRecord->GetMode() == SCA_InputRecord::RECORD_READ) {
+      m_frameStatistics.Print(m_profileLabels);
+    }
   }
 }
 
@@ -1112,6 +1350,7 @@ void KX_KetsjiEngine::AddScene(KX_Scene *scene)
 {
   m_scenes->Add(CM_AddRef(scene));
   PostProcessScene(scene);
+  m_renderRequested = true;
 }
 
 void KX_KetsjiEngine::PostProcessScene(KX_Scene *scene)
@@ -1258,6 +1497,16 @@ void KX_KetsjiEngine::RenderDebugProperties()
           MT_Vector2(xcoord + (int)(2.2 * profile_indent), ycoord), boxSize, white);
       ycoord += const_ysize;
     }
+
+    // Average delay of the fixed frames after their target time.
+    if (m_flags & FIXED_FRAMERATE) {
+      debugDraw.RenderText2D("Pacing Error:", MT_Vector2(xcoord + const_xindent, ycoord), white);
+
+      debugtxt = (boost::format("%5.2fms") % (m_framePacer.GetAverageError() * 1000.0)).str();
+      debugDraw.RenderText2D(
+          debugtxt, MT_Vector2(xcoord + const_xindent + profile_indent, ycoord), white);
+      ycoord += const_ysize;
+    }
   }
   // Add the ymargin for titles below the other section of debug info
   ycoord += title_y_top_margin;
@@ -1492,6 +1741,9 @@ void KX_KetsjiEngine::SetFlag(FlagType flag, bool enable)
   else {
     m_flags = (FlagType)(m_flags & ~flag);
   }
+
+  // Most flags change the rendered frame, e.g the framerate or profile display.
+  m_renderRequested = true;
 }
 
 double KX_KetsjiEngine::GetClockTime(void) const
@@ -1544,6 +1796,30 @@ bool KX_KetsjiEngine::GetRender()
   return m_doRender;
 }
 
+void KX_KetsjiEngine::SetFramePacing(KX_FramePacer::Mode mode)
+{
+  m_framePacing = mode;
+  m_renderRequested = true;
+}
+
+KX_FramePacer::Mode KX_KetsjiEngine::GetFramePacing() const
+{
+  return m_framePacing;
+}
+
+void KX_KetsjiEngine::RequestRender()
+{
+  m_renderRequested = true;
+}
+
+void KX_KetsjiEngine::SetInputRecord(SCA_InputRecord *record)
+{
+  m_inputRecord = record;
+  if (m_inputRecord && m_inputRecord->GetMode() == SCA_InputRecord::RECORD_READ) {
+    SetFlag(USE_EXTERNAL_CLOCK, true);
+  }
+}
+
 void KX_KetsjiEngine::ProcessScheduledScenes(void)
 {
   // Check whether there will be changes to the list of scenes
@@ -1552,6 +1828,7 @@ void KX_KetsjiEngine::ProcessScheduledScenes(void)
     // Change the scene list
     ReplaceScheduledScenes();
     RemoveScheduledScenes();
+    m_renderRequested = true;
   }
 }
 
@@ -1597,6 +1874,8 @@ KX_DebugOption KX_KetsjiEngine::GetShowShadowFrustum() const
 
 void KX_KetsjiEngine::Resize()
 {
+  m_renderRequested = true;
+
   /* extended mode needs to recalculate camera frusta when */
   KX_Scene *firstscene = m_scenes->GetFront();
   const RAS_FrameSettings &framesettings = firstscene->GetFramingType();
@@ -37,6 +37,8 @@
 
 #include "CM_Clock.h"
 #include "EXP_Python.h"
+#include "KX_FramePacer.h"
+#include "KX_FrameStatistics.h"
 #include "KX_ISystem.h"
 #include "KX_Scene.h"
 #include "KX_TimeCategoryLogger.h"
@@ -50,6 +52,8 @@ class KX_NetworkMessageManager;
 class RAS_ICanvas;
 class RAS_FrameBuffer;
 class SCA_IInputDevice;
+class SCA_InputRecord;
+struct TaskPool;
 
 enum class KX_ExitRequest {
   NO_REQUEST = 0,
@@ -90,7 +94,11 @@ class KX_KetsjiEngine {
     /// Automatic add debug properties to the debug list.
     AUTO_ADD_DEBUG_PROPERTIES = (1 << 6),
     /// Use override camera?
-    CAMERA_OVERRIDE = (1 << 7)
+    CAMERA_OVERRIDE = (1 << 7),
+    /// Update scenegraph and physics of the scenes in parallel of the logic of the next scenes?
+    PARALLEL_SCENES = (1 << 8),
+    /// Run logic and physics without any window or render (dedicated server)?
+    HEADLESS = (1 << 9)
   };
 
  private:
@@ -154,6 +162,17 @@ class KX_KetsjiEngine {
     double framestep;
   };
 
+  /// Data used to update the scenegraph and physics of a scene in a task.
+  struct SceneTaskData {
+    KX_KetsjiEngine *m_engine;
+    KX_Scene *m_scene;
+    const FrameTimes *m_times;
+    bool m_lastFrame;
+  };
+
+  /// Task pool used to update the scenes in parallel.
+  TaskPool *m_scenesTaskPool;
+
   CM_Clock m_clock;
 
   /// Lists of scenes scheduled to be removed at the end of the frame.
@@ -190,6 +209,17 @@ class KX_KetsjiEngine {
 
   bool m_doRender; /* whether or not the scene should be rendered after the logic frame */
 
+  /// Sleep between the fixed frames.
+  KX_FramePacer m_framePacer;
+  KX_FramePacer::Mode m_framePacing;
+  /// Render the next frame in render on change pacing even if the scenes didn't change.
+  bool m_renderRequested;
+
+  /// Input record written or replayed each frame, nullptr when disabled.
+  SCA_InputRecord *m_inputRecord;
+  /// Time of each frame during a replay.
+  KX_FrameStatistics m_frameStatistics;
+
   /// Key used to exit the BGE
   short m_exitkey;
 
@@ -219,6 +249,7 @@ class KX_KetsjiEngine {
     tc_overhead,  // profile info drawing overhead
     tc_outside,   // time spent outside main loop
     tc_latency,   // time spent waiting on the gpu
+    tc_sleep,     // time spent waiting for the next fixed frame
     tc_numCategories
   } KX_TimeCategory;
 
@@ -285,6 +316,22 @@ class KX_KetsjiEngine {
   void BeginFrame();
   FrameTimes GetFrameTimes();
 
+  /// Process logic and python of a scene, it must always be called from the main thread.
+  void LogicScene(KX_Scene *scene, const FrameTimes &times, bool firstFrame);
+  /** Update scenegraph and physics of a scene.
+   * \param mainThread True when the engine time logger can be used.
+   */
+  void PhysicsScene(KX_Scene *scene, const FrameTimes &times, bool lastFrame, bool mainThread);
+  static void PhysicsSceneTaskFunc(TaskPool *__restrict pool, void *taskdata);
+  /** Return true when no scene can run python. Python can access the objects of any scene,
+   * it must not run while the scenegraph and physics of other scenes are updated in tasks.
+   */
+  bool CanProceedScenesInParallel() const;
+  /** Process the logic of each scene on the main thread and then update its scenegraph and
+   * physics in a task, running while the logic of the next scenes is processed.
+   */
+  void ParallelScenes(const FrameTimes &times, bool firstFrame, bool lastFrame);
+
  public:
   KX_KetsjiEngine(KX_ISystem *system,
                   struct bContext *C,
@@ -316,6 +363,8 @@ class KX_KetsjiEngine {
   void SetNetworkMessageManager(KX_NetworkMessageManager *manager);
 #ifdef WITH_PYTHON
   PyObject *GetPyProfileDict();
+  /// Return a dictionary of the profiling information per scene.
+  PyObject *GetPySceneProfileDict();
 #endif
   void SetConverter(BL_Converter *converter);
   BL_Converter *GetConverter()
@@ -468,6 +517,19 @@ class KX_KetsjiEngine {
    */
   bool GetRender();
 
+  /// Set how the fixed frames are waited and rendered.
+  void SetFramePacing(KX_FramePacer::Mode mode);
+  KX_FramePacer::Mode GetFramePacing() const;
+  /** Render the next frame in render on change pacing, for the changes made outside of the
+   * scene graph like materials, texts, 2D filters or debug drawings. */
+  void RequestRender();
+
+  /** Set the input record written with the clock time of each frame, or replayed in place of
+   * the live inputs and clock. A replay uses the external clock and prints the frame time
+   * statistics when the engine stops.
+   */
+  void SetInputRecord(SCA_InputRecord *record);
+
   /// Allow debug bounding box debug.
   void SetShowBoundingBox(KX_DebugOption mode);
   /// Returns the current setting for bounding box debug.
@@ -105,6 +105,11 @@ class KX_KetsjiEngine *KX_LibLoadStatus::GetEngine()
   return m_engine;
 }
 
+const std::string &KX_LibLoadStatus::GetLibraryName() const
+{
+  return m_libname;
+}
+
 class KX_Scene *KX_LibLoadStatus::GetMergeScene()
 {
   return m_mergescene;
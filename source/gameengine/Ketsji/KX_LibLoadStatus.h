@@ -60,6 +60,7 @@ class KX_LibLoadStatus : public EXP_PyObjectPlus {
   class BL_Converter *GetConverter();
   class KX_KetsjiEngine *GetEngine();
   class KX_Scene *GetMergeScene();
+  const std::string &GetLibraryName() const;
 
   void SetData(void *data);
   void *GetData();
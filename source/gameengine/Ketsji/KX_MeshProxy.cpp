@@ -93,6 +93,8 @@ PyMethodDef KX_MeshProxy::Methods[] = {
     {"transform", (PyCFunction)KX_MeshProxy::sPyTransform, METH_VARARGS},
     {"transformUV", (PyCFunction)KX_MeshProxy::sPyTransformUV, METH_VARARGS},
     {"replaceMaterial", (PyCFunction)KX_MeshProxy::sPyReplaceMaterial, METH_VARARGS},
+    {"getVertexArrays", (PyCFunction)KX_MeshProxy::sPyGetVertexArrays, METH_VARARGS},
+    {"markModified", (PyCFunction)KX_MeshProxy::sPyMarkModified, METH_VARARGS},
     {nullptr, nullptr}  // Sentinel
 };
 
@@ -380,6 +382,293 @@ PyObject *KX_MeshProxy::PyReplaceMaterial(PyObject *args, PyObject *kwds)
   Py_RETURN_NONE;
 }
 
+/** Python object exporting a buffer over an attribute of a display array. Unlike a memoryview
+ * it checks on each export that the storage of the array still exists.
+ */
+struct KX_MeshArrayExporter {
+  PyObject_HEAD
+  /// The mesh proxy, kept alive with the exporter.
+  PyObject *mesh;
+  RAS_IDisplayArray *array;
+  /// Export state of the array storage the exporter was created on.
+  std::shared_ptr<RAS_IDisplayArray::StorageExport> *storage;
+  /// True to export the indices instead of the vertices.
+  bool indices;
+  intptr_t offset;
+  const char *format;
+  Py_ssize_t itemsize;
+  int ndim;
+  Py_ssize_t shape[3];
+  Py_ssize_t strides[3];
+  bool readonly;
+};
+
+static int mesh_array_exporter_getbuffer(KX_MeshArrayExporter *self, Py_buffer *view, int flags)
+{
+  RAS_IDisplayArray::StorageExport &storage = **self->storage;
+  if (!storage.valid) {
+    PyErr_SetString(PyExc_BufferError,
+                    "mesh vertex array: the mesh was freed or its vertex array reallocated");
+    view->obj = nullptr;
+    return -1;
+  }
+  if ((flags & PyBUF_WRITABLE) && self->readonly) {
+    PyErr_SetString(PyExc_BufferError, "mesh vertex array: the indices are read only");
+    view->obj = nullptr;
+    return -1;
+  }
+  // The vertex attributes are interleaved, the consumer must handle strides.
+  if ((flags & PyBUF_STRIDES) != PyBUF_STRIDES) {
+    PyErr_SetString(PyExc_BufferError, "mesh vertex array: the buffer is strided");
+    view->obj = nullptr;
+    return -1;
+  }
+
+  // A buffer can't point to null, used by empty arrays.
+  static char empty;
+  char *data = self->indices ? (char *)self->array->GetIndexPointer() :
+                               (char *)self->array->GetVertexPointer();
+
+  Py_ssize_t len = self->itemsize;
+  for (int i = 0; i < self->ndim; ++i) {
+    len *= self->shape[i];
+  }
+
+  view->buf = data ? data + self->offset : &empty;
+  view->obj = (PyObject *)self;
+  Py_INCREF(self);
+  view->len = len;
+  view->itemsize = self->itemsize;
+  view->readonly = self->readonly;
+  view->ndim = self->ndim;
+  view->format = (flags & PyBUF_FORMAT) ? (char *)self->format : nullptr;
+  view->shape = self->shape;
+  view->strides = self->strides;
+  view->suboffsets = nullptr;
+  view->internal = nullptr;
+
+  ++storage.exports;
+
+  return 0;
+}
+
+static void mesh_array_exporter_releasebuffer(KX_MeshArrayExporter *self, Py_buffer *view)
+{
+  // The export state outlives the storage, the count is still meaningful.
+  --(*self->storage)->exports;
+}
+
+static void mesh_array_exporter_dealloc(KX_MeshArrayExporter *self)
+{
+  Py_DECREF(self->mesh);
+  delete self->storage;
+  PyObject_Del(self);
+}
+
+static PyBufferProcs mesh_array_exporter_buffer = {
+    (getbufferproc)mesh_array_exporter_getbuffer,
+    (releasebufferproc)mesh_array_exporter_releasebuffer};
+
+static PyTypeObject KX_MeshArrayExporter_Type = {
+    PyVarObject_HEAD_INIT(nullptr, 0) "KX_MeshArrayExporter", sizeof(KX_MeshArrayExporter)};
+
+static bool mesh_array_exporter_ready()
+{
+  if (!(KX_MeshArrayExporter_Type.tp_flags & Py_TPFLAGS_READY)) {
+    KX_MeshArrayExporter_Type.tp_dealloc = (destructor)mesh_array_exporter_dealloc;
+    KX_MeshArrayExporter_Type.tp_as_buffer = &mesh_array_exporter_buffer;
+    KX_MeshArrayExporter_Type.tp_flags = Py_TPFLAGS_DEFAULT;
+    KX_MeshArrayExporter_Type.tp_doc = "Buffer over a mesh vertex array attribute";
+    return (PyType_Ready(&KX_MeshArrayExporter_Type) == 0);
+  }
+  return true;
+}
+
+/// Return a new exporter of a display array attribute, the shape and strides are copied.
+static PyObject *mesh_array_exporter_new(PyObject *mesh,
+                                         RAS_IDisplayArray *array,
+                                         bool indices,
+                                         intptr_t offset,
+                                         const char *format,
+                                         Py_ssize_t itemsize,
+                                         int ndim,
+                                         const Py_ssize_t *shape,
+                                         const Py_ssize_t *strides,
+                                         bool readonly)
+{
+  KX_MeshArrayExporter *self = PyObject_New(KX_MeshArrayExporter, &KX_MeshArrayExporter_Type);
+  if (!self) {
+    return nullptr;
+  }
+
+  Py_INCREF(mesh);
+  self->mesh = mesh;
+  self->array = array;
+  self->storage = new std::shared_ptr<RAS_IDisplayArray::StorageExport>(
+      array->GetStorageExport());
+  self->indices = indices;
+  self->offset = offset;
+  self->format = format;
+  self->itemsize = itemsize;
+  self->ndim = ndim;
+  for (int i = 0; i < ndim; ++i) {
+    self->shape[i] = shape[i];
+    self->strides[i] = strides[i];
+  }
+  self->readonly = readonly;
+
+  return (PyObject *)self;
+}
+
+PyObject *KX_MeshProxy::PyGetVertexArrays(PyObject *args, PyObject *kwds)
+{
+  int matid;
+
+  if (!PyArg_ParseTuple(args, "i:getVertexArrays", &matid)) {
+    return nullptr;
+  }
+
+  RAS_MeshMaterial *mmat = m_meshobj->GetMeshMaterial(matid);
+  if (!mmat) {
+    PyErr_Format(PyExc_ValueError, "mesh.getVertexArrays(...): invalid material index %d", matid);
+    return nullptr;
+  }
+
+  if (!mesh_array_exporter_ready()) {
+    return nullptr;
+  }
+
+  RAS_IDisplayArray *array = mmat->GetDisplayArray();
+  // The vertices are interleaved, each attribute is viewed with the vertex size as stride.
+  const Py_ssize_t vertexSize = array->GetVertexMemorySize();
+  const Py_ssize_t numVertexes = array->GetVertexCount();
+
+  Py_ssize_t vecShape[2] = {numVertexes, 3};
+  Py_ssize_t vecStrides[2] = {vertexSize, sizeof(float)};
+  Py_ssize_t uvShape[3] = {numVertexes, array->GetVertexUvSize(), 2};
+  Py_ssize_t uvStrides[3] = {vertexSize, 2 * sizeof(float), sizeof(float)};
+  Py_ssize_t colorShape[3] = {numVertexes, array->GetVertexColorSize(), 4};
+  Py_ssize_t colorStrides[3] = {vertexSize, sizeof(unsigned int), sizeof(unsigned char)};
+  Py_ssize_t indexShape[1] = {array->GetIndexCount()};
+  Py_ssize_t indexStrides[1] = {sizeof(unsigned int)};
+
+  PyObject *mesh = GetProxy();
+  PyObject *positions = mesh_array_exporter_new(mesh,
+                                                array,
+                                                false,
+                                                array->GetVertexXYZOffset(),
+                                                "f",
+                                                sizeof(float),
+                                                2,
+                                                vecShape,
+                                                vecStrides,
+                                                false);
+  PyObject *normals = mesh_array_exporter_new(mesh,
+                                              array,
+                                              false,
+                                              array->GetVertexNormalOffset(),
+                                              "f",
+                                              sizeof(float),
+                                              2,
+                                              vecShape,
+                                              vecStrides,
+                                              false);
+  PyObject *uvs = mesh_array_exporter_new(mesh,
+                                          array,
+                                          false,
+                                          array->GetVertexUVOffset(),
+                                          "f",
+                                          sizeof(float),
+                                          3,
+                                          uvShape,
+                                          uvStrides,
+                                          false);
+  PyObject *colors = mesh_array_exporter_new(mesh,
+                                             array,
+                                             false,
+                                             array->GetVertexColorOffset(),
+                                             "B",
+                                             sizeof(unsigned char),
+                                             3,
+                                             colorShape,
+                                             colorStrides,
+                                             false);
+  // Indices are read only, an index out of the vertex array would be unsafe.
+  PyObject *indices = mesh_array_exporter_new(mesh,
+                                              array,
+                                              true,
+                                              0,
+                                              "I",
+                                              sizeof(unsigned int),
+                                              1,
+                                              indexShape,
+                                              indexStrides,
+                                              true);
+  Py_DECREF(mesh);
+
+  if (!positions || !normals || !uvs || !colors || !indices) {
+    Py_XDECREF(positions);
+    Py_XDECREF(normals);
+    Py_XDECREF(uvs);
+    Py_XDECREF(colors);
+    Py_XDECREF(indices);
+    return nullptr;
+  }
+
+  return Py_BuildValue("{sNsNsNsNsN}",
+                       "positions",
+                       positions,
+                       "normals",
+                       normals,
+                       "uvs",
+                       uvs,
+                       "colors",
+                       colors,
+                       "indices",
+                       indices);
+}
+
+PyObject *KX_MeshProxy::PyMarkModified(PyObject *args, PyObject *kwds)
+{
+  int matid;
+  int start = 0;
+  int end = -1;
+
+  if (!PyArg_ParseTuple(args, "i|ii:markModified", &matid, &start, &end)) {
+    return nullptr;
+  }
+
+  RAS_MeshMaterial *mmat = m_meshobj->GetMeshMaterial(matid);
+  if (!mmat) {
+    PyErr_Format(PyExc_ValueError, "mesh.markModified(...): invalid material index %d", matid);
+    return nullptr;
+  }
+
+  RAS_IDisplayArray *array = mmat->GetDisplayArray();
+  const int numVertexes = array->GetVertexCount();
+  if (end == -1) {
+    end = numVertexes;
+  }
+
+  if (start < 0 || start > end || end > numVertexes) {
+    PyErr_Format(PyExc_ValueError,
+                 "mesh.markModified(...): invalid vertex range [%d, %d) for %d vertices",
+                 start,
+                 end,
+                 numVertexes);
+    return nullptr;
+  }
+
+  array->AppendModifiedRange(RAS_IDisplayArray::POSITION_MODIFIED |
+                                 RAS_IDisplayArray::NORMAL_MODIFIED |
+                                 RAS_IDisplayArray::UVS_MODIFIED |
+                                 RAS_IDisplayArray::COLORS_MODIFIED,
+                             start,
+                             end);
+
+  Py_RETURN_NONE;
+}
+
 PyObject *KX_MeshProxy::pyattr_get_materials(EXP_PyObjectPlus *self_v,
                                              const EXP_PYATTRIBUTE_DEF *attrdef)
 {
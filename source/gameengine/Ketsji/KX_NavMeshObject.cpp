@@ -27,16 +27,24 @@
 
 #include "KX_NavMeshObject.h"
 
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <unordered_map>
+
 #include "BKE_context.h"
 #include "BKE_mesh.h"
 #include "BKE_mesh_legacy_convert.h"
 #include "BLI_sort.h"
+#include "BLI_task.h"
 #include "DEG_depsgraph_query.h"
 #include "MEM_guardedalloc.h"
 
 #include "BL_Converter.h"
 #include "CM_Message.h"
+#include "CM_Thread.h"
 #include "DetourStatNavMeshBuilder.h"
+#include "DetourTileNavMeshBuilder.h"
 #include "KX_Globals.h"
 #include "KX_ObstacleSimulation.h"
 #include "KX_PyMath.h"
@@ -574,14 +582,378 @@ static int polyFindVertex(const unsigned short *p,
   return res;
 }
 
-KX_NavMeshObject::KX_NavMeshObject() : KX_GameObject(), m_navMesh(nullptr)
+/// Free the arrays allocated by KX_NavMeshObject::BuildVertIndArrays.
+static void freeVertIndArrays(float *vertices,
+                              float *dvertices,
+                              unsigned short *polys,
+                              unsigned short *dmeshes,
+                              unsigned short *dtris)
+{
+  if (vertices) {
+    delete[] vertices;
+  }
+  if (dvertices) {
+    delete[] dvertices;
+  }
+  if (polys) {
+    MEM_freeN(polys);
+  }
+  if (dmeshes) {
+    MEM_freeN(dmeshes);
+  }
+  if (dtris) {
+    MEM_freeN(dtris);
+  }
+}
+
+/// Cell size used to quantize the tile vertices.
+static const float TILE_CELL_SIZE = 0.1f;
+/// Maximum height difference between the two sides of a portal across tiles.
+static const float TILE_PORTAL_HEIGHT = 0.5f;
+/// Maximum number of vertices of a polygon clipped against the four tile borders,
+/// each clip at most doubles the vertex count of a six vertices polygon.
+static const int TILE_MAX_CLIP_VERTS = 96;
+
+/// Convex polygons the tiles are cut from, in navigation mesh coordinates.
+struct KX_NavMeshTileSource {
+  std::vector<float> m_verts;
+  /// m_vertsPerPoly vertex indices per polygon, unused indices are 0xffff.
+  std::vector<unsigned short> m_polys;
+  /// Minimum and maximum x and z of each polygon.
+  std::vector<float> m_polyBounds;
+  int m_vertsPerPoly;
+  float m_bmin[3];
+  float m_bmax[3];
+};
+
+/// Tile data built by a rebuild task and waiting to be added to the navigation mesh.
+struct KX_NavMeshTileData {
+  int m_x;
+  int m_y;
+  /// Rebuild stamp of the tile when the task was queued, older results are dropped.
+  int m_stamp;
+  unsigned char *m_data;
+  int m_dataSize;
+};
+
+struct KX_NavMeshTiles {
+  dtTiledNavMesh m_navMesh;
+  std::shared_ptr<const KX_NavMeshTileSource> m_source;
+  float m_origin[3];
+  /// Size of a tile in cells.
+  int m_tileCells;
+  int m_width;
+  int m_height;
+  /// Number of rebuilds queued for each tile.
+  std::vector<int> m_stamps;
+
+  TaskPool *m_pool;
+  CM_ThreadMutex m_mutex;
+  std::vector<KX_NavMeshTileData> m_finished;
+
+  KX_NavMeshTiles() : m_pool(nullptr)
+  {
+  }
+
+  ~KX_NavMeshTiles()
+  {
+    if (m_pool) {
+      BLI_task_pool_work_and_wait(m_pool);
+      BLI_task_pool_free(m_pool);
+    }
+    for (KX_NavMeshTileData &tile : m_finished) {
+      delete[] tile.m_data;
+    }
+    // dtTiledNavMesh doesn't free the data it owns on destruction.
+    for (int y = 0; y < m_height; ++y) {
+      for (int x = 0; x < m_width; ++x) {
+        m_navMesh.removeTileAt(x, y, nullptr, nullptr);
+      }
+    }
+  }
+};
+
+struct TileTaskData {
+  KX_NavMeshTiles *tiles;
+  std::shared_ptr<const KX_NavMeshTileSource> source;
+  int x;
+  int y;
+  int stamp;
+};
+
+struct TileBuildData {
+  const KX_NavMeshTiles *tiles;
+  std::vector<KX_NavMeshTileData> *results;
+};
+
+/** Clip a polygon of (x, y, z) vertices against an axis aligned plane.
+ * \param axis 0 for a plane of constant x, 2 for a plane of constant z.
+ * \param keepAbove Keep the part of the polygon above the plane.
+ */
+static int clipPolygon(
+    const float *in, int nin, float *out, int axis, float value, bool keepAbove)
+{
+  int nout = 0;
+  for (int i = 0, j = nin - 1; i < nin; j = i++) {
+    const float *a = &in[j * 3];
+    const float *b = &in[i * 3];
+    const float da = keepAbove ? a[axis] - value : value - a[axis];
+    const float db = keepAbove ? b[axis] - value : value - b[axis];
+    if ((da < 0.0f && db > 0.0f) || (da > 0.0f && db < 0.0f)) {
+      const float t = da / (da - db);
+      float *v = &out[nout++ * 3];
+      interp_v3_v3v3(v, a, b, t);
+      // Put the vertex exactly on the border, portals are found by exact coordinates.
+      v[axis] = value;
+    }
+    if (db >= 0.0f) {
+      copy_v3_v3(&out[nout++ * 3], b);
+    }
+  }
+  return nout;
+}
+
+/** Cut the source polygons overlapping the tile (tx, ty) and build the detour tile data.
+ * Only uses the source and the tile grid so that it can run in a worker thread.
+ * \return False if the tile is empty or can't be built.
+ */
+static bool buildTileData(const KX_NavMeshTileSource &source,
+                          const float *origin,
+                          int tileCells,
+                          int tx,
+                          int ty,
+                          unsigned char **data,
+                          int *dataSize)
+{
+  const float cs = TILE_CELL_SIZE;
+  const int nvp = DT_TILE_VERTS_PER_POLYGON;
+  const float tileSize = tileCells * cs;
+  const float bmin[2] = {origin[0] + tx * tileSize, origin[2] + ty * tileSize};
+  const float bmax[2] = {bmin[0] + tileSize, bmin[1] + tileSize};
+
+  // Clip the overlapping polygons to the tile, in cells relative to the tile corner.
+  std::vector<float> clipVerts;
+  std::vector<int> clipPolys;
+  float ymin = FLT_MAX, ymax = -FLT_MAX;
+  const int npolys = source.m_polys.size() / source.m_vertsPerPoly;
+  for (int i = 0; i < npolys; ++i) {
+    const float *bounds = &source.m_polyBounds[i * 4];
+    if (bounds[0] > bmax[0] || bounds[1] < bmin[0] || bounds[2] > bmax[1] ||
+        bounds[3] < bmin[1])
+    {
+      continue;
+    }
+
+    float bufa[TILE_MAX_CLIP_VERTS * 3], bufb[TILE_MAX_CLIP_VERTS * 3];
+    const unsigned short *p = &source.m_polys[i * source.m_vertsPerPoly];
+    int nv = polyNumVerts(p, source.m_vertsPerPoly);
+    for (int j = 0; j < nv; ++j) {
+      const float *v = &source.m_verts[p[j] * 3];
+      bufa[j * 3 + 0] = (v[0] - bmin[0]) / cs;
+      bufa[j * 3 + 1] = v[1];
+      bufa[j * 3 + 2] = (v[2] - bmin[1]) / cs;
+    }
+    nv = clipPolygon(bufa, nv, bufb, 0, 0.0f, true);
+    nv = clipPolygon(bufb, nv, bufa, 0, (float)tileCells, false);
+    nv = clipPolygon(bufa, nv, bufb, 2, 0.0f, true);
+    nv = clipPolygon(bufb, nv, bufa, 2, (float)tileCells, false);
+    if (nv < 3) {
+      continue;
+    }
+
+    clipPolys.push_back(nv);
+    for (int j = 0; j < nv; ++j) {
+      const float *v = &bufa[j * 3];
+      clipVerts.insert(clipVerts.end(), v, v + 3);
+      ymin = std::min(ymin, v[1]);
+      ymax = std::max(ymax, v[1]);
+    }
+  }
+
+  if (clipPolys.empty()) {
+    return false;
+  }
+
+  // Quantize and weld the vertices, split the polygons with too many vertices in fans.
+  std::vector<unsigned short> verts;
+  std::vector<unsigned short> polys;
+  std::unordered_map<uint64_t, unsigned short> vertsMap;
+  const float *clipVert = clipVerts.data();
+  for (int nclip : clipPolys) {
+    unsigned short poly[TILE_MAX_CLIP_VERTS];
+    int nv = 0;
+    for (int j = 0; j < nclip; ++j, clipVert += 3) {
+      const unsigned short q[3] = {
+          (unsigned short)clamp_i((int)roundf(clipVert[0]), 0, tileCells),
+          (unsigned short)clamp_i((int)roundf((clipVert[1] - ymin) / cs), 0, 0xfffe),
+          (unsigned short)clamp_i((int)roundf(clipVert[2]), 0, tileCells)};
+      const uint64_t key = ((uint64_t)q[0] << 32) | ((uint64_t)q[1] << 16) | q[2];
+      std::unordered_map<uint64_t, unsigned short>::iterator it = vertsMap.find(key);
+      unsigned short index;
+      if (it == vertsMap.end()) {
+        if (verts.size() / 3 >= 0xfffe) {
+          return false;
+        }
+        index = verts.size() / 3;
+        verts.insert(verts.end(), q, q + 3);
+        vertsMap.emplace(key, index);
+      }
+      else {
+        index = it->second;
+      }
+      if (nv == 0 || poly[nv - 1] != index) {
+        poly[nv++] = index;
+      }
+    }
+    if (nv > 1 && poly[nv - 1] == poly[0]) {
+      --nv;
+    }
+    if (nv < 3) {
+      continue;
+    }
+
+    for (int start = 1; start < nv - 1;) {
+      const int end = std::min(start + nvp - 2, nv - 1);
+      const size_t base = polys.size();
+      polys.resize(base + nvp * 2, 0xffff);
+      polys[base] = poly[0];
+      for (int j = start; j <= end; ++j) {
+        polys[base + j - start + 1] = poly[j];
+      }
+      start = end;
+    }
+  }
+
+  const int nverts = verts.size() / 3;
+  const int ntilepolys = polys.size() / (nvp * 2);
+  if (ntilepolys == 0) {
+    return false;
+  }
+  if (ntilepolys > DT_MAX_POLYGONS) {
+    CM_Error("navigation mesh tile (" << tx << ", " << ty << ") has " << ntilepolys
+                                      << " polygons, the maximum is " << DT_MAX_POLYGONS
+                                      << ", use a smaller tile size");
+    return false;
+  }
+
+  if (!buildMeshAdjacency(polys.data(), ntilepolys, nverts, nvp)) {
+    return false;
+  }
+
+  // Fake detail meshes, a triangle fan of each polygon.
+  std::vector<unsigned short> dmeshes(ntilepolys * 4);
+  std::vector<unsigned char> dtris;
+  for (int i = 0; i < ntilepolys; ++i) {
+    const int nv = polyNumVerts(&polys[i * nvp * 2], nvp);
+    unsigned short *dmesh = &dmeshes[i * 4];
+    dmesh[0] = 0;
+    dmesh[1] = nv;
+    dmesh[2] = dtris.size() / 4;
+    dmesh[3] = nv - 2;
+    for (int j = 2; j < nv; ++j) {
+      const unsigned char tri[4] = {0, (unsigned char)(j - 1), (unsigned char)j, 0};
+      dtris.insert(dtris.end(), tri, tri + 4);
+    }
+  }
+
+  const float tbmin[3] = {bmin[0], ymin, bmin[1]};
+  const float tbmax[3] = {bmax[0], ymax, bmax[1]};
+  // The detail vertices are all polygon vertices, the array is never read.
+  const float dverts[3] = {0.0f, 0.0f, 0.0f};
+  return dtCreateNavMeshTileData(verts.data(),
+                                 nverts,
+                                 polys.data(),
+                                 ntilepolys,
+                                 nvp,
+                                 dmeshes.data(),
+                                 dverts,
+                                 0,
+                                 dtris.data(),
+                                 dtris.size() / 4,
+                                 tbmin,
+                                 tbmax,
+                                 cs,
+                                 cs,
+                                 tileCells,
+                                 0,
+                                 data,
+                                 dataSize);
+}
+
+static void build_tile_task_func(void *__restrict userdata,
+                                 int iter,
+                                 const TaskParallelTLS *__restrict tls)
+{
+  TileBuildData *data = static_cast<TileBuildData *>(userdata);
+  const KX_NavMeshTiles *tiles = data->tiles;
+  KX_NavMeshTileData &tile = (*data->results)[iter];
+  tile.m_x = iter % tiles->m_width;
+  tile.m_y = iter / tiles->m_width;
+  tile.m_stamp = 0;
+  tile.m_data = nullptr;
+  tile.m_dataSize = 0;
+  buildTileData(*tiles->m_source,
+                tiles->m_origin,
+                tiles->m_tileCells,
+                tile.m_x,
+                tile.m_y,
+                &tile.m_data,
+                &tile.m_dataSize);
+}
+
+static void rebuild_tile_task_func(TaskPool *__restrict pool, void *taskdata)
+{
+  TileTaskData *task = static_cast<TileTaskData *>(taskdata);
+  KX_NavMeshTiles *tiles = task->tiles;
+
+  KX_NavMeshTileData tile;
+  tile.m_x = task->x;
+  tile.m_y = task->y;
+  tile.m_stamp = task->stamp;
+  tile.m_data = nullptr;
+  tile.m_dataSize = 0;
+  buildTileData(*task->source,
+                tiles->m_origin,
+                tiles->m_tileCells,
+                tile.m_x,
+                tile.m_y,
+                &tile.m_data,
+                &tile.m_dataSize);
+
+  tiles->m_mutex.Lock();
+  tiles->m_finished.push_back(tile);
+  tiles->m_mutex.Unlock();
+}
+
+static void rebuild_tile_task_free(TaskPool *__restrict pool, void *taskdata)
+{
+  delete static_cast<TileTaskData *>(taskdata);
+}
+
+KX_NavMeshCorridor::KX_NavMeshCorridor() : m_revision(-1)
+{
+  zero_v3(m_goal);
+}
+
+void KX_NavMeshCorridor::Reset()
+{
+  m_polys.clear();
+  m_revision = -1;
+}
+
+int KX_NavMeshCorridor::GetLength() const
+{
+  return m_polys.size();
+}
+
+KX_NavMeshObject::KX_NavMeshObject()
+    : KX_GameObject(), m_navMesh(nullptr), m_tiles(nullptr), m_tileSize(0.0f), m_revision(0)
 {
 }
 
 KX_NavMeshObject::~KX_NavMeshObject()
 {
-  if (m_navMesh)
-    delete m_navMesh;
+  FreeNavMesh();
 }
 
 KX_PythonProxy *KX_NavMeshObject::NewInstance()
@@ -592,7 +964,9 @@ KX_PythonProxy *KX_NavMeshObject::NewInstance()
 void KX_NavMeshObject::ProcessReplica()
 {
   KX_GameObject::ProcessReplica();
-  m_navMesh = nullptr; /* without this, building frees the navmesh we copied from */
+  /* without this, building frees the navmesh we copied from */
+  m_navMesh = nullptr;
+  m_tiles = nullptr;
   if (!BuildNavMesh()) {
     CM_FunctionError("unable to build navigation mesh");
     return;
@@ -781,16 +1155,17 @@ bool KX_NavMeshObject::BuildVertIndArrays(float *&vertices,
 
 bool KX_NavMeshObject::BuildNavMesh()
 {
-  if (m_navMesh) {
-    delete m_navMesh;
-    m_navMesh = nullptr;
-  }
+  FreeNavMesh();
 
   if (GetMeshCount() == 0) {
     CM_Error("can't find mesh for navmesh object: " << m_name);
     return false;
   }
 
+  if (m_tileSize > 0.0f) {
+    return BuildTiledNavMesh();
+  }
+
   float *vertices = nullptr, *dvertices = nullptr;
   unsigned short *polys = nullptr, *dtris = nullptr, *dmeshes = nullptr;
   int nverts = 0, npolys = 0, ndvertsuniq = 0, ndtris = 0;
@@ -807,21 +1182,7 @@ bool KX_NavMeshObject::BuildNavMesh()
                           vertsPerPoly) ||
       vertsPerPoly < 3) {
     CM_Error("can't build navigation mesh data for object: " << m_name);
-    if (vertices) {
-      delete[] vertices;
-    }
-    if (dvertices) {
-      delete[] dvertices;
-    }
-    if (polys) {
-      MEM_freeN(polys);
-    }
-    if (dmeshes) {
-      MEM_freeN(dmeshes);
-    }
-    if (dtris) {
-      MEM_freeN(dtris);
-    }
+    freeVertIndArrays(vertices, dvertices, polys, dmeshes, dtris);
     return false;
   }
 
@@ -837,42 +1198,14 @@ bool KX_NavMeshObject::BuildNavMesh()
 
   if (!buildMeshAdjacency(polys, npolys, nverts, vertsPerPoly)) {
     CM_FunctionError("unable to build mesh adjacency information.");
-    if (vertices) {
-      delete[] vertices;
-    }
-    if (dvertices) {
-      delete[] dvertices;
-    }
-    if (polys) {
-      MEM_freeN(polys);
-    }
-    if (dmeshes) {
-      MEM_freeN(dmeshes);
-    }
-    if (dtris) {
-      MEM_freeN(dtris);
-    }
+    freeVertIndArrays(vertices, dvertices, polys, dmeshes, dtris);
     return false;
   }
 
   float cs = 0.2f;
 
   if (!nverts || !npolys) {
-    if (vertices) {
-      delete[] vertices;
-    }
-    if (dvertices) {
-      delete[] dvertices;
-    }
-    if (polys) {
-      MEM_freeN(polys);
-    }
-    if (dmeshes) {
-      MEM_freeN(dmeshes);
-    }
-    if (dtris) {
-      MEM_freeN(dtris);
-    }
+    freeVertIndArrays(vertices, dvertices, polys, dmeshes, dtris);
     return false;
   }
 
@@ -1023,8 +1356,240 @@ dtStatNavMesh *KX_NavMeshObject::GetNavMesh()
   return m_navMesh;
 }
 
+dtTiledNavMesh *KX_NavMeshObject::GetTiledNavMesh()
+{
+  return m_tiles ? &m_tiles->m_navMesh : nullptr;
+}
+
+void KX_NavMeshObject::FreeNavMesh()
+{
+  if (m_navMesh) {
+    delete m_navMesh;
+    m_navMesh = nullptr;
+  }
+  if (m_tiles) {
+    delete m_tiles;
+    m_tiles = nullptr;
+  }
+  ++m_revision;
+}
+
+void KX_NavMeshObject::RefreshObstacles()
+{
+  KX_ObstacleSimulation *obssimulation = GetScene()->GetObstacleSimulation();
+  if (obssimulation) {
+    obssimulation->DestroyObstacleForObj(this);
+    obssimulation->AddObstaclesForNavMesh(this);
+  }
+}
+
+KX_NavMeshTileSource *KX_NavMeshObject::BuildTileSource()
+{
+  float *vertices = nullptr, *dvertices = nullptr;
+  unsigned short *polys = nullptr, *dtris = nullptr, *dmeshes = nullptr;
+  int nverts = 0, npolys = 0, ndvertsuniq = 0, ndtris = 0;
+  int vertsPerPoly = 0;
+  if (!BuildVertIndArrays(vertices,
+                          nverts,
+                          polys,
+                          npolys,
+                          dmeshes,
+                          dvertices,
+                          ndvertsuniq,
+                          dtris,
+                          ndtris,
+                          vertsPerPoly) ||
+      vertsPerPoly < 3 || !nverts || !npolys)
+  {
+    CM_Error("can't build navigation mesh data for object: " << m_name);
+    freeVertIndArrays(vertices, dvertices, polys, dmeshes, dtris);
+    return nullptr;
+  }
+
+  if (dmeshes == nullptr) {
+    for (int i = 0; i < nverts; i++) {
+      flipAxes(&vertices[i * 3]);
+    }
+  }
+
+  KX_NavMeshTileSource *source = new KX_NavMeshTileSource();
+  source->m_vertsPerPoly = vertsPerPoly;
+  source->m_verts.assign(vertices, vertices + nverts * 3);
+  source->m_polys.resize(npolys * vertsPerPoly);
+  source->m_polyBounds.resize(npolys * 4);
+  for (int i = 0; i < npolys; ++i) {
+    const unsigned short *p = &polys[i * vertsPerPoly * 2];
+    std::copy(p, p + vertsPerPoly, &source->m_polys[i * vertsPerPoly]);
+
+    float *bounds = &source->m_polyBounds[i * 4];
+    bounds[0] = bounds[2] = FLT_MAX;
+    bounds[1] = bounds[3] = -FLT_MAX;
+    for (int j = 0, nv = polyNumVerts(p, vertsPerPoly); j < nv; ++j) {
+      const float *v = &vertices[p[j] * 3];
+      bounds[0] = std::min(bounds[0], v[0]);
+      bounds[1] = std::max(bounds[1], v[0]);
+      bounds[2] = std::min(bounds[2], v[2]);
+      bounds[3] = std::max(bounds[3], v[2]);
+    }
+  }
+  calcMeshBounds(vertices, nverts, source->m_bmin, source->m_bmax);
+
+  freeVertIndArrays(vertices, dvertices, polys, dmeshes, dtris);
+
+  return source;
+}
+
+bool KX_NavMeshObject::BuildTiledNavMesh()
+{
+  std::shared_ptr<const KX_NavMeshTileSource> source(BuildTileSource());
+  if (!source) {
+    return false;
+  }
+
+  const int tileCells = clamp_i((int)(m_tileSize / TILE_CELL_SIZE), 1, 0xfffe);
+  const float tileSize = tileCells * TILE_CELL_SIZE;
+  const int width = max_ii((int)ceilf((source->m_bmax[0] - source->m_bmin[0]) / tileSize), 1);
+  const int height = max_ii((int)ceilf((source->m_bmax[2] - source->m_bmin[2]) / tileSize), 1);
+  if (width * height > DT_MAX_TILES) {
+    CM_Error("navigation mesh object " << m_name << " needs " << width * height
+                                       << " tiles, the maximum is " << DT_MAX_TILES
+                                       << ", use a bigger tile size");
+    return false;
+  }
+
+  KX_NavMeshTiles *tiles = new KX_NavMeshTiles();
+  tiles->m_source = source;
+  copy_v3_v3(tiles->m_origin, source->m_bmin);
+  tiles->m_tileCells = tileCells;
+  tiles->m_width = width;
+  tiles->m_height = height;
+  tiles->m_stamps.resize(width * height, 0);
+
+  if (!tiles->m_navMesh.init(tiles->m_origin, tileSize, TILE_PORTAL_HEIGHT)) {
+    CM_FunctionError("unable to initialize the tiled navigation mesh.");
+    delete tiles;
+    return false;
+  }
+
+  // Build the tiles in parallel, they are added to the navigation mesh afterward.
+  std::vector<KX_NavMeshTileData> results(width * height);
+  TileBuildData data;
+  data.tiles = tiles;
+  data.results = &results;
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  BLI_task_parallel_range(0, width * height, &data, build_tile_task_func, &settings);
+
+  for (KX_NavMeshTileData &tile : results) {
+    if (tile.m_data &&
+        !tiles->m_navMesh.addTileAt(tile.m_x, tile.m_y, tile.m_data, tile.m_dataSize, true))
+    {
+      delete[] tile.m_data;
+    }
+  }
+
+  m_tiles = tiles;
+
+  return true;
+}
+
+int KX_NavMeshObject::RebuildTiles(const MT_Vector3 &min, const MT_Vector3 &max)
+{
+  if (!m_tiles) {
+    return 0;
+  }
+
+  std::shared_ptr<const KX_NavMeshTileSource> source(BuildTileSource());
+  if (!source) {
+    return 0;
+  }
+  m_tiles->m_source = source;
+
+  // Bounds of the box in navigation mesh coordinates.
+  float bmin[3], bmax[3];
+  INIT_MINMAX(bmin, bmax);
+  for (int i = 0; i < 8; ++i) {
+    const MT_Vector3 corner((i & 1) ? max.x() : min.x(),
+                            (i & 2) ? max.y() : min.y(),
+                            (i & 4) ? max.z() : min.z());
+    float pos[3];
+    TransformToLocalCoords(corner).getValue(pos);
+    flipAxes(pos);
+    minmax_v3v3_v3(bmin, bmax, pos);
+  }
+
+  const float *origin = m_tiles->m_origin;
+  const float tileSize = m_tiles->m_tileCells * TILE_CELL_SIZE;
+  const int minx = max_ii((int)floorf((bmin[0] - origin[0]) / tileSize), 0);
+  const int maxx = min_ii((int)floorf((bmax[0] - origin[0]) / tileSize), m_tiles->m_width - 1);
+  const int miny = max_ii((int)floorf((bmin[2] - origin[2]) / tileSize), 0);
+  const int maxy = min_ii((int)floorf((bmax[2] - origin[2]) / tileSize), m_tiles->m_height - 1);
+
+  if (!m_tiles->m_pool) {
+    m_tiles->m_pool = BLI_task_pool_create(nullptr, TASK_PRIORITY_LOW);
+  }
+
+  int count = 0;
+  for (int y = miny; y <= maxy; ++y) {
+    for (int x = minx; x <= maxx; ++x) {
+      TileTaskData *task = new TileTaskData();
+      task->tiles = m_tiles;
+      task->source = source;
+      task->x = x;
+      task->y = y;
+      task->stamp = ++m_tiles->m_stamps[y * m_tiles->m_width + x];
+      BLI_task_pool_push(
+          m_tiles->m_pool, rebuild_tile_task_func, task, true, rebuild_tile_task_free);
+      ++count;
+    }
+  }
+
+  return count;
+}
+
+void KX_NavMeshObject::MergeTiles()
+{
+  if (!m_tiles) {
+    return;
+  }
+
+  std::vector<KX_NavMeshTileData> finished;
+  m_tiles->m_mutex.Lock();
+  finished.swap(m_tiles->m_finished);
+  m_tiles->m_mutex.Unlock();
+
+  bool changed = false;
+  for (KX_NavMeshTileData &tile : finished) {
+    // A more recent rebuild of this tile is queued.
+    if (tile.m_stamp != m_tiles->m_stamps[tile.m_y * m_tiles->m_width + tile.m_x]) {
+      delete[] tile.m_data;
+      continue;
+    }
+
+    m_tiles->m_navMesh.removeTileAt(tile.m_x, tile.m_y, nullptr, nullptr);
+    if (tile.m_data &&
+        !m_tiles->m_navMesh.addTileAt(tile.m_x, tile.m_y, tile.m_data, tile.m_dataSize, true))
+    {
+      delete[] tile.m_data;
+    }
+    changed = true;
+  }
+
+  if (changed) {
+    // The references to the polygons of the rebuilt tiles and their walls changed.
+    ++m_revision;
+    RefreshObstacles();
+  }
+}
+
 void KX_NavMeshObject::DrawNavMesh(NavMeshRenderMode renderMode)
 {
+  MergeTiles();
+  if (m_tiles) {
+    DrawTiledNavMesh(renderMode);
+    return;
+  }
   if (!m_navMesh)
     return;
   MT_Vector4 color(0.0f, 0.0f, 0.0f, 1.0f);
@@ -1082,6 +1647,52 @@ void KX_NavMeshObject::DrawNavMesh(NavMeshRenderMode renderMode)
   }
 }
 
+void KX_NavMeshObject::DrawTiledNavMesh(NavMeshRenderMode renderMode)
+{
+  const MT_Vector4 color(0.0f, 0.0f, 0.0f, 1.0f);
+
+  for (int ti = 0; ti < DT_MAX_TILES; ++ti) {
+    const dtTileHeader *header = m_tiles->m_navMesh.getTile(ti)->header;
+    if (!header) {
+      continue;
+    }
+
+    for (int pi = 0; pi < header->npolys; ++pi) {
+      const dtTilePoly *poly = &header->polys[pi];
+
+      if (renderMode == RM_TRIS) {
+        const dtTilePolyDetail *pd = &header->dmeshes[pi];
+        for (int j = 0; j < pd->ntris; ++j) {
+          const unsigned char *t = &header->dtris[(pd->tbase + j) * 4];
+          MT_Vector3 tri[3];
+          for (int k = 0; k < 3; ++k) {
+            const float *v = (t[k] < poly->nv) ?
+                                 &header->verts[poly->v[t[k]] * 3] :
+                                 &header->dverts[(pd->vbase + (t[k] - poly->nv)) * 3];
+            tri[k] = TransformToWorldCoords(MT_Vector3(v[0], v[2], v[1]));
+          }
+
+          for (int k = 0; k < 3; k++)
+            KX_RasterizerDrawDebugLine(tri[k], tri[(k + 1) % 3], color);
+        }
+        continue;
+      }
+
+      for (int i = 0, j = (int)poly->nv - 1; i < (int)poly->nv; j = i++) {
+        if (poly->n[j] && renderMode == RM_WALLS)
+          continue;
+        const float *vif = &header->verts[poly->v[i] * 3];
+        const float *vjf = &header->verts[poly->v[j] * 3];
+        MT_Vector3 vi(vif[0], vif[2], vif[1]);
+        MT_Vector3 vj(vjf[0], vjf[2], vjf[1]);
+        vi = TransformToWorldCoords(vi);
+        vj = TransformToWorldCoords(vj);
+        KX_RasterizerDrawDebugLine(vi, vj, color);
+      }
+    }
+  }
+}
+
 MT_Vector3 KX_NavMeshObject::TransformToLocalCoords(const MT_Vector3 &wpos)
 {
   MT_Matrix3x3 orientation = NodeGetWorldOrientation();
@@ -1104,12 +1715,100 @@ MT_Vector3 KX_NavMeshObject::TransformToWorldCoords(const MT_Vector3 &lpos)
   return wpos;
 }
 
+unsigned int KX_NavMeshObject::FindNearestPoly(const float *pos)
+{
+  if (m_tiles) {
+    return m_tiles->m_navMesh.findNearestPoly(pos, polyPickExt);
+  }
+  return m_navMesh->findNearestPoly(pos, polyPickExt);
+}
+
+int KX_NavMeshObject::FindPolyPath(unsigned int startRef,
+                                   unsigned int endRef,
+                                   const float *startPos,
+                                   const float *endPos,
+                                   unsigned int *polys,
+                                   int maxPolys)
+{
+  if (m_tiles) {
+    return m_tiles->m_navMesh.findPath(startRef, endRef, startPos, endPos, polys, maxPolys);
+  }
+
+  std::vector<dtStatPolyRef> statPolys(maxPolys);
+  const int npolys = m_navMesh->findPath(
+      startRef, endRef, startPos, endPos, statPolys.data(), maxPolys);
+  std::copy(statPolys.begin(), statPolys.begin() + npolys, polys);
+  return npolys;
+}
+
+bool KX_NavMeshObject::RepairCorridor(KX_NavMeshCorridor &corridor,
+                                      unsigned int startRef,
+                                      unsigned int endRef,
+                                      const float *endPos,
+                                      int maxPolys)
+{
+  std::vector<unsigned int> &polys = corridor.m_polys;
+  if (polys.empty() || corridor.m_revision != m_revision) {
+    return false;
+  }
+
+  // Drop the polygons the start moved past.
+  std::vector<unsigned int>::iterator it = std::find(polys.begin(), polys.end(), startRef);
+  if (it == polys.end()) {
+    return false;
+  }
+  polys.erase(polys.begin(), it);
+
+  // The goal is still in the corridor, drop the polygons after it.
+  it = std::find(polys.begin(), polys.end(), endRef);
+  if (it != polys.end()) {
+    polys.erase(it + 1, polys.end());
+    return true;
+  }
+
+  // Extend the corridor from its last polygon to the goal.
+  const int maxTail = maxPolys - (int)polys.size() + 1;
+  if (maxTail < 2) {
+    return false;
+  }
+  std::vector<unsigned int> tail(maxTail);
+  const int ntail = FindPolyPath(
+      polys.back(), endRef, corridor.m_goal, endPos, tail.data(), maxTail);
+  if (ntail == 0 || tail[ntail - 1] != endRef) {
+    return false;
+  }
+  polys.insert(polys.end(), tail.begin() + 1, tail.begin() + ntail);
+
+  // Cut the loops the tail made by going back through the corridor.
+  for (int i = 0; i < (int)polys.size(); ++i) {
+    for (int j = polys.size() - 1; j > i; --j) {
+      if (polys[j] == polys[i]) {
+        polys.erase(polys.begin() + i + 1, polys.begin() + j + 1);
+        break;
+      }
+    }
+  }
+
+  return true;
+}
+
 int KX_NavMeshObject::FindPath(const MT_Vector3 &from,
                                const MT_Vector3 &to,
                                float *path,
                                int maxPathLen)
 {
-  if (!m_navMesh)
+  KX_NavMeshCorridor corridor;
+  return FindPath(from, to, path, maxPathLen, corridor);
+}
+
+int KX_NavMeshObject::FindPath(const MT_Vector3 &from,
+                               const MT_Vector3 &to,
+                               float *path,
+                               int maxPathLen,
+                               KX_NavMeshCorridor &corridor)
+{
+  MergeTiles();
+  if (!m_navMesh && !m_tiles)
     return 0;
   MT_Vector3 localfrom = TransformToLocalCoords(from);
   MT_Vector3 localto = TransformToLocalCoords(to);
@@ -1118,25 +1817,41 @@ int KX_NavMeshObject::FindPath(const MT_Vector3 &from,
   flipAxes(spos);
   localto.getValue(epos);
   flipAxes(epos);
-  dtStatPolyRef sPolyRef = m_navMesh->findNearestPoly(spos, polyPickExt);
-  dtStatPolyRef ePolyRef = m_navMesh->findNearestPoly(epos, polyPickExt);
-
-  int pathLen = 0;
-  if (sPolyRef && ePolyRef) {
-    dtStatPolyRef *polys = new dtStatPolyRef[maxPathLen];
-    int npolys;
-    npolys = m_navMesh->findPath(sPolyRef, ePolyRef, spos, epos, polys, maxPathLen);
-    if (npolys) {
-      pathLen = m_navMesh->findStraightPath(spos, epos, polys, npolys, path, maxPathLen);
-      for (int i = 0; i < pathLen; i++) {
-        flipAxes(&path[i * 3]);
-        MT_Vector3 waypoint(&path[i * 3]);
-        waypoint = TransformToWorldCoords(waypoint);
-        waypoint.getValue(&path[i * 3]);
-      }
-    }
+  const unsigned int sPolyRef = FindNearestPoly(spos);
+  const unsigned int ePolyRef = FindNearestPoly(epos);
+  if (!sPolyRef || !ePolyRef) {
+    corridor.Reset();
+    return 0;
+  }
 
-    delete[] polys;
+  std::vector<unsigned int> &polys = corridor.m_polys;
+  if (!RepairCorridor(corridor, sPolyRef, ePolyRef, epos, maxPathLen)) {
+    polys.resize(maxPathLen);
+    polys.resize(FindPolyPath(sPolyRef, ePolyRef, spos, epos, polys.data(), maxPathLen));
+    corridor.m_revision = m_revision;
+  }
+  copy_v3_v3(corridor.m_goal, epos);
+
+  if (polys.empty()) {
+    return 0;
+  }
+
+  int pathLen;
+  if (m_tiles) {
+    pathLen = m_tiles->m_navMesh.findStraightPath(
+        spos, epos, polys.data(), polys.size(), path, maxPathLen);
+  }
+  else {
+    const std::vector<dtStatPolyRef> statPolys(polys.begin(), polys.end());
+    pathLen = m_navMesh->findStraightPath(
+        spos, epos, statPolys.data(), statPolys.size(), path, maxPathLen);
+  }
+
+  for (int i = 0; i < pathLen; i++) {
+    flipAxes(&path[i * 3]);
+    MT_Vector3 waypoint(&path[i * 3]);
+    waypoint = TransformToWorldCoords(waypoint);
+    waypoint.getValue(&path[i * 3]);
   }
 
   return pathLen;
@@ -1144,7 +1859,8 @@ int KX_NavMeshObject::FindPath(const MT_Vector3 &from,
 
 float KX_NavMeshObject::Raycast(const MT_Vector3 &from, const MT_Vector3 &to)
 {
-  if (!m_navMesh)
+  MergeTiles();
+  if (!m_navMesh && !m_tiles)
     return 0.f;
   MT_Vector3 localfrom = TransformToLocalCoords(from);
   MT_Vector3 localto = TransformToLocalCoords(to);
@@ -1153,10 +1869,16 @@ float KX_NavMeshObject::Raycast(const MT_Vector3 &from, const MT_Vector3 &to)
   flipAxes(spos);
   localto.getValue(epos);
   flipAxes(epos);
-  dtStatPolyRef sPolyRef = m_navMesh->findNearestPoly(spos, polyPickExt);
+  const unsigned int sPolyRef = FindNearestPoly(spos);
   float t = 0;
-  static dtStatPolyRef polys[MAX_PATH_LEN];
-  m_navMesh->raycast(sPolyRef, spos, epos, t, polys, MAX_PATH_LEN);
+  if (m_tiles) {
+    dtTilePolyRef polys[MAX_PATH_LEN];
+    m_tiles->m_navMesh.raycast(sPolyRef, spos, epos, t, polys, MAX_PATH_LEN);
+  }
+  else {
+    static dtStatPolyRef polys[MAX_PATH_LEN];
+    m_navMesh->raycast(sPolyRef, spos, epos, t, polys, MAX_PATH_LEN);
+  }
   return t;
 }
 
@@ -1225,6 +1947,8 @@ PyTypeObject KX_NavMeshObject::Type = {PyVarObject_HEAD_INIT(nullptr, 0) "KX_Nav
                                        game_object_new};
 
 PyAttributeDef KX_NavMeshObject::Attributes[] = {
+    EXP_PYATTRIBUTE_FLOAT_RW_CHECK(
+        "tileSize", 0.0f, 10000.0f, KX_NavMeshObject, m_tileSize, CheckTileSize),
     EXP_PYATTRIBUTE_NULL  // Sentinel
 };
 
@@ -1234,6 +1958,7 @@ PyMethodDef KX_NavMeshObject::Methods[] = {
     EXP_PYMETHODTABLE(KX_NavMeshObject, raycast),
     EXP_PYMETHODTABLE(KX_NavMeshObject, draw),
     EXP_PYMETHODTABLE(KX_NavMeshObject, rebuild),
+    EXP_PYMETHODTABLE(KX_NavMeshObject, rebuildTiles),
     {nullptr, nullptr}  // Sentinel
 };
 
@@ -1294,4 +2019,26 @@ EXP_PYMETHODDEF_DOC_NOARGS(KX_NavMeshObject, rebuild, "rebuild(): rebuild naviga
   Py_RETURN_NONE;
 }
 
+EXP_PYMETHODDEF_DOC(KX_NavMeshObject,
+                    rebuildTiles,
+                    "rebuildTiles(min, max): rebuild the tiles overlapping a box in background\n"
+                    "Returns the number of tiles queued\n")
+{
+  PyObject *ob_min, *ob_max;
+  if (!PyArg_ParseTuple(args, "OO:rebuildTiles", &ob_min, &ob_max))
+    return nullptr;
+  MT_Vector3 min, max;
+  if (!PyVecTo(ob_min, min) || !PyVecTo(ob_max, max))
+    return nullptr;
+  return PyLong_FromLong(RebuildTiles(min, max));
+}
+
+int KX_NavMeshObject::CheckTileSize(EXP_PyObjectPlus *self, const PyAttributeDef *attrdef)
+{
+  KX_NavMeshObject *navmesh = static_cast<KX_NavMeshObject *>(self);
+  navmesh->BuildNavMesh();
+  navmesh->RefreshObstacles();
+  return 0;
+}
+
 #endif  // WITH_PYTHON
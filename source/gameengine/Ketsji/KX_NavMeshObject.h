@@ -29,14 +29,45 @@
 #include <vector>
 
 #include "DetourStatNavMesh.h"
+#include "DetourTileNavMesh.h"
 #include "EXP_PyObjectPlus.h"
 #include "KX_GameObject.h"
 
+struct KX_NavMeshTileSource;
+struct KX_NavMeshTiles;
+
+/** Polygon corridor of a path, kept between path queries so that the path can be repaired
+ * when its start or goal moves instead of being searched again from scratch.
+ */
+class KX_NavMeshCorridor {
+  friend class KX_NavMeshObject;
+
+ private:
+  /// Polygon references from the start to the goal polygon.
+  std::vector<unsigned int> m_polys;
+  /// Goal position of the last query, in navigation mesh coordinates.
+  float m_goal[3];
+  /// Navigation mesh revision the polygon references belong to.
+  int m_revision;
+
+ public:
+  KX_NavMeshCorridor();
+
+  void Reset();
+  /// Return the number of polygons in the corridor.
+  int GetLength() const;
+};
 
 class KX_NavMeshObject : public KX_GameObject {
   Py_Header
 
       protected : dtStatNavMesh *m_navMesh;
+  /// Tiled navigation mesh data, used instead of m_navMesh when m_tileSize is not zero.
+  KX_NavMeshTiles *m_tiles;
+  /// Size of a tile in local units, zero builds a single static navigation mesh.
+  float m_tileSize;
+  /// Incremented each time polygon references change, invalidates the path corridors.
+  int m_revision;
 
   bool BuildVertIndArrays(float *&vertices,
                           int &nverts,
@@ -48,6 +79,24 @@ class KX_NavMeshObject : public KX_GameObject {
                           unsigned short *&dtris,
                           int &ndtris,
                           int &vertsPerPoly);
+  KX_NavMeshTileSource *BuildTileSource();
+  bool BuildTiledNavMesh();
+  void FreeNavMesh();
+  /// Replace the wall obstacles of the navigation mesh in the obstacle simulation.
+  void RefreshObstacles();
+
+  unsigned int FindNearestPoly(const float *pos);
+  int FindPolyPath(unsigned int startRef,
+                   unsigned int endRef,
+                   const float *startPos,
+                   const float *endPos,
+                   unsigned int *polys,
+                   int maxPolys);
+  bool RepairCorridor(KX_NavMeshCorridor &corridor,
+                      unsigned int startRef,
+                      unsigned int endRef,
+                      const float *endPos,
+                      int maxPolys);
 
  public:
   KX_NavMeshObject();
@@ -58,11 +107,32 @@ class KX_NavMeshObject : public KX_GameObject {
 
   bool BuildNavMesh();
   dtStatNavMesh *GetNavMesh();
+  /// Return the tiled navigation mesh or nullptr if the navigation mesh isn't tiled.
+  dtTiledNavMesh *GetTiledNavMesh();
+
+  /** Queue an asynchronous rebuild of the tiles overlapping a world space box.
+   * The tiles are cut again from the current mesh and are swapped in by MergeTiles().
+   * \return The number of tiles queued.
+   */
+  int RebuildTiles(const MT_Vector3 &min, const MT_Vector3 &max);
+  /// Add the tiles finished by the rebuild tasks, called before any query.
+  void MergeTiles();
+
   int FindPath(const MT_Vector3 &from, const MT_Vector3 &to, float *path, int maxPathLen);
+  /** Find a path reusing the polygon corridor of the previous query.
+   * The corridor is trimmed when the start moved along it and extended from its end
+   * when the goal left it, a full search is only done when it can't be repaired.
+   */
+  int FindPath(const MT_Vector3 &from,
+               const MT_Vector3 &to,
+               float *path,
+               int maxPathLen,
+               KX_NavMeshCorridor &corridor);
   float Raycast(const MT_Vector3 &from, const MT_Vector3 &to);
 
   enum NavMeshRenderMode { RM_WALLS, RM_POLYS, RM_TRIS, RM_MAX };
   void DrawNavMesh(NavMeshRenderMode mode);
+  void DrawTiledNavMesh(NavMeshRenderMode mode);
   void DrawPath(const float *path, int pathLen, const MT_Vector4 &color);
 
   MT_Vector3 TransformToLocalCoords(const MT_Vector3 &wpos);
@@ -73,10 +143,12 @@ class KX_NavMeshObject : public KX_GameObject {
   /* --------------------------------------------------------------------- */
 
   static PyObject *game_object_new(PyTypeObject *type, PyObject *args, PyObject *kwds);
+  static int CheckTileSize(EXP_PyObjectPlus *self, const PyAttributeDef *attrdef);
 
   EXP_PYMETHOD_DOC(KX_NavMeshObject, findPath);
   EXP_PYMETHOD_DOC(KX_NavMeshObject, raycast);
   EXP_PYMETHOD_DOC(KX_NavMeshObject, draw);
   EXP_PYMETHOD_DOC_NOARGS(KX_NavMeshObject, rebuild);
+  EXP_PYMETHOD_DOC(KX_NavMeshObject, rebuildTiles);
 #endif /* WITH_PYTHON */
 };
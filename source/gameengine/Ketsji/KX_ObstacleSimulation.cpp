@@ -28,9 +28,13 @@
 
 #include "KX_ObstacleSimulation.h"
 
+#include <cmath>
+
 #include "KX_Globals.h"
 #include "KX_NavMeshObject.h"
 
+#include "BLI_task.h"
+
 namespace {
 inline float perp(const MT_Vector2 &a, const MT_Vector2 &b)
 {
@@ -186,8 +190,58 @@ static float interpolateToi(float a, const float *dir, const float *toi, const i
   return 0;
 }
 
+/// Maximum number of cells of the obstacle grid.
+static const int GRID_MAX_CELLS = 256 * 256;
+/// Maximum number of times the cell size is doubled to fit the grid in GRID_MAX_CELLS.
+static const int GRID_MAX_RESIZES = 16;
+/// Minimum number of obstacle tests before the samples are processed in parallel.
+static const int PARALLEL_MIN_TESTS = 2048;
+
+static void obstacleBounds(const KX_Obstacle *obstacle, float bmin[2], float bmax[2])
+{
+  if (obstacle->m_shape == KX_OBSTACLE_SEGMENT) {
+    const MT_Vector3 &p1 = obstacle->m_worldPos;
+    const MT_Vector3 &p2 = obstacle->m_worldPos2;
+    vset(bmin, std::min(p1.x(), p2.x()), std::min(p1.y(), p2.y()));
+    vset(bmax, std::max(p1.x(), p2.x()), std::max(p1.y(), p2.y()));
+  }
+  else {
+    vset(bmin, obstacle->m_pos.x(), obstacle->m_pos.y());
+    vset(bmax, obstacle->m_pos.x(), obstacle->m_pos.y());
+  }
+
+  const float rad = obstacle->m_rad;
+  vset(bmin, bmin[0] - rad, bmin[1] - rad);
+  vset(bmax, bmax[0] + rad, bmax[1] + rad);
+}
+
+static bool obstacleBoundsValid(const float bmin[2], const float bmax[2])
+{
+  return (std::isfinite(bmin[0]) && std::isfinite(bmin[1]) && std::isfinite(bmax[0]) &&
+          std::isfinite(bmax[1]));
+}
+
+/// Convert a grid relative coordinate to a cell coordinate, clamping out of range and NaN values.
+static int gridCoord(float coord, int size)
+{
+  if (!(coord > 0.0f)) {
+    return 0;
+  }
+  if (coord >= (float)(size - 1)) {
+    return size - 1;
+  }
+  return (int)coord;
+}
+
 KX_ObstacleSimulation::KX_ObstacleSimulation(MT_Scalar levelHeight, bool enableVisualization)
-    : m_levelHeight(levelHeight), m_enableVisualization(enableVisualization)
+    : m_levelHeight(levelHeight),
+      m_enableVisualization(enableVisualization),
+      m_gridCellSize(1.0f),
+      m_gridWidth(0),
+      m_gridHeight(0),
+      m_gridDirty(true),
+      m_maxObstacleSpeed(0.0f),
+      m_queryStamp(0)
 {
 }
 
@@ -212,10 +266,37 @@ KX_Obstacle *KX_ObstacleSimulation::CreateObstacle(KX_GameObject *gameobj)
     vset(&obstacle->hvel[i * 2], 0, 0);
   obstacle->hhead = 0;
 
+  obstacle->m_index = m_obstacles.size();
   m_obstacles.push_back(obstacle);
+  m_objectObstacles[gameobj].push_back(obstacle);
+  m_gridDirty = true;
   return obstacle;
 }
 
+void KX_ObstacleSimulation::RemoveObstacle(KX_Obstacle *obstacle)
+{
+  KX_Obstacle *last = m_obstacles.back();
+  last->m_index = obstacle->m_index;
+  m_obstacles[obstacle->m_index] = last;
+  m_obstacles.pop_back();
+  m_gridDirty = true;
+
+  delete obstacle;
+}
+
+void KX_ObstacleSimulation::UpdateSegmentWorldPosition(KX_Obstacle *obstacle)
+{
+  if (obstacle->m_type == KX_OBSTACLE_NAV_MESH) {
+    KX_NavMeshObject *navmeshobj = static_cast<KX_NavMeshObject *>(obstacle->m_gameObj);
+    obstacle->m_worldPos = navmeshobj->TransformToWorldCoords(obstacle->m_pos);
+    obstacle->m_worldPos2 = navmeshobj->TransformToWorldCoords(obstacle->m_pos2);
+  }
+  else {
+    obstacle->m_worldPos = obstacle->m_pos;
+    obstacle->m_worldPos2 = obstacle->m_pos2;
+  }
+}
+
 void KX_ObstacleSimulation::AddObstacleForObj(KX_GameObject *gameobj)
 {
   KX_Obstacle *obstacle = CreateObstacle(gameobj);
@@ -223,6 +304,7 @@ void KX_ObstacleSimulation::AddObstacleForObj(KX_GameObject *gameobj)
   obstacle->m_type = KX_OBSTACLE_OBJ;
   obstacle->m_shape = KX_OBSTACLE_CIRCLE;
   obstacle->m_rad = blenderobject->obstacleRad;
+  obstacle->m_pos = gameobj->NodeGetWorldPosition();
 }
 
 void KX_ObstacleSimulation::AddObstaclesForNavMesh(KX_NavMeshObject *navmeshobj)
@@ -245,6 +327,41 @@ void KX_ObstacleSimulation::AddObstaclesForNavMesh(KX_NavMeshObject *navmeshobj)
         obstacle->m_pos = MT_Vector3(vj[0], vj[2], vj[1]);
         obstacle->m_pos2 = MT_Vector3(vi[0], vi[2], vi[1]);
         obstacle->m_rad = 0;
+        UpdateSegmentWorldPosition(obstacle);
+      }
+    }
+  }
+
+  dtTiledNavMesh *tiledNavMesh = navmeshobj->GetTiledNavMesh();
+  if (tiledNavMesh) {
+    for (int ti = 0; ti < DT_MAX_TILES; ti++) {
+      const dtTileHeader *header = tiledNavMesh->getTile(ti)->header;
+      if (!header) {
+        continue;
+      }
+
+      for (int pi = 0; pi < header->npolys; pi++) {
+        const dtTilePoly *poly = &header->polys[pi];
+
+        for (int i = 0, j = (int)poly->nv - 1; i < (int)poly->nv; j = i++) {
+          // Edges on tile borders are walls only when not linked to a neighbour tile.
+          bool linked = false;
+          for (int k = 0; k < poly->nlinks && !linked; k++) {
+            linked = (header->links[poly->links + k].e == j);
+          }
+          if (linked)
+            continue;
+          const float *vj = &header->verts[poly->v[j] * 3];
+          const float *vi = &header->verts[poly->v[i] * 3];
+
+          KX_Obstacle *obstacle = CreateObstacle(navmeshobj);
+          obstacle->m_type = KX_OBSTACLE_NAV_MESH;
+          obstacle->m_shape = KX_OBSTACLE_SEGMENT;
+          obstacle->m_pos = MT_Vector3(vj[0], vj[2], vj[1]);
+          obstacle->m_pos2 = MT_Vector3(vi[0], vi[2], vi[1]);
+          obstacle->m_rad = 0;
+          UpdateSegmentWorldPosition(obstacle);
+        }
       }
     }
   }
@@ -252,29 +369,32 @@ void KX_ObstacleSimulation::AddObstaclesForNavMesh(KX_NavMeshObject *navmeshobj)
 
 void KX_ObstacleSimulation::DestroyObstacleForObj(KX_GameObject *gameobj)
 {
-  for (size_t i = 0; i < m_obstacles.size();) {
-    if (m_obstacles[i]->m_gameObj == gameobj) {
-      KX_Obstacle *obstacle = m_obstacles[i];
-      m_obstacles[i] = m_obstacles.back();
-      m_obstacles.pop_back();
-      delete obstacle;
-    }
-    else
-      i++;
+  std::map<KX_GameObject *, KX_Obstacles>::iterator it = m_objectObstacles.find(gameobj);
+  if (it == m_objectObstacles.end()) {
+    return;
   }
+
+  for (KX_Obstacle *obstacle : it->second) {
+    RemoveObstacle(obstacle);
+  }
+  m_objectObstacles.erase(it);
 }
 
 void KX_ObstacleSimulation::UpdateObstacles()
 {
+  m_maxObstacleSpeed = 0.0f;
+
   for (size_t i = 0; i < m_obstacles.size(); i++) {
-    if (m_obstacles[i]->m_type == KX_OBSTACLE_NAV_MESH ||
-        m_obstacles[i]->m_shape == KX_OBSTACLE_SEGMENT)
+    KX_Obstacle *obs = m_obstacles[i];
+    if (obs->m_type == KX_OBSTACLE_NAV_MESH || obs->m_shape == KX_OBSTACLE_SEGMENT) {
+      UpdateSegmentWorldPosition(obs);
       continue;
+    }
 
-    KX_Obstacle *obs = m_obstacles[i];
     obs->m_pos = obs->m_gameObj->NodeGetWorldPosition();
     obs->vel[0] = obs->m_gameObj->GetLinearVelocity().x();
     obs->vel[1] = obs->m_gameObj->GetLinearVelocity().y();
+    m_maxObstacleSpeed = std::max(m_maxObstacleSpeed, len_v2(obs->vel));
 
     // Update velocity history and calculate perceived (average) velocity.
     copy_v2_v2(&obs->hvel[obs->hhead * 2], obs->vel);
@@ -284,16 +404,130 @@ void KX_ObstacleSimulation::UpdateObstacles()
       add_v2_v2v2(obs->pvel, obs->pvel, &obs->hvel[j * 2]);
     mul_v2_fl(obs->pvel, 1.0f / VEL_HIST_SIZE);
   }
+
+  BuildGrid();
+}
+
+void KX_ObstacleSimulation::BuildGrid()
+{
+  m_gridDirty = false;
+
+  const int nobs = m_obstacles.size();
+  m_queryStamps.assign(nobs, 0);
+  m_queryStamp = 0;
+  m_obstacleCells.resize(nobs * 4);
+
+  if (nobs == 0) {
+    m_gridWidth = 0;
+    m_gridHeight = 0;
+    m_gridCellStart.clear();
+    m_gridItems.clear();
+    return;
+  }
+
+  float gmin[2] = {FLT_MAX, FLT_MAX};
+  float gmax[2] = {-FLT_MAX, -FLT_MAX};
+  float maxRad = 0.0f;
+  int nvalid = 0;
+  for (KX_Obstacle *obs : m_obstacles) {
+    float bmin[2], bmax[2];
+    obstacleBounds(obs, bmin, bmax);
+    // Obstacles with broken transforms can't be hit and are left out of the grid.
+    if (!obstacleBoundsValid(bmin, bmax)) {
+      continue;
+    }
+    gmin[0] = std::min(gmin[0], bmin[0]);
+    gmin[1] = std::min(gmin[1], bmin[1]);
+    gmax[0] = std::max(gmax[0], bmax[0]);
+    gmax[1] = std::max(gmax[1], bmax[1]);
+    maxRad = std::max(maxRad, (float)obs->m_rad);
+    ++nvalid;
+  }
+
+  if (nvalid == 0) {
+    gmin[0] = gmin[1] = gmax[0] = gmax[1] = 0.0f;
+  }
+
+  // Aim at a few obstacles per cell while keeping an agent in a small number of cells.
+  const float sizex = gmax[0] - gmin[0];
+  const float sizey = gmax[1] - gmin[1];
+  m_gridCellSize = std::max(std::max(sqrtf(sizex * sizey / std::max(nvalid, 1)), maxRad * 2.0f),
+                            0.5f);
+  /* The cell count is computed in floating point, a grid spanning far away obstacles would
+   * overflow an integer. A span too large to fit after a few resizes, or not even representable,
+   * falls back to a single cell. */
+  bool fit = false;
+  for (int i = 0; i < GRID_MAX_RESIZES && std::isfinite(m_gridCellSize); ++i) {
+    const float width = floorf(sizex / m_gridCellSize) + 1.0f;
+    const float height = floorf(sizey / m_gridCellSize) + 1.0f;
+    if ((double)width * (double)height <= (double)GRID_MAX_CELLS) {
+      m_gridWidth = (int)width;
+      m_gridHeight = (int)height;
+      fit = true;
+      break;
+    }
+    m_gridCellSize *= 2.0f;
+  }
+  if (!fit || !std::isfinite(sizex) || !std::isfinite(sizey)) {
+    m_gridCellSize = FLT_MAX;
+    m_gridWidth = 1;
+    m_gridHeight = 1;
+  }
+  m_gridOrigin = MT_Vector2(gmin[0], gmin[1]);
+
+  const float invCellSize = 1.0f / m_gridCellSize;
+  const int ncells = m_gridWidth * m_gridHeight;
+  m_gridCellStart.assign(ncells + 1, 0);
+
+  // Count the items per cell.
+  for (int i = 0; i < nobs; ++i) {
+    float bmin[2], bmax[2];
+    obstacleBounds(m_obstacles[i], bmin, bmax);
+    int *cells = &m_obstacleCells[i * 4];
+    if (!obstacleBoundsValid(bmin, bmax)) {
+      // Empty cell range.
+      cells[0] = cells[1] = 0;
+      cells[2] = cells[3] = -1;
+      continue;
+    }
+
+    cells[0] = gridCoord((bmin[0] - gmin[0]) * invCellSize, m_gridWidth);
+    cells[1] = gridCoord((bmin[1] - gmin[1]) * invCellSize, m_gridHeight);
+    cells[2] = gridCoord((bmax[0] - gmin[0]) * invCellSize, m_gridWidth);
+    cells[3] = gridCoord((bmax[1] - gmin[1]) * invCellSize, m_gridHeight);
+
+    for (int y = cells[1]; y <= cells[3]; ++y) {
+      for (int x = cells[0]; x <= cells[2]; ++x) {
+        ++m_gridCellStart[y * m_gridWidth + x];
+      }
+    }
+  }
+
+  // Accumulate the counts so that each cell stores the end of its items.
+  for (int c = 1; c <= ncells; ++c) {
+    m_gridCellStart[c] += m_gridCellStart[c - 1];
+  }
+  m_gridItems.resize(m_gridCellStart[ncells]);
+
+  // Fill the cells backward, moving each cell start to its first item.
+  for (int i = 0; i < nobs; ++i) {
+    const int *cells = &m_obstacleCells[i * 4];
+    for (int y = cells[1]; y <= cells[3]; ++y) {
+      for (int x = cells[0]; x <= cells[2]; ++x) {
+        m_gridItems[--m_gridCellStart[y * m_gridWidth + x]] = i;
+      }
+    }
+  }
 }
 
 KX_Obstacle *KX_ObstacleSimulation::GetObstacle(KX_GameObject *gameobj)
 {
-  for (size_t i = 0; i < m_obstacles.size(); i++) {
-    if (m_obstacles[i]->m_gameObj == gameobj)
-      return m_obstacles[i];
+  std::map<KX_GameObject *, KX_Obstacles>::iterator it = m_objectObstacles.find(gameobj);
+  if (it == m_objectObstacles.end()) {
+    return nullptr;
   }
 
-  return nullptr;
+  return it->second.front();
 }
 
 void KX_ObstacleSimulation::AdjustObstacleVelocity(KX_Obstacle *activeObst,
@@ -313,16 +547,8 @@ void KX_ObstacleSimulation::DrawObstacles()
   static const int SECTORS_NUM = 32;
   for (size_t i = 0; i < m_obstacles.size(); i++) {
     if (m_obstacles[i]->m_shape == KX_OBSTACLE_SEGMENT) {
-      MT_Vector3 p1 = m_obstacles[i]->m_pos;
-      MT_Vector3 p2 = m_obstacles[i]->m_pos2;
-      // apply world transform
-      if (m_obstacles[i]->m_type == KX_OBSTACLE_NAV_MESH) {
-        KX_NavMeshObject *navmeshobj = static_cast<KX_NavMeshObject *>(m_obstacles[i]->m_gameObj);
-        p1 = navmeshobj->TransformToWorldCoords(p1);
-        p2 = navmeshobj->TransformToWorldCoords(p2);
-      }
-
-      KX_RasterizerDrawDebugLine(p1, p2, bluecolor);
+      KX_RasterizerDrawDebugLine(
+          m_obstacles[i]->m_worldPos, m_obstacles[i]->m_worldPos2, bluecolor);
     }
     else if (m_obstacles[i]->m_shape == KX_OBSTACLE_CIRCLE) {
       KX_RasterizerDrawDebugCircle(
@@ -371,6 +597,51 @@ static bool filterObstacle(KX_Obstacle *activeObst,
   return true;
 }
 
+void KX_ObstacleSimulation::QueryNeighbors(KX_Obstacle *activeObst,
+                                           KX_NavMeshObject *activeNavMeshObj,
+                                           const float radius)
+{
+  if (m_gridDirty) {
+    BuildGrid();
+  }
+
+  m_neighbors.clear();
+  if (m_gridWidth == 0) {
+    return;
+  }
+
+  if (++m_queryStamp == 0) {
+    std::fill(m_queryStamps.begin(), m_queryStamps.end(), 0);
+    m_queryStamp = 1;
+  }
+
+  const float invCellSize = 1.0f / m_gridCellSize;
+  const float px = activeObst->m_pos.x() - m_gridOrigin.x();
+  const float py = activeObst->m_pos.y() - m_gridOrigin.y();
+  const int minx = gridCoord((px - radius) * invCellSize, m_gridWidth);
+  const int miny = gridCoord((py - radius) * invCellSize, m_gridHeight);
+  const int maxx = gridCoord((px + radius) * invCellSize, m_gridWidth);
+  const int maxy = gridCoord((py + radius) * invCellSize, m_gridHeight);
+
+  for (int y = miny; y <= maxy; ++y) {
+    for (int x = minx; x <= maxx; ++x) {
+      const int cell = y * m_gridWidth + x;
+      for (int i = m_gridCellStart[cell], end = m_gridCellStart[cell + 1]; i < end; ++i) {
+        const int index = m_gridItems[i];
+        if (m_queryStamps[index] == m_queryStamp) {
+          continue;
+        }
+        m_queryStamps[index] = m_queryStamp;
+
+        KX_Obstacle *ob = m_obstacles[index];
+        if (filterObstacle(activeObst, activeNavMeshObj, ob, m_levelHeight)) {
+          m_neighbors.push_back(ob);
+        }
+      }
+    }
+  }
+}
+
 ///////////*********TOI_rays**********/////////////////
 KX_ObstacleSimulationTOI::KX_ObstacleSimulationTOI(MT_Scalar levelHeight, bool enableVisualization)
     : KX_ObstacleSimulation(levelHeight, enableVisualization),
@@ -390,14 +661,19 @@ void KX_ObstacleSimulationTOI::AdjustObstacleVelocity(KX_Obstacle *activeObst,
                                                       MT_Scalar maxDeltaSpeed,
                                                       MT_Scalar maxDeltaAngle)
 {
-  int nobs = m_obstacles.size();
-  int obstidx = std::find(m_obstacles.begin(), m_obstacles.end(), activeObst) -
-                m_obstacles.begin();
-  if (obstidx == nobs)
+  const int obstidx = activeObst->m_index;
+  if (obstidx < 0 || obstidx >= (int)m_obstacles.size() || m_obstacles[obstidx] != activeObst)
     return;
 
   vset(activeObst->dvel, velocity.x(), velocity.y());
 
+  /* Only obstacles reachable before the max TOI affect the sampling. The relative velocity of
+   * a sample is bounded by twice the sample velocity, itself at most twice the desired
+   * velocity, plus the agent and obstacle velocities. */
+  const float relSpeed = 4.0f * len_v2(activeObst->dvel) + len_v2(activeObst->vel) +
+                         m_maxObstacleSpeed;
+  QueryNeighbors(activeObst, activeNavMeshObj, activeObst->m_rad + relSpeed * m_maxToi);
+
   // apply RVO
   sampleRVO(activeObst, activeNavMeshObj, maxDeltaAngle);
 
@@ -427,6 +703,104 @@ struct TOICircle {
   float minToi, maxToi;         // Min/max TOI (seconds)
 };
 
+struct RaysSampleData {
+  KX_Obstacle *activeObst;
+  const KX_Obstacles *obstacles;
+  MT_Vector2 vel;
+  float vmax;
+  float odir;
+  float aoff;
+  int maxSamples;
+  float minToi;
+  float maxToi;
+  float velWeight;
+  float toiWeight;
+  float collisionWeight;
+  TOICircle *tc;
+  float *scores;
+};
+
+static void sample_ray_task_func(void *__restrict userdata,
+                                 int iter,
+                                 const TaskParallelTLS *__restrict tls)
+{
+  const RaysSampleData *data = (const RaysSampleData *)userdata;
+  KX_Obstacle *activeObst = data->activeObst;
+  const MT_Vector2 &vel = data->vel;
+
+  // Calculate sample velocity
+  const float ndir = ((float)iter / (float)data->maxSamples) - data->aoff;
+  const float dir = data->odir + ndir * (float)M_PI * 2.0f;
+  MT_Vector2 svel;
+  svel.x() = cosf(dir) * data->vmax;
+  svel.y() = sinf(dir) * data->vmax;
+
+  // Find min time of impact and exit amongst all obstacles.
+  float tmin = data->maxToi;
+  float tmine = 0.0f;
+  for (KX_Obstacle *ob : *data->obstacles) {
+    float htmin, htmax;
+
+    if (ob->m_shape == KX_OBSTACLE_CIRCLE) {
+      MT_Vector2 vab;
+      if (len_v2(ob->vel) < 0.01f * 0.01f) {
+        // Stationary, use VO
+        vab = svel;
+      }
+      else {
+        // Moving, use RVO
+        vab = 2 * svel - vel - MT_Vector2(ob->vel);
+      }
+
+      if (!sweepCircleCircle(activeObst->m_pos.to2d(),
+                             activeObst->m_rad,
+                             vab,
+                             ob->m_pos.to2d(),
+                             ob->m_rad,
+                             htmin,
+                             htmax)) {
+        continue;
+      }
+    }
+    else if (ob->m_shape == KX_OBSTACLE_SEGMENT) {
+      if (!sweepCircleSegment(activeObst->m_pos.to2d(),
+                              activeObst->m_rad,
+                              svel,
+                              ob->m_worldPos.to2d(),
+                              ob->m_worldPos2.to2d(),
+                              ob->m_rad,
+                              htmin,
+                              htmax)) {
+        continue;
+      }
+    }
+    else {
+      continue;
+    }
+
+    if (htmin > 0.0f) {
+      // The closest obstacle is somewhere ahead of us, keep track of nearest obstacle.
+      if (htmin < tmin)
+        tmin = htmin;
+    }
+    else if (htmax > 0.0f) {
+      // The agent overlaps the obstacle, keep track of first safe exit.
+      if (htmax > tmine)
+        tmine = htmax;
+    }
+  }
+
+  // Calculate sample penalties and final score.
+  const float apen = data->velWeight * fabsf(ndir);
+  const float tpen = data->toiWeight * (1.0f / (0.0001f + tmin / data->maxToi));
+  const float cpen = data->collisionWeight * (tmine / data->minToi) * (tmine / data->minToi);
+  data->scores[iter] = apen + tpen + cpen;
+
+  data->tc->dir[iter] = dir;
+  data->tc->toi[iter] = tmin;
+  data->tc->toie[iter] = tmine;
+}
+
 KX_ObstacleSimulationTOI_rays::KX_ObstacleSimulationTOI_rays(MT_Scalar levelHeight,
                                                              bool enableVisualization)
     : KX_ObstacleSimulationTOI(levelHeight, enableVisualization)
@@ -462,100 +836,36 @@ void KX_ObstacleSimulationTOI_rays::sampleRVO(KX_Obstacle *activeObst,
   const int iforw = m_maxSamples / 2;
   const float aoff = (float)iforw / (float)m_maxSamples;
 
-  size_t nobs = m_obstacles.size();
+  float scores[AVOID_MAX_STEPS];
+
+  RaysSampleData data;
+  data.activeObst = activeObst;
+  data.obstacles = &m_neighbors;
+  data.vel = vel;
+  data.vmax = vmax;
+  data.odir = odir;
+  data.aoff = aoff;
+  data.maxSamples = m_maxSamples;
+  data.minToi = m_minToi;
+  data.maxToi = m_maxToi;
+  data.velWeight = m_velWeight;
+  data.toiWeight = m_toiWeight;
+  data.collisionWeight = m_collisionWeight;
+  data.tc = &tc;
+  data.scores = scores;
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (m_maxSamples * (int)m_neighbors.size() >= PARALLEL_MIN_TESTS);
+  BLI_task_parallel_range(0, m_maxSamples, &data, sample_ray_task_func, &settings);
+
+  // Update best score.
   for (int iter = 0; iter < m_maxSamples; ++iter) {
-    // Calculate sample velocity
-    const float ndir = ((float)iter / (float)m_maxSamples) - aoff;
-    const float dir = odir + ndir * (float)M_PI * 2.0f;
-    MT_Vector2 svel;
-    svel.x() = cosf(dir) * vmax;
-    svel.y() = sinf(dir) * vmax;
-
-    // Find min time of impact and exit amongst all obstacles.
-    float tmin = m_maxToi;
-    float tmine = 0.0f;
-    for (int i = 0; i < nobs; ++i) {
-      KX_Obstacle *ob = m_obstacles[i];
-      bool res = filterObstacle(activeObst, activeNavMeshObj, ob, m_levelHeight);
-      if (!res)
-        continue;
-
-      float htmin, htmax;
-
-      if (ob->m_shape == KX_OBSTACLE_CIRCLE) {
-        MT_Vector2 vab;
-        if (len_v2(ob->vel) < 0.01f * 0.01f) {
-          // Stationary, use VO
-          vab = svel;
-        }
-        else {
-          // Moving, use RVO
-          vab = 2 * svel - vel - MT_Vector2(ob->vel);
-        }
-
-        if (!sweepCircleCircle(activeObst->m_pos.to2d(),
-                               activeObst->m_rad,
-                               vab,
-                               ob->m_pos.to2d(),
-                               ob->m_rad,
-                               htmin,
-                               htmax)) {
-          continue;
-        }
-      }
-      else if (ob->m_shape == KX_OBSTACLE_SEGMENT) {
-        MT_Vector3 p1 = ob->m_pos;
-        MT_Vector3 p2 = ob->m_pos2;
-        // apply world transform
-        if (ob->m_type == KX_OBSTACLE_NAV_MESH) {
-          KX_NavMeshObject *navmeshobj = static_cast<KX_NavMeshObject *>(ob->m_gameObj);
-          p1 = navmeshobj->TransformToWorldCoords(p1);
-          p2 = navmeshobj->TransformToWorldCoords(p2);
-        }
-
-        if (!sweepCircleSegment(activeObst->m_pos.to2d(),
-                                activeObst->m_rad,
-                                svel,
-                                p1.to2d(),
-                                p2.to2d(),
-                                ob->m_rad,
-                                htmin,
-                                htmax)) {
-          continue;
-        }
-      }
-      else {
-        continue;
-      }
-
-      if (htmin > 0.0f) {
-        // The closest obstacle is somewhere ahead of us, keep track of nearest obstacle.
-        if (htmin < tmin)
-          tmin = htmin;
-      }
-      else if (htmax > 0.0f) {
-        // The agent overlaps the obstacle, keep track of first safe exit.
-        if (htmax > tmine)
-          tmine = htmax;
-      }
+    if (scores[iter] < bestScore) {
+      bestDir = tc.dir[iter];
+      bestToi = tc.toi[iter];
+      bestScore = scores[iter];
     }
-
-    // Calculate sample penalties and final score.
-    const float apen = m_velWeight * fabsf(ndir);
-    const float tpen = m_toiWeight * (1.0f / (0.0001f + tmin / m_maxToi));
-    const float cpen = m_collisionWeight * (tmine / m_minToi) * (tmine / m_minToi);
-    const float score = apen + tpen + cpen;
-
-    // Update best score.
-    if (score < bestScore) {
-      bestDir = dir;
-      bestToi = tmin;
-      bestScore = score;
-    }
-
-    tc.dir[iter] = dir;
-    tc.toi[iter] = tmin;
-    tc.toie[iter] = tmine;
   }
 
   if (len_v2(activeObst->vel) > 0.1f) {
@@ -587,15 +897,161 @@ void KX_ObstacleSimulationTOI_rays::sampleRVO(KX_Obstacle *activeObst,
 
 ///////////********* TOI_cells**********/////////////////
 
+struct CellsSampleData {
+  KX_Obstacle *activeObst;
+  const KX_Obstacles *obstacles;
+  float activeObstPos[2];
+  float ivmax;
+  const float *spos;
+  float maxToi;
+  float velWeight;
+  float curVelWeight;
+  float sideWeight;
+  float toiWeight;
+  float *penalties;
+};
+
+static void sample_cell_task_func(void *__restrict userdata,
+                                  int n,
+                                  const TaskParallelTLS *__restrict tls)
+{
+  const CellsSampleData *data = (const CellsSampleData *)userdata;
+  KX_Obstacle *activeObst = data->activeObst;
+  const float *activeObstPos = data->activeObstPos;
+
+  float vcand[2];
+  copy_v2_v2(vcand, &data->spos[n * 2]);
+
+  // Find min time of impact and exit amongst all obstacles.
+  float tmin = data->maxToi;
+  float side = 0;
+  int nside = 0;
+
+  for (KX_Obstacle *ob : *data->obstacles) {
+    float htmin, htmax;
+
+    if (ob->m_shape == KX_OBSTACLE_CIRCLE) {
+      float vab[2];
+
+      // Moving, use RVO
+      mul_v2_v2fl(vab, vcand, 2);
+      sub_v2_v2v2(vab, vab, activeObst->vel);
+      sub_v2_v2v2(vab, vab, ob->vel);
+
+      // Side
+      // NOTE: dp, and dv are constant over the whole calculation,
+      // they can be precomputed per object.
+      const float *pa = activeObstPos;
+      float pb[2];
+      vset(pb, ob->m_pos.x(), ob->m_pos.y());
+
+      const float orig[2] = {0, 0};
+      float dp[2], dv[2], np[2];
+      sub_v2_v2v2(dp, pb, pa);
+      normalize_v2(dp);
+      sub_v2_v2v2(dv, ob->dvel, activeObst->dvel);
+
+      /* TODO: use line_point_side_v2 */
+      if (area_tri_signed_v2(orig, dp, dv) < 0.01f) {
+        np[0] = -dp[1];
+        np[1] = dp[0];
+      }
+      else {
+        np[0] = dp[1];
+        np[1] = -dp[0];
+      }
+
+      side += clamp(std::min(dot_v2v2(dp, vab), dot_v2v2(np, vab)) * 2.0f, 0.0f, 1.0f);
+      nside++;
+
+      if (!sweepCircleCircle(activeObst->m_pos.to2d(),
+                             activeObst->m_rad,
+                             MT_Vector2(vab),
+                             ob->m_pos.to2d(),
+                             ob->m_rad,
+                             htmin,
+                             htmax)) {
+        continue;
+      }
+
+      // Handle overlapping obstacles.
+      if (htmin < 0.0f && htmax > 0.0f) {
+        // Avoid more when overlapped.
+        htmin = -htmin * 0.5f;
+      }
+    }
+    else if (ob->m_shape == KX_OBSTACLE_SEGMENT) {
+      float p[2], q[2];
+      vset(p, ob->m_worldPos.x(), ob->m_worldPos.y());
+      vset(q, ob->m_worldPos2.x(), ob->m_worldPos2.y());
+
+      // NOTE: the segments are assumed to come from a navmesh which is shrunken by
+      // the agent radius, hence the use of really small radius.
+      // This can be handle more efficiently by using seg-seg test instead.
+      // If the whole segment is to be treated as obstacle, use agent->rad instead of 0.01f!
+      const float r = 0.01f;  // agent->rad
+      if (dist_squared_to_line_segment_v2(activeObstPos, p, q) < sqr(r + ob->m_rad)) {
+        float sdir[2], snorm[2];
+        sub_v2_v2v2(sdir, q, p);
+        snorm[0] = sdir[1];
+        snorm[1] = -sdir[0];
+        // If the velocity is pointing towards the segment, no collision.
+        if (dot_v2v2(snorm, vcand) < 0.0f)
+          continue;
+        // Else immediate collision.
+        htmin = 0.0f;
+        htmax = 10.0f;
+      }
+      else {
+        if (!sweepCircleSegment(MT_Vector2(activeObstPos),
+                                r,
+                                MT_Vector2(vcand),
+                                MT_Vector2(p),
+                                MT_Vector2(q),
+                                ob->m_rad,
+                                htmin,
+                                htmax))
+          continue;
+      }
+
+      // Avoid less when facing walls.
+      htmin *= 2.0f;
+    }
+    else {
+      continue;
+    }
+
+    if (htmin >= 0.0f) {
+      // The closest obstacle is somewhere ahead of us, keep track of nearest obstacle.
+      if (htmin < tmin)
+        tmin = htmin;
+    }
+  }
+
+  /* Normalize side bias, to prevent it dominating too much.
+   * The bias is averaged over the neighbors only, which are all the obstacles a sample can reach
+   * before maxToi. Averaging over every obstacle of the level made the avoidance of an agent
+   * depend on the number of unrelated agents far away, and would cost a test per obstacle and
+   * per sample again. */
+  if (nside)
+    side /= nside;
+
+  const float vpen = data->velWeight * (len_v2v2(vcand, activeObst->dvel) * data->ivmax);
+  const float vcpen = data->curVelWeight * (len_v2v2(vcand, activeObst->vel) * data->ivmax);
+  const float spen = data->sideWeight * side;
+  const float tpen = data->toiWeight * (1.0f / (0.1f + tmin / data->maxToi));
+
+  data->penalties[n] = vpen + vcpen + spen + tpen;
+}
+
 static void processSamples(KX_Obstacle *activeObst,
-                           KX_NavMeshObject *activeNavMeshObj,
-                           KX_Obstacles &obstacles,
-                           float levelHeight,
+                           const KX_Obstacles &obstacles,
                            const float vmax,
                            const float *spos,
                            const float cs,
                            const int nspos,
                            float *res,
+                           float *penalties,
                            float maxToi,
                            float velWeight,
                            float curVelWeight,
@@ -604,149 +1060,29 @@ static void processSamples(KX_Obstacle *activeObst,
 {
   vset(res, 0, 0);
 
-  const float ivmax = 1.0f / vmax;
-
-  float activeObstPos[2];
-  vset(activeObstPos, activeObst->m_pos.x(), activeObst->m_pos.y());
+  CellsSampleData data;
+  data.activeObst = activeObst;
+  data.obstacles = &obstacles;
+  vset(data.activeObstPos, activeObst->m_pos.x(), activeObst->m_pos.y());
+  data.ivmax = 1.0f / vmax;
+  data.spos = spos;
+  data.maxToi = maxToi;
+  data.velWeight = velWeight;
+  data.curVelWeight = curVelWeight;
+  data.sideWeight = sideWeight;
+  data.toiWeight = toiWeight;
+  data.penalties = penalties;
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (nspos * (int)obstacles.size() >= PARALLEL_MIN_TESTS);
+  BLI_task_parallel_range(0, nspos, &data, sample_cell_task_func, &settings);
 
   float minPenalty = FLT_MAX;
-
   for (int n = 0; n < nspos; ++n) {
-    float vcand[2];
-    copy_v2_v2(vcand, &spos[n * 2]);
-
-    // Find min time of impact and exit amongst all obstacles.
-    float tmin = maxToi;
-    float side = 0;
-    int nside = 0;
-
-    for (int i = 0; i < obstacles.size(); ++i) {
-      KX_Obstacle *ob = obstacles[i];
-      bool found = filterObstacle(activeObst, activeNavMeshObj, ob, levelHeight);
-      if (!found)
-        continue;
-      float htmin, htmax;
-
-      if (ob->m_shape == KX_OBSTACLE_CIRCLE) {
-        float vab[2];
-
-        // Moving, use RVO
-        mul_v2_v2fl(vab, vcand, 2);
-        sub_v2_v2v2(vab, vab, activeObst->vel);
-        sub_v2_v2v2(vab, vab, ob->vel);
-
-        // Side
-        // NOTE: dp, and dv are constant over the whole calculation,
-        // they can be precomputed per object.
-        const float *pa = activeObstPos;
-        float pb[2];
-        vset(pb, ob->m_pos.x(), ob->m_pos.y());
-
-        const float orig[2] = {0, 0};
-        float dp[2], dv[2], np[2];
-        sub_v2_v2v2(dp, pb, pa);
-        normalize_v2(dp);
-        sub_v2_v2v2(dv, ob->dvel, activeObst->dvel);
-
-        /* TODO: use line_point_side_v2 */
-        if (area_tri_signed_v2(orig, dp, dv) < 0.01f) {
-          np[0] = -dp[1];
-          np[1] = dp[0];
-        }
-        else {
-          np[0] = dp[1];
-          np[1] = -dp[0];
-        }
-
-        side += clamp(std::min(dot_v2v2(dp, vab), dot_v2v2(np, vab)) * 2.0f, 0.0f, 1.0f);
-        nside++;
-
-        if (!sweepCircleCircle(activeObst->m_pos.to2d(),
-                               activeObst->m_rad,
-                               MT_Vector2(vab),
-                               ob->m_pos.to2d(),
-                               ob->m_rad,
-                               htmin,
-                               htmax)) {
-          continue;
-        }
-
-        // Handle overlapping obstacles.
-        if (htmin < 0.0f && htmax > 0.0f) {
-          // Avoid more when overlapped.
-          htmin = -htmin * 0.5f;
-        }
-      }
-      else if (ob->m_shape == KX_OBSTACLE_SEGMENT) {
-        MT_Vector3 p1 = ob->m_pos;
-        MT_Vector3 p2 = ob->m_pos2;
-        // apply world transform
-        if (ob->m_type == KX_OBSTACLE_NAV_MESH) {
-          KX_NavMeshObject *navmeshobj = static_cast<KX_NavMeshObject *>(ob->m_gameObj);
-          p1 = navmeshobj->TransformToWorldCoords(p1);
-          p2 = navmeshobj->TransformToWorldCoords(p2);
-        }
-        float p[2], q[2];
-        vset(p, p1.x(), p1.y());
-        vset(q, p2.x(), p2.y());
-
-        // NOTE: the segments are assumed to come from a navmesh which is shrunken by
-        // the agent radius, hence the use of really small radius.
-        // This can be handle more efficiently by using seg-seg test instead.
-        // If the whole segment is to be treated as obstacle, use agent->rad instead of 0.01f!
-        const float r = 0.01f;  // agent->rad
-        if (dist_squared_to_line_segment_v2(activeObstPos, p, q) < sqr(r + ob->m_rad)) {
-          float sdir[2], snorm[2];
-          sub_v2_v2v2(sdir, q, p);
-          snorm[0] = sdir[1];
-          snorm[1] = -sdir[0];
-          // If the velocity is pointing towards the segment, no collision.
-          if (dot_v2v2(snorm, vcand) < 0.0f)
-            continue;
-          // Else immediate collision.
-          htmin = 0.0f;
-          htmax = 10.0f;
-        }
-        else {
-          if (!sweepCircleSegment(MT_Vector2(activeObstPos),
-                                  r,
-                                  MT_Vector2(vcand),
-                                  MT_Vector2(p),
-                                  MT_Vector2(q),
-                                  ob->m_rad,
-                                  htmin,
-                                  htmax))
-            continue;
-        }
-
-        // Avoid less when facing walls.
-        htmin *= 2.0f;
-      }
-      else {
-        continue;
-      }
-
-      if (htmin >= 0.0f) {
-        // The closest obstacle is somewhere ahead of us, keep track of nearest obstacle.
-        if (htmin < tmin)
-          tmin = htmin;
-      }
-    }
-
-    // Normalize side bias, to prevent it dominating too much.
-    if (nside)
-      side /= nside;
-
-    const float vpen = velWeight * (len_v2v2(vcand, activeObst->dvel) * ivmax);
-    const float vcpen = curVelWeight * (len_v2v2(vcand, activeObst->vel) * ivmax);
-    const float spen = sideWeight * side;
-    const float tpen = toiWeight * (1.0f / (0.1f + tmin / maxToi));
-
-    const float penalty = vpen + vcpen + spen + tpen;
-
-    if (penalty < minPenalty) {
-      minPenalty = penalty;
-      copy_v2_v2(res, vcand);
+    if (penalties[n] < minPenalty) {
+      minPenalty = penalties[n];
+      copy_v2_v2(res, &spos[n * 2]);
     }
   }
 }
@@ -758,7 +1094,8 @@ void KX_ObstacleSimulationTOI_cells::sampleRVO(KX_Obstacle *activeObst,
   vset(activeObst->nvel, 0.f, 0.f);
   float vmax = len_v2(activeObst->dvel);
 
-  float *spos = new float[2 * m_maxSamples];
+  float *spos = m_samplePositions.data();
+  float *penalties = m_samplePenalties.data();
   int nspos = 0;
 
   if (!m_adaptive) {
@@ -781,14 +1118,13 @@ void KX_ObstacleSimulationTOI_cells::sampleRVO(KX_Obstacle *activeObst,
       }
     }
     processSamples(activeObst,
-                   activeNavMeshObj,
-                   m_obstacles,
-                   m_levelHeight,
+                   m_neighbors,
                    vmax,
                    spos,
                    cs / 2,
                    nspos,
                    activeObst->nvel,
+                   penalties,
                    m_maxToi,
                    m_velWeight,
                    m_curVelWeight,
@@ -822,14 +1158,13 @@ void KX_ObstacleSimulationTOI_cells::sampleRVO(KX_Obstacle *activeObst,
       }
 
       processSamples(activeObst,
-                     activeNavMeshObj,
-                     m_obstacles,
-                     m_levelHeight,
+                     m_neighbors,
                      vmax,
                      spos,
                      cs / 2,
                      nspos,
                      res,
+                     penalties,
                      m_maxToi,
                      m_velWeight,
                      m_curVelWeight,
@@ -840,8 +1175,6 @@ void KX_ObstacleSimulationTOI_cells::sampleRVO(KX_Obstacle *activeObst,
     }
     copy_v2_v2(activeObst->nvel, res);
   }
-
-  delete[] spos;
 }
 
 KX_ObstacleSimulationTOI_cells::KX_ObstacleSimulationTOI_cells(MT_Scalar levelHeight,
@@ -857,4 +1190,7 @@ KX_ObstacleSimulationTOI_cells::KX_ObstacleSimulationTOI_cells(MT_Scalar levelHe
   m_curVelWeight = 0.75f;
   m_toiWeight = 2.5f;
   m_collisionWeight = 0.75f;  // side_weight
+
+  m_samplePositions.resize(m_maxSamples * 2);
+  m_samplePenalties.resize(m_maxSamples);
 }
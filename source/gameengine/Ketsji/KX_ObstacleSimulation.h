@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include <map>
 #include <vector>
 
 #include "MT_Vector2.h"
@@ -58,7 +59,13 @@ struct KX_Obstacle {
   float hvel[VEL_HIST_SIZE * 2];
   int hhead;
 
+  /// World space end points of segment obstacles, updated in UpdateObstacles().
+  MT_Vector3 m_worldPos;
+  MT_Vector3 m_worldPos2;
+
   KX_GameObject *m_gameObj;
+  /// Index in the simulation obstacle list.
+  int m_index;
 };
 typedef std::vector<KX_Obstacle *> KX_Obstacles;
 
@@ -66,10 +73,41 @@ class KX_ObstacleSimulation {
  protected:
   KX_Obstacles m_obstacles;
 
+  /// Obstacles owned by each game object, a nav mesh owns all its segments.
+  std::map<KX_GameObject *, KX_Obstacles> m_objectObstacles;
+
   MT_Scalar m_levelHeight;
   bool m_enableVisualization;
 
+  /// Uniform grid of obstacle indices in the XY plane, rebuilt in UpdateObstacles().
+  MT_Vector2 m_gridOrigin;
+  float m_gridCellSize;
+  int m_gridWidth;
+  int m_gridHeight;
+  /// First item of each cell in m_gridItems, the last entry is the total number of items.
+  std::vector<int> m_gridCellStart;
+  std::vector<int> m_gridItems;
+  /// Cell range covered by each obstacle: min x, min y, max x, max y.
+  std::vector<int> m_obstacleCells;
+  /// True when obstacles were added or removed since the grid was built.
+  bool m_gridDirty;
+  /// Largest speed of the circle obstacles, used to bound the query radius.
+  float m_maxObstacleSpeed;
+
+  /// Stamp of the last query per obstacle, to skip obstacles spanning several cells.
+  std::vector<unsigned int> m_queryStamps;
+  unsigned int m_queryStamp;
+  /// Obstacles found by the last QueryNeighbors() call.
+  KX_Obstacles m_neighbors;
+
   KX_Obstacle *CreateObstacle(KX_GameObject *gameobj);
+  void RemoveObstacle(KX_Obstacle *obstacle);
+  void UpdateSegmentWorldPosition(KX_Obstacle *obstacle);
+  void BuildGrid();
+  /// Fill m_neighbors with the obstacles relevant for an agent in a radius around it.
+  void QueryNeighbors(KX_Obstacle *activeObst,
+                      KX_NavMeshObject *activeNavMeshObj,
+                      const float radius);
 
  public:
   KX_ObstacleSimulation(MT_Scalar levelHeight, bool enableVisualization);
@@ -99,6 +137,7 @@ class KX_ObstacleSimulationTOI : public KX_ObstacleSimulation {
   float m_toiWeight;        // Sample selection TOI weight
   float m_collisionWeight;  // Sample selection collision weight
 
+  /// Compute the steering velocity of an agent avoiding the obstacles in m_neighbors.
   virtual void sampleRVO(KX_Obstacle *activeObst,
                          KX_NavMeshObject *activeNavMeshObj,
                          const float maxDeltaAngle) = 0;
@@ -127,6 +166,9 @@ class KX_ObstacleSimulationTOI_cells : public KX_ObstacleSimulationTOI {
   float m_bias;
   bool m_adaptive;
   int m_sampleRadius;
+  /// Sample velocities and their penalties, sized to m_maxSamples.
+  std::vector<float> m_samplePositions;
+  std::vector<float> m_samplePenalties;
   virtual void sampleRVO(KX_Obstacle *activeObst,
                          KX_NavMeshObject *activeNavMeshObj,
                          const float maxDeltaAngle);
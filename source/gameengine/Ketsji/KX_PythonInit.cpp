@@ -104,6 +104,8 @@
 #include "BL_Converter.h"
 #include "BL_Shader.h"
 #include "CM_Message.h"
+#include "CM_Trace.h"
+#include "KX_GlobalDictStorage.h"
 #include "KX_Globals.h"
 #include "KX_LibLoadStatus.h"
 #include "KX_MeshProxy.h" /* for creating a new library of mesh objects */
@@ -145,6 +147,7 @@
 static SCA_PythonKeyboard *gp_PythonKeyboard = nullptr;
 static SCA_PythonMouse *gp_PythonMouse = nullptr;
 static SCA_PythonJoystick *gp_PythonJoysticks[JOYINDEX_MAX] = {nullptr};
+static KX_GlobalDictStorage *gp_GlobalDictStorage = nullptr;
 
 static struct {
   PyObject *path;
@@ -256,11 +259,34 @@ static PyObject *gPyRestartGame(PyObject *)
 }
 
 PyDoc_STRVAR(gPySaveGlobalDict_doc,
-             "saveGlobalDict()\n"
-             "Saves bge.logic.globalDict to a file");
-static PyObject *gPySaveGlobalDict(PyObject *)
+             "saveGlobalDict(asynchronous=False, delta=False, callback=None)\n"
+             "Saves bge.logic.globalDict to a file, delta appends only the changed items and\n"
+             "asynchronous writes the file in background, callback receives the success");
+static PyObject *gPySaveGlobalDict(PyObject *, PyObject *args, PyObject *kwds)
 {
-  saveGamePythonConfig();
+  int asynchronous = 0, delta = 0;
+  PyObject *callback = Py_None;
+
+  static const char *kwlist[] = {"asynchronous", "delta", "callback", nullptr};
+
+  if (!PyArg_ParseTupleAndKeywords(args,
+                                   kwds,
+                                   "|iiO:saveGlobalDict",
+                                   const_cast<char **>(kwlist),
+                                   &asynchronous,
+                                   &delta,
+                                   &callback))
+  {
+    return nullptr;
+  }
+
+  if (callback != Py_None && !PyCallable_Check(callback)) {
+    PyErr_SetString(PyExc_TypeError,
+                    "saveGlobalDict(asynchronous, delta, callback): callback must be callable");
+    return nullptr;
+  }
+
+  saveGamePythonConfig(delta, asynchronous, (callback == Py_None) ? nullptr : callback);
 
   Py_RETURN_NONE;
 }
@@ -283,6 +309,44 @@ static PyObject *gPyGetProfileInfo(PyObject *)
   return KX_GetActiveEngine()->GetPyProfileDict();
 }
 
+PyDoc_STRVAR(gPyGetSceneProfileInfo_doc,
+             "getSceneProfileInfo()\n"
+             "returns a dictionary with profiling information per scene");
+static PyObject *gPyGetSceneProfileInfo(PyObject *)
+{
+  return KX_GetActiveEngine()->GetPySceneProfileDict();
+}
+
+PyDoc_STRVAR(gPySetTraceEnabled_doc,
+             "setTraceEnabled(enabled, frameThreshold=0.0)\n"
+             "enables the recording of a trace of the engine, written when a frame takes longer\n"
+             "than frameThreshold milliseconds if not zero");
+static PyObject *gPySetTraceEnabled(PyObject *, PyObject *args)
+{
+  int enabled;
+  float threshold = 0.0f;
+  if (!PyArg_ParseTuple(args, "i|f:setTraceEnabled", &enabled, &threshold)) {
+    return nullptr;
+  }
+
+  CM_Trace::SetFrameThreshold(threshold * 1.0e-3);
+  CM_Trace::SetEnabled(enabled);
+  Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(gPyWriteTrace_doc,
+             "writeTrace(filepath)\n"
+             "writes the recorded trace in the Chrome trace format and returns True on success");
+static PyObject *gPyWriteTrace(PyObject *, PyObject *args)
+{
+  char *filepath;
+  if (!PyArg_ParseTuple(args, "s:writeTrace", &filepath)) {
+    return nullptr;
+  }
+
+  return PyBool_FromLong(CM_Trace::Write(filepath));
+}
+
 PyDoc_STRVAR(gPySendMessage_doc,
              "sendMessage(subject, [body, to, from])\n"
              "sends a message in same manner as a message actuator"
@@ -370,6 +434,32 @@ static PyObject *gPyGetRender(PyObject *)
   return PyBool_FromLong(KX_GetActiveEngine()->GetRender());
 }
 
+static PyObject *gPySetFramePacing(PyObject *, PyObject *args)
+{
+  int mode;
+  if (!PyArg_ParseTuple(args, "i:setFramePacing", &mode))
+    return nullptr;
+
+  if (mode < KX_FramePacer::PACING_CAPPED || mode > KX_FramePacer::PACING_RENDER_ON_CHANGE) {
+    PyErr_SetString(PyExc_ValueError, "setFramePacing(mode): mode must be a KX_PACING_* value");
+    return nullptr;
+  }
+
+  KX_GetActiveEngine()->SetFramePacing((KX_FramePacer::Mode)mode);
+  Py_RETURN_NONE;
+}
+
+static PyObject *gPyGetFramePacing(PyObject *)
+{
+  return PyLong_FromLong(KX_GetActiveEngine()->GetFramePacing());
+}
+
+static PyObject *gPyRequestRender(PyObject *)
+{
+  KX_GetActiveEngine()->RequestRender();
+  Py_RETURN_NONE;
+}
+
 static PyObject *gPySetMaxLogicFrame(PyObject *, PyObject *args)
 {
   int frame;
@@ -758,6 +848,31 @@ static PyObject *gLibList(PyObject *, PyObject *args)
   return list;
 }
 
+static PyObject *gLibMergeBudget(PyObject *, PyObject *args)
+{
+  float budget;
+
+  if (!PyArg_ParseTuple(args, "f:setLibLoadMergeBudget", &budget)) {
+    return nullptr;
+  }
+
+  if (budget < 0.0f) {
+    PyErr_SetString(PyExc_ValueError,
+                    "bge.logic.setLibLoadMergeBudget(budget): expected a positive budget");
+    return nullptr;
+  }
+
+  // The budget is in milliseconds.
+  KX_GetActiveEngine()->GetConverter()->SetMergeBudget(budget * 0.001);
+
+  Py_RETURN_NONE;
+}
+
+static PyObject *gLibGetMergeBudget(PyObject *)
+{
+  return PyFloat_FromDouble(KX_GetActiveEngine()->GetConverter()->GetMergeBudget() * 1000.0);
+}
+
 struct PyNextFrameState pynextframestate;
 static PyObject *gPyNextFrame(PyObject *)
 {
@@ -783,7 +898,7 @@ static struct PyMethodDef game_methods[] = {
     {"restartGame", (PyCFunction)gPyRestartGame, METH_NOARGS, (const char *)gPyRestartGame_doc},
     {"saveGlobalDict",
      (PyCFunction)gPySaveGlobalDict,
-     METH_NOARGS,
+     METH_VARARGS | METH_KEYWORDS,
      (const char *)gPySaveGlobalDict_doc},
     {"loadGlobalDict",
      (PyCFunction)gPyLoadGlobalDict,
@@ -854,6 +969,18 @@ static struct PyMethodDef game_methods[] = {
      (PyCFunction)gPyGetRender,
      METH_NOARGS,
      (const char *)"get the global render flag value"},
+    {"setFramePacing",
+     (PyCFunction)gPySetFramePacing,
+     METH_VARARGS,
+     (const char *)"Set how the fixed frames are waited and rendered"},
+    {"getFramePacing",
+     (PyCFunction)gPyGetFramePacing,
+     METH_NOARGS,
+     (const char *)"Get how the fixed frames are waited and rendered"},
+    {"requestRender",
+     (PyCFunction)gPyRequestRender,
+     METH_NOARGS,
+     (const char *)"Render the next frame when rendering only on change"},
     {"getUseExternalClock",
      (PyCFunction)gPyGetUseExternalClock,
      METH_NOARGS,
@@ -918,11 +1045,25 @@ static struct PyMethodDef game_methods[] = {
      METH_NOARGS,
      (const char *)"Render next frame (if Python has control)"},
     {"getProfileInfo", (PyCFunction)gPyGetProfileInfo, METH_NOARGS, gPyGetProfileInfo_doc},
+    {"getSceneProfileInfo",
+     (PyCFunction)gPyGetSceneProfileInfo,
+     METH_NOARGS,
+     gPyGetSceneProfileInfo_doc},
+    {"setTraceEnabled", (PyCFunction)gPySetTraceEnabled, METH_VARARGS, gPySetTraceEnabled_doc},
+    {"writeTrace", (PyCFunction)gPyWriteTrace, METH_VARARGS, gPyWriteTrace_doc},
     /* library functions */
     {"LibLoad", (PyCFunction)gLibLoad, METH_VARARGS | METH_KEYWORDS, (const char *)""},
     {"LibNew", (PyCFunction)gLibNew, METH_VARARGS, (const char *)""},
     {"LibFree", (PyCFunction)gLibFree, METH_VARARGS, (const char *)""},
     {"LibList", (PyCFunction)gLibList, METH_VARARGS, (const char *)""},
+    {"setLibLoadMergeBudget",
+     (PyCFunction)gLibMergeBudget,
+     METH_VARARGS,
+     (const char *)"Sets the time in milliseconds spent merging libraries per frame"},
+    {"getLibLoadMergeBudget",
+     (PyCFunction)gLibGetMergeBudget,
+     METH_NOARGS,
+     (const char *)"Gets the time in milliseconds spent merging libraries per frame"},
 
     {nullptr, (PyCFunction) nullptr, 0, nullptr}};
 
@@ -995,6 +1136,7 @@ static PyObject *gPySetEyeSeparation(PyObject *, PyObject *args)
   }
 
   KX_GetActiveEngine()->GetRasterizer()->SetEyeSeparation(sep);
+  KX_GetActiveEngine()->RequestRender();
 
   Py_RETURN_NONE;
 }
@@ -1022,6 +1164,7 @@ static PyObject *gPySetFocalLength(PyObject *, PyObject *args)
   }
 
   KX_GetActiveEngine()->GetRasterizer()->SetFocalLength(focus);
+  KX_GetActiveEngine()->RequestRender();
 
   Py_RETURN_NONE;
 }
@@ -1113,6 +1256,7 @@ static PyObject *gPySetAnisotropicFiltering(PyObject *, PyObject *args)
   }
 
   KX_GetActiveEngine()->GetRasterizer()->SetAnisotropicFiltering(level);
+  KX_GetActiveEngine()->RequestRender();
 
   Py_RETURN_NONE;
 }
@@ -1203,6 +1347,7 @@ static PyObject *gPySetMipmapping(PyObject *, PyObject *args)
   }
 
   KX_GetActiveEngine()->GetRasterizer()->SetMipmapping((RAS_Rasterizer::MipmapOption)val);
+  KX_GetActiveEngine()->RequestRender();
   Py_RETURN_NONE;
 }
 
@@ -1681,6 +1826,11 @@ PyMODINIT_FUNC initGameLogicPythonBinding()
       d, KX_DYN_DISABLE_RIGID_BODY, SCA_DynamicActuator::KX_DYN_DISABLE_RIGID_BODY);
   KX_MACRO_addTypesToDict(d, KX_DYN_SET_MASS, SCA_DynamicActuator::KX_DYN_SET_MASS);
 
+  /* Frame Pacing */
+  KX_MACRO_addTypesToDict(d, KX_PACING_CAPPED, KX_FramePacer::PACING_CAPPED);
+  KX_MACRO_addTypesToDict(d, KX_PACING_UNCAPPED_RENDER, KX_FramePacer::PACING_UNCAPPED_RENDER);
+  KX_MACRO_addTypesToDict(d, KX_PACING_RENDER_ON_CHANGE, KX_FramePacer::PACING_RENDER_ON_CHANGE);
+
   /* Input & Mouse Sensor */
   KX_MACRO_addTypesToDict(d, KX_INPUT_NONE, SCA_InputEvent::NONE);
   KX_MACRO_addTypesToDict(d, KX_INPUT_JUST_ACTIVATED, SCA_InputEvent::JUSTACTIVATED);
@@ -1816,6 +1966,12 @@ PyMODINIT_FUNC initGameLogicPythonBinding()
   KX_MACRO_addTypesToDict(d, KX_ACTION_BLEND_BLEND, BL_Action::ACT_BLEND_BLEND);
   KX_MACRO_addTypesToDict(d, KX_ACTION_BLEND_ADD, BL_Action::ACT_BLEND_ADD);
 
+  /* KX_Scene animation culling */
+  KX_MACRO_addTypesToDict(d, KX_ANIMATION_CULLING_NONE, KX_Scene::ANIMATION_CULLING_NONE);
+  KX_MACRO_addTypesToDict(
+      d, KX_ANIMATION_CULLING_INVISIBLE, KX_Scene::ANIMATION_CULLING_INVISIBLE);
+  KX_MACRO_addTypesToDict(d, KX_ANIMATION_CULLING_FRUSTUM, KX_Scene::ANIMATION_CULLING_FRUSTUM);
+
   /* Mouse Actuator object axis*/
   KX_MACRO_addTypesToDict(
       d, KX_ACT_MOUSE_OBJECT_AXIS_X, SCA_MouseActuator::KX_ACT_MOUSE_OBJECT_AXIS_X);
@@ -2292,6 +2448,10 @@ void exitGamePlayerPythonScripting()
     }
   }
 
+  // Finish the pending globalDict save.
+  delete gp_GlobalDictStorage;
+  gp_GlobalDictStorage = nullptr;
+
   /* since python restarts we cant let the python backup of the sys.path hang around in a global
    * pointer */
   restorePySysObjects(); /* get back the original sys.path and clear the backup */
@@ -2507,6 +2667,10 @@ void exitGamePythonScripting()
     }
   }
 
+  // Finish the pending globalDict save.
+  delete gp_GlobalDictStorage;
+  gp_GlobalDictStorage = nullptr;
+
   restorePySysObjects(); /* get back the original sys.path and clear the backup */
   bpy_import_main_set(nullptr);
   EXP_PyObjectPlus::ClearDeprecationWarning();
@@ -2955,35 +3119,23 @@ PyMODINIT_FUNC initApplicationPythonBinding()
 }
 
 // utility function for loading and saving the globalDict
-void saveGamePythonConfig()
+static KX_GlobalDictStorage *getGlobalDictStorage()
+{
+  if (!gp_GlobalDictStorage) {
+    gp_GlobalDictStorage = new KX_GlobalDictStorage();
+  }
+  return gp_GlobalDictStorage;
+}
+
+void saveGamePythonConfig(bool delta, bool asynchronous, PyObject *callback)
 {
-  char *marshal_buffer = nullptr;
-  int marshal_length = 0;
   PyObject *gameLogic = PyImport_ImportModule("GameLogic");
   if (gameLogic) {
     PyObject *pyGlobalDict = PyDict_GetItemString(PyModule_GetDict(gameLogic),
                                                   "globalDict");  // Same as importing the module
-    if (pyGlobalDict) {
-#  ifdef Py_MARSHAL_VERSION
-      PyObject *pyGlobalDictMarshal = PyMarshal_WriteObjectToString(
-          pyGlobalDict, 2);  // Py_MARSHAL_VERSION == 2 as of Py2.5
-#  else
-      PyObject *pyGlobalDictMarshal = PyMarshal_WriteObjectToString(pyGlobalDict);
-#  endif
-      if (pyGlobalDictMarshal) {
-        // for testing only
-        // PyObject_Print(pyGlobalDictMarshal, stderr, 0);
-        char *marshal_cstring;
-
-        marshal_cstring = PyBytes_AsString(pyGlobalDictMarshal);  // py3 uses byte arrays
-        marshal_length = PyBytes_Size(pyGlobalDictMarshal);
-        marshal_buffer = new char[marshal_length + 1];
-        memcpy(marshal_buffer, marshal_cstring, marshal_length);
-        Py_DECREF(pyGlobalDictMarshal);
-      }
-      else {
-        CM_Error("bge.logic.globalDict could not be marshal'd");
-      }
+    if (pyGlobalDict && PyDict_Check(pyGlobalDict)) {
+      getGlobalDictStorage()->Save(
+          pyGlobalDict, pathGamePythonConfig(), delta, asynchronous, callback);
     }
     else {
       CM_Error("bge.logic.globalDict was removed");
@@ -2994,29 +3146,12 @@ void saveGamePythonConfig()
     PyErr_Clear();
     CM_Error("bge.logic failed to import bge.logic.globalDict will be lost");
   }
+}
 
-  std::string marshal_path = pathGamePythonConfig();
-
-  if (marshal_length && marshal_buffer) {
-    FILE *fp = fopen(marshal_path.c_str(), "wb");
-
-    if (fp) {
-      if (fwrite(marshal_buffer, 1, marshal_length, fp) != marshal_length) {
-        CM_Error("could not write marshal data");
-      }
-
-      fclose(fp);
-    }
-    else {
-      CM_Error("could not open marshal file");
-    }
-  }
-  else {
-    CM_Error("could not create marshal buffer");
-  }
-
-  if (marshal_buffer) {
-    delete[] marshal_buffer;
+void updateGamePythonConfig()
+{
+  if (gp_GlobalDictStorage) {
+    gp_GlobalDictStorage->Update();
   }
 }
 
@@ -3024,6 +3159,22 @@ void loadGamePythonConfig()
 {
   std::string marshal_path = pathGamePythonConfig();
 
+  PyObject *gameLogic = PyImport_ImportModule("GameLogic");
+  if (gameLogic) {
+    PyObject *pyGlobalDict = PyDict_GetItemString(PyModule_GetDict(gameLogic),
+                                                  "globalDict");  // Same as importing the module
+    const bool loaded = pyGlobalDict && PyDict_Check(pyGlobalDict) &&
+                        getGlobalDictStorage()->Load(pyGlobalDict, marshal_path);
+    Py_DECREF(gameLogic);
+    if (loaded) {
+      return;
+    }
+  }
+  else {
+    PyErr_Clear();
+  }
+
+  // Files saved before the snapshot format hold a single marshal of the dictionary.
   FILE *fp = fopen(marshal_path.c_str(), "rb");
 
   if (fp) {
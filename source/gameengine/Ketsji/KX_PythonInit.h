@@ -70,8 +70,12 @@ void setupGamePython(KX_KetsjiEngine *ketsjiengine,
                      struct bContext *C,
                      bool *audioDeviceIsInitialized);
 std::string pathGamePythonConfig();
-void saveGamePythonConfig();
+void saveGamePythonConfig(bool delta = false,
+                          bool asynchronous = false,
+                          PyObject *callback = nullptr);
 void loadGamePythonConfig();
+/// Run the callback of a finished asynchronous globalDict save.
+void updateGamePythonConfig();
 
 /// Create a python interpreter and stop the engine until the interpreter is active.
 void createPythonConsole();
@@ -32,6 +32,8 @@
 
 #include "KX_RayCast.h"
 
+#include <vector>
+
 #include "CM_Message.h"
 
 KX_RayCast::KX_RayCast(PHY_IPhysicsController *ignoreController, bool faceNormal, bool faceUV)
@@ -117,3 +119,37 @@ bool KX_RayCast::RayTest(PHY_IPhysicsEnvironment *physics_environment,
   }
   return false;
 }
+
+void KX_RayCast::RayTestBatch(PHY_IPhysicsEnvironment *physics_environment,
+                              KX_RayCast *const *callbacks,
+                              const float *frompoints,
+                              const float *topoints,
+                              unsigned int numRays,
+                              PHY_RayCastResult *results)
+{
+  if (physics_environment == nullptr || numRays == 0) {
+    return;
+  }
+
+  const std::vector<PHY_IRayCastFilterCallback *> filters(callbacks, callbacks + numRays);
+  physics_environment->RayTestBatch(filters.data(), frompoints, topoints, numRays, results);
+
+  for (unsigned int i = 0; i < numRays; ++i) {
+    KX_RayCast *callback = callbacks[i];
+    callback->m_hitFound = false;
+    PHY_RayCastResult &result = results[i];
+    if (!result.m_controller) {
+      continue;
+    }
+
+    KX_ClientObjectInfo *info = static_cast<KX_ClientObjectInfo *>(
+        result.m_controller->GetNewClientInfo());
+    if (!info) {
+      BLI_assert(info && "Physics controller with no client object info");
+      continue;
+    }
+
+    callback->reportHit(&result);
+    callback->RayHit(info);
+  }
+}
@@ -97,6 +97,19 @@ class KX_RayCast : public PHY_IRayCastFilterCallback {
                       const MT_Vector3 &frompoint,
                       const MT_Vector3 &topoint,
                       KX_RayCast &callback);
+
+  /** Cast a batch of rays on several threads, the ray coordinates are stored by three floats in
+   * frompoints and topoints. NeedRayCast and RayHit of the callbacks are called on the calling
+   * thread, RayHit for the closest hit of each ray. Unlike RayTest the hit can't be skipped to
+   * continue the ray.
+   * \param results Preallocated results of numRays size.
+   */
+  static void RayTestBatch(PHY_IPhysicsEnvironment *physics_environment,
+                           KX_RayCast *const *callbacks,
+                           const float *frompoints,
+                           const float *topoints,
+                           unsigned int numRays,
+                           PHY_RayCastResult *results);
 };
 
 template<class T, class dataT> class KX_RayCast::Callback : public KX_RayCast {
@@ -0,0 +1,83 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Ketsji/KX_RayEventManager.cpp
+ *  \ingroup ketsji
+ */
+
+#include "KX_RayEventManager.h"
+
+#include "SCA_RaySensor.h"
+
+KX_RayEventManager::KX_RayEventManager(class SCA_LogicManager *logicmgr,
+                                       PHY_IPhysicsEnvironment *physEnv)
+    : SCA_EventManager(logicmgr, RAY_EVENTMGR), m_physEnv(physEnv)
+{
+}
+
+KX_RayEventManager::~KX_RayEventManager()
+{
+}
+
+void KX_RayEventManager::NextFrame()
+{
+  m_callbacks.clear();
+  m_callbackPtrs.clear();
+  m_fromPoints.clear();
+  m_toPoints.clear();
+
+  /* Gather the rays of the sensors evaluated in this frame only, the hit state of the other
+   * sensors is kept until their next evaluation. */
+  for (SCA_ISensor *sensor : m_sensors) {
+    if (!sensor->IsEvaluated()) {
+      continue;
+    }
+
+    SCA_RaySensor *raysensor = static_cast<SCA_RaySensor *>(sensor);
+    MT_Vector3 frompoint, topoint;
+    PHY_IPhysicsController *ignoreController = raysensor->ComputeRay(frompoint, topoint);
+    m_callbacks.emplace_back(raysensor, ignoreController);
+    m_fromPoints.insert(m_fromPoints.end(), {frompoint.x(), frompoint.y(), frompoint.z()});
+    m_toPoints.insert(m_toPoints.end(), {topoint.x(), topoint.y(), topoint.z()});
+    raysensor->SetRayBatched();
+  }
+
+  const unsigned int numRays = m_callbacks.size();
+  if (numRays > 0) {
+    for (KX_RayCast::Callback<SCA_RaySensor, void> &callback : m_callbacks) {
+      m_callbackPtrs.push_back(&callback);
+    }
+    m_results.resize(numRays);
+
+    // Cast all the rays and set the hit state of the sensors.
+    KX_RayCast::RayTestBatch(m_physEnv,
+                             m_callbackPtrs.data(),
+                             m_fromPoints.data(),
+                             m_toPoints.data(),
+                             numRays,
+                             m_results.data());
+  }
+
+  for (SCA_ISensor *sensor : m_sensors) {
+    sensor->Activate(m_logicmgr);
+  }
+}
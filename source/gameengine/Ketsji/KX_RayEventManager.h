@@ -0,0 +1,55 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file KX_RayEventManager.h
+ *  \ingroup ketsji
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "KX_RayCast.h"
+#include "SCA_EventManager.h"
+
+class SCA_RaySensor;
+class PHY_IPhysicsEnvironment;
+
+/** Event manager of the ray sensors, the rays of all the sensors evaluated in a frame are cast
+ * in a single batch before the sensors evaluation.
+ */
+class KX_RayEventManager : public SCA_EventManager {
+  PHY_IPhysicsEnvironment *m_physEnv;
+
+  /// Buffers of the batch, kept between the frames to avoid allocations.
+  std::vector<KX_RayCast::Callback<SCA_RaySensor, void>> m_callbacks;
+  std::vector<KX_RayCast *> m_callbackPtrs;
+  std::vector<float> m_fromPoints;
+  std::vector<float> m_toPoints;
+  std::vector<PHY_RayCastResult> m_results;
+
+ public:
+  KX_RayEventManager(class SCA_LogicManager *logicmgr, PHY_IPhysicsEnvironment *physEnv);
+  virtual ~KX_RayEventManager();
+
+  virtual void NextFrame();
+};
@@ -57,6 +57,7 @@
 #include "wm_event_system.h"
 #include "xr/wm_xr.h"
 
+#include "BL_ActionManager.h"
 #include "BL_Converter.h"
 #include "BL_DataConversion.h"
 #include "BL_SceneConverter.h"
@@ -75,8 +76,10 @@
 #include "KX_NodeRelationships.h"
 #include "KX_ObstacleSimulation.h"
 #include "KX_PyMath.h"
+#include "KX_RayEventManager.h"
 #include "PHY_IPhysicsController.h"
 #include "PHY_IPhysicsEnvironment.h"
+#include "PIL_time.h"
 #include "RAS_BucketManager.h"
 #include "RAS_FrameBuffer.h"
 #include "SCA_2DFilterActuator.h"
@@ -87,6 +90,7 @@
 #include "SCA_MouseManager.h"
 #include "SCA_TimeEventManager.h"
 #include "SG_Controller.h"
+#include "SG_Familly.h"
 
 #ifdef WITH_PYTHON
 #  include "EXP_PythonCallBack.h"
@@ -121,11 +125,17 @@ bool KX_Scene::KX_ScenegraphRescheduleFunc(SG_Node *node, void *gameobj, void *s
   return node->Reschedule(((KX_Scene *)scene)->m_sghead);
 }
 
+void KX_Scene::KX_ScenegraphRenderDirtyFunc(SG_Node *node, void *gameobj, void *scene)
+{
+  ((KX_Scene *)scene)->AddTransformSyncObject((KX_GameObject *)gameobj);
+}
+
 SG_Callbacks KX_Scene::m_callbacks = SG_Callbacks(KX_SceneReplicationFunc,
                                                   KX_SceneDestructionFunc,
                                                   KX_GameObject::UpdateTransformFunc,
                                                   KX_Scene::KX_ScenegraphUpdateFunc,
-                                                  KX_Scene::KX_ScenegraphRescheduleFunc);
+                                                  KX_Scene::KX_ScenegraphRescheduleFunc,
+                                                  KX_Scene::KX_ScenegraphRenderDirtyFunc);
 
 KX_Scene::KX_Scene(SCA_IInputDevice *inputDevice,
                    const std::string &sceneName,
@@ -140,7 +150,9 @@ KX_Scene::KX_Scene(SCA_IInputDevice *inputDevice,
       m_overlayCamera(nullptr),               // eevee (For overlay collections)
       m_sceneConverter(nullptr),              // eevee
       m_isPythonMainLoop(false),              // eevee
+      m_hasPythonLogic(false),
       m_collectionRemap(false),               // eevee (to uncheck viewport restrictflag)
+      m_numSyncedObjects(0),
       m_keyboardmgr(nullptr),
       m_mousemgr(nullptr),
       m_physicsEnvironment(0),
@@ -149,6 +161,9 @@ KX_Scene::KX_Scene(SCA_IInputDevice *inputDevice,
       m_overrideCullingCamera(nullptr),
       m_ueberExecutionPriority(0),
       m_blenderScene(scene),
+      m_animationCulling(ANIMATION_CULLING_NONE),
+      m_sceneChanged(true),
+      m_logger(m_clock, 25),
       m_isActivedHysteresis(false),
       m_lodHysteresisValue(0),
       m_isRuntime(true)  // eevee
@@ -203,7 +218,9 @@ KX_Scene::KX_Scene(SCA_IInputDevice *inputDevice,
       m_obstacleSimulation = nullptr;
   }
 
-  m_animationPool = BLI_task_pool_create(&m_animationPoolData, TASK_PRIORITY_LOW);
+  for (int i = 0; i < tc_numCategories; ++i) {
+    m_logger.AddCategory(i);
+  }
 
 #ifdef WITH_PYTHON
   m_attr_dict = nullptr;
@@ -277,7 +294,12 @@ KX_Scene::KX_Scene(SCA_IInputDevice *inputDevice,
   CTX_wm_view3d(C)->shading.type = KX_GetActiveEngine()->ShadingTypeRuntime();
   ConfigureOverlays();
 
-  if (!KX_GetActiveEngine()->UseViewportRender()) {
+  if (KX_GetActiveEngine()->GetFlag(KX_KetsjiEngine::HEADLESS)) {
+    /* No render loop and no eevee cache in headless mode, the materials are converted
+     * without GPU material like in viewport render. */
+    scene->flag |= SCE_INTERACTIVE;
+  }
+  else if (!KX_GetActiveEngine()->UseViewportRender()) {
     /* We want to indicate that we are in bge runtime. The flag can be used in draw code but in
      * depsgraph code too later */
     scene->flag |= SCE_INTERACTIVE;
@@ -325,7 +347,10 @@ KX_Scene::~KX_Scene()
   }
   /*************************/
 
-  if (!KX_GetActiveEngine()->UseViewportRender()) {
+  if (KX_GetActiveEngine()->GetFlag(KX_KetsjiEngine::HEADLESS)) {
+    // Nothing was rendered, no GPU viewport to free.
+  }
+  else if (!KX_GetActiveEngine()->UseViewportRender()) {
     if (!m_isPythonMainLoop) {
       /* This will free m_gpuViewport and m_gpuOffScreen */
       DRW_game_render_loop_end();
@@ -380,10 +405,6 @@ KX_Scene::~KX_Scene()
   if (m_obstacleSimulation)
     delete m_obstacleSimulation;
 
-  if (m_animationPool) {
-    BLI_task_pool_free(m_animationPool);
-  }
-
   if (m_objectlist)
     m_objectlist->Release();
 
@@ -749,9 +770,10 @@ void KX_Scene::RenderAfterCameraSetup(KX_Camera *cam,
   }
 
   /* Notify the depsgraph if object transform changed in the scene
-   * for next drawing loop. */
-  for (KX_GameObject *gameobj : GetObjectList()) {
-    gameobj->TagForTransformUpdate(is_overlay_pass, is_last_render_pass);
+   * for next drawing loop. Only the objects moved since the last frame
+   * are visited, see KX_ScenegraphRenderDirtyFunc. */
+  for (KX_GameObject *gameobj : m_transformSyncObjects) {
+    gameobj->TagForTransformUpdate(bmain, depsgraph, is_overlay_pass, is_last_render_pass);
   }
 
   /* Notify depsgraph for other changes */
@@ -767,8 +789,11 @@ void KX_Scene::RenderAfterCameraSetup(KX_Camera *cam,
   //UpdateParents(0.0);
 
   /* Update evaluated object object_to_world according to SceneGraph. */
-  for (KX_GameObject *gameobj : GetObjectList()) {
-    gameobj->TagForTransformUpdateEvaluated();
+  SyncTransformsEvaluated(depsgraph);
+
+  if (is_last_render_pass) {
+    m_numSyncedObjects = m_transformSyncObjects.size();
+    m_transformSyncObjects.clear();
   }
 
   engine->EndCountDepsgraphTime();
@@ -1183,6 +1208,16 @@ void KX_Scene::SetIsPythonMainLoop(bool isPythonMainLoop)
   m_isPythonMainLoop = isPythonMainLoop;
 }
 
+void KX_Scene::SetHasPythonLogic()
+{
+  m_hasPythonLogic = true;
+}
+
+bool KX_Scene::HasPythonLogic() const
+{
+  return m_hasPythonLogic || m_isPythonMainLoop;
+}
+
 void KX_Scene::AddObjToLodObjList(KX_GameObject *gameobj)
 {
   std::vector<KX_GameObject *>::iterator it = std::find(
@@ -1337,21 +1372,78 @@ bool KX_Scene::SomethingIsMoving()
 void KX_Scene::AppendToIdsToUpdateInAllRenderPasses(ID *id, IDRecalcFlag flag)
 {
   std::pair<ID *, IDRecalcFlag> it = {id, flag};
+  m_idsToUpdateLock.Lock();
   if (std::find(m_idsToUpdateInAllRenderPasses.begin(),
                 m_idsToUpdateInAllRenderPasses.end(),
                 it) == m_idsToUpdateInAllRenderPasses.end()) {
     m_idsToUpdateInAllRenderPasses.push_back(it);
   }
+  m_idsToUpdateLock.Unlock();
 }
 
 void KX_Scene::AppendToIdsToUpdateInOverlayPass(ID *id, IDRecalcFlag flag)
 {
   std::pair<ID *, IDRecalcFlag> it = {id, flag};
+  m_idsToUpdateLock.Lock();
   if (std::find(m_idsToUpdateInOverlayPass.begin(),
                 m_idsToUpdateInOverlayPass.end(),
                 it) == m_idsToUpdateInOverlayPass.end()) {
     m_idsToUpdateInOverlayPass.push_back(it);
   }
+  m_idsToUpdateLock.Unlock();
+}
+
+void KX_Scene::AddTransformSyncObject(KX_GameObject *gameobj)
+{
+  m_transformSyncLock.Lock();
+  m_transformSyncObjects.push_back(gameobj);
+  m_transformSyncLock.Unlock();
+}
+
+struct SyncTransformData {
+  KX_GameObject **objects;
+  Depsgraph *depsgraph;
+};
+
+static void sync_transform_evaluated_func(void *__restrict userdata,
+                                          int iter,
+                                          const TaskParallelTLS *__restrict tls)
+{
+  SyncTransformData *data = (SyncTransformData *)userdata;
+  data->objects[iter]->TagForTransformUpdateEvaluated(data->depsgraph);
+}
+
+void KX_Scene::SyncTransformsEvaluated(Depsgraph *depsgraph)
+{
+  /* Objects driven by blender or which can't have their original object transformed
+   * are not in the dirty list and must be synced at each render pass. This only checks
+   * object flags, without any depsgraph or matrix access for the other objects. */
+  for (KX_GameObject *gameobj : GetObjectList()) {
+    Object *ob_orig = gameobj->GetBlenderObject();
+    if (!ob_orig) {
+      continue;
+    }
+    if (ob_orig->transflag & OB_TRANSFLAG_OVERRIDE_GAME_PRIORITY) {
+      gameobj->SyncTransformWithDepsgraph();
+    }
+    else if (!gameobj->GetSGNode()->IsDirty(SG_Node::DIRTY_RENDER) &&
+             !OrigObCanBeTransformedInRealtime(ob_orig)) {
+      gameobj->TagForTransformUpdateEvaluated(depsgraph);
+    }
+  }
+
+  /* The evaluated objects are independent, sync them in parallel. */
+  SyncTransformData data = {m_transformSyncObjects.data(), depsgraph};
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 64;
+  BLI_task_parallel_range(
+      0, m_transformSyncObjects.size(), &data, sync_transform_evaluated_func, &settings);
+}
+
+int KX_Scene::GetNumSyncedObjects() const
+{
+  return m_numSyncedObjects;
 }
 
 void KX_Scene::TagForExtraIdsUpdate(Main *bmain, KX_Camera *cam)
@@ -1934,10 +2026,31 @@ void KX_Scene::DupliGroupRecurse(KX_GameObject *groupobj, int level)
   }
 }
 
+void KX_Scene::SetObjectLifespan(KX_GameObject *gameobj, float lifespan)
+{
+  // add a timebomb to this object
+  // lifespan of zero means 'this object lives forever'
+  if (lifespan > 0.0f) {
+    // for now, convert between so called frames and realtime
+    m_tempObjectList.push_back(gameobj);
+    // this convert the life from frames to sort-of seconds, hard coded 0.016666667 that assumes we have
+    // 60 frames per second if you change this value, make sure you change it in
+    // KX_GameObject::pyattr_get_life property too
+    EXP_Value *fval = new EXP_FloatValue(lifespan * 0.016666667f);
+    gameobj->SetProperty("::timebomb", fval);
+    fval->Release();
+  }
+}
+
 KX_GameObject *KX_Scene::AddReplicaObject(KX_GameObject *originalobject,
                                           KX_GameObject *referenceobject,
                                           float lifespan)
 {
+  KX_GameObject *recycled = RecyclePooledObject(originalobject, referenceobject, lifespan);
+  if (recycled) {
+    return recycled;
+  }
+
   m_logicHierarchicalGameObjects.clear();
   m_map_gameobject_to_replica.clear();
   m_groupGameObjects.clear();
@@ -1950,19 +2063,13 @@ KX_GameObject *KX_Scene::AddReplicaObject(KX_GameObject *originalobject,
   // lets create a replica
   KX_GameObject *replica = (KX_GameObject *)AddNodeReplicaObject(nullptr, originalobj);
 
-  // add a timebomb to this object
-  // lifespan of zero means 'this object lives forever'
-  if (lifespan > 0.0f) {
-    // for now, convert between so called frames and realtime
-    m_tempObjectList.push_back(replica);
-    // this convert the life from frames to sort-of seconds, hard coded 0.016666667 that assumes we have
-    // 60 frames per second if you change this value, make sure you change it in
-    // KX_GameObject::pyattr_get_life property too
-    EXP_Value *fval = new EXP_FloatValue(lifespan * 0.016666667f);
-    replica->SetProperty("::timebomb", fval);
-    fval->Release();
+  // the replica will be parked in the pool of its original object at removal
+  if (!m_objectPools.empty() && m_objectPools.find(originalobj) != m_objectPools.end()) {
+    replica->SetPoolOriginal(originalobj);
   }
 
+  SetObjectLifespan(replica, lifespan);
+
   // add to 'rootparent' list (this is the list of top hierarchy objects, updated each frame)
   m_parentlist->Add(CM_AddRef(replica));
 
@@ -2034,6 +2141,240 @@ KX_GameObject *KX_Scene::AddReplicaObject(KX_GameObject *originalobject,
   return replica;
 }
 
+/** Return true if the object runs a python prototype or components, these must be disposed
+ * when the object is removed and started again with a fresh state and proxy, which is what
+ * creating a new replica does.
+ */
+static bool object_has_python_logic(KX_GameObject *gameobj)
+{
+  return (gameobj->GetPrototype() || gameobj->GetComponents());
+}
+
+KX_GameObject *KX_Scene::RecyclePooledObject(KX_GameObject *originalobj,
+                                             KX_GameObject *referenceobj,
+                                             float lifespan)
+{
+  if (m_objectPools.empty()) {
+    return nullptr;
+  }
+
+  const std::map<KX_GameObject *, ObjectPool>::iterator it = m_objectPools.find(originalobj);
+  if (it == m_objectPools.end() || it->second.m_objects.empty()) {
+    return nullptr;
+  }
+
+  KX_GameObject *replica = it->second.m_objects.back();
+  it->second.m_objects.pop_back();
+
+  // restore the properties of the original object, changed during the previous life
+  for (int i = 0, numprops = replica->GetPropertyCount(); i < numprops; ++i) {
+    EXP_Value *prop = replica->GetProperty(i);
+    if (prop->GetProperty("timer")) {
+      m_timemgr->RemoveTimeProperty(prop);
+    }
+  }
+  replica->ClearProperties();
+
+  for (const std::string &name : originalobj->GetPropertyNames()) {
+    EXP_Value *prop = originalobj->GetProperty(name)->GetReplica();
+    if (prop->GetProperty("timer")) {
+      m_timemgr->AddTimeProperty(prop);
+    }
+    replica->SetProperty(name, prop);
+    prop->Release();
+  }
+
+  SetObjectLifespan(replica, lifespan);
+
+  // place the replica as a new one, see AddReplicaObject
+  SG_Node *orgnode = originalobj->GetSGNode();
+  replica->NodeSetLocalScale(orgnode->GetLocalScale());
+  replica->NodeSetLocalPosition(orgnode->GetLocalPosition());
+  replica->NodeSetLocalOrientation(orgnode->GetLocalOrientation());
+
+  if (referenceobj) {
+    replica->NodeSetLocalPosition(referenceobj->NodeGetWorldPosition());
+    replica->NodeSetLocalOrientation(referenceobj->NodeGetWorldOrientation());
+    replica->NodeSetRelativeScale(referenceobj->GetSGNode()->GetRootSGParent()->GetLocalScale());
+    replica->SetLayer(referenceobj->GetLayer());
+  }
+  else {
+    replica->SetLayer(m_blenderScene->lay);
+  }
+
+  replica->GetSGNode()->UpdateWorldData(0);
+
+  replica->RestorePhysics(false);
+  PHY_IPhysicsController *ctrl = replica->GetPhysicsController();
+  if (ctrl) {
+    ctrl->SetLinearVelocity(MT_Vector3(0.0f, 0.0f, 0.0f), false);
+    ctrl->SetAngularVelocity(MT_Vector3(0.0f, 0.0f, 0.0f), false);
+  }
+
+  replica->RestoreLogicAndActions(false);
+  replica->ResetState();
+  replica->SetVisible(originalobj->GetVisible(), false);
+
+  GetBlenderSceneConverter()->RegisterGameObject(replica, replica->GetBlenderObject());
+
+  if (m_obstacleSimulation && originalobj->GetBlenderObject()->gameflag & OB_HASOBSTACLE) {
+    m_obstacleSimulation->AddObstacleForObj(replica);
+  }
+
+  if (KX_GetActiveEngine()->GetFlag(KX_KetsjiEngine::AUTO_ADD_DEBUG_PROPERTIES)) {
+    AddObjectDebugProperties(replica);
+  }
+
+  // the pool reference goes back to the object list
+  m_objectlist->Add(replica);
+
+  // the caller releases the replica as for AddReplicaObject
+  return CM_AddRef(replica);
+}
+
+bool KX_Scene::ParkPooledObject(KX_GameObject *gameobj)
+{
+  KX_GameObject *originalobj = gameobj->GetPoolOriginal();
+  if (!originalobj) {
+    return false;
+  }
+
+  const std::map<KX_GameObject *, ObjectPool>::iterator it = m_objectPools.find(originalobj);
+  if (it == m_objectPools.end()) {
+    return false;
+  }
+
+  ObjectPool &pool = it->second;
+  // objects parented or used as parent during their life can't be recycled
+  if (pool.m_objects.size() >= pool.m_size || gameobj->GetParent() ||
+      !gameobj->GetSGNode()->GetSGChildren().empty() || object_has_python_logic(gameobj))
+  {
+    return false;
+  }
+
+  CM_ListRemoveIfFound(m_euthanasyobjects, gameobj);
+  CM_ListRemoveIfFound(m_tempObjectList, gameobj);
+  CM_ListRemoveIfFound(m_animatedlist, gameobj);
+
+  gameobj->ResetPooledState();
+  // as for a removed object, python must not access the object through its current proxy
+  gameobj->InvalidateProxy();
+
+  RemoveObjectDebugProperties(gameobj);
+  // a parked object must not be found from its blender object, it is registered when recycled
+  GetBlenderSceneConverter()->UnregisterGameObject(gameobj);
+
+  if (m_obstacleSimulation) {
+    m_obstacleSimulation->DestroyObstacleForObj(gameobj);
+  }
+
+  gameobj->SuspendLogicAndActions(false);
+  gameobj->SuspendPhysics(true, false);
+  gameobj->SetVisible(false, false);
+
+  /* The object stays in the root parent list to be freed with the scene,
+   * the pool takes over the reference of the object list. */
+  m_objectlist->RemoveValue(gameobj);
+  pool.m_objects.push_back(gameobj);
+
+  return true;
+}
+
+bool KX_Scene::CanPoolObject(KX_GameObject *gameobj) const
+{
+  switch (gameobj->GetGameObjectType()) {
+    case SCA_IObject::OBJ_ARMATURE:
+    case SCA_IObject::OBJ_CAMERA:
+    case SCA_IObject::OBJ_LIGHT:
+    case SCA_IObject::OBJ_TEXT: {
+      return false;
+    }
+  }
+
+  return (!gameobj->IsDupliGroup() && !object_has_python_logic(gameobj) && gameobj->GetSGNode() &&
+          gameobj->GetSGNode()->GetSGChildren().empty());
+}
+
+void KX_Scene::SetObjectPoolSize(KX_GameObject *gameobj, unsigned int size)
+{
+  const std::map<KX_GameObject *, ObjectPool>::iterator it = m_objectPools.find(gameobj);
+  if (it == m_objectPools.end()) {
+    if (size > 0) {
+      m_objectPools[gameobj].m_size = size;
+    }
+    return;
+  }
+
+  ObjectPool &pool = it->second;
+  pool.m_size = size;
+
+  // the replicas exceeding the pool size are freed at the end of the frame
+  while (pool.m_objects.size() > size) {
+    KX_GameObject *replica = pool.m_objects.back();
+    pool.m_objects.pop_back();
+
+    replica->SetPoolOriginal(nullptr);
+    m_objectlist->Add(replica);
+    DelayedRemoveObject(replica);
+  }
+
+  if (size == 0) {
+    m_objectPools.erase(it);
+
+    // the living replicas are now freed at removal
+    for (KX_GameObject *replica : m_objectlist) {
+      if (replica->GetPoolOriginal() == gameobj) {
+        replica->SetPoolOriginal(nullptr);
+      }
+    }
+  }
+}
+
+unsigned int KX_Scene::PrewarmObjectPool(KX_GameObject *gameobj, unsigned int count)
+{
+  const std::map<KX_GameObject *, ObjectPool>::iterator it = m_objectPools.find(gameobj);
+  if (it == m_objectPools.end()) {
+    return 0;
+  }
+
+  ObjectPool &pool = it->second;
+  count = std::min(count, (unsigned int)(pool.m_size - pool.m_objects.size()));
+
+  // don't recycle the parked replicas while creating the new ones
+  std::vector<KX_GameObject *> parked;
+  parked.swap(pool.m_objects);
+
+  std::vector<KX_GameObject *> replicas(count);
+  for (unsigned int i = 0; i < count; ++i) {
+    replicas[i] = AddReplicaObject(gameobj, nullptr);
+  }
+
+  pool.m_objects.swap(parked);
+
+  for (KX_GameObject *replica : replicas) {
+    ParkPooledObject(replica);
+    // release here because AddReplicaObject AddRef's
+    replica->Release();
+  }
+
+  return count;
+}
+
+void KX_Scene::GetObjectPoolInfo(KX_GameObject *gameobj,
+                                 unsigned int &size,
+                                 unsigned int &available)
+{
+  const std::map<KX_GameObject *, ObjectPool>::const_iterator it = m_objectPools.find(gameobj);
+  if (it == m_objectPools.end()) {
+    size = 0;
+    available = 0;
+  }
+  else {
+    size = it->second.m_size;
+    available = it->second.m_objects.size();
+  }
+}
+
 void KX_Scene::RemoveObject(KX_GameObject *gameobj)
 {
   // disconnect child from parent
@@ -2072,6 +2413,7 @@ void KX_Scene::DelayedRemoveObject(KX_GameObject *gameobj)
 bool KX_Scene::NewRemoveObject(KX_GameObject *gameobj)
 {
   gameobj->Dispose();
+  m_sceneChanged = true;
 
   /* remove property from debug list */
   RemoveObjectDebugProperties(gameobj);
@@ -2142,7 +2484,27 @@ bool KX_Scene::NewRemoveObject(KX_GameObject *gameobj)
 
   gameobj->RemoveMeshes();
 
+  // The removed object must not be synced with the depsgraph anymore.
+  m_transformSyncLock.Lock();
+  m_transformSyncObjects.erase(
+      std::remove(m_transformSyncObjects.begin(), m_transformSyncObjects.end(), gameobj),
+      m_transformSyncObjects.end());
+  m_transformSyncLock.Unlock();
+
   bool ret = true;
+  // the pool of a parked object holds the reference of the object list
+  KX_GameObject *poolOriginal = gameobj->GetPoolOriginal();
+  if (poolOriginal) {
+    const std::map<KX_GameObject *, ObjectPool>::iterator it = m_objectPools.find(poolOriginal);
+    if (it != m_objectPools.end() && CM_ListRemoveIfFound(it->second.m_objects, gameobj)) {
+      ret = (gameobj->Release() != nullptr);
+    }
+  }
+  // the pool of a removed original object is freed
+  if (m_objectPools.find(gameobj) != m_objectPools.end()) {
+    SetObjectPoolSize(gameobj, 0);
+  }
+
   if (m_lightlist->RemoveValue(gameobj)) {
     ret = (gameobj->Release() != nullptr);
   }
@@ -2341,68 +2703,109 @@ void KX_Scene::AddAnimatedObject(KX_GameObject *gameobj)
   CM_ListAddIfNotFound(m_animatedlist, gameobj);
 }
 
-// static void update_anim_thread_func(TaskPool *pool, void *taskdata, int UNUSED(threadid))
-//{
-//  KX_GameObject *gameobj, *parent;
-//  bool needs_update;
-//  KX_Scene::AnimationPoolData *data = (KX_Scene::AnimationPoolData
-//  *)BLI_task_pool_user_data(pool); double curtime = data->curtime;
+bool KX_Scene::ArmatureAnimationIsCulled(KX_GameObject *gameobj)
+{
+  if (m_animationCulling == ANIMATION_CULLING_NONE) {
+    return false;
+  }
 
-//  gameobj = (KX_GameObject *)taskdata;
+  KX_Camera *cam = (m_animationCulling == ANIMATION_CULLING_FRUSTUM) ? GetActiveCamera() :
+                                                                       nullptr;
 
-//  // Non-armature updates are fast enough, so just update them
-//  needs_update = gameobj->GetGameObjectType() != SCA_IObject::OBJ_ARMATURE;
+  // Check for meshes that haven't been culled
+  bool has_mesh = false;
+  for (SG_Node *childnode : gameobj->GetSGNode()->GetSGChildren()) {
+    KX_GameObject *child = static_cast<KX_GameObject *>(childnode->GetSGClientObject());
+    if (!child || child->GetMeshCount() == 0) {
+      continue;
+    }
 
-//  if (!needs_update) {
-//    // If we got here, we're looking to update an armature, so check its children meshes
-//    // to see if we need to bother with a more expensive pose update
-//    const std::vector<KX_GameObject *> children = gameobj->GetChildren();
+    has_mesh = true;
+    if (!child->GetVisible()) {
+      continue;
+    }
 
-//    bool has_mesh = false, has_non_mesh = false;
+    if (!cam) {
+      return false;
+    }
 
-//    // Check for meshes that haven't been culled
-//    for (KX_GameObject *child : children) {
-//      // if (!child->GetCulled()) { // eevee disable armature animation culling
-//      needs_update = true;
-//      break;
-//      //}
+    Object *ob = child->GetBlenderObject();
+    const BoundBox *bb = ob ? BKE_object_boundbox_get(ob) : nullptr;
+    if (!bb) {
+      return false;
+    }
 
-//      if (child->GetMeshCount() == 0)
-//        has_non_mesh = true;
-//      else
-//        has_mesh = true;
-//    }
+    const MT_Matrix4x4 mat(child->NodeGetWorldTransform());
+    if (cam->GetFrustum().AabbInsideFrustum(MT_Vector3(bb->vec[0]), MT_Vector3(bb->vec[6]), mat) !=
+        SG_Frustum::OUTSIDE)
+    {
+      return false;
+    }
+  }
 
-//    // If we didn't find a non-culled mesh, check to see
-//    // if we even have any meshes, and update if this
-//    // armature has only non-mesh children.
-//    if (!needs_update && !has_mesh && has_non_mesh)
-//      needs_update = true;
-//  }
+  /* An armature with only non-mesh children is always updated,
+   * its bones can still move the children. */
+  return has_mesh;
+}
 
-//  // If the object is a culled armature, then we manage only the animation time and end of its
-//  // animations.
-//  gameobj->UpdateActionManager(curtime, needs_update);
+struct AnimationTaskData {
+  KX_GameObject **objects;
+  double curtime;
+};
 
-//  if (needs_update) {
-//    const std::vector<KX_GameObject *> children = gameobj->GetChildren();
-//    parent = gameobj->GetParent();
-//  }
-//}
+static void update_anim_thread_func(void *__restrict userdata,
+                                    int iter,
+                                    const TaskParallelTLS *__restrict tls)
+{
+  AnimationTaskData *data = (AnimationTaskData *)userdata;
+  data->objects[iter]->GetActionManagerNoCreate()->UpdateActions(data->curtime, true);
+}
 
 void KX_Scene::UpdateAnimations(double curtime)
 {
-  // m_animationPoolData.curtime = curtime;
+  m_animationTaskObjects.clear();
 
   for (KX_GameObject *gameobj : m_animatedlist) {
-    // BLI_task_pool_push(m_animationPool, update_anim_thread_func, gameobj, false,
-    // TASK_PRIORITY_LOW);
-    if (!gameobj->IsActionsSuspended()) {
+    // Also make sure the action manager exists before updating it from the animation threads.
+    if (gameobj->IsActionsSuspended()) {
+      continue;
+    }
+
+    if (!m_sceneChanged && gameobj->GetActionManagerNoCreate()->HasPlayingActions()) {
+      m_sceneChanged = true;
+    }
+
+    /* Only the pose evaluation of armatures is thread safe, the other actions modify the
+     * scene graph or blender data shared between objects. */
+    if (gameobj->GetGameObjectType() != SCA_IObject::OBJ_ARMATURE) {
       gameobj->UpdateActionManager(curtime, true);
     }
+    // If the object is a culled armature, then we manage only the animation time and end of its
+    // animations.
+    else if (ArmatureAnimationIsCulled(gameobj)) {
+      gameobj->UpdateActionManager(curtime, false);
+    }
+    else {
+      m_animationTaskObjects.push_back(gameobj);
+    }
   }
 
-  // BLI_task_pool_work_and_wait(m_animationPool);
+  if (m_animationTaskObjects.empty()) {
+    return;
+  }
+
+  AnimationTaskData data = {m_animationTaskObjects.data(), curtime};
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 4;
+  BLI_task_parallel_range(
+      0, m_animationTaskObjects.size(), &data, update_anim_thread_func, &settings);
+
+  // The scene graph controllers of the actions are updated from the main thread.
+  for (KX_GameObject *gameobj : m_animationTaskObjects) {
+    gameobj->GetActionManagerNoCreate()->UpdateIPOs();
+  }
 }
 
 void KX_Scene::LogicUpdateFrame(double curtime)
@@ -2423,7 +2826,10 @@ void KX_Scene::LogicEndFrame()
    * explicitly. NewRemoveObject is the place to do it.
    */
   while (!m_euthanasyobjects.empty()) {
-    RemoveObject(m_euthanasyobjects.front());
+    KX_GameObject *gameobj = m_euthanasyobjects.front();
+    if (!ParkPooledObject(gameobj)) {
+      RemoveObject(gameobj);
+    }
   }
 
   // prepare obstacle simulation for new frame
@@ -2435,16 +2841,134 @@ void KX_Scene::LogicEndFrame()
   }
 }
 
+struct SceneGraphTaskData {
+  SG_Node **nodes;
+  const std::pair<unsigned int, unsigned int> *ranges;
+  double curtime;
+};
+
+static void update_sg_familly_thread_func(void *__restrict userdata,
+                                          int iter,
+                                          const TaskParallelTLS *__restrict tls)
+{
+  SceneGraphTaskData *data = (SceneGraphTaskData *)userdata;
+  const std::pair<unsigned int, unsigned int> &range = data->ranges[iter];
+  for (unsigned int i = range.first; i < range.second; ++i) {
+    data->nodes[i]->UpdateWorldDataThread(data->curtime);
+  }
+}
+
+/// Return true if the node or one of its descendants uses a slow or vertex parent relation.
+static bool sg_node_has_serial_relation(SG_Node *node)
+{
+  if (node->IsSlowParent() || node->IsVertexParent()) {
+    return true;
+  }
+
+  for (SG_Node *child : node->GetSGChildren()) {
+    if (sg_node_has_serial_relation(child)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/** Stamp given to the nodes scheduled by UpdateParents, shared by all the scenes as the merged
+ * nodes keep their stamp. */
+static unsigned int sgUpdateStamp = 0;
+
+/// Return true if the familly of the node uses a slow or vertex parent relation.
+static bool sg_familly_has_serial_relation(SG_Node *node)
+{
+  SG_Familly *familly = node->GetFamilly().get();
+  if (familly->GetRelationState() == SG_Familly::RELATION_UNKNOWN) {
+    SG_Node *root = node;
+    while (root->GetSGParent()) {
+      root = root->GetSGParent();
+    }
+    familly->SetRelationState(sg_node_has_serial_relation(root) ?
+                                  SG_Familly::RELATION_SERIAL :
+                                  SG_Familly::RELATION_PARALLEL);
+  }
+
+  return (familly->GetRelationState() == SG_Familly::RELATION_SERIAL);
+}
+
 /**
  * UpdateParents: SceneGraph transformation update.
+ * The famillies (node hierarchies) are independent and updated in parallel, each under
+ * its familly lock. Famillies using slow or vertex parents keep the serial update.
  */
 void KX_Scene::UpdateParents(double curtime)
 {
   // we use the SG dynamic list
   SG_Node *node;
 
+  m_sgUpdateNodes.clear();
   while ((node = SG_Node::GetNextScheduled(m_sghead)) != nullptr) {
-    node->UpdateWorldData(curtime);
+    m_sgUpdateNodes.push_back(node);
+  }
+
+  if (!m_sgUpdateNodes.empty()) {
+    m_sceneChanged = true;
+
+    // The nodes with a scheduled ancestor are updated by the recursion of this ancestor.
+    const unsigned int stamp = ++sgUpdateStamp;
+    for (SG_Node *scheduledNode : m_sgUpdateNodes) {
+      scheduledNode->SetUpdateStamp(stamp);
+    }
+    const auto hasScheduledParent = [stamp](SG_Node *scheduledNode) {
+      for (SG_Node *parent = scheduledNode->GetSGParent(); parent;
+           parent = parent->GetSGParent()) {
+        if (parent->GetUpdateStamp() == stamp) {
+          return true;
+        }
+      }
+      return false;
+    };
+    m_sgUpdateNodes.erase(
+        std::remove_if(m_sgUpdateNodes.begin(), m_sgUpdateNodes.end(), hasScheduledParent),
+        m_sgUpdateNodes.end());
+
+    // Group the nodes by familly.
+    std::sort(m_sgUpdateNodes.begin(), m_sgUpdateNodes.end(), [](SG_Node *a, SG_Node *b) {
+      return a->GetFamilly().get() < b->GetFamilly().get();
+    });
+
+    m_sgFamillyRanges.clear();
+    m_sgSerialNodes.clear();
+    for (unsigned int i = 0, size = m_sgUpdateNodes.size(); i < size;) {
+      const SG_Familly *familly = m_sgUpdateNodes[i]->GetFamilly().get();
+      const bool serial = sg_familly_has_serial_relation(m_sgUpdateNodes[i]);
+      unsigned int end = i;
+      while (end < size && m_sgUpdateNodes[end]->GetFamilly().get() == familly) {
+        ++end;
+      }
+
+      if (serial) {
+        m_sgSerialNodes.insert(m_sgSerialNodes.end(),
+                               m_sgUpdateNodes.begin() + i,
+                               m_sgUpdateNodes.begin() + end);
+      }
+      else {
+        m_sgFamillyRanges.emplace_back(i, end);
+      }
+      i = end;
+    }
+
+    if (!m_sgFamillyRanges.empty()) {
+      SceneGraphTaskData data = {m_sgUpdateNodes.data(), m_sgFamillyRanges.data(), curtime};
+
+      TaskParallelSettings settings;
+      BLI_parallel_range_settings_defaults(&settings);
+      settings.min_iter_per_thread = 16;
+      BLI_task_parallel_range(
+          0, m_sgFamillyRanges.size(), &data, update_sg_familly_thread_func, &settings);
+    }
+
+    for (SG_Node *serialNode : m_sgSerialNodes) {
+      serialNode->UpdateWorldData(curtime);
+    }
   }
 
   // the list must be empty here
@@ -2557,6 +3081,8 @@ void KX_Scene::SetPhysicsEnvironment(class PHY_IPhysicsEnvironment *physEnv)
   if (m_physicsEnvironment) {
     KX_CollisionEventManager *collisionmgr = new KX_CollisionEventManager(m_logicmgr, physEnv);
     m_logicmgr->RegisterEventManager(collisionmgr);
+    KX_RayEventManager *raymgr = new KX_RayEventManager(m_logicmgr, physEnv);
+    m_logicmgr->RegisterEventManager(raymgr);
   }
 }
 
@@ -2567,20 +3093,10 @@ short KX_Scene::GetAnimationFPS()
 
 static void MergeScene_LogicBrick(SCA_ILogicBrick *brick, KX_Scene *from, KX_Scene *to)
 {
-  SCA_LogicManager *logicmgr = to->GetLogicManager();
-
   brick->Replace_IScene(to);
   brick->Replace_NetworkScene(to->GetNetworkMessageScene());
   brick->SetLogicManager(to->GetLogicManager());
 
-  // If we end up replacing a KX_CollisionEventManager, we need to make sure
-  // physics controllers are properly in place. In other words, do this
-  // after merging physics controllers!
-  SCA_ISensor *sensor = dynamic_cast<class SCA_ISensor *>(brick);
-  if (sensor) {
-    sensor->Replace_EventManager(logicmgr);
-  }
-
   SCA_2DFilterActuator *filter_actuator = dynamic_cast<class SCA_2DFilterActuator *>(brick);
   if (filter_actuator) {
     filter_actuator->SetScene(to, to->Get2DFilterManager());
@@ -2604,12 +3120,6 @@ static void MergeScene_GameObject(KX_GameObject *gameobj, KX_Scene *to, KX_Scene
     MergeScene_LogicBrick(controller, from, to);
   }
 
-  /* graphics controller */
-  PHY_IController *ctrl = gameobj->GetPhysicsController();
-  if (ctrl) {
-    ctrl->SetPhysicsEnvironment(to->GetPhysicsEnvironment());
-  }
-
   /* SG_Node can hold a scene reference */
   SG_Node *sg = gameobj->GetSGNode();
   if (sg) {
@@ -2624,10 +3134,6 @@ static void MergeScene_GameObject(KX_GameObject *gameobj, KX_Scene *to, KX_Scene
     }
   }
 
-  // All armatures should be in the animated object list to be umpdated.
-  if (gameobj->GetGameObjectType() == SCA_IObject::OBJ_ARMATURE)
-    to->AddAnimatedObject(gameobj);
-
   /* Add the object to the scene's logic manager */
   to->GetLogicManager()->RegisterGameObjectName(gameobj->GetName(), gameobj);
   to->GetLogicManager()->RegisterGameObj(gameobj->GetBlenderObject(), gameobj);
@@ -2640,59 +3146,208 @@ static void MergeScene_GameObject(KX_GameObject *gameobj, KX_Scene *to, KX_Scene
   }
 }
 
+/// Start the logic and the animations of an object merged by MergeScene_GameObject.
+static void MergeScene_ActivateGameObject(KX_GameObject *gameobj, KX_Scene *to)
+{
+  /* The physics environment merge moved the registered physics controllers, the suspended
+   * ones still refer to the other environment. */
+  PHY_IController *ctrl = gameobj->GetPhysicsController();
+  if (ctrl) {
+    ctrl->SetPhysicsEnvironment(to->GetPhysicsEnvironment());
+  }
+
+  // If we end up replacing a KX_CollisionEventManager, we need to make sure
+  // physics controllers are properly in place. In other words, do this
+  // after merging physics controllers!
+  SCA_SensorList &sensors = gameobj->GetSensors();
+  for (SCA_ISensor *sensor : sensors) {
+    sensor->Replace_EventManager(to->GetLogicManager());
+  }
+
+  // All armatures should be in the animated object list to be umpdated.
+  if (gameobj->GetGameObjectType() == SCA_IObject::OBJ_ARMATURE)
+    to->AddAnimatedObject(gameobj);
+}
+
+KX_Scene::MergeState::MergeState() : m_stage(MERGE_BEGIN), m_index(0)
+{
+}
+
 bool KX_Scene::MergeScene(KX_Scene *other)
+{
+  MergeState state;
+  float progress;
+  MergeSceneStep(other, state, DBL_MAX, progress);
+
+  return (state.m_stage == MergeState::MERGE_DONE);
+}
+
+bool KX_Scene::MergeSceneStep(KX_Scene *other, MergeState &state, double deadline, float &progress)
 {
   PHY_IPhysicsEnvironment *env = this->GetPhysicsEnvironment();
   PHY_IPhysicsEnvironment *env_other = other->GetPhysicsEnvironment();
+  EXP_ListValue<KX_GameObject> *otherObjects = other->GetObjectList();
+  EXP_ListValue<KX_GameObject> *otherInactiveObjects = other->GetInactiveList();
+  const unsigned int numObjects = otherObjects->GetCount();
+
+  if (state.m_stage == MergeState::MERGE_BEGIN) {
+    if ((env == nullptr) !=
+        (env_other == nullptr)) /* TODO - even when both scenes have NONE physics, the other is
+                                   loaded with bullet enabled, ??? */
+    {
+      CM_FunctionError("physics scenes type differ, aborting\n\tsource "
+                       << (int)(env != nullptr) << ", target " << (int)(env_other != nullptr));
+      state.m_stage = MergeState::MERGE_FAILED;
+      progress = 1.0f;
+      return true;
+    }
 
-  if ((env == nullptr) !=
-      (env_other == nullptr)) /* TODO - even when both scenes have NONE physics, the other is
-                                 loaded with bullet enabled, ??? */
-  {
-    CM_FunctionError("physics scenes type differ, aborting\n\tsource "
-                     << (int)(env != nullptr) << ", target " << (int)(env_other != nullptr));
-    return false;
-  }
+    // List of all physics objects to merge (needed by ReplicateConstraints).
+    if (env) {
+      for (KX_GameObject *gameobj : *otherObjects) {
+        if (gameobj->GetPhysicsController()) {
+          state.m_physicsObjects.push_back(gameobj);
+        }
+      }
+    }
 
-  GetBucketManager()->MergeBucketManager(other->GetBucketManager());
+    state.m_stage = MergeState::MERGE_OBJECTS;
+  }
 
   /* active + inactive == all ??? - lets hope so */
-  for (KX_GameObject *gameobj : *other->GetObjectList()) {
-    MergeScene_GameObject(gameobj, this, other);
+  const unsigned int numAllObjects = numObjects + otherInactiveObjects->GetCount();
+  const unsigned int numPhysicsObjects = state.m_physicsObjects.size();
+  BL_Converter *converter = KX_GetActiveEngine()->GetConverter();
+  const unsigned int numMaterials = converter->GetSceneMaterialCount(other);
+
+  /* The number of steps of each stage used for the progress, the physics controllers count is
+   * not known and the physics objects count is used instead. */
+  const unsigned int stageSteps[] = {0,
+                                     numAllObjects,
+                                     numPhysicsObjects,
+                                     numPhysicsObjects,
+                                     numPhysicsObjects,
+                                     numPhysicsObjects,
+                                     numMaterials,
+                                     1};
+  BLI_STATIC_ASSERT(ARRAY_SIZE(stageSteps) == MergeState::MERGE_FINISH + 1,
+                    "missing merge stage steps");
+
+  // Merge one element at a time until the deadline, the stage changes are free.
+  while (state.m_stage < MergeState::MERGE_FINISH) {
+    bool stageDone = false;
+    switch (state.m_stage) {
+      case MergeState::MERGE_OBJECTS: {
+        if (state.m_index == numAllObjects) {
+          stageDone = true;
+          break;
+        }
 
-    /* add properties to debug list for LibLoad objects */
-    if (KX_GetActiveEngine()->GetFlag(KX_KetsjiEngine::AUTO_ADD_DEBUG_PROPERTIES)) {
-      AddObjectDebugProperties(gameobj);
+        KX_GameObject *gameobj = (state.m_index < numObjects) ?
+                                     otherObjects->GetValue(state.m_index) :
+                                     otherInactiveObjects->GetValue(state.m_index - numObjects);
+        MergeScene_GameObject(gameobj, this, other);
+        break;
+      }
+      case MergeState::MERGE_PHYSICS: {
+        /* The staged controllers are out of both physics environments, they can't collide with
+         * the objects of this scene before being constrained. */
+        stageDone = (env->StageMergeEnvironment(env_other, 1) == 0);
+        break;
+      }
+      case MergeState::MERGE_PHYSICS_ADD: {
+        stageDone = (env->AddStagedControllers(env_other, 1) == 0);
+        break;
+      }
+      case MergeState::MERGE_CONSTRAINTS: {
+        if (state.m_index == numPhysicsObjects) {
+          stageDone = true;
+          break;
+        }
+
+        // Replicate all constraints in the right physics environment.
+        KX_GameObject *gameobj = state.m_physicsObjects[state.m_index];
+        gameobj->GetPhysicsController()->ReplicateConstraints(gameobj, state.m_physicsObjects);
+        gameobj->ClearConstraints();
+        break;
+      }
+      case MergeState::MERGE_COLLISIONS: {
+        stageDone = (env->EnableMergedCollisions(1) == 0);
+        break;
+      }
+      case MergeState::MERGE_MATERIALS: {
+        if (state.m_index == numMaterials) {
+          stageDone = true;
+          break;
+        }
+
+        converter->MergeSceneMaterial(this, other, state.m_index);
+        break;
+      }
+      default: {
+        BLI_assert(false);
+        break;
+      }
     }
-  }
 
-  for (KX_GameObject *gameobj : *other->GetInactiveList()) {
-    MergeScene_GameObject(gameobj, this, other);
-  }
+    if (stageDone) {
+      state.m_stage = (MergeState::Stage)(state.m_stage + 1);
+      // Without physics environment there is no physics stage.
+      if (!env && state.m_stage > MergeState::MERGE_OBJECTS &&
+          state.m_stage <= MergeState::MERGE_COLLISIONS)
+      {
+        state.m_stage = MergeState::MERGE_MATERIALS;
+      }
+      state.m_index = 0;
+      continue;
+    }
 
-  if (env) {
-    env->MergeEnvironment(env_other);
-    EXP_ListValue<KX_GameObject> *otherObjects = other->GetObjectList();
+    ++state.m_index;
 
-    // List of all physics objects to merge (needed by ReplicateConstraints).
-    std::vector<KX_GameObject *> physicsObjects;
-    for (KX_GameObject *gameobj : *otherObjects) {
-      if (gameobj->GetPhysicsController()) {
-        physicsObjects.push_back(gameobj);
+    if (PIL_check_seconds_timer() >= deadline) {
+      unsigned int merged = std::min(state.m_index, stageSteps[state.m_stage]);
+      unsigned int total = 0;
+      for (unsigned int i = 0; i < ARRAY_SIZE(stageSteps); ++i) {
+        total += stageSteps[i];
+        if (i < (unsigned int)state.m_stage) {
+          merged += stageSteps[i];
+        }
       }
+      progress = (float)merged / (float)total;
+      return false;
     }
+  }
 
-    for (unsigned int i = 0; i < physicsObjects.size(); ++i) {
-      KX_GameObject *gameobj = physicsObjects[i];
-      // Replicate all constraints in the right physics environment.
-      gameobj->GetPhysicsController()->ReplicateConstraints(gameobj, physicsObjects);
-      gameobj->ClearConstraints();
+  if (env) {
+    // Simulate all the physics controllers at once, so they start with their constraints.
+    env->ActivateMergedControllers();
+  }
+
+  for (KX_GameObject *gameobj : *otherObjects) {
+    MergeScene_ActivateGameObject(gameobj, this);
+
+    /* add properties to debug list for LibLoad objects */
+    if (KX_GetActiveEngine()->GetFlag(KX_KetsjiEngine::AUTO_ADD_DEBUG_PROPERTIES)) {
+      AddObjectDebugProperties(gameobj);
     }
   }
 
+  for (KX_GameObject *gameobj : *otherInactiveObjects) {
+    MergeScene_ActivateGameObject(gameobj, this);
+  }
+
+  GetBucketManager()->MergeBucketManager(other->GetBucketManager());
+
   GetObjectList()->MergeList(other->GetObjectList());
   other->GetObjectList()->ReleaseAndRemoveAll();
 
+  /* The merged objects already tagged render dirty won't notify this scene,
+   * take over the transform sync list. */
+  m_transformSyncObjects.insert(m_transformSyncObjects.end(),
+                                other->m_transformSyncObjects.begin(),
+                                other->m_transformSyncObjects.end());
+  other->m_transformSyncObjects.clear();
+
   GetInactiveList()->MergeList(other->GetInactiveList());
   other->GetInactiveList()->ReleaseAndRemoveAll();
 
@@ -2708,10 +3363,12 @@ bool KX_Scene::MergeScene(KX_Scene *other)
   GetFontList()->MergeList(other->GetFontList());
   other->GetFontList()->ReleaseAndRemoveAll();
 
-  /* move materials across, assume they both use the same scene-converters
-   * Do this after lights are merged so materials can use the lights in shaders
-   */
-  KX_GetActiveEngine()->GetConverter()->MergeScene(this, other);
+  // Move the materials constructed in MERGE_MATERIALS and the meshes across.
+  converter->MergeScene(this, other);
+
+  if (other->m_hasPythonLogic) {
+    SetHasPythonLogic();
+  }
 
   /* merge logic */
   {
@@ -2743,6 +3400,9 @@ bool KX_Scene::MergeScene(KX_Scene *other)
       timemgr->AddTimeProperty(times[i]);
     }
   }
+
+  state.m_stage = MergeState::MERGE_DONE;
+  progress = 1.0f;
   return true;
 }
 
@@ -2850,6 +3510,10 @@ PyMethodDef KX_Scene::Methods[] = {
     EXP_PYMETHODTABLE(KX_Scene, addOverlayCollection),
     EXP_PYMETHODTABLE(KX_Scene, removeOverlayCollection),
     EXP_PYMETHODTABLE(KX_Scene, getGameObjectFromObject),
+    EXP_PYMETHODTABLE(KX_Scene, setObjectPoolSize),
+    EXP_PYMETHODTABLE(KX_Scene, prewarmObjectPool),
+    EXP_PYMETHODTABLE(KX_Scene, getObjectPoolInfo),
+    EXP_PYMETHODTABLE_KEYWORDS(KX_Scene, rayCastBatch),
 
     /* dict style access */
     EXP_PYMETHODTABLE(KX_Scene, get),
@@ -3168,6 +3832,26 @@ int KX_Scene::pyattr_set_gravity(EXP_PyObjectPlus *self_v,
   return PY_SET_ATTR_SUCCESS;
 }
 
+PyObject *KX_Scene::pyattr_get_num_dispatched_collisions(EXP_PyObjectPlus *self_v,
+                                                         const EXP_PYATTRIBUTE_DEF *attrdef)
+{
+  KX_Scene *self = static_cast<KX_Scene *>(self_v);
+  KX_CollisionEventManager *collisionmgr = static_cast<KX_CollisionEventManager *>(
+      self->m_logicmgr->FindEventManager(SCA_EventManager::TOUCH_EVENTMGR));
+
+  return PyLong_FromLong(collisionmgr ? collisionmgr->GetNumDispatchedCollisions() : 0);
+}
+
+PyObject *KX_Scene::pyattr_get_num_skipped_collisions(EXP_PyObjectPlus *self_v,
+                                                      const EXP_PYATTRIBUTE_DEF *attrdef)
+{
+  KX_Scene *self = static_cast<KX_Scene *>(self_v);
+  KX_CollisionEventManager *collisionmgr = static_cast<KX_CollisionEventManager *>(
+      self->m_logicmgr->FindEventManager(SCA_EventManager::TOUCH_EVENTMGR));
+
+  return PyLong_FromLong(collisionmgr ? collisionmgr->GetNumSkippedCollisions() : 0);
+}
+
 PyAttributeDef KX_Scene::Attributes[] = {
     EXP_PYATTRIBUTE_RO_FUNCTION("name", KX_Scene, pyattr_get_name),
     EXP_PYATTRIBUTE_RO_FUNCTION("objects", KX_Scene, pyattr_get_objects),
@@ -3193,6 +3877,17 @@ PyAttributeDef KX_Scene::Attributes[] = {
     EXP_PYATTRIBUTE_RW_FUNCTION("gravity", KX_Scene, pyattr_get_gravity, pyattr_set_gravity),
     EXP_PYATTRIBUTE_BOOL_RO("activityCulling", KX_Scene, m_activityCulling),
     EXP_PYATTRIBUTE_BOOL_RO("dbvt_culling", KX_Scene, m_dbvt_culling),
+    EXP_PYATTRIBUTE_INT_RO("numSyncedObjects", KX_Scene, m_numSyncedObjects),
+    EXP_PYATTRIBUTE_RO_FUNCTION(
+        "numDispatchedCollisions", KX_Scene, pyattr_get_num_dispatched_collisions),
+    EXP_PYATTRIBUTE_RO_FUNCTION(
+        "numSkippedCollisions", KX_Scene, pyattr_get_num_skipped_collisions),
+    EXP_PYATTRIBUTE_INT_RW("animationCulling",
+                           ANIMATION_CULLING_NONE,
+                           ANIMATION_CULLING_FRUSTUM,
+                           true,
+                           KX_Scene,
+                           m_animationCulling),
     EXP_PYATTRIBUTE_RO_FUNCTION("logger", KX_Scene, KX_PythonProxy::pyattr_get_logger),
     EXP_PYATTRIBUTE_RO_FUNCTION("loggerName", KX_Scene, KX_PythonProxy::pyattr_get_logger_name),
     EXP_PYATTRIBUTE_NULL  // Sentinel
@@ -3538,6 +4233,382 @@ EXP_PYMETHODDEF_DOC(KX_Scene,
   Py_RETURN_NONE;
 }
 
+EXP_PYMETHODDEF_DOC(KX_Scene,
+                    setObjectPoolSize,
+                    "setObjectPoolSize(object, size)\n"
+                    "Set the maximum number of removed replicas of an inactive object kept\n"
+                    "to be recycled by addObject, 0 disables the pool.\n")
+{
+  PyObject *pyob;
+  KX_GameObject *ob;
+  int size;
+
+  if (!PyArg_ParseTuple(args, "Oi:setObjectPoolSize", &pyob, &size)) {
+    return nullptr;
+  }
+
+  if (!ConvertPythonToGameObject(
+          m_logicmgr,
+          pyob,
+          &ob,
+          false,
+          "scene.setObjectPoolSize(object, size): KX_Scene (first argument)"))
+  {
+    return nullptr;
+  }
+
+  if (!m_inactivelist->SearchValue(ob)) {
+    PyErr_SetString(PyExc_ValueError,
+                    "scene.setObjectPoolSize(object, size): KX_Scene (first argument): object "
+                    "must be in an inactive layer");
+    return nullptr;
+  }
+
+  if (size < 0) {
+    PyErr_SetString(PyExc_ValueError,
+                    "scene.setObjectPoolSize(object, size): KX_Scene (second argument): size "
+                    "must be positive");
+    return nullptr;
+  }
+
+  if (size > 0 && !CanPoolObject(ob)) {
+    PyErr_SetString(PyExc_ValueError,
+                    "scene.setObjectPoolSize(object, size): KX_Scene (first argument): object "
+                    "can't be pooled, it must not have children, python components or "
+                    "prototype or be a light, camera, text, armature or collection instance");
+    return nullptr;
+  }
+
+  SetObjectPoolSize(ob, size);
+
+  Py_RETURN_NONE;
+}
+
+EXP_PYMETHODDEF_DOC(KX_Scene,
+                    prewarmObjectPool,
+                    "prewarmObjectPool(object, count)\n"
+                    "Add up to count replicas of an inactive object in its pool.\n"
+                    "Return the number of replicas added.\n")
+{
+  PyObject *pyob;
+  KX_GameObject *ob;
+  int count;
+
+  if (!PyArg_ParseTuple(args, "Oi:prewarmObjectPool", &pyob, &count)) {
+    return nullptr;
+  }
+
+  if (!ConvertPythonToGameObject(
+          m_logicmgr,
+          pyob,
+          &ob,
+          false,
+          "scene.prewarmObjectPool(object, count): KX_Scene (first argument)"))
+  {
+    return nullptr;
+  }
+
+  if (m_objectPools.find(ob) == m_objectPools.end()) {
+    PyErr_SetString(PyExc_ValueError,
+                    "scene.prewarmObjectPool(object, count): KX_Scene (first argument): object "
+                    "has no pool, use setObjectPoolSize first");
+    return nullptr;
+  }
+
+  if (count < 0) {
+    PyErr_SetString(PyExc_ValueError,
+                    "scene.prewarmObjectPool(object, count): KX_Scene (second argument): count "
+                    "must be positive");
+    return nullptr;
+  }
+
+  return PyLong_FromLong(PrewarmObjectPool(ob, count));
+}
+
+EXP_PYMETHODDEF_DOC(KX_Scene,
+                    getObjectPoolInfo,
+                    "getObjectPoolInfo(object)\n"
+                    "Return the size of the pool of an inactive object and the number of\n"
+                    "replicas available in it.\n")
+{
+  PyObject *pyob;
+  KX_GameObject *ob;
+
+  if (!PyArg_ParseTuple(args, "O:getObjectPoolInfo", &pyob)) {
+    return nullptr;
+  }
+
+  if (!ConvertPythonToGameObject(
+          m_logicmgr, pyob, &ob, false, "scene.getObjectPoolInfo(object): KX_Scene"))
+  {
+    return nullptr;
+  }
+
+  unsigned int size;
+  unsigned int available;
+  GetObjectPoolInfo(ob, size, available);
+
+  return Py_BuildValue("(II)", size, available);
+}
+
+/// Filter of the rays cast by rayCastBatch, only the objects in the groups of the mask are hit.
+class KX_RayCastMaskFilter : public PHY_IRayCastFilterCallback {
+  unsigned int m_mask;
+
+ public:
+  KX_RayCastMaskFilter(unsigned int mask) : PHY_IRayCastFilterCallback(nullptr), m_mask(mask)
+  {
+  }
+
+  virtual bool needBroadphaseRayCast(PHY_IPhysicsController *controller)
+  {
+    KX_ClientObjectInfo *info = static_cast<KX_ClientObjectInfo *>(
+        controller->GetNewClientInfo());
+    return info && info->m_gameobject && (info->m_gameobject->GetCollisionGroup() & m_mask);
+  }
+
+  virtual void reportHit(PHY_RayCastResult *result)
+  {
+  }
+};
+
+/// Convert a C-contiguous buffer of floats or doubles, or a sequence of vectors, to coordinates.
+static bool PyPointsTo(PyObject *value, std::vector<float> &points, const char *error_prefix)
+{
+  if (PyObject_CheckBuffer(value)) {
+    Py_buffer view;
+    if (PyObject_GetBuffer(value, &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) == -1) {
+      return false;
+    }
+
+    // Skip the native byte order prefix.
+    const char *format = view.format ? view.format : "B";
+    if (format[0] == '@' || format[0] == '=' || format[0] == '<') {
+      ++format;
+    }
+    const bool isFloat = (strcmp(format, "f") == 0);
+    const bool isDouble = (strcmp(format, "d") == 0);
+    const Py_ssize_t count = (view.itemsize > 0) ? view.len / view.itemsize : 0;
+    if ((!isFloat && !isDouble) || (count % 3) != 0) {
+      PyBuffer_Release(&view);
+      PyErr_Format(PyExc_TypeError,
+                   "%s, expected a buffer of float or double 3D coordinates",
+                   error_prefix);
+      return false;
+    }
+
+    points.resize(count);
+    if (isFloat) {
+      memcpy(points.data(), view.buf, view.len);
+    }
+    else {
+      const double *data = (const double *)view.buf;
+      std::copy(data, data + count, points.begin());
+    }
+    PyBuffer_Release(&view);
+    return true;
+  }
+
+  PyObject *seq = PySequence_Fast(value, error_prefix);
+  if (!seq) {
+    return false;
+  }
+
+  const Py_ssize_t size = PySequence_Fast_GET_SIZE(seq);
+  PyObject **items = PySequence_Fast_ITEMS(seq);
+  points.resize(size * 3);
+  for (Py_ssize_t i = 0; i < size; ++i) {
+    MT_Vector3 point;
+    if (!PyVecTo(items[i], point)) {
+      Py_DECREF(seq);
+      return false;
+    }
+    point.getValue(&points[i * 3]);
+  }
+
+  Py_DECREF(seq);
+  return true;
+}
+
+/// Get a writable C-contiguous buffer of at least size floats or doubles.
+static bool PyPointsOutput(PyObject *value,
+                           Py_buffer &view,
+                           bool &isDouble,
+                           Py_ssize_t size,
+                           const char *error_prefix)
+{
+  if (!PyObject_CheckBuffer(value)) {
+    PyErr_Format(PyExc_TypeError, "%s, expected a writable buffer", error_prefix);
+    return false;
+  }
+  if (PyObject_GetBuffer(value, &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT | PyBUF_WRITABLE) ==
+      -1)
+  {
+    return false;
+  }
+
+  const char *format = view.format ? view.format : "B";
+  if (format[0] == '@' || format[0] == '=' || format[0] == '<') {
+    ++format;
+  }
+  isDouble = (strcmp(format, "d") == 0);
+  const Py_ssize_t count = (view.itemsize > 0) ? view.len / view.itemsize : 0;
+  if ((!isDouble && strcmp(format, "f") != 0) || count < size) {
+    PyBuffer_Release(&view);
+    PyErr_Format(PyExc_ValueError,
+                 "%s, expected a buffer of at least %zd floats or doubles",
+                 error_prefix,
+                 size);
+    return false;
+  }
+  return true;
+}
+
+/// Write a vector in a buffer of floats or doubles checked by PyPointsOutput.
+static void PyPointWrite(const Py_buffer &view,
+                         bool isDouble,
+                         unsigned int index,
+                         const MT_Vector3 &point)
+{
+  for (unsigned short i = 0; i < 3; ++i) {
+    if (isDouble) {
+      ((double *)view.buf)[index * 3 + i] = point[i];
+    }
+    else {
+      ((float *)view.buf)[index * 3 + i] = point[i];
+    }
+  }
+}
+
+EXP_PYMETHODDEF_DOC(KX_Scene,
+                    rayCastBatch,
+                    "rayCastBatch(origins, targets, points, normals, objects=None, mask=0xFFFF)\n"
+                    "Cast a ray from every origin to the target of the same index on several\n"
+                    "threads, write the hit points, normals and objects in the given buffers\n"
+                    "and list and return the number of rays hitting an object.\n")
+{
+  PyObject *pyorigins;
+  PyObject *pytargets;
+  PyObject *pypoints;
+  PyObject *pynormals;
+  PyObject *pyobjects = Py_None;
+  int mask = (1 << OB_MAX_COL_MASKS) - 1;
+
+  static const char *kwlist[] = {
+      "origins", "targets", "points", "normals", "objects", "mask", nullptr};
+  if (!PyArg_ParseTupleAndKeywords(args,
+                                   kwds,
+                                   "OOOO|Oi:rayCastBatch",
+                                   const_cast<char **>(kwlist),
+                                   &pyorigins,
+                                   &pytargets,
+                                   &pypoints,
+                                   &pynormals,
+                                   &pyobjects,
+                                   &mask))
+  {
+    return nullptr;
+  }
+
+  if (mask == 0 || mask & ~((1 << OB_MAX_COL_MASKS) - 1)) {
+    PyErr_Format(PyExc_TypeError,
+                 "scene.rayCastBatch(...): KX_Scene, mask argument must be a "
+                 "int bitfield, 0 < mask < %i",
+                 (1 << OB_MAX_COL_MASKS));
+    return nullptr;
+  }
+
+  std::vector<float> origins;
+  std::vector<float> targets;
+  if (!PyPointsTo(pyorigins, origins, "scene.rayCastBatch(...): KX_Scene, origins") ||
+      !PyPointsTo(pytargets, targets, "scene.rayCastBatch(...): KX_Scene, targets"))
+  {
+    return nullptr;
+  }
+
+  if (origins.size() != targets.size()) {
+    PyErr_SetString(PyExc_ValueError,
+                    "scene.rayCastBatch(...): KX_Scene, origins and targets "
+                    "must have the same length");
+    return nullptr;
+  }
+
+  const unsigned int numRays = origins.size() / 3;
+  if (pyobjects != Py_None &&
+      (!PyList_Check(pyobjects) || PyList_GET_SIZE(pyobjects) < (Py_ssize_t)numRays))
+  {
+    PyErr_SetString(PyExc_ValueError,
+                    "scene.rayCastBatch(...): KX_Scene, objects must be None or a list "
+                    "at least as long as origins");
+    return nullptr;
+  }
+
+  Py_buffer points;
+  Py_buffer normals;
+  bool pointsDouble;
+  bool normalsDouble;
+  if (!PyPointsOutput(pypoints,
+                      points,
+                      pointsDouble,
+                      numRays * 3,
+                      "scene.rayCastBatch(...): KX_Scene, points"))
+  {
+    return nullptr;
+  }
+  if (!PyPointsOutput(pynormals,
+                      normals,
+                      normalsDouble,
+                      numRays * 3,
+                      "scene.rayCastBatch(...): KX_Scene, normals"))
+  {
+    PyBuffer_Release(&points);
+    return nullptr;
+  }
+
+  std::vector<PHY_RayCastResult> results(numRays);
+  if (m_physicsEnvironment && numRays > 0) {
+    KX_RayCastMaskFilter filter(mask);
+    const std::vector<PHY_IRayCastFilterCallback *> filters(numRays, &filter);
+    m_physicsEnvironment->RayTestBatch(
+        filters.data(), origins.data(), targets.data(), numRays, results.data());
+  }
+
+  unsigned int numHits = 0;
+  for (unsigned int i = 0; i < numRays; ++i) {
+    const PHY_RayCastResult &result = results[i];
+    KX_ClientObjectInfo *info = result.m_controller ?
+                                    static_cast<KX_ClientObjectInfo *>(
+                                        result.m_controller->GetNewClientInfo()) :
+                                    nullptr;
+    KX_GameObject *gameobj = info ? info->m_gameobject : nullptr;
+    if (gameobj) {
+      PyPointWrite(points, pointsDouble, i, result.m_hitPoint);
+      PyPointWrite(normals, normalsDouble, i, result.m_hitNormal);
+      ++numHits;
+    }
+    else {
+      // The buffers keep the values of the missed rays from a previous call otherwise.
+      PyPointWrite(points, pointsDouble, i, MT_Vector3(0.0f, 0.0f, 0.0f));
+      PyPointWrite(normals, normalsDouble, i, MT_Vector3(0.0f, 0.0f, 0.0f));
+    }
+
+    if (pyobjects != Py_None) {
+      if (gameobj) {
+        PyList_SetItem(pyobjects, i, gameobj->GetProxy());
+      }
+      else {
+        Py_INCREF(Py_None);
+        PyList_SetItem(pyobjects, i, Py_None);
+      }
+    }
+  }
+
+  PyBuffer_Release(&points);
+  PyBuffer_Release(&normals);
+
+  return PyLong_FromLong(numHits);
+}
+
 bool ConvertPythonToScene(PyObject *value,
                           KX_Scene **scene,
                           bool py_none_ok,
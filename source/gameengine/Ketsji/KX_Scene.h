@@ -32,9 +32,11 @@
 #pragma once
 
 #include <list>
+#include <map>
 #include <set>
 #include <vector>
 
+#include "CM_Thread.h"
 #include "DNA_ID.h"  // For IDRecalcFlag
 
 #include "EXP_PyObjectPlus.h"
@@ -42,6 +44,7 @@
 #include "KX_PhysicsEngineEnums.h"
 #include "KX_PythonProxy.h"
 #include "KX_PythonProxyManager.h"
+#include "KX_TimeCategoryLogger.h"
 #include "MT_Transform.h"
 #include "RAS_FramingManager.h"
 #include "RAS_Rect.h"
@@ -83,7 +86,6 @@ class KX_2DFilterManager;
 class BL_SceneConverter;
 struct KX_ClientObjectInfo;
 class KX_ObstacleSimulation;
-struct TaskPool;
 
 /*********EEVEE INTEGRATION************/
 struct bNodeTree;
@@ -107,8 +109,17 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
  public:
   enum DrawingCallbackType { PRE_DRAW = 0, POST_DRAW, PRE_DRAW_SETUP, MAX_DRAW_CALLBACK };
 
-  struct AnimationPoolData {
-    double curtime;
+  /// Categories for the profiling of the scene.
+  enum TimeCategory { tc_logic = 0, tc_scenegraph, tc_physics, tc_numCategories };
+
+  /// Policies to skip the pose evaluation of the armatures, only their actions' time is updated.
+  enum AnimationCulling {
+    /// All the armatures are evaluated.
+    ANIMATION_CULLING_NONE = 0,
+    /// Skip the armatures whose mesh children are all invisible.
+    ANIMATION_CULLING_INVISIBLE,
+    /// Skip the armatures whose mesh children are all invisible or out of the camera frustum.
+    ANIMATION_CULLING_FRUSTUM
   };
 
  private:
@@ -135,6 +146,8 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
   std::vector<KX_Camera *> m_imageRenderCameraList;
   BL_SceneConverter *m_sceneConverter;
   bool m_isPythonMainLoop;
+  /// True when objects of the scene use python controllers or components.
+  bool m_hasPythonLogic;
   std::vector<KX_GameObject *> m_kxobWithLod;
   std::map<Object *, char> m_obRestrictFlags;
   bool m_collectionRemap;
@@ -151,12 +164,35 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
    */
   std::vector<std::pair<ID *, IDRecalcFlag>> m_idsToUpdateInAllRenderPasses;
   std::vector<std::pair<ID *, IDRecalcFlag>> m_idsToUpdateInOverlayPass;
+  /// The armature actions append ids from the animation threads.
+  CM_ThreadSpinLock m_idsToUpdateLock;
+
+  /* Objects whose transform changed since the last frame, filled by the
+   * scene graph update and synced with the depsgraph at each render pass.
+   * An object is in this list as long as its node is DIRTY_RENDER.
+   */
+  std::vector<KX_GameObject *> m_transformSyncObjects;
+  CM_ThreadSpinLock m_transformSyncLock;
+  /// Number of objects synced with the depsgraph during the last frame.
+  int m_numSyncedObjects;
   /*************************************************/
 
   RAS_BucketManager *m_bucketmanager;
 
   std::vector<KX_GameObject *> m_tempObjectList;
 
+  /** Replicas of an inactive object kept deactivated after their removal instead of being
+   * freed, they are recycled by AddReplicaObject.
+   */
+  struct ObjectPool {
+    /// Maximum number of parked replicas.
+    unsigned int m_size;
+    /// The parked replicas, owning the reference previously held by the object list.
+    std::vector<KX_GameObject *> m_objects;
+  };
+  /// All the object pools, indexed by the pooled inactive object.
+  std::map<KX_GameObject *, ObjectPool> m_objectPools;
+
   /**
    * The list of objects which have been removed during the
    * course of one frame. They are actually destroyed in
@@ -301,8 +337,22 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
 
   KX_ObstacleSimulation *m_obstacleSimulation;
 
-  AnimationPoolData m_animationPoolData;
-  TaskPool *m_animationPool;
+  /// The animation culling policy, see AnimationCulling.
+  int m_animationCulling;
+  /// Armatures evaluated in parallel during UpdateAnimations.
+  std::vector<KX_GameObject *> m_animationTaskObjects;
+  /// Scheduled nodes updated by UpdateParents, grouped by familly.
+  std::vector<SG_Node *> m_sgUpdateNodes;
+  /// Ranges in m_sgUpdateNodes of the famillies updated in parallel.
+  std::vector<std::pair<unsigned int, unsigned int>> m_sgFamillyRanges;
+  /// Nodes of the famillies using slow or vertex parents, updated serially.
+  std::vector<SG_Node *> m_sgSerialNodes;
+  /// Objects moved, animated or removed since the last render, see KX_FramePacer.
+  bool m_sceneChanged;
+
+  /// Clock and time logger used to profile the scene, independently of the other scenes.
+  CM_Clock m_clock;
+  KX_TimeCategoryLogger m_logger;
 
   /**
    * LOD Hysteresis settings
@@ -310,6 +360,18 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
   bool m_isActivedHysteresis;
   int m_lodHysteresisValue;
 
+  /// Set the life of an added object in frames, 0 means the object lives forever.
+  void SetObjectLifespan(KX_GameObject *gameobj, float lifespan);
+  /// Get a replica out of the pool of originalobj if one is available.
+  KX_GameObject *RecyclePooledObject(KX_GameObject *originalobj,
+                                     KX_GameObject *referenceobj,
+                                     float lifespan);
+  /// Deactivate a removed replica and store it in its pool, return false if it must be freed.
+  bool ParkPooledObject(KX_GameObject *gameobj);
+
+  /// Return true if the pose of this armature doesn't need to be evaluated, see AnimationCulling.
+  bool ArmatureAnimationIsCulled(KX_GameObject *gameobj);
+
   // Convert objects list & collection helpers
   void convert_blender_objects_list_synchronous(std::vector<Object *> objectslist);
   void convert_blender_collection_synchronous(Collection *co);
@@ -356,6 +418,9 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
   void RemoveImageRenderCamera(KX_Camera *cam);
   bool CameraIsInactive(KX_Camera *cam);
   void SetIsPythonMainLoop(bool isPython);
+  void SetHasPythonLogic();
+  /// Return true when python can run during the logic of the scene.
+  bool HasPythonLogic() const;
   void AddObjToLodObjList(KX_GameObject *gameobj);
   void RemoveObjFromLodObjList(KX_GameObject *gameobj);
   void BackupRestrictFlag(Object *ob, char restrictFlag);
@@ -374,6 +439,11 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
   void AppendToIdsToUpdateInAllRenderPasses(ID *id, IDRecalcFlag flag);
   void AppendToIdsToUpdateInOverlayPass(ID *id, IDRecalcFlag flag);
   void TagForExtraIdsUpdate(Main *bmain, KX_Camera *cam);
+  /// Register an object to sync with the depsgraph at the next render passes, thread safe.
+  void AddTransformSyncObject(KX_GameObject *gameobj);
+  /// Sync the evaluated objects transform with the scene graph.
+  void SyncTransformsEvaluated(struct Depsgraph *depsgraph);
+  int GetNumSyncedObjects() const;
   KX_GameObject *AddDuplicaObject(KX_GameObject *gameobj,
                                   KX_GameObject *reference,
                                   float lifespan);
@@ -390,6 +460,7 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
    */
   static bool KX_ScenegraphUpdateFunc(SG_Node *node, void *gameobj, void *scene);
   static bool KX_ScenegraphRescheduleFunc(SG_Node *node, void *gameobj, void *scene);
+  static void KX_ScenegraphRenderDirtyFunc(SG_Node *node, void *gameobj, void *scene);
   void UpdateParents(double curtime);
   void DupliGroupRecurse(KX_GameObject *groupobj, int level);
   bool IsObjectInGroup(KX_GameObject *gameobj)
@@ -405,6 +476,17 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
   void RemoveNodeDestructObject(SG_Node *node, KX_GameObject *gameobj);
   void RemoveObject(KX_GameObject *gameobj);
   void RemoveDupliGroup(KX_GameObject *gameobj);
+
+  /// Return true if the replicas of this inactive object can be recycled in a pool.
+  bool CanPoolObject(KX_GameObject *gameobj) const;
+  /** Set the maximum number of replicas of gameobj kept in its pool,
+   * 0 removes the pool and frees the replicas it contains.
+   */
+  void SetObjectPoolSize(KX_GameObject *gameobj, unsigned int size);
+  /// Fill the pool of gameobj with up to count new replicas, return the number added.
+  unsigned int PrewarmObjectPool(KX_GameObject *gameobj, unsigned int count);
+  /// Return the maximum and current number of replicas in the pool of gameobj.
+  void GetObjectPoolInfo(KX_GameObject *gameobj, unsigned int &size, unsigned int &available);
   void DelayedRemoveObject(KX_GameObject *gameobj);
 
   bool NewRemoveObject(KX_GameObject *gameobj);
@@ -554,6 +636,26 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
     return m_obstacleSimulation;
   }
 
+  KX_TimeCategoryLogger &GetTimeLogger()
+  {
+    return m_logger;
+  }
+
+  bool GetSceneChanged() const
+  {
+    return m_sceneChanged;
+  }
+
+  void SetSceneChanged(bool changed)
+  {
+    m_sceneChanged = changed;
+  }
+
+  virtual void RequestRender()
+  {
+    m_sceneChanged = true;
+  }
+
   /**  Inherited from EXP_Value -- returns the name of this object. */
   virtual std::string GetName();
 
@@ -581,6 +683,10 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
   EXP_PYMETHOD_DOC(KX_Scene, addOverlayCollection);
   EXP_PYMETHOD_DOC(KX_Scene, removeOverlayCollection);
   EXP_PYMETHOD_DOC(KX_Scene, getGameObjectFromObject);
+  EXP_PYMETHOD_DOC(KX_Scene, setObjectPoolSize);
+  EXP_PYMETHOD_DOC(KX_Scene, prewarmObjectPool);
+  EXP_PYMETHOD_DOC(KX_Scene, getObjectPoolInfo);
+  EXP_PYMETHOD_DOC(KX_Scene, rayCastBatch);
 
   /* attributes */
   static PyObject *pyattr_get_name(EXP_PyObjectPlus *self_v, const EXP_PYATTRIBUTE_DEF *attrdef);
@@ -619,6 +725,10 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
   static int pyattr_set_gravity(EXP_PyObjectPlus *self_v,
                                 const EXP_PYATTRIBUTE_DEF *attrdef,
                                 PyObject *value);
+  static PyObject *pyattr_get_num_dispatched_collisions(EXP_PyObjectPlus *self_v,
+                                                        const EXP_PYATTRIBUTE_DEF *attrdef);
+  static PyObject *pyattr_get_num_skipped_collisions(EXP_PyObjectPlus *self_v,
+                                                     const EXP_PYATTRIBUTE_DEF *attrdef);
 
   /* getitem/setitem */
   static PyMappingMethods Mapping;
@@ -639,7 +749,47 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
     return m_blenderScene;
   }
 
+  /// Progress of a scene merge spread over several frames, see MergeSceneStep.
+  struct MergeState {
+    enum Stage {
+      MERGE_BEGIN = 0,
+      /// Move the logic bricks and the scene references of the objects.
+      MERGE_OBJECTS,
+      /// Stage the physics controllers out of the other physics environment.
+      MERGE_PHYSICS,
+      /// Add the staged physics controllers to this environment, without simulation.
+      MERGE_PHYSICS_ADD,
+      /// Replicate the constraints of the merged physics objects.
+      MERGE_CONSTRAINTS,
+      /// Let the merged physics controllers detect collisions, without contact response.
+      MERGE_COLLISIONS,
+      /// Construct the materials for this scene.
+      MERGE_MATERIALS,
+      /** Simulate the merged physics controllers, start the logic of the objects and merge the
+       * object lists and logic managers. */
+      MERGE_FINISH,
+      MERGE_DONE,
+      MERGE_FAILED
+    } m_stage;
+
+    /// Index of the next object, physics controller or material to merge in the current stage.
+    unsigned int m_index;
+    /// Objects using a physics controller, needed by ReplicateConstraints.
+    std::vector<KX_GameObject *> m_physicsObjects;
+
+    MergeState();
+  };
+
   bool MergeScene(KX_Scene *other);
+  /** Merge the scene other into this scene until the time deadline is passed.
+   * At least one object, physics controller or material is merged per call. The physics
+   * controllers are simulated, the objects join the scene lists and their logic is activated
+   * only in the last call.
+   * \param deadline The time to stop at, compared to PIL_check_seconds_timer().
+   * \param progress Set to the merged fraction of the scene.
+   * \return True when the merge is finished or failed.
+   */
+  bool MergeSceneStep(KX_Scene *other, MergeState &state, double deadline, float &progress);
 
   // void PrintStats(int verbose_level) {
   //	m_bucketmanager->PrintStats(verbose_level)
@@ -103,3 +103,11 @@ double KX_TimeLogger::GetAverage() const
 
   return avg;
 }
+
+double KX_TimeLogger::GetLast() const
+{
+  if (m_measurements.size() > 1) {
+    return m_measurements[1];
+  }
+  return 0.0;
+}
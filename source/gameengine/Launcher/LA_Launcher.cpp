@@ -32,6 +32,7 @@
 
 #include "BKE_main.h"
 #include "BKE_sound.h"
+#include "BLI_math_base.h"
 #include "DNA_scene_types.h"
 #include "wm_event_types.h"
 
@@ -51,6 +52,7 @@
 #include "KX_PythonMain.h"
 #include "LA_System.h"
 #include "LA_SystemCommandLine.h"
+#include "SCA_InputRecord.h"
 
 #ifdef WITH_PYTHON
 #  include "Texture.h"  // For FreeAllTextures.
@@ -81,6 +83,7 @@ LA_Launcher::LA_Launcher(GHOST_ISystem *system,
       m_kxsystem(nullptr),
       m_inputDevice(nullptr),
       m_eventConsumer(nullptr),
+      m_inputRecord(nullptr),
       m_canvas(nullptr),
       m_rasterizer(nullptr),
       m_converter(nullptr),
@@ -131,6 +134,7 @@ void LA_Launcher::InitEngine()
   const GameData &gm = m_startScene->gm;
   bool properties = (SYS_GetCommandLineInt(syshandle, "show_properties", 0) != 0);
   bool profile = (SYS_GetCommandLineInt(syshandle, "show_profile", 0) != 0);
+  bool headless = (SYS_GetCommandLineInt(syshandle, "headless", 0) != 0);
 
   bool showPhysics = (gm.flag & GAME_SHOW_PHYSICS);
   SYS_WriteCommandLineInt(syshandle, "show_physics", showPhysics);
@@ -140,7 +144,11 @@ void LA_Launcher::InitEngine()
                               syshandle, "fixedtime", (gm.flag & GAME_ENABLE_ALL_FRAMES)) == 0);
   bool frameRate = (SYS_GetCommandLineInt(syshandle, "show_framerate", 0) != 0);
   bool nodepwarnings = (SYS_GetCommandLineInt(syshandle, "ignore_deprecation_warnings", 1) != 0);
+  const int framePacing = SYS_GetCommandLineInt(syshandle, "frame_pacing", 0);
+  const char *inputRecord = SYS_GetCommandLineString(syshandle, "input_record", nullptr);
+  const char *inputReplay = SYS_GetCommandLineString(syshandle, "input_replay", nullptr);
   bool restrictAnimFPS = (gm.flag & GAME_RESTRICT_ANIM_UPDATES) != 0;
+  bool parallelScenes = (gm.flag & GAME_USE_PARALLEL_SCENES) != 0;
 
   // Setup python console keys used as shortcut.
   for (unsigned short i = 0; i < 4; ++i) {
@@ -154,8 +162,10 @@ void LA_Launcher::InitEngine()
       (KX_KetsjiEngine::FlagType)((fixed_framerate ? KX_KetsjiEngine::FIXED_FRAMERATE : 0) |
                                   (frameRate ? KX_KetsjiEngine::SHOW_FRAMERATE : 0) |
                                   (restrictAnimFPS ? KX_KetsjiEngine::RESTRICT_ANIMATION : 0) |
+                                  (parallelScenes ? KX_KetsjiEngine::PARALLEL_SCENES : 0) |
                                   (properties ? KX_KetsjiEngine::SHOW_DEBUG_PROPERTIES : 0) |
-                                  (profile ? KX_KetsjiEngine::SHOW_PROFILE : 0));
+                                  (profile ? KX_KetsjiEngine::SHOW_PROFILE : 0) |
+                                  (headless ? KX_KetsjiEngine::HEADLESS : 0));
 
   m_rasterizer = new RAS_Rasterizer();
 
@@ -224,6 +234,19 @@ void LA_Launcher::InitEngine()
 
   m_ketsjiEngine->SetFlag(flags, true);
   m_ketsjiEngine->SetRender(true);
+  m_ketsjiEngine->SetFramePacing((KX_FramePacer::Mode)clamp_i(
+      framePacing, KX_FramePacer::PACING_CAPPED, KX_FramePacer::PACING_RENDER_ON_CHANGE));
+
+  // Replay a record in place of the live inputs, or record the live inputs.
+  if (inputReplay || inputRecord) {
+    m_inputRecord = new SCA_InputRecord();
+    if (m_inputRecord->Open(inputReplay ? inputReplay : inputRecord,
+                            inputReplay ? SCA_InputRecord::RECORD_READ :
+                                          SCA_InputRecord::RECORD_WRITE))
+    {
+      m_ketsjiEngine->SetInputRecord(m_inputRecord);
+    }
+  }
 
   m_ketsjiEngine->SetTicRate(gm.ticrate);
   m_ketsjiEngine->SetMaxLogicFrame(gm.maxlogicstep);
@@ -338,6 +361,10 @@ void LA_Launcher::ExitEngine()
     delete m_inputDevice;
     m_inputDevice = nullptr;
   }
+  if (m_inputRecord) {
+    delete m_inputRecord;
+    m_inputRecord = nullptr;
+  }
   if (m_eventConsumer) {
     m_system->removeEventConsumer(m_eventConsumer);
     delete m_eventConsumer;
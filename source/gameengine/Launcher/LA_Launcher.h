@@ -41,6 +41,7 @@ class RAS_ICanvas;
 class DEV_EventConsumer;
 class DEV_InputDevice;
 class GHOST_ISystem;
+class SCA_InputRecord;
 struct Scene;
 struct Main;
 
@@ -70,6 +71,8 @@ class LA_Launcher {
   /// The game engine's input device abstraction.
   DEV_InputDevice *m_inputDevice;
   DEV_EventConsumer *m_eventConsumer;
+  /// Record of the inputs written or replayed, nullptr when disabled.
+  SCA_InputRecord *m_inputRecord;
   /// The game engine's canvas abstraction.
   RAS_ICanvas *m_canvas;
   /// The rasterizer.
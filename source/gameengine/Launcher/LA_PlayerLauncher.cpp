@@ -38,6 +38,7 @@
 
 #include "BKE_sound.h"
 #include "BLI_fileops.h"
+#include "DNA_scene_types.h"
 #include "MEM_guardedalloc.h"
 
 #include "CM_Message.h"
@@ -163,5 +164,11 @@ bool LA_PlayerLauncher::EngineNextFrame()
 
 RAS_ICanvas *LA_PlayerLauncher::CreateCanvas()
 {
-  return (new GPG_Canvas(m_rasterizer, m_mainWindow));
+  GPG_Canvas *canvas = new GPG_Canvas(m_rasterizer, m_mainWindow);
+  if (!m_mainWindow) {
+    /* Headless player, keep the player resolution of the file for the camera projections and
+     * the mouse normalization. */
+    canvas->Resize(m_startScene->gm.xplay, m_startScene->gm.yplay);
+  }
+  return canvas;
 }
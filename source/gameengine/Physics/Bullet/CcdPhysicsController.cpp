@@ -32,12 +32,15 @@
 #include "DNA_mesh_types.h"
 
 #include "BulletCollision/CollisionDispatch/btGhostObject.h"
+#include "BulletCollision/CollisionShapes/btConvexPointCloudShape.h"
 #include "BulletCollision/Gimpact/btGImpactShape.h"
 #include "BulletSoftBody/btSoftBodyHelpers.h"
 #include "BulletSoftBody/btSoftRigidDynamicsWorld.h"
 #include "LinearMath/btConvexHull.h"
+#include "LinearMath/btConvexHullComputer.h"
 
 #include "CcdPhysicsEnvironment.h"
+#include "CcdShapeCache.h"
 #include "KX_GameObject.h"
 #include "RAS_DisplayArray.h"
 #include "RAS_MeshObject.h"
@@ -197,9 +200,10 @@ CcdPhysicsController::CcdPhysicsController(const CcdConstructionInfo &ci) : m_cc
   m_parentRoot = nullptr;
   // copy pointers locally to allow smart release
   m_MotionState = ci.m_MotionState;
-  m_collisionShape = ci.m_collisionShape;
   // apply scaling before creating rigid body
-  m_collisionShape->setLocalScaling(m_cci.m_scaling);
+  m_collisionShape = CcdShapeConstructionInfo::SetShapeScaling(ci.m_collisionShape,
+                                                               m_cci.m_scaling);
+  m_cci.m_collisionShape = m_collisionShape;
   if (m_cci.m_mass)
     m_collisionShape->calculateLocalInertia(m_cci.m_mass, m_cci.m_localInertiaTensor);
   // shape info is shared, increment ref count
@@ -654,6 +658,10 @@ void CcdPhysicsController::SetGravity(const MT_Vector3 &gravity)
 
 static void DeleteBulletShape(btCollisionShape *shape, bool free)
 {
+  if (CcdShapeConstructionInfo::ReleaseSharedShape(shape)) {
+    return;
+  }
+
   if (shape->getShapeType() == SCALED_TRIANGLE_MESH_SHAPE_PROXYTYPE) {
     /* If we use Bullet scaled shape (btScaledBvhTriangleMeshShape) we have to
      * free the child of the unscaled shape (btTriangleMeshShape) here.
@@ -732,6 +740,21 @@ bool CcdPhysicsController::ReplaceControllerShape(btCollisionShape *newShape)
   return true;
 }
 
+void CcdPhysicsController::SetCollisionShapeScaling(const btVector3 &scaling)
+{
+  btCollisionShape *shape = m_object->getCollisionShape();
+  btCollisionShape *newShape = CcdShapeConstructionInfo::SetShapeScaling(shape, scaling);
+  if (newShape == shape) {
+    return;
+  }
+
+  m_object->setCollisionShape(newShape);
+  m_collisionShape = newShape;
+  m_cci.m_collisionShape = newShape;
+  // The collision algorithms of the pairs still reference the previous shape.
+  GetPhysicsEnvironment()->RefreshCcdPhysicsController(this);
+}
+
 CcdPhysicsController::~CcdPhysicsController()
 {
   // will be reference counted, due to sharing
@@ -832,7 +855,7 @@ bool CcdPhysicsController::SynchronizeMotionStates(float time)
   }
 
   const MT_Vector3 &scale = m_MotionState->GetWorldScaling();
-  GetCollisionShape()->setLocalScaling(ToBullet(scale));
+  SetCollisionShapeScaling(ToBullet(scale));
 
   return true;
 }
@@ -948,12 +971,13 @@ void CcdPhysicsController::PostProcessReplica(class PHY_IMotionState *motionstat
   if (m_shapeInfo) {
     m_shapeInfo->AddRef();
     m_collisionShape = m_shapeInfo->CreateBulletShape(
-        m_cci.m_margin, m_cci.m_bGimpact, !m_cci.m_bSoft);
+        m_cci.m_margin, m_cci.m_bGimpact, !m_cci.m_bSoft, m_cci.m_scaling);
 
     if (m_collisionShape) {
       // new shape has no scaling, apply initial scaling
       // m_collisionShape->setMargin(m_cci.m_margin);
-      m_collisionShape->setLocalScaling(m_cci.m_scaling);
+      m_collisionShape = CcdShapeConstructionInfo::SetShapeScaling(m_collisionShape,
+                                                                   m_cci.m_scaling);
 
       if (m_cci.m_mass)
         m_collisionShape->calculateLocalInertia(m_cci.m_mass, m_cci.m_localInertiaTensor);
@@ -1239,7 +1263,7 @@ void CcdPhysicsController::SetScaling(const MT_Vector3 &scale)
     if (m_object && m_object->getCollisionShape()) {
       m_object->activate(true);  // without this, sleeping objects scale wont be applied in bullet
                                  // if python changes the scale - Campbell.
-      m_object->getCollisionShape()->setLocalScaling(m_cci.m_scaling);
+      SetCollisionShapeScaling(m_cci.m_scaling);
 
       btRigidBody *body = GetRigidBody();
       if (body && m_cci.m_mass) {
@@ -1720,8 +1744,8 @@ void CcdPhysicsController::AddCompoundChild(PHY_IPhysicsController *child)
   GetShapeInfo()->AddShape(proxyShapeInfo);
   // create new bullet collision shape from the object shapeinfo and set scaling
   btCollisionShape *newChildShape = proxyShapeInfo->CreateBulletShape(
-      childCtrl->GetMargin(), childCtrl->GetConstructionInfo().m_bGimpact, true);
-  newChildShape->setLocalScaling(relativeScale);
+      childCtrl->GetMargin(), childCtrl->GetConstructionInfo().m_bGimpact, true, relativeScale);
+  newChildShape = CcdShapeConstructionInfo::SetShapeScaling(newChildShape, relativeScale);
   // add bullet collision shape to parent compound collision shape
   compoundShape->addChildShape(proxyShapeInfo->m_childTrans, newChildShape);
   // proxyShapeInfo is not needed anymore, release it
@@ -1778,7 +1802,7 @@ void CcdPhysicsController::RemoveCompoundChild(PHY_IPhysicsController *child)
         break;
       }
     }
-    delete childCtrl->m_bulletChildShape;
+    DeleteBulletShape(childCtrl->m_bulletChildShape, true);
     childCtrl->m_bulletChildShape = nullptr;
   }
   // recompute inertia of parent
@@ -1976,19 +2000,23 @@ void DefaultMotionState::CalculateWorldTransformations()
 
 // Shape constructor
 std::map<RAS_MeshObject *, CcdShapeConstructionInfo *> CcdShapeConstructionInfo::m_meshShapeMap;
+std::map<RAS_MeshObject *, CcdShapeConstructionInfo *>
+    CcdShapeConstructionInfo::m_polytopeShapeMap;
+unsigned int CcdShapeConstructionInfo::m_numShared = 0;
+size_t CcdShapeConstructionInfo::m_savedMemory = 0;
 
 CcdShapeConstructionInfo *CcdShapeConstructionInfo::FindMesh(RAS_MeshObject *mesh,
                                                              bool polytope)
 {
-  if (polytope)
-    // not yet supported
+  const std::map<RAS_MeshObject *, CcdShapeConstructionInfo *> &shapeMap =
+      polytope ? m_polytopeShapeMap : m_meshShapeMap;
+  std::map<RAS_MeshObject *, CcdShapeConstructionInfo *>::const_iterator mit = shapeMap.find(mesh);
+  if (mit == shapeMap.end()) {
     return nullptr;
+  }
 
-  std::map<RAS_MeshObject *, CcdShapeConstructionInfo *>::const_iterator mit = m_meshShapeMap.find(
-      mesh);
-  if (mit != m_meshShapeMap.end())
-    return mit->second;
-  return nullptr;
+  // The mesh conversion is not duplicated, the reuse is counted by CreateBulletShape.
+  return mit->second;
 }
 
 CcdShapeConstructionInfo *CcdShapeConstructionInfo::GetReplica()
@@ -2003,6 +2031,7 @@ void CcdShapeConstructionInfo::ProcessReplica()
   m_userData = nullptr;
   m_meshObject = nullptr;
   m_triangleIndexVertexArray = nullptr;
+  m_optimizedBvh = nullptr;
   m_forceReInstance = false;
   m_shapeProxy = nullptr;
   m_vertexArray.clear();
@@ -2010,6 +2039,8 @@ void CcdShapeConstructionInfo::ProcessReplica()
   m_triFaceArray.clear();
   m_triFaceUVcoArray.clear();
   m_shapeArray.clear();
+  m_hullPoints.clear();
+  m_sharedShapes.clear();
 }
 
 bool CcdShapeConstructionInfo::SetMesh(class KX_Scene *kxscene,
@@ -2305,8 +2336,25 @@ bool CcdShapeConstructionInfo::SetMesh(class KX_Scene *kxscene,
 
   m_meshObject = meshobj;
 
-  // sharing only on static mesh at present, if you change that, you must also change in FindMesh
-  if (!polytope) {
+  if (polytope) {
+    /* The hull is computed once for all the objects and replicas using this mesh, their shapes
+     * only reference its points. */
+    btConvexHullComputer hull;
+    hull.compute(&m_vertexArray[0], 3 * sizeof(btScalar), m_vertexArray.size() / 3, 0.0f, 0.0f);
+    if (hull.vertices.size() > 0) {
+      m_hullPoints = hull.vertices;
+    }
+    else {
+      for (size_t i = 0; i < m_vertexArray.size(); i += 3) {
+        m_hullPoints.push_back(
+            btVector3(m_vertexArray[i], m_vertexArray[i + 1], m_vertexArray[i + 2]));
+      }
+    }
+
+    m_polytopeShapeMap.insert(
+        std::pair<RAS_MeshObject *, CcdShapeConstructionInfo *>(meshobj, this));
+  }
+  else {
     // triangle shape can be shared, store the mesh object in the map
     m_meshShapeMap.insert(std::pair<RAS_MeshObject *, CcdShapeConstructionInfo *>(meshobj, this));
   }
@@ -2643,6 +2691,10 @@ bool CcdShapeConstructionInfo::UpdateMesh(class KX_GameObject *from_gameobj,
   if (m_triangleIndexVertexArray) {
     m_forceReInstance = true;
   }
+  // The shared GImpact shapes reference the previous mesh, they can't be used anymore.
+  for (SharedShape &sharedShape : m_sharedShapes) {
+    sharedShape.m_valid = false;
+  }
 
   // Make sure to also replace the mesh in the shape map! Otherwise we leave dangling references
   // when we free. Note, this whole business could cause issues with shared meshes. If we update
@@ -2672,13 +2724,14 @@ bool CcdShapeConstructionInfo::SetProxy(CcdShapeConstructionInfo *shapeInfo)
 
 btCollisionShape *CcdShapeConstructionInfo::CreateBulletShape(btScalar margin,
                                                               bool useGimpact,
-                                                              bool useBvh)
+                                                              bool useBvh,
+                                                              const btVector3 &scaling)
 {
   btCollisionShape *collisionShape = nullptr;
   btCompoundShape *compoundShape = nullptr;
 
   if (m_shapeType == PHY_SHAPE_PROXY && m_shapeProxy != nullptr)
-    return m_shapeProxy->CreateBulletShape(margin, useGimpact, useBvh);
+    return m_shapeProxy->CreateBulletShape(margin, useGimpact, useBvh, scaling);
 
   switch (m_shapeType) {
     default:
@@ -2705,8 +2758,21 @@ btCollisionShape *CcdShapeConstructionInfo::CreateBulletShape(btScalar margin,
       break;
 
     case PHY_SHAPE_POLYTOPE:
-      collisionShape = new btConvexHullShape(
-          &m_vertexArray[0], m_vertexArray.size() / 3, 3 * sizeof(btScalar));
+      // Soft bodies are built from the points of a btConvexHullShape.
+      if (useBvh && m_hullPoints.size() > 0) {
+        // The point cloud shape only references the points and applies its own scaling.
+        collisionShape = new btConvexPointCloudShape(
+            &m_hullPoints[0], m_hullPoints.size(), btVector3(1.0f, 1.0f, 1.0f));
+        // Any other user would have its own btConvexHullShape copying all the vertices.
+        if (GetRefCount() > 1) {
+          ++m_numShared;
+          m_savedMemory += (m_vertexArray.size() / 3) * sizeof(btVector3);
+        }
+      }
+      else {
+        collisionShape = new btConvexHullShape(
+            &m_vertexArray[0], m_vertexArray.size() / 3, 3 * sizeof(btScalar));
+      }
       collisionShape->setMargin(margin);
       break;
 
@@ -2737,10 +2803,7 @@ btCollisionShape *CcdShapeConstructionInfo::CreateBulletShape(btScalar margin,
           m_forceReInstance = false;
         }
 
-        btGImpactMeshShape *gimpactShape = new btGImpactMeshShape(m_triangleIndexVertexArray);
-        gimpactShape->setMargin(margin);
-        gimpactShape->updateBound();
-        collisionShape = gimpactShape;
+        collisionShape = GetSharedGimpactShape(margin, scaling);
       }
       else {
         if (!m_triangleIndexVertexArray || m_forceReInstance) {
@@ -2773,16 +2836,48 @@ btCollisionShape *CcdShapeConstructionInfo::CreateBulletShape(btScalar margin,
                                                                         3 * sizeof(btScalar));
           }
 
+          if (m_optimizedBvh) {
+            CcdShapeCache::FreeOptimizedBvh(m_optimizedBvh);
+            m_optimizedBvh = nullptr;
+          }
+
           m_forceReInstance = false;
         }
 
         btBvhTriangleMeshShape *unscaledShape = new btBvhTriangleMeshShape(
-            m_triangleIndexVertexArray, true, useBvh);
+            m_triangleIndexVertexArray, true, false);
+        if (useBvh) {
+          // The BVH is built once for all the shapes using this mesh, or loaded from the cache.
+          if (!m_optimizedBvh) {
+            const std::string key = CcdShapeCache::GetKey(
+                m_vertexArray.size() ? &m_vertexArray[0] : nullptr,
+                m_vertexArray.size() * sizeof(btScalar),
+                m_triFaceArray.data(),
+                m_triFaceArray.size() * sizeof(int),
+                m_weldingThreshold1);
+            m_optimizedBvh = CcdShapeCache::GetOptimizedBvh(key,
+                                                            m_triangleIndexVertexArray,
+                                                            unscaledShape->getLocalAabbMin(),
+                                                            unscaledShape->getLocalAabbMax());
+          }
+          unscaledShape->setOptimizedBvh(m_optimizedBvh);
+        }
         unscaledShape->setMargin(margin);
         collisionShape = new btScaledBvhTriangleMeshShape(unscaledShape,
                                                           btVector3(1.0f, 1.0f, 1.0f));
         collisionShape->setMargin(margin);
       }
+
+      /* Any other user would have its own mesh conversion, a reused GImpact shape adds its own
+       * memory in GetSharedGimpactShape. */
+      if (GetRefCount() > 1) {
+        ++m_numShared;
+        m_savedMemory += sizeof(CcdShapeConstructionInfo) +
+                         m_vertexArray.size() * sizeof(btScalar) +
+                         m_polygonIndexArray.size() * sizeof(int) +
+                         m_triFaceArray.size() * sizeof(int) +
+                         m_triFaceUVcoArray.size() * sizeof(UVco);
+      }
       break;
 
     case PHY_SHAPE_COMPOUND:
@@ -2794,9 +2889,10 @@ btCollisionShape *CcdShapeConstructionInfo::CreateBulletShape(btScalar margin,
       for (std::vector<CcdShapeConstructionInfo *>::iterator sit = m_shapeArray.begin();
            sit != m_shapeArray.end();
            sit++) {
-        collisionShape = (*sit)->CreateBulletShape(margin, useGimpact, useBvh);
+        collisionShape = (*sit)->CreateBulletShape(
+            margin, useGimpact, useBvh, (*sit)->m_childScale);
         if (collisionShape) {
-          collisionShape->setLocalScaling((*sit)->m_childScale);
+          collisionShape = SetShapeScaling(collisionShape, (*sit)->m_childScale);
           compoundShape->addChildShape((*sit)->m_childTrans, collisionShape);
         }
       }
@@ -2810,6 +2906,94 @@ btCollisionShape *CcdShapeConstructionInfo::CreateBulletShape(btScalar margin,
   return collisionShape;
 }
 
+/// Estimate the memory used by a GImpact shape and its BVH.
+static size_t gimpact_shape_memory(const btGImpactMeshShape *shape)
+{
+  size_t size = sizeof(btGImpactMeshShape);
+  for (int i = 0; i < shape->getMeshPartCount(); ++i) {
+    const btGImpactMeshShapePart *part = shape->getMeshPart(i);
+    size += sizeof(btGImpactMeshShapePart) +
+            part->getBoxSet()->getNodeCount() * sizeof(BT_QUANTIZED_BVH_NODE);
+  }
+  return size;
+}
+
+btCollisionShape *CcdShapeConstructionInfo::GetSharedGimpactShape(btScalar margin,
+                                                                  const btVector3 &scaling)
+{
+  for (SharedShape &sharedShape : m_sharedShapes) {
+    btCollisionShape *shape = sharedShape.m_shape;
+    if (sharedShape.m_valid && shape->getMargin() == margin &&
+        shape->getLocalScaling() == scaling)
+    {
+      ++sharedShape.m_users;
+      // The reuse itself is counted by CreateBulletShape.
+      m_savedMemory += gimpact_shape_memory(static_cast<btGImpactMeshShape *>(shape));
+      return shape;
+    }
+  }
+
+  btGImpactMeshShape *gimpactShape = new btGImpactMeshShape(m_triangleIndexVertexArray);
+  gimpactShape->setMargin(margin);
+  gimpactShape->setLocalScaling(scaling);
+  gimpactShape->updateBound();
+  // Mark the shape as shared, see ReleaseSharedShape.
+  gimpactShape->setUserPointer(this);
+
+  m_sharedShapes.push_back({gimpactShape, 1, true});
+
+  return gimpactShape;
+}
+
+btCollisionShape *CcdShapeConstructionInfo::SetShapeScaling(btCollisionShape *shape,
+                                                            const btVector3 &scaling)
+{
+  CcdShapeConstructionInfo *shapeInfo = static_cast<CcdShapeConstructionInfo *>(
+      shape->getUserPointer());
+  if (!shapeInfo) {
+    shape->setLocalScaling(scaling);
+    return shape;
+  }
+
+  if (shape->getLocalScaling() == scaling) {
+    return shape;
+  }
+
+  btCollisionShape *newShape = shapeInfo->GetSharedGimpactShape(shape->getMargin(), scaling);
+  ReleaseSharedShape(shape);
+  return newShape;
+}
+
+bool CcdShapeConstructionInfo::ReleaseSharedShape(btCollisionShape *shape)
+{
+  CcdShapeConstructionInfo *shapeInfo = static_cast<CcdShapeConstructionInfo *>(
+      shape->getUserPointer());
+  if (!shapeInfo) {
+    return false;
+  }
+
+  std::vector<SharedShape> &sharedShapes = shapeInfo->m_sharedShapes;
+  for (std::vector<SharedShape>::iterator it = sharedShapes.begin(); it != sharedShapes.end();
+       ++it)
+  {
+    if (it->m_shape == shape) {
+      if (--it->m_users == 0) {
+        delete shape;
+        sharedShapes.erase(it);
+      }
+      break;
+    }
+  }
+
+  return true;
+}
+
+void CcdShapeConstructionInfo::GetSharingStats(unsigned int &numShared, size_t &savedMemory)
+{
+  numShared = m_numShared;
+  savedMemory = m_savedMemory;
+}
+
 void CcdShapeConstructionInfo::AddShape(CcdShapeConstructionInfo *shapeInfo)
 {
   m_shapeArray.push_back(shapeInfo);
@@ -2825,14 +3009,24 @@ CcdShapeConstructionInfo::~CcdShapeConstructionInfo()
 
   if (m_triangleIndexVertexArray)
     delete m_triangleIndexVertexArray;
+  if (m_optimizedBvh) {
+    CcdShapeCache::FreeOptimizedBvh(m_optimizedBvh);
+  }
   m_vertexArray.clear();
-  if (m_shapeType == PHY_SHAPE_MESH && m_meshObject != nullptr) {
-    std::map<RAS_MeshObject *, CcdShapeConstructionInfo *>::iterator mit = m_meshShapeMap.find(
+  if (ELEM(m_shapeType, PHY_SHAPE_MESH, PHY_SHAPE_POLYTOPE) && m_meshObject != nullptr) {
+    std::map<RAS_MeshObject *, CcdShapeConstructionInfo *> &shapeMap =
+        (m_shapeType == PHY_SHAPE_MESH) ? m_meshShapeMap : m_polytopeShapeMap;
+    std::map<RAS_MeshObject *, CcdShapeConstructionInfo *>::iterator mit = shapeMap.find(
         m_meshObject);
-    if (mit != m_meshShapeMap.end() && mit->second == this) {
-      m_meshShapeMap.erase(mit);
+    if (mit != shapeMap.end() && mit->second == this) {
+      shapeMap.erase(mit);
     }
   }
+  /* A controller replacing its shape info releases it before its shape, the shape is then
+   * deleted as an unshared one. */
+  for (SharedShape &sharedShape : m_sharedShapes) {
+    sharedShape.m_shape->setUserPointer(nullptr);
+  }
   if (m_shapeType == PHY_SHAPE_PROXY && m_shapeProxy != nullptr) {
     m_shapeProxy->Release();
   }
@@ -79,6 +79,7 @@ class CcdShapeConstructionInfo : public CM_RefCount<CcdShapeConstructionInfo> {
         m_userData(nullptr),
         m_meshObject(nullptr),
         m_triangleIndexVertexArray(nullptr),
+        m_optimizedBvh(nullptr),
         m_forceReInstance(false),
         m_weldingThreshold1(0.0f),
         m_shapeProxy(nullptr)
@@ -156,9 +157,27 @@ class CcdShapeConstructionInfo : public CM_RefCount<CcdShapeConstructionInfo> {
     return m_shapeProxy;
   }
 
+  /** Create a Bullet shape, a shared shape must be freed with ReleaseSharedShape.
+   * The convex hull shapes reference the hull points of this shape info, except for soft
+   * bodies (useBvh false). The GImpact shapes are shared between the users of the same scaling
+   * and margin.
+   * \param scaling The initial scaling of the shape.
+   */
   btCollisionShape *CreateBulletShape(btScalar margin,
                                       bool useGimpact = false,
-                                      bool useBvh = true);
+                                      bool useBvh = true,
+                                      const btVector3 &scaling = btVector3(1.0f, 1.0f, 1.0f));
+
+  /** Set the scaling of a Bullet shape created by CreateBulletShape. A shared shape is not
+   * modified, it is released and the shared shape of the new scaling is returned instead.
+   */
+  static btCollisionShape *SetShapeScaling(btCollisionShape *shape, const btVector3 &scaling);
+  /// Release a Bullet shape shared between controllers, return false for an unshared shape.
+  static bool ReleaseSharedShape(btCollisionShape *shape);
+  /** Return the number of shape infos and Bullet shapes reusing the data of another one and
+   * an estimation of the memory it saved in bytes.
+   */
+  static void GetSharingStats(unsigned int &numShared, size_t &savedMemory);
 
   // member variables
   PHY_ShapeType m_shapeType;
@@ -189,11 +208,26 @@ class CcdShapeConstructionInfo : public CM_RefCount<CcdShapeConstructionInfo> {
   }
 
  protected:
+  /// A GImpact shape used by several controllers.
+  struct SharedShape {
+    btCollisionShape *m_shape;
+    unsigned int m_users;
+    /// False when the mesh was updated, the shape is only kept until its users release it.
+    bool m_valid;
+  };
+
   static std::map<RAS_MeshObject *, CcdShapeConstructionInfo *> m_meshShapeMap;
+  static std::map<RAS_MeshObject *, CcdShapeConstructionInfo *> m_polytopeShapeMap;
+  static unsigned int m_numShared;
+  static size_t m_savedMemory;
+
+  btCollisionShape *GetSharedGimpactShape(btScalar margin, const btVector3 &scaling);
   /// Keep a pointer to the original mesh
   RAS_MeshObject *m_meshObject;
   /// The list of vertexes and indexes for the triangle mesh, shared between Bullet shape.
   btTriangleIndexVertexArray *m_triangleIndexVertexArray;
+  /// The BVH of the triangle mesh, shared between Bullet shape and stored in CcdShapeCache.
+  btOptimizedBvh *m_optimizedBvh;
   /// for compound shapes
   std::vector<CcdShapeConstructionInfo *> m_shapeArray;
   /// use gimpact for concave dynamic/moving collision detection
@@ -202,6 +236,10 @@ class CcdShapeConstructionInfo : public CM_RefCount<CcdShapeConstructionInfo> {
   float m_weldingThreshold1;
   /// only used for PHY_SHAPE_PROXY, pointer to actual shape info
   CcdShapeConstructionInfo *m_shapeProxy;
+  /// Vertices of the convex hull of m_vertexArray, used by all the polytope Bullet shapes.
+  btAlignedObjectArray<btVector3> m_hullPoints;
+  /// GImpact shapes of the controllers using this shape info.
+  std::vector<SharedShape> m_sharedShapes;
 };
 
 struct CcdConstructionInfo {
@@ -635,6 +673,9 @@ class CcdPhysicsController : public PHY_IPhysicsController {
    */
   bool ReplaceControllerShape(btCollisionShape *newShape);
 
+  /// Set the scaling of the Bullet shape, a shape shared between controllers is replaced.
+  void SetCollisionShapeScaling(const btVector3 &scaling);
+
   virtual ~CcdPhysicsController();
 
   CcdConstructionInfo &GetConstructionInfo()
@@ -21,7 +21,10 @@
 
 #include "CcdPhysicsEnvironment.h"
 
+#include "BKE_collection.h"
 #include "BKE_object.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
 #include "DNA_object_force_types.h"
 #include "DNA_scene_types.h"
 
@@ -29,11 +32,14 @@
 #include "BulletCollision/Gimpact/btGImpactCollisionAlgorithm.h"
 #include "BulletCollision/NarrowPhaseCollision/btRaycastCallback.h"
 #include "BulletDynamics/ConstraintSolver/btNNCGConstraintSolver.h"
+#include "BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h"
 #include "BulletSoftBody/btSoftBodyRigidBodyCollisionConfiguration.h"
 #include "BulletSoftBody/btSoftRigidDynamicsWorld.h"
+#include "LinearMath/btThreads.h"
 
 #include "BL_SceneConverter.h"
 #include "CM_List.h"
+#include "CM_Trace.h"
 #include "CcdConstraint.h"
 #include "CcdGraphicController.h"
 #include "KX_ClientObjectInfo.h"
@@ -67,6 +73,213 @@ void DrawRasterizerLine(const float *from, const float *to, int color);
 #  endif  //_MSC_VER
 #endif    // WIN32
 
+/** Bullet task scheduler running the parallel loops of the multithreaded world
+ * in the Blender task scheduler (TBB) instead of spawning its own threads.
+ * The range is split in at most m_numThreads chunks to honor the scene physics threads setting.
+ */
+class CcdTaskScheduler : public btITaskScheduler {
+ private:
+  int m_numThreads;
+
+  struct ForData {
+    const btIParallelForBody *body;
+    int begin;
+    int end;
+    int chunkSize;
+  };
+
+  struct SumData {
+    const btIParallelSumBody *body;
+    int begin;
+    int end;
+    int chunkSize;
+    btScalar *sums;
+  };
+
+  static void ForFunc(void *__restrict userdata, int chunk, const TaskParallelTLS *__restrict tls)
+  {
+    const ForData *data = (ForData *)userdata;
+    const int begin = data->begin + chunk * data->chunkSize;
+    data->body->forLoop(begin, std::min(begin + data->chunkSize, data->end));
+  }
+
+  static void SumFunc(void *__restrict userdata, int chunk, const TaskParallelTLS *__restrict tls)
+  {
+    const SumData *data = (SumData *)userdata;
+    const int begin = data->begin + chunk * data->chunkSize;
+    data->sums[chunk] = data->body->sumLoop(begin, std::min(begin + data->chunkSize, data->end));
+  }
+
+  /// Return the number of iterations per chunk, at least grainSize.
+  int GetChunkSize(int iBegin, int iEnd, int grainSize) const
+  {
+    const int perThread = (iEnd - iBegin + m_numThreads - 1) / m_numThreads;
+    return std::max(std::max(grainSize, perThread), 1);
+  }
+
+ public:
+  CcdTaskScheduler() : btITaskScheduler("Blender"), m_numThreads(1)
+  {
+  }
+
+  virtual int getMaxNumThreads() const
+  {
+    return BLI_system_thread_count();
+  }
+
+  virtual int getNumThreads() const
+  {
+    return m_numThreads;
+  }
+
+  virtual void setNumThreads(int numThreads)
+  {
+    m_numThreads = std::max(1, std::min(numThreads, getMaxNumThreads()));
+  }
+
+  virtual void parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody &body)
+  {
+    const int chunkSize = GetChunkSize(iBegin, iEnd, grainSize);
+    const int numChunks = (iEnd - iBegin + chunkSize - 1) / chunkSize;
+    if (numChunks <= 1) {
+      body.forLoop(iBegin, iEnd);
+      return;
+    }
+
+    ForData data = {&body, iBegin, iEnd, chunkSize};
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    BLI_task_parallel_range(0, numChunks, &data, ForFunc, &settings);
+  }
+
+  virtual btScalar parallelSum(int iBegin, int iEnd, int grainSize, const btIParallelSumBody &body)
+  {
+    const int chunkSize = GetChunkSize(iBegin, iEnd, grainSize);
+    const int numChunks = (iEnd - iBegin + chunkSize - 1) / chunkSize;
+    if (numChunks <= 1) {
+      return body.sumLoop(iBegin, iEnd);
+    }
+
+    std::vector<btScalar> sums(numChunks);
+    SumData data = {&body, iBegin, iEnd, chunkSize, sums.data()};
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    BLI_task_parallel_range(0, numChunks, &data, SumFunc, &settings);
+
+    btScalar sum = 0.0f;
+    for (btScalar value : sums) {
+      sum += value;
+    }
+    return sum;
+  }
+};
+
+static CcdTaskScheduler &GetTaskScheduler()
+{
+  static CcdTaskScheduler scheduler;
+  return scheduler;
+}
+
+/** Soft rigid dynamics world solving the rigid body simulation islands in parallel,
+ * as btDiscreteDynamicsWorldMt does for a discrete world. Soft bodies are still
+ * solved on the calling thread.
+ */
+ATTRIBUTE_ALIGNED16(class) CcdSoftRigidDynamicsWorldMt : public btSoftRigidDynamicsWorld
+{
+ protected:
+  struct UpdaterIntegrateTransforms : public btIParallelForBody {
+    btScalar timeStep;
+    btRigidBody **rigidBodies;
+    CcdSoftRigidDynamicsWorldMt *world;
+
+    void forLoop(int iBegin, int iEnd) const
+    {
+      world->integrateTransformsInternal(&rigidBodies[iBegin], iEnd - iBegin, timeStep);
+    }
+  };
+
+  struct UpdaterCreatePredictiveContacts : public btIParallelForBody {
+    btScalar timeStep;
+    btRigidBody **rigidBodies;
+    CcdSoftRigidDynamicsWorldMt *world;
+
+    void forLoop(int iBegin, int iEnd) const
+    {
+      world->createPredictiveContactsInternal(&rigidBodies[iBegin], iEnd - iBegin, timeStep);
+    }
+  };
+
+  /// Number of rigid bodies per task in the parallel loops.
+  static const int s_grainSize = 50;
+
+  virtual void solveConstraints(btContactSolverInfo &solverInfo)
+  {
+    BT_PROFILE("solveConstraints");
+
+    m_constraintSolver->prepareSolve(getCollisionWorld()->getNumCollisionObjects(),
+                                     getCollisionWorld()->getDispatcher()->getNumManifolds());
+
+    btSimulationIslandManagerMt *islandManager = static_cast<btSimulationIslandManagerMt *>(
+        m_islandManager);
+    btSimulationIslandManagerMt::SolverParams solverParams;
+    solverParams.m_solverPool = m_constraintSolver;
+    solverParams.m_solverMt = nullptr;
+    solverParams.m_solverInfo = &solverInfo;
+    solverParams.m_debugDrawer = m_debugDrawer;
+    solverParams.m_dispatcher = getCollisionWorld()->getDispatcher();
+    islandManager->buildAndProcessIslands(
+        getCollisionWorld()->getDispatcher(), getCollisionWorld(), m_constraints, solverParams);
+
+    m_constraintSolver->allSolved(solverInfo, m_debugDrawer);
+  }
+
+  virtual void integrateTransforms(btScalar timeStep)
+  {
+    BT_PROFILE("integrateTransforms");
+    if (m_nonStaticRigidBodies.size() > 0) {
+      UpdaterIntegrateTransforms update;
+      update.world = this;
+      update.timeStep = timeStep;
+      update.rigidBodies = &m_nonStaticRigidBodies[0];
+      btParallelFor(0, m_nonStaticRigidBodies.size(), s_grainSize, update);
+    }
+  }
+
+  virtual void createPredictiveContacts(btScalar timeStep)
+  {
+    BT_PROFILE("createPredictiveContacts");
+    releasePredictiveContacts();
+    if (m_nonStaticRigidBodies.size() > 0) {
+      UpdaterCreatePredictiveContacts update;
+      update.world = this;
+      update.timeStep = timeStep;
+      update.rigidBodies = &m_nonStaticRigidBodies[0];
+      btParallelFor(0, m_nonStaticRigidBodies.size(), s_grainSize, update);
+    }
+  }
+
+ public:
+  BT_DECLARE_ALIGNED_ALLOCATOR();
+
+  CcdSoftRigidDynamicsWorldMt(btDispatcher *dispatcher,
+                              btBroadphaseInterface *pairCache,
+                              btConstraintSolverPoolMt *solverPool,
+                              btCollisionConfiguration *collisionConfiguration)
+      : btSoftRigidDynamicsWorld(dispatcher, pairCache, solverPool, collisionConfiguration)
+  {
+    // Replace the island manager by one dispatching the islands to the solver pool.
+    if (m_ownsIslandManager) {
+      m_islandManager->~btSimulationIslandManager();
+      btAlignedFree(m_islandManager);
+    }
+    void *mem = btAlignedAlloc(sizeof(btSimulationIslandManagerMt), 16);
+    btSimulationIslandManagerMt *islandManager = new (mem) btSimulationIslandManagerMt();
+    islandManager->setMinimumSolverBatchSize(m_solverInfo.m_minimumSolverBatchSize);
+    m_islandManager = islandManager;
+    m_ownsIslandManager = true;
+  }
+};
+
 class VehicleClosestRayResultCallback : public btCollisionWorld::ClosestRayResultCallback {
  private:
   const btCollisionShape *m_hitTriangleShape;
@@ -365,16 +578,21 @@ void CcdPhysicsEnvironment::SetDebugDrawer(btIDebugDraw *debugDrawer)
   m_debugDrawer = debugDrawer;
 }
 
-CcdPhysicsEnvironment::CcdPhysicsEnvironment(PHY_SolverType solverType, bool useDbvtCulling)
+CcdPhysicsEnvironment::CcdPhysicsEnvironment(PHY_SolverType solverType,
+                                             bool useDbvtCulling,
+                                             int numThreads)
     : m_cullingCache(nullptr),
       m_cullingTree(nullptr),
       m_numIterations(10),
       m_numTimeSubSteps(1),
       m_solverType(PHY_SOLVER_NONE),
+      m_numThreads(std::max(1, std::min(numThreads, BLI_system_thread_count()))),
       m_deactivationTime(2.0f),
       m_linearDeactivationThreshold(0.8f),
       m_angularDeactivationThreshold(1.0f),
       m_contactBreakingThreshold(0.02f),
+      m_subStepTraceBegin(-1.0),
+      m_numMergedCollisions(0),
       m_solver(nullptr),
       m_filterCallback(nullptr),
       m_ghostPairCallback(nullptr),
@@ -405,10 +623,25 @@ CcdPhysicsEnvironment::CcdPhysicsEnvironment(PHY_SolverType solverType, bool use
   SetSolverType(solverType);  // issues with quickstep and memory allocations
   //	m_dynamicsWorld = new
   // btDiscreteDynamicsWorld(dispatcher,m_broadphase,m_solver,m_collisionConfiguration);
-  m_dynamicsWorld = new btSoftRigidDynamicsWorld(
-      dispatcher, m_broadphase, m_solver, m_collisionConfiguration);
+  if (m_numThreads > 1) {
+    CcdTaskScheduler &scheduler = GetTaskScheduler();
+    if (btGetTaskScheduler() != &scheduler) {
+      btSetTaskScheduler(&scheduler);
+    }
+    m_dynamicsWorld = new CcdSoftRigidDynamicsWorldMt(
+        dispatcher,
+        m_broadphase,
+        static_cast<btConstraintSolverPoolMt *>(m_solver),
+        m_collisionConfiguration);
+  }
+  else {
+    m_dynamicsWorld = new btSoftRigidDynamicsWorld(
+        dispatcher, m_broadphase, m_solver, m_collisionConfiguration);
+  }
   m_dynamicsWorld->setInternalTickCallback(&CcdPhysicsEnvironment::StaticSimulationSubtickCallback,
                                            this);
+  m_dynamicsWorld->setInternalTickCallback(
+      &CcdPhysicsEnvironment::StaticSimulationPreSubtickCallback, this, true);
   // m_dynamicsWorld->getSolverInfo().m_linearSlop = 0.01f;
   // m_dynamicsWorld->getSolverInfo().m_solverMode=	SOLVER_USE_WARMSTARTING +
   // SOLVER_USE_2_FRICTION_DIRECTIONS +	SOLVER_RANDMIZE_ORDER +	SOLVER_USE_FRICTION_WARMSTARTING;
@@ -564,6 +797,21 @@ bool CcdPhysicsEnvironment::RemoveCcdPhysicsController(CcdPhysicsController *ctr
     return false;
   }
 
+  // a controller removed during a merge gets back the state it had before being added
+  for (unsigned int i = 0, size = m_mergedControllers.size(); i < size; ++i) {
+    const MergedController &merged = m_mergedControllers[i];
+    if (merged.m_controller == ctrl) {
+      btCollisionObject *obj = ctrl->GetCollisionObject();
+      obj->setCollisionFlags(merged.m_collisionFlags);
+      obj->forceActivationState(merged.m_activationState);
+      if (i < m_numMergedCollisions) {
+        --m_numMergedCollisions;
+      }
+      m_mergedControllers.erase(m_mergedControllers.begin() + i);
+      break;
+    }
+  }
+
   // also remove constraint
   btRigidBody *body = ctrl->GetRigidBody();
   if (body) {
@@ -718,6 +966,20 @@ void CcdPhysicsEnvironment::SimulationSubtickCallback(btScalar timeStep)
   for (it = m_controllers.begin(); it != m_controllers.end(); it++) {
     (*it)->SimulationTick(timeStep);
   }
+
+  if (m_subStepTraceBegin >= 0.0) {
+    CM_Trace::AddEvent("physics", "Substep", m_subStepTraceBegin, CM_Trace::GetTime());
+    m_subStepTraceBegin = -1.0;
+  }
+}
+
+void CcdPhysicsEnvironment::StaticSimulationPreSubtickCallback(btDynamicsWorld *world,
+                                                               btScalar timeStep)
+{
+  CcdPhysicsEnvironment *this_ = static_cast<CcdPhysicsEnvironment *>(world->getWorldUserInfo());
+  if (CM_Trace::IsEnabled()) {
+    this_->m_subStepTraceBegin = CM_Trace::GetTime();
+  }
 }
 
 bool CcdPhysicsEnvironment::ProceedDeltaTime(double curTime, float timeStep, float interval)
@@ -725,9 +987,7 @@ bool CcdPhysicsEnvironment::ProceedDeltaTime(double curTime, float timeStep, flo
   std::set<CcdPhysicsController *>::iterator it;
   int i;
 
-  // Update Bullet global variables.
-  gDeactivationTime = m_deactivationTime;
-  gContactBreakingThreshold = m_contactBreakingThreshold;
+  ApplyGlobalSettings();
 
   for (it = m_controllers.begin(); it != m_controllers.end(); it++) {
     (*it)->SynchronizeMotionStates(timeStep);
@@ -764,6 +1024,45 @@ void CcdPhysicsEnvironment::UpdateSoftBodies()
   }
 }
 
+bool CcdPhysicsEnvironment::CanProceedConcurrently(PHY_IPhysicsEnvironment *other) const
+{
+#ifndef BT_THREADSAFE
+  /* Without BT_THREADSAFE the profiler, the thread index and the pool allocators of Bullet
+   * are shared between all the worlds without any guard. */
+  return false;
+#endif
+
+  CcdPhysicsEnvironment *ccdOther = dynamic_cast<CcdPhysicsEnvironment *>(other);
+  // Other physics engines don't use the Bullet global variables.
+  if (!ccdOther) {
+    return true;
+  }
+
+  // The Bullet task scheduler is shared, only one multithreaded world can step at a time.
+  if (m_numThreads > 1 || ccdOther->m_numThreads > 1) {
+    return false;
+  }
+
+  // The Bullet global variables are overwritten at each step, they must be the same.
+  return (m_deactivationTime == ccdOther->m_deactivationTime &&
+          m_contactBreakingThreshold == ccdOther->m_contactBreakingThreshold);
+}
+
+void CcdPhysicsEnvironment::ApplyGlobalSettings()
+{
+  /* Update Bullet global variables, only when they change: the environments stepped
+   * concurrently all read the same values and must not write them. */
+  if (gDeactivationTime != m_deactivationTime) {
+    gDeactivationTime = m_deactivationTime;
+  }
+  if (gContactBreakingThreshold != m_contactBreakingThreshold) {
+    gContactBreakingThreshold = m_contactBreakingThreshold;
+  }
+  if (m_numThreads > 1) {
+    GetTaskScheduler().setNumThreads(m_numThreads);
+  }
+}
+
 class ClosestRayResultCallbackNotMe : public btCollisionWorld::ClosestRayResultCallback {
   btCollisionObject *m_owner;
   btCollisionObject *m_parent;
@@ -1009,20 +1308,31 @@ void CcdPhysicsEnvironment::SetSolverType(PHY_SolverType solverType)
     return;
   }
 
-  switch (solverType) {
-    case PHY_SOLVER_SEQUENTIAL: {
-      m_solver = new btSequentialImpulseConstraintSolver();
-      break;
-    }
+  // The multithreaded world uses a pool of solvers, one per thread.
+  std::vector<btConstraintSolver *> solvers(m_numThreads);
+  for (btConstraintSolver *&solver : solvers) {
+    switch (solverType) {
+      case PHY_SOLVER_SEQUENTIAL: {
+        solver = new btSequentialImpulseConstraintSolver();
+        break;
+      }
 
-    case PHY_SOLVER_NNCG: {
-      m_solver = new btNNCGConstraintSolver();
-      break;
-    }
-    default: {
-      BLI_assert(false);
-    }
-  };
+      case PHY_SOLVER_NNCG: {
+        solver = new btNNCGConstraintSolver();
+        break;
+      }
+      default: {
+        BLI_assert(false);
+      }
+    };
+  }
+
+  if (m_numThreads > 1) {
+    m_solver = new btConstraintSolverPoolMt(solvers.data(), m_numThreads);
+  }
+  else {
+    m_solver = solvers[0];
+  }
   m_solverType = solverType;
 }
 
@@ -1065,18 +1375,56 @@ void CcdPhysicsEnvironment::RemoveConstraintById(int constraintId, bool free)
   }
 }
 
+/// Return false if a ray test modifies the data of the shape, as the GImpact shapes do.
+static bool IsShapeRayTestThreadSafe(const btCollisionShape *shape)
+{
+  if (shape->getShapeType() == GIMPACT_SHAPE_PROXYTYPE) {
+    return false;
+  }
+  if (shape->isCompound()) {
+    const btCompoundShape *compoundShape = static_cast<const btCompoundShape *>(shape);
+    for (int i = 0; i < compoundShape->getNumChildShapes(); i++) {
+      if (!IsShapeRayTestThreadSafe(compoundShape->getChildShape(i))) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/// Return false if a ray test on the object can't run concurrently with other ray tests.
+static bool IsRayTestThreadSafe(const btCollisionObject *object)
+{
+  // Soft bodies build their face tree on the first ray test.
+  if (object->getInternalType() == btCollisionObject::CO_SOFT_BODY) {
+    return false;
+  }
+  return IsShapeRayTestThreadSafe(object->getCollisionShape());
+}
+
 struct FilterClosestRayResultCallback : public btCollisionWorld::ClosestRayResultCallback {
   PHY_IRayCastFilterCallback &m_phyRayFilter;
   const btCollisionShape *m_hitTriangleShape;
   int m_hitTriangleIndex;
+  /// Skip the objects which can't be ray tested on several threads.
+  bool m_skipThreadUnsafe;
+  /// True if an object was skipped because of m_skipThreadUnsafe.
+  mutable bool m_skippedThreadUnsafe;
+  /// Don't call the user filter, it reads the game objects and is run later on the main thread.
+  bool m_deferFilter;
 
   FilterClosestRayResultCallback(PHY_IRayCastFilterCallback &phyRayFilter,
                                  const btVector3 &rayFrom,
-                                 const btVector3 &rayTo)
+                                 const btVector3 &rayTo,
+                                 bool skipThreadUnsafe = false,
+                                 bool deferFilter = false)
       : btCollisionWorld::ClosestRayResultCallback(rayFrom, rayTo),
         m_phyRayFilter(phyRayFilter),
         m_hitTriangleShape(nullptr),
-        m_hitTriangleIndex(0)
+        m_hitTriangleIndex(0),
+        m_skipThreadUnsafe(skipThreadUnsafe),
+        m_skippedThreadUnsafe(false),
+        m_deferFilter(deferFilter)
   {
   }
 
@@ -1094,7 +1442,13 @@ struct FilterClosestRayResultCallback : public btCollisionWorld::ClosestRayResul
     CcdPhysicsController *phyCtrl = static_cast<CcdPhysicsController *>(object->getUserPointer());
     if (phyCtrl == m_phyRayFilter.m_ignoreController)
       return false;
-    return m_phyRayFilter.needBroadphaseRayCast(phyCtrl);
+    if (!m_deferFilter && !m_phyRayFilter.needBroadphaseRayCast(phyCtrl))
+      return false;
+    if (m_skipThreadUnsafe && !IsRayTestThreadSafe(object)) {
+      m_skippedThreadUnsafe = true;
+      return false;
+    }
+    return true;
   }
 
   virtual btScalar addSingleResult(btCollisionWorld::LocalRayResult &rayResult,
@@ -1152,25 +1506,14 @@ static bool GetHitTriangle(btCollisionShape *shape,
   return true;
 }
 
-PHY_IPhysicsController *CcdPhysicsEnvironment::RayTest(PHY_IRayCastFilterCallback &filterCallback,
-                                                       float fromX,
-                                                       float fromY,
-                                                       float fromZ,
-                                                       float toX,
-                                                       float toY,
-                                                       float toZ)
+/// Cast the ray of rayCallback and fill result with its closest hit, return true on hit.
+static bool RayTestClosest(btCollisionWorld *world,
+                           FilterClosestRayResultCallback &rayCallback,
+                           PHY_RayCastResult &result)
 {
-  btVector3 rayFrom(fromX, fromY, fromZ);
-  btVector3 rayTo(toX, toY, toZ);
-
-  btVector3 hitPointWorld, normalWorld;
-
-  // Either Ray Cast with or without filtering
-
-  // btCollisionWorld::ClosestRayResultCallback rayCallback(rayFrom,rayTo);
-  FilterClosestRayResultCallback rayCallback(filterCallback, rayFrom, rayTo);
-
-  PHY_RayCastResult result;
+  PHY_IRayCastFilterCallback &filterCallback = rayCallback.m_phyRayFilter;
+  const btVector3 &rayFrom = rayCallback.m_rayFromWorld;
+  const btVector3 &rayTo = rayCallback.m_rayToWorld;
 
   // don't collision with sensor object
   rayCallback.m_collisionFilterMask = CcdConstructionInfo::AllFilter ^
@@ -1179,7 +1522,7 @@ PHY_IPhysicsController *CcdPhysicsEnvironment::RayTest(PHY_IRayCastFilterCallbac
   rayCallback.m_flags |= btTriangleRaycastCallback::kF_UseSubSimplexConvexCastRaytest;
   //, ,filterCallback.m_faceNormal);
 
-  m_dynamicsWorld->rayTest(rayFrom, rayTo, rayCallback);
+  world->rayTest(rayFrom, rayTo, rayCallback);
   if (rayCallback.hasHit()) {
     CcdPhysicsController *controller = static_cast<CcdPhysicsController *>(
         rayCallback.m_collisionObject->getUserPointer());
@@ -1190,7 +1533,7 @@ PHY_IPhysicsController *CcdPhysicsEnvironment::RayTest(PHY_IRayCastFilterCallbac
 
     if (rayCallback.m_hitTriangleShape != nullptr) {
       // identify the mesh polygon
-      CcdShapeConstructionInfo *shapeInfo = controller->m_shapeInfo;
+      CcdShapeConstructionInfo *shapeInfo = controller->GetShapeInfo();
       if (shapeInfo) {
         btCollisionShape *shape = controller->GetCollisionObject()->getCollisionShape();
         if (shape->isCompound()) {
@@ -1311,12 +1654,95 @@ PHY_IPhysicsController *CcdPhysicsEnvironment::RayTest(PHY_IRayCastFilterCallbac
     result.m_hitNormal[0] = rayCallback.m_hitNormalWorld.getX();
     result.m_hitNormal[1] = rayCallback.m_hitNormalWorld.getY();
     result.m_hitNormal[2] = rayCallback.m_hitNormalWorld.getZ();
+    return true;
+  }
+
+  return false;
+}
+
+PHY_IPhysicsController *CcdPhysicsEnvironment::RayTest(PHY_IRayCastFilterCallback &filterCallback,
+                                                       float fromX,
+                                                       float fromY,
+                                                       float fromZ,
+                                                       float toX,
+                                                       float toY,
+                                                       float toZ)
+{
+  btVector3 rayFrom(fromX, fromY, fromZ);
+  btVector3 rayTo(toX, toY, toZ);
+
+  // Either Ray Cast with or without filtering
+
+  // btCollisionWorld::ClosestRayResultCallback rayCallback(rayFrom,rayTo);
+  FilterClosestRayResultCallback rayCallback(filterCallback, rayFrom, rayTo);
+
+  PHY_RayCastResult result;
+  if (RayTestClosest(m_dynamicsWorld, rayCallback, result)) {
     filterCallback.reportHit(&result);
   }
 
   return result.m_controller;
 }
 
+struct RayTestBatchData {
+  btCollisionWorld *world;
+  PHY_IRayCastFilterCallback *const *filterCallbacks;
+  const float *from;
+  const float *to;
+  PHY_RayCastResult *results;
+  /// Set for the rays which must be tested again on a single thread.
+  std::vector<char> *deferred;
+};
+
+static void ray_test_batch_task_func(void *__restrict userdata,
+                                     int iter,
+                                     const TaskParallelTLS *__restrict tls)
+{
+  RayTestBatchData *data = static_cast<RayTestBatchData *>(userdata);
+  const float *from = &data->from[iter * 3];
+  const float *to = &data->to[iter * 3];
+  const btVector3 rayFrom(from[0], from[1], from[2]);
+  const btVector3 rayTo(to[0], to[1], to[2]);
+
+  FilterClosestRayResultCallback rayCallback(
+      *data->filterCallbacks[iter], rayFrom, rayTo, true, true);
+  PHY_RayCastResult &result = data->results[iter];
+  result = PHY_RayCastResult();
+  RayTestClosest(data->world, rayCallback, result);
+  (*data->deferred)[iter] = rayCallback.m_skippedThreadUnsafe;
+}
+
+void CcdPhysicsEnvironment::RayTestBatch(PHY_IRayCastFilterCallback *const *filterCallbacks,
+                                         const float *from,
+                                         const float *to,
+                                         unsigned int numRays,
+                                         PHY_RayCastResult *results)
+{
+  std::vector<char> deferred(numRays, false);
+  RayTestBatchData data = {m_dynamicsWorld, filterCallbacks, from, to, results, &deferred};
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 64;
+  BLI_task_parallel_range(0, numRays, &data, ray_test_batch_task_func, &settings);
+
+  /* The user filters are run here on the closest hit, when it passes the filter it's also the
+   * closest filtered hit. The rays whose closest hit is filtered out, or which crossed an object
+   * unsafe to test on several threads, are tested again here against all the objects. */
+  for (unsigned int i = 0; i < numRays; ++i) {
+    PHY_IPhysicsController *controller = results[i].m_controller;
+    if (!deferred[i] &&
+        (!controller || filterCallbacks[i]->needBroadphaseRayCast(controller))) {
+      continue;
+    }
+    const btVector3 rayFrom(from[i * 3], from[i * 3 + 1], from[i * 3 + 2]);
+    const btVector3 rayTo(to[i * 3], to[i * 3 + 1], to[i * 3 + 2]);
+    FilterClosestRayResultCallback rayCallback(*filterCallbacks[i], rayFrom, rayTo);
+    results[i] = PHY_RayCastResult();
+    RayTestClosest(m_dynamicsWorld, rayCallback, results[i]);
+  }
+}
+
 // Handles occlusion culling.
 // The implementation is based on the CDTestFramework
 struct OcclusionBuffer {
@@ -1963,23 +2389,106 @@ btDispatcher *CcdPhysicsEnvironment::GetDispatcher()
   return m_dynamicsWorld->getDispatcher();
 }
 
-void CcdPhysicsEnvironment::MergeEnvironment(PHY_IPhysicsEnvironment *other_env)
+unsigned int CcdPhysicsEnvironment::StageMergeEnvironment(PHY_IPhysicsEnvironment *other_env,
+                                                          unsigned int maxControllers)
 {
   CcdPhysicsEnvironment *other = static_cast<CcdPhysicsEnvironment *>(other_env);
   if (other == nullptr) {
     CM_Error("other scene is not using Bullet physics, not merging physics.");
-    return;
+    return 0;
   }
 
   std::set<CcdPhysicsController *>::iterator it;
 
-  while (other->m_controllers.begin() != other->m_controllers.end()) {
+  for (unsigned int i = 0; i < maxControllers && !other->m_controllers.empty(); ++i) {
     it = other->m_controllers.begin();
     CcdPhysicsController *ctrl = (*it);
 
     other->RemoveCcdPhysicsController(ctrl, true);
+    other->m_stagedControllers.push_back(ctrl);
+  }
+
+  return other->m_controllers.size();
+}
+
+unsigned int CcdPhysicsEnvironment::AddStagedControllers(PHY_IPhysicsEnvironment *other_env,
+                                                         unsigned int maxControllers)
+{
+  CcdPhysicsEnvironment *other = static_cast<CcdPhysicsEnvironment *>(other_env);
+  if (other == nullptr) {
+    CM_Error("other scene is not using Bullet physics, not merging physics.");
+    return 0;
+  }
+
+  for (unsigned int i = 0; i < maxControllers && !other->m_stagedControllers.empty(); ++i) {
+    CcdPhysicsController *ctrl = other->m_stagedControllers.back();
+    other->m_stagedControllers.pop_back();
+
+    // The controller is in no environment, only its environment pointer is changed.
+    ctrl->SetPhysicsEnvironment(this);
     this->AddCcdPhysicsController(ctrl);
+
+    btCollisionObject *obj = ctrl->GetCollisionObject();
+    m_mergedControllers.push_back({ctrl, obj->getCollisionFlags(), obj->getActivationState()});
+
+    /* Until the other controllers and the constraints are added the controller isn't simulated
+     * and its proxy without filter pairs with nothing, including rays and sensors. */
+    obj->setCollisionFlags(obj->getCollisionFlags() | btCollisionObject::CF_NO_CONTACT_RESPONSE);
+    obj->forceActivationState(DISABLE_SIMULATION);
+    btBroadphaseProxy *handle = obj->getBroadphaseHandle();
+    if (handle) {
+      handle->m_collisionFilterGroup = 0;
+      handle->m_collisionFilterMask = 0;
+      // Remove the pairs found when the proxy was created.
+      m_dynamicsWorld->refreshBroadphaseProxy(obj);
+    }
+    if (ctrl->GetCharacterController()) {
+      m_dynamicsWorld->removeAction(ctrl->GetCharacterController());
+    }
   }
+
+  return other->m_stagedControllers.size();
+}
+
+unsigned int CcdPhysicsEnvironment::EnableMergedCollisions(unsigned int maxControllers)
+{
+  for (unsigned int i = 0;
+       i < maxControllers && m_numMergedCollisions < m_mergedControllers.size();
+       ++i, ++m_numMergedCollisions)
+  {
+    CcdPhysicsController *ctrl = m_mergedControllers[m_numMergedCollisions].m_controller;
+    btCollisionObject *obj = ctrl->GetCollisionObject();
+    btBroadphaseProxy *handle = obj->getBroadphaseHandle();
+    if (handle) {
+      handle->m_collisionFilterGroup = ctrl->GetCollisionFilterGroup();
+      handle->m_collisionFilterMask = ctrl->GetCollisionFilterMask();
+      // Recreate the proxy to find its pairs with the new filter.
+      m_dynamicsWorld->refreshBroadphaseProxy(obj);
+    }
+  }
+
+  return m_mergedControllers.size() - m_numMergedCollisions;
+}
+
+void CcdPhysicsEnvironment::ActivateMergedControllers()
+{
+  EnableMergedCollisions(m_mergedControllers.size());
+
+  for (const MergedController &merged : m_mergedControllers) {
+    CcdPhysicsController *ctrl = merged.m_controller;
+    btCollisionObject *obj = ctrl->GetCollisionObject();
+    obj->setCollisionFlags(merged.m_collisionFlags);
+    obj->forceActivationState(merged.m_activationState);
+    // Set the object to be active so it can at least by evaluated once.
+    obj->setActivationState(ACTIVE_TAG);
+
+    if (ctrl->GetCharacterController()) {
+      m_dynamicsWorld->addAction(ctrl->GetCharacterController());
+    }
+  }
+
+  m_mergedControllers.clear();
+  m_numMergedCollisions = 0;
 }
 
 CcdPhysicsEnvironment::~CcdPhysicsEnvironment()
@@ -2077,8 +2586,14 @@ void CcdPhysicsEnvironment::CallbackTriggers()
   // Walk over all overlapping pairs, and if one of the involved bodies is registered for trigger
   // callback, perform callback
   btDispatcher *dispatcher = m_dynamicsWorld->getDispatcher();
-  for (unsigned int i = 0, numManifolds = dispatcher->getNumManifolds(); i < numManifolds; i++) {
-    bool colliding_ctrl0 = true;
+  const unsigned int numManifolds = dispatcher->getNumManifolds();
+
+  /* The collision data of the previous step were consumed by the logic, reserving the maximum
+   * size keeps the pointers given to the callbacks valid while the vector is filled. */
+  m_collData.clear();
+  m_collData.reserve(numManifolds);
+
+  for (unsigned int i = 0; i < numManifolds; i++) {
     btPersistentManifold *manifold = dispatcher->getManifoldByIndexInternal(i);
     if (manifold->getNumContacts() == 0) {
       continue;
@@ -2103,8 +2618,12 @@ void CcdPhysicsEnvironment::CallbackTriggers()
       continue;
     }
 
-    const CcdCollData *coll_data = new CcdCollData(manifold);
-    m_triggerCallbacks[PHY_OBJECT_RESPONSE](m_triggerCallbacksUserPtrs[PHY_OBJECT_RESPONSE], ctrl0, ctrl1, coll_data, first);
+    m_collData.emplace_back(manifold);
+    m_triggerCallbacks[PHY_OBJECT_RESPONSE](m_triggerCallbacksUserPtrs[PHY_OBJECT_RESPONSE],
+                                            ctrl0,
+                                            ctrl1,
+                                            &m_collData.back(),
+                                            first);
   }
 }
 
@@ -2740,8 +3259,21 @@ CcdPhysicsEnvironment *CcdPhysicsEnvironment::Create(Scene *blenderscene, bool v
       PHY_SOLVER_SEQUENTIAL,  // GAME_SOLVER_SEQUENTIAL
       PHY_SOLVER_NNCG,        // GAME_SOLVER_NNGC
   };
+  /* The multithreaded world only solves rigid bodies in parallel,
+   * scenes using soft bodies keep the single threaded world. */
+  int numThreads = blenderscene->gm.physicsThreads;
+  if (numThreads > 1) {
+    FOREACH_SCENE_OBJECT_BEGIN (blenderscene, ob) {
+      if (ob->gameflag & OB_SOFT_BODY) {
+        numThreads = 1;
+        break;
+      }
+    }
+    FOREACH_SCENE_OBJECT_END;
+  }
+
   CcdPhysicsEnvironment *ccdPhysEnv = new CcdPhysicsEnvironment(
-      solverTypeTable[blenderscene->gm.solverType], false);
+      solverTypeTable[blenderscene->gm.solverType], false, numThreads);
   ccdPhysEnv->SetDebugDrawer(new BlenderDebugDraw());
   ccdPhysEnv->SetDeactivationLinearTreshold(blenderscene->gm.lineardeactthreshold);
   ccdPhysEnv->SetDeactivationAngularTreshold(blenderscene->gm.angulardeactthreshold);
@@ -3023,8 +3555,18 @@ void CcdPhysicsEnvironment::ConvertObject(BL_SceneConverter *converter,
       break;
     }
     case OB_BOUND_CONVEX_HULL: {
-      shapeInfo->SetMesh(kxscene, meshobj, true);
-      bm = shapeInfo->CreateBulletShape(ci.m_margin);
+      // The hull of a mesh is computed once and shared by all the objects using it.
+      CcdShapeConstructionInfo *sharedShapeInfo = CcdShapeConstructionInfo::FindMesh(meshobj,
+                                                                                     true);
+      if (sharedShapeInfo != nullptr) {
+        shapeInfo->Release();
+        shapeInfo = sharedShapeInfo;
+        shapeInfo->AddRef();
+      }
+      else {
+        shapeInfo->SetMesh(kxscene, meshobj, true);
+      }
+      bm = shapeInfo->CreateBulletShape(ci.m_margin, false, !isbulletsoftbody);
       break;
     }
     case OB_BOUND_CAPSULE: {
@@ -3058,7 +3600,10 @@ void CcdPhysicsEnvironment::ConvertObject(BL_SceneConverter *converter,
         shapeInfo->setVertexWeldingThreshold1(0.0f);  // todo: expose this to the UI
       }
 
-      bm = shapeInfo->CreateBulletShape(ci.m_margin, useGimpact, !isbulletsoftbody);
+      bm = shapeInfo->CreateBulletShape(ci.m_margin,
+                                        useGimpact,
+                                        !isbulletsoftbody,
+                                        ToBullet(gameobj->NodeGetWorldScaling()));
       // should we compute inertia for dynamic shape?
       // bm->calculateLocalInertia(ci.m_mass,ci.m_localInertiaTensor);
 
@@ -3108,7 +3653,7 @@ void CcdPhysicsEnvironment::ConvertObject(BL_SceneConverter *converter,
       MT_Matrix3x3 relativeRot = parentInvRot * gameNode->GetWorldOrientation();
 
       shapeInfo->m_childScale = ToBullet(relativeScale);
-      bm->setLocalScaling(shapeInfo->m_childScale);
+      bm = CcdShapeConstructionInfo::SetShapeScaling(bm, shapeInfo->m_childScale);
       shapeInfo->m_childTrans.setOrigin(ToBullet(relativePos));
       shapeInfo->m_childTrans.setBasis(ToBullet(relativeRot));
 
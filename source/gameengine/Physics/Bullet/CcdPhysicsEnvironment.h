@@ -49,6 +49,7 @@ class PHY_IVehicle;
 class CcdGraphicController;
 class CcdOverlapFilterCallBack;
 class CcdShapeConstructionInfo;
+class CcdCollData;
 
 /** CcdPhysicsEnvironment is an experimental mainloop for physics simulation using optional
  * continuous collision detection. Physics Environment takes care of stepping the simulation and is
@@ -87,15 +88,21 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
 
   PHY_SolverType m_solverType;
 
+  /// Number of threads used to solve the simulation islands, 1 for the single threaded world.
+  int m_numThreads;
+
   float m_deactivationTime;
   float m_linearDeactivationThreshold;
   float m_angularDeactivationThreshold;
   float m_contactBreakingThreshold;
 
+  /// Trace time of the beginning of the current simulation substep.
+  double m_subStepTraceBegin;
+
   void ProcessFhSprings(double curTime, float timeStep);
 
  public:
-  CcdPhysicsEnvironment(PHY_SolverType solverType, bool useDbvtCulling);
+  CcdPhysicsEnvironment(PHY_SolverType solverType, bool useDbvtCulling, int numThreads = 1);
 
   virtual ~CcdPhysicsEnvironment();
 
@@ -134,6 +141,9 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
 
   virtual void UpdateSoftBodies();
 
+  virtual bool CanProceedConcurrently(PHY_IPhysicsEnvironment *other) const;
+  virtual void ApplyGlobalSettings();
+
   /**
    * Called by Bullet for every physical simulation (sub)tick.
    * Our constructor registers this callback to Bullet, which stores a pointer to 'this' in
@@ -141,6 +151,8 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
    */
   static void StaticSimulationSubtickCallback(btDynamicsWorld *world, btScalar timeStep);
   void SimulationSubtickCallback(btScalar timeStep);
+  /// Called by Bullet before every simulation (sub)tick.
+  static void StaticSimulationPreSubtickCallback(btDynamicsWorld *world, btScalar timeStep);
 
   virtual void DebugDrawWorld();
   //		virtual bool		proceedDeltaTimeOneStep(float timeStep);
@@ -200,6 +212,11 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
                                           float toX,
                                           float toY,
                                           float toZ);
+  virtual void RayTestBatch(PHY_IRayCastFilterCallback *const *filterCallbacks,
+                            const float *from,
+                            const float *to,
+                            unsigned int numRays,
+                            PHY_RayCastResult *results);
   virtual bool CullingTest(PHY_CullingCallback callback,
                            void *userData,
                            const std::array<MT_Vector4, 6> &planes,
@@ -279,7 +296,12 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
 
   class btConstraintSolver *GetConstraintSolver();
 
-  void MergeEnvironment(PHY_IPhysicsEnvironment *other_env);
+  unsigned int StageMergeEnvironment(PHY_IPhysicsEnvironment *other_env,
+                                     unsigned int maxControllers);
+  unsigned int AddStagedControllers(PHY_IPhysicsEnvironment *other_env,
+                                    unsigned int maxControllers);
+  unsigned int EnableMergedCollisions(unsigned int maxControllers);
+  void ActivateMergedControllers();
 
   static CcdPhysicsEnvironment *Create(struct Scene *blenderscene, bool visualizePhysics);
 
@@ -301,12 +323,28 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
 
  protected:
   std::set<CcdPhysicsController *> m_controllers;
+  /// Controllers removed by StageMergeEnvironment and waiting for AddStagedControllers.
+  std::vector<CcdPhysicsController *> m_stagedControllers;
+
+  /// Controller added by AddStagedControllers with the state restored on activation.
+  struct MergedController {
+    CcdPhysicsController *m_controller;
+    int m_collisionFlags;
+    int m_activationState;
+  };
+  std::vector<MergedController> m_mergedControllers;
+  /// Number of merged controllers with collisions enabled by EnableMergedCollisions.
+  unsigned int m_numMergedCollisions;
 
   PHY_ResponseCallback m_triggerCallbacks[PHY_NUM_RESPONSE];
   void *m_triggerCallbacksUserPtrs[PHY_NUM_RESPONSE];
 
   std::vector<WrapperVehicle *> m_wrapperVehicles;
 
+  /** Collision data of the manifolds passed to the trigger callbacks, reused every step. The
+   * pointers stay valid until the next call of CallbackTriggers. */
+  std::vector<CcdCollData> m_collData;
+
   /** use explicit btSoftRigidDynamicsWorld/btDiscreteDynamicsWorld* so that we have access to
    * btDiscreteDynamicsWorld::addRigidBody(body,filter,group)
    * so that we can set the body collision filter/group at the time of creation
@@ -0,0 +1,275 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file CcdShapeCache.cpp
+ *  \ingroup physbullet
+ */
+
+#include "CcdShapeCache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "BKE_appdir.h"
+#include "BLI_fileops.h"
+#include "BLI_fileops_types.h"
+#include "BLI_hash_md5.h"
+#include "BLI_path_util.h"
+#include "BulletCollision/CollisionShapes/btOptimizedBvh.h"
+
+#include "CM_Message.h"
+
+/// Increase when the layout of the cache entries changes.
+static const unsigned int CACHE_VERSION = 1;
+/// Meshes with less triangles are faster to build than to load.
+static const size_t CACHE_MIN_TRIANGLES = 4096;
+/// Size in bytes of the cache directory above which the least recently used entries are removed.
+static const unsigned long long CACHE_MAX_SIZE = 256ull * 1024ull * 1024ull;
+
+/// Header of a cache entry, followed by the serialized BVH.
+struct CcdShapeCacheHeader {
+  char magic[4];
+  unsigned int version;
+  unsigned int dataSize;
+};
+
+/// Settings and platform details changing the serialized BVH, part of the key.
+struct CcdShapeCacheSettings {
+  unsigned int version;
+  unsigned int bulletVersion;
+  unsigned int scalarSize;
+  unsigned int bvhSize;
+  unsigned int nodeSize;
+  float weldingThreshold;
+  unsigned long long verticesSize;
+  unsigned long long indicesSize;
+  unsigned char verticesHash[16];
+  unsigned char indicesHash[16];
+};
+
+static const char cacheMagic[4] = {'B', 'G', 'E', 'B'};
+
+/// Return the cache directory, created on first use, empty if unavailable.
+static const std::string &get_cache_directory()
+{
+  static const std::string directory = []() {
+    char path[FILE_MAX];
+    if (!BKE_appdir_folder_caches(path, sizeof(path))) {
+      return std::string();
+    }
+    BLI_path_append(path, sizeof(path), "bge_shapes");
+    if (!BLI_dir_create_recursive(path)) {
+      CM_Warning("unable to create the physics shape cache directory: " << path);
+      return std::string();
+    }
+    return std::string(path);
+  }();
+
+  return directory;
+}
+
+/// Load the BVH of a cache entry, an invalid entry is removed to be stored again.
+static btOptimizedBvh *load_bvh(const std::string &path)
+{
+  FILE *file = BLI_fopen(path.c_str(), "rb");
+  if (!file) {
+    return nullptr;
+  }
+
+  const size_t fileSize = BLI_file_size(path.c_str());
+
+  CcdShapeCacheHeader header;
+  void *buffer = nullptr;
+  // Never trust the data size of the header for the allocation, it must match the file size.
+  if (fileSize != (size_t)-1 && fread(&header, sizeof(header), 1, file) == 1 &&
+      memcmp(header.magic, cacheMagic, sizeof(cacheMagic)) == 0 &&
+      header.version == CACHE_VERSION && header.dataSize == fileSize - sizeof(header))
+  {
+    buffer = btAlignedAlloc(header.dataSize, 16);
+    if (fread(buffer, 1, header.dataSize, file) != header.dataSize) {
+      btAlignedFree(buffer);
+      buffer = nullptr;
+    }
+  }
+  fclose(file);
+
+  btOptimizedBvh *bvh = nullptr;
+  if (buffer) {
+    // The BVH is constructed at the beginning of the buffer and references the rest of it.
+    bvh = btOptimizedBvh::deSerializeInPlace(buffer, header.dataSize, false);
+    if (!bvh) {
+      btAlignedFree(buffer);
+    }
+  }
+
+  if (bvh) {
+    // Mark the entry as recently used for prune_cache.
+    BLI_file_touch(path.c_str());
+  }
+  else {
+    CM_Warning("invalid physics shape cache entry removed: " << path);
+    BLI_delete(path.c_str(), false, false);
+  }
+
+  return bvh;
+}
+
+/// Remove the least recently used entries until the cache is under its size limit.
+static void prune_cache(const std::string &directory)
+{
+  struct direntry *entries;
+  const unsigned int numEntries = BLI_filelist_dir_contents(directory.c_str(), &entries);
+
+  std::vector<const struct direntry *> cacheEntries;
+  unsigned long long totalSize = 0;
+  for (unsigned int i = 0; i < numEntries; ++i) {
+    const struct direntry &entry = entries[i];
+    if (S_ISREG(entry.type) && BLI_path_extension_check(entry.relname, ".bvh")) {
+      cacheEntries.push_back(&entry);
+      totalSize += entry.s.st_size;
+    }
+  }
+
+  if (totalSize > CACHE_MAX_SIZE) {
+    std::sort(cacheEntries.begin(),
+              cacheEntries.end(),
+              [](const struct direntry *entry1, const struct direntry *entry2) {
+                return entry1->s.st_mtime < entry2->s.st_mtime;
+              });
+
+    for (const struct direntry *entry : cacheEntries) {
+      if (totalSize <= CACHE_MAX_SIZE) {
+        break;
+      }
+      // An entry used by another player may fail to be removed, it is then kept.
+      if (BLI_delete(entry->path, false, false) == 0) {
+        totalSize -= entry->s.st_size;
+      }
+    }
+  }
+
+  BLI_filelist_free(entries, numEntries);
+}
+
+static void store_bvh(const std::string &path, const btOptimizedBvh *bvh)
+{
+  CcdShapeCacheHeader header;
+  memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+  header.version = CACHE_VERSION;
+  header.dataSize = bvh->calculateSerializeBufferSize();
+
+  void *buffer = btAlignedAlloc(header.dataSize, 16);
+  if (bvh->serializeInPlace(buffer, header.dataSize, false)) {
+    // Other threads or players may store the same entry, each one uses its own temporary file.
+    const size_t unique = std::hash<std::thread::id>()(std::this_thread::get_id()) ^
+                          std::chrono::steady_clock::now().time_since_epoch().count();
+    const std::string tmpPath = path + "." + std::to_string(unique) + ".tmp";
+
+    FILE *file = BLI_fopen(tmpPath.c_str(), "wb");
+    if (file) {
+      bool written = (fwrite(&header, sizeof(header), 1, file) == 1 &&
+                      fwrite(buffer, 1, header.dataSize, file) == header.dataSize);
+      written = (fclose(file) == 0) && written;
+      if (!written || BLI_rename_overwrite(tmpPath.c_str(), path.c_str()) != 0) {
+        BLI_delete(tmpPath.c_str(), false, false);
+      }
+    }
+  }
+  btAlignedFree(buffer);
+}
+
+std::string CcdShapeCache::GetKey(const void *vertices,
+                                  size_t verticesSize,
+                                  const void *indices,
+                                  size_t indicesSize,
+                                  float weldingThreshold)
+{
+  if (indicesSize / (3 * sizeof(int)) < CACHE_MIN_TRIANGLES) {
+    return "";
+  }
+
+  CcdShapeCacheSettings settings;
+  memset(&settings, 0, sizeof(settings));
+  settings.version = CACHE_VERSION;
+  settings.bulletVersion = BT_BULLET_VERSION;
+  settings.scalarSize = sizeof(btScalar);
+  settings.bvhSize = sizeof(btOptimizedBvh);
+  settings.nodeSize = sizeof(btQuantizedBvhNode);
+  settings.weldingThreshold = weldingThreshold;
+  settings.verticesSize = verticesSize;
+  settings.indicesSize = indicesSize;
+  BLI_hash_md5_buffer((const char *)vertices, verticesSize, settings.verticesHash);
+  BLI_hash_md5_buffer((const char *)indices, indicesSize, settings.indicesHash);
+
+  unsigned char hash[16];
+  BLI_hash_md5_buffer((const char *)&settings, sizeof(settings), hash);
+
+  char key[33];
+  return BLI_hash_md5_to_hexdigest(hash, key);
+}
+
+btOptimizedBvh *CcdShapeCache::GetOptimizedBvh(const std::string &key,
+                                               btStridingMeshInterface *meshInterface,
+                                               const btVector3 &aabbMin,
+                                               const btVector3 &aabbMax)
+{
+  std::string path;
+  if (!key.empty()) {
+    const std::string &directory = get_cache_directory();
+    if (!directory.empty()) {
+      char filepath[FILE_MAX];
+      BLI_path_join(filepath, sizeof(filepath), directory.c_str(), (key + ".bvh").c_str());
+      path = filepath;
+    }
+  }
+
+  if (!path.empty()) {
+    btOptimizedBvh *bvh = load_bvh(path);
+    if (bvh) {
+      return bvh;
+    }
+  }
+
+  // Same allocation as btBvhTriangleMeshShape::buildOptimizedBvh.
+  void *mem = btAlignedAlloc(sizeof(btOptimizedBvh), 16);
+  btOptimizedBvh *bvh = new (mem) btOptimizedBvh();
+  bvh->build(meshInterface, true, aabbMin, aabbMax);
+
+  if (!path.empty()) {
+    store_bvh(path, bvh);
+    prune_cache(get_cache_directory());
+  }
+
+  return bvh;
+}
+
+void CcdShapeCache::FreeOptimizedBvh(btOptimizedBvh *bvh)
+{
+  // Loaded BVH are stored at the beginning of their aligned buffer, built ones in their own
+  // aligned allocation, both are freed the same way.
+  bvh->~btOptimizedBvh();
+  btAlignedFree(bvh);
+}
@@ -0,0 +1,70 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file CcdShapeCache.h
+ *  \ingroup physbullet
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+class btOptimizedBvh;
+class btStridingMeshInterface;
+class btVector3;
+
+/** A persistent cache of the BVH of triangle mesh shapes, stored in the user cache directory
+ * and reused across runs. The entries are keyed on a hash of the mesh data and the settings
+ * used to build the BVH. Loading doesn't lock, entries are written in a temporary file renamed
+ * once complete. The least recently used entries are removed when the cache grows over 256 MiB.
+ */
+class CcdShapeCache {
+ public:
+  /** Compute the key of a triangle mesh BVH.
+   * \param vertices The vertex data of the mesh.
+   * \param verticesSize The size of the vertex data in bytes.
+   * \param indices The triangle indices of the mesh.
+   * \param indicesSize The size of the triangle indices in bytes.
+   * \param weldingThreshold The vertex welding threshold applied to the mesh.
+   * \return An empty key when the mesh is too small to be worth caching.
+   */
+  static std::string GetKey(const void *vertices,
+                            size_t verticesSize,
+                            const void *indices,
+                            size_t indicesSize,
+                            float weldingThreshold);
+
+  /** Return the BVH stored for a key, or build it and store it when missing.
+   * \param key The key of the mesh, if empty the BVH is always built.
+   * \param meshInterface The triangle mesh to build the BVH from.
+   * \param aabbMin, aabbMax The bounds used to quantize the BVH.
+   * \return A BVH to free with FreeOptimizedBvh.
+   */
+  static btOptimizedBvh *GetOptimizedBvh(const std::string &key,
+                                         btStridingMeshInterface *meshInterface,
+                                         const btVector3 &aabbMin,
+                                         const btVector3 &aabbMax);
+
+  /// Free a BVH returned by GetOptimizedBvh.
+  static void FreeOptimizedBvh(btOptimizedBvh *bvh);
+};
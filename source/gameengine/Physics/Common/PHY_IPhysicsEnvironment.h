@@ -124,6 +124,18 @@ class PHY_IPhysicsEnvironment {
 
   virtual void UpdateSoftBodies() = 0;
 
+  /// Return true if this environment can be stepped in a thread while 'other' is stepped in
+  /// another thread.
+  virtual bool CanProceedConcurrently(PHY_IPhysicsEnvironment *other) const
+  {
+    return true;
+  }
+  /// Apply the settings shared by all the environments of the physics engine, it is called
+  /// from the main thread before stepping this environment concurrently to others.
+  virtual void ApplyGlobalSettings()
+  {
+  }
+
   /// draw debug lines (make sure to call this during the render phase, otherwise lines are not
   /// drawn properly)
   virtual void DebugDrawWorld()
@@ -240,6 +252,16 @@ class PHY_IPhysicsEnvironment {
                                           float toX,
                                           float toY,
                                           float toZ) = 0;
+  /** Test a batch of rays, possibly on several threads. The ray coordinates are stored by three
+   * floats in from and to and each ray is filtered by its own callback, only called from the
+   * calling thread. The closest hit of each ray is written in results, with a nullptr controller
+   * if nothing was hit, reportHit of the callbacks is not called.
+   */
+  virtual void RayTestBatch(PHY_IRayCastFilterCallback *const *filterCallbacks,
+                            const float *from,
+                            const float *to,
+                            unsigned int numRays,
+                            PHY_RayCastResult *results) = 0;
 
   // culling based on physical broad phase
   // the plane number must be set as follow: near, far, left, right, top, botton
@@ -269,7 +291,26 @@ class PHY_IPhysicsEnvironment {
 
   virtual void ExportFile(const std::string &filename){};
 
-  virtual void MergeEnvironment(PHY_IPhysicsEnvironment *other_env) = 0;
+  /** Remove at most maxControllers physics controllers from other_env and keep them staged for
+   * AddStagedControllers, the staged controllers are simulated in none of the environments.
+   * \return The number of controllers left to stage in other_env.
+   */
+  virtual unsigned int StageMergeEnvironment(PHY_IPhysicsEnvironment *other_env,
+                                             unsigned int maxControllers) = 0;
+  /** Add at most maxControllers controllers staged from other_env into this environment, they
+   * are not simulated and collide with nothing until EnableMergedCollisions and
+   * ActivateMergedControllers.
+   * \return The number of staged controllers left in other_env.
+   */
+  virtual unsigned int AddStagedControllers(PHY_IPhysicsEnvironment *other_env,
+                                            unsigned int maxControllers) = 0;
+  /** Let at most maxControllers added controllers detect collisions, still without contact
+   * response and simulation.
+   * \return The number of added controllers left without collisions.
+   */
+  virtual unsigned int EnableMergedCollisions(unsigned int maxControllers) = 0;
+  /// Simulate all the merged controllers at once, so they start with their constraints.
+  virtual void ActivateMergedControllers() = 0;
 
   virtual void ConvertObject(BL_SceneConverter *converter,
                              KX_GameObject *gameobj,
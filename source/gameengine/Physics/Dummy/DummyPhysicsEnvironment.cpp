@@ -31,6 +31,8 @@
 
 #include "DummyPhysicsEnvironment.h"
 
+#include <algorithm>
+
 DummyPhysicsEnvironment::DummyPhysicsEnvironment()
 {
   // create physicsengine data
@@ -122,3 +124,12 @@ PHY_IPhysicsController *DummyPhysicsEnvironment::RayTest(
   // collision detection / raytesting
   return nullptr;
 }
+
+void DummyPhysicsEnvironment::RayTestBatch(PHY_IRayCastFilterCallback *const *filterCallbacks,
+                                           const float *from,
+                                           const float *to,
+                                           unsigned int numRays,
+                                           PHY_RayCastResult *results)
+{
+  std::fill(results, results + numRays, PHY_RayCastResult());
+}
@@ -98,6 +98,11 @@ class DummyPhysicsEnvironment : public PHY_IPhysicsEnvironment {
                                           float toX,
                                           float toY,
                                           float toZ);
+  virtual void RayTestBatch(PHY_IRayCastFilterCallback *const *filterCallbacks,
+                            const float *from,
+                            const float *to,
+                            unsigned int numRays,
+                            PHY_RayCastResult *results);
   virtual bool CullingTest(PHY_CullingCallback callback,
                            void *userData,
                            const std::array<MT_Vector4, 6> &planes,
@@ -140,7 +145,27 @@ class DummyPhysicsEnvironment : public PHY_IPhysicsEnvironment {
     return nullptr;
   }
 
-  virtual void MergeEnvironment(PHY_IPhysicsEnvironment *other_env)
+  virtual unsigned int StageMergeEnvironment(PHY_IPhysicsEnvironment *other_env,
+                                             unsigned int maxControllers)
+  {
+    // Dummy, nothing to do here
+    return 0;
+  }
+
+  virtual unsigned int AddStagedControllers(PHY_IPhysicsEnvironment *other_env,
+                                            unsigned int maxControllers)
+  {
+    // Dummy, nothing to do here
+    return 0;
+  }
+
+  virtual unsigned int EnableMergedCollisions(unsigned int maxControllers)
+  {
+    // Dummy, nothing to do here
+    return 0;
+  }
+
+  virtual void ActivateMergedControllers()
   {
     // Dummy, nothing to do here
   }
@@ -112,6 +112,9 @@ template<class Vertex> class RAS_DisplayArray : public virtual RAS_IDisplayArray
 
   virtual void AddVertex(RAS_IVertex *vert)
   {
+    if (m_storageExport) {
+      InvalidateStorageExport();
+    }
     m_vertexes.push_back(*((Vertex *)vert));
   }
 
@@ -129,6 +132,12 @@ template<class Vertex> class RAS_DisplayArray : public virtual RAS_IDisplayArray
     return new Vertex(xyz, uvs, tangent, rgba, normal);
   }
 
+  virtual void ResizeVertices(unsigned int count)
+  {
+    InvalidateStorageExport();
+    m_vertexes.resize(count);
+  }
+
   virtual void UpdateCache()
   {
     const unsigned int size = GetVertexCount();
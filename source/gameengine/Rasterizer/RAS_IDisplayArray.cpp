@@ -26,16 +26,26 @@
 
 #include "RAS_DisplayArray.h"
 
+#include <cstring>
+
+#include "CM_Message.h"
+
 #include <epoxy/gl.h>
 
 RAS_IDisplayArray::RAS_IDisplayArray(PrimitiveType type, const RAS_VertexFormat &format)
-    : m_type(type), m_modifiedFlag(NONE_MODIFIED), m_format(format)
+    : m_type(type),
+      m_modifiedFlag(NONE_MODIFIED),
+      m_modifiedBegin(0),
+      m_modifiedEnd(0),
+      m_format(format)
 {
 }
 
 RAS_IDisplayArray::RAS_IDisplayArray(const RAS_IDisplayArray &other)
     : m_type(other.m_type),
       m_modifiedFlag(other.m_modifiedFlag),
+      m_modifiedBegin(other.m_modifiedBegin),
+      m_modifiedEnd(other.m_modifiedEnd),
       m_format(other.m_format),
       m_vertexInfos(other.m_vertexInfos),
       m_indices(other.m_indices)
@@ -44,6 +54,29 @@ RAS_IDisplayArray::RAS_IDisplayArray(const RAS_IDisplayArray &other)
 
 RAS_IDisplayArray::~RAS_IDisplayArray()
 {
+  InvalidateStorageExport();
+}
+
+void RAS_IDisplayArray::InvalidateStorageExport()
+{
+  if (!m_storageExport) {
+    return;
+  }
+
+  if (m_storageExport->exports > 0) {
+    CM_Warning("display array storage freed or reallocated while exported to python, "
+               "the exported buffers must be released before");
+  }
+  m_storageExport->valid = false;
+  m_storageExport.reset();
+}
+
+const std::shared_ptr<RAS_IDisplayArray::StorageExport> &RAS_IDisplayArray::GetStorageExport()
+{
+  if (!m_storageExport) {
+    m_storageExport.reset(new StorageExport{true, 0});
+  }
+  return m_storageExport;
 }
 
 #define NEW_DISPLAY_ARRAY_UV(vertformat, uv, color, primtype) \
@@ -98,32 +131,41 @@ int RAS_IDisplayArray::GetOpenGLPrimitiveType() const
 
 void RAS_IDisplayArray::UpdateFrom(RAS_IDisplayArray *other, int flag)
 {
+  unsigned int begin;
+  unsigned int end;
+  other->GetModifiedRange(begin, end);
+  end = min_ii(end, other->GetVertexCount());
+  if (begin >= end) {
+    begin = 0;
+    end = other->GetVertexCount();
+  }
+
   if (flag & TANGENT_MODIFIED) {
-    for (unsigned int i = 0, size = other->GetVertexCount(); i < size; ++i) {
+    for (unsigned int i = begin; i < end; ++i) {
       GetVertex(i)->SetTangent(MT_Vector4(other->GetVertex(i)->getTangent()));
     }
   }
   if (flag & UVS_MODIFIED) {
     const unsigned short uvSize = min_ii(GetVertexUvSize(), other->GetVertexUvSize());
-    for (unsigned int i = 0, size = other->GetVertexCount(); i < size; ++i) {
+    for (unsigned int i = begin; i < end; ++i) {
       for (unsigned int uv = 0; uv < uvSize; ++uv) {
         GetVertex(i)->SetUV(uv, MT_Vector2(other->GetVertex(i)->getUV(uv)));
       }
     }
   }
   if (flag & POSITION_MODIFIED) {
-    for (unsigned int i = 0, size = other->GetVertexCount(); i < size; ++i) {
+    for (unsigned int i = begin; i < end; ++i) {
       GetVertex(i)->SetXYZ(MT_Vector3(other->GetVertex(i)->getXYZ()));
     }
   }
   if (flag & NORMAL_MODIFIED) {
-    for (unsigned int i = 0, size = other->GetVertexCount(); i < size; ++i) {
+    for (unsigned int i = begin; i < end; ++i) {
       GetVertex(i)->SetNormal(MT_Vector3(other->GetVertex(i)->getNormal()));
     }
   }
   if (flag & COLORS_MODIFIED) {
     const unsigned short colorSize = min_ii(GetVertexColorSize(), other->GetVertexColorSize());
-    for (unsigned int i = 0, size = other->GetVertexCount(); i < size; ++i) {
+    for (unsigned int i = begin; i < end; ++i) {
       for (unsigned int color = 0; color < colorSize; ++color) {
         GetVertex(i)->SetRGBA(color, other->GetVertex(i)->getRawRGBA(color));
       }
@@ -141,9 +183,36 @@ void RAS_IDisplayArray::AppendModifiedFlag(unsigned short flag)
   SetModifiedFlag(m_modifiedFlag | flag);
 }
 
+void RAS_IDisplayArray::AppendModifiedRange(unsigned short flag,
+                                            unsigned int begin,
+                                            unsigned int end)
+{
+  if (begin >= end) {
+    return;
+  }
+
+  if (m_modifiedBegin >= m_modifiedEnd) {
+    m_modifiedBegin = begin;
+    m_modifiedEnd = end;
+  }
+  else {
+    m_modifiedBegin = min_ii(m_modifiedBegin, begin);
+    m_modifiedEnd = max_ii(m_modifiedEnd, end);
+  }
+  m_modifiedFlag |= flag;
+}
+
 void RAS_IDisplayArray::SetModifiedFlag(unsigned short flag)
 {
   m_modifiedFlag = flag;
+  m_modifiedBegin = 0;
+  m_modifiedEnd = (flag == NONE_MODIFIED) ? 0 : GetVertexCount();
+}
+
+void RAS_IDisplayArray::GetModifiedRange(unsigned int &begin, unsigned int &end) const
+{
+  begin = m_modifiedBegin;
+  end = m_modifiedEnd;
 }
 
 const RAS_VertexFormat &RAS_IDisplayArray::GetFormat() const
@@ -151,6 +220,45 @@ const RAS_VertexFormat &RAS_IDisplayArray::GetFormat() const
   return m_format;
 }
 
+unsigned int RAS_IDisplayArray::GetVertexDataSize() const
+{
+  // The vertex data follows the virtual table pointer, the tangent is the first member.
+  return GetVertexMemorySize() - GetVertexTangentOffset();
+}
+
+void RAS_IDisplayArray::GetVertexData(char *data) const
+{
+  const unsigned int stride = GetVertexMemorySize();
+  const unsigned int size = GetVertexDataSize();
+  const char *vertex = (const char *)GetVertexPointer() + GetVertexTangentOffset();
+
+  for (unsigned int i = 0, count = GetVertexCount(); i < count; ++i, vertex += stride) {
+    memcpy(data + i * size, vertex, size);
+  }
+}
+
+void RAS_IDisplayArray::SetData(const char *vertexData,
+                                const RAS_VertexInfo *infos,
+                                unsigned int vertexCount,
+                                const unsigned int *indices,
+                                unsigned int indexCount)
+{
+  // Also invalidates the exported indices.
+  ResizeVertices(vertexCount);
+
+  const unsigned int stride = GetVertexMemorySize();
+  const unsigned int size = GetVertexDataSize();
+  if (vertexCount > 0) {
+    char *vertex = (char *)GetVertexNoCache(0) + GetVertexTangentOffset();
+    for (unsigned int i = 0; i < vertexCount; ++i, vertex += stride) {
+      memcpy(vertex, vertexData + i * size, size);
+    }
+  }
+
+  m_vertexInfos.assign(infos, infos + vertexCount);
+  m_indices.assign(indices, indices + indexCount);
+}
+
 RAS_IDisplayArray::Type RAS_IDisplayArray::GetType() const
 {
   return NORMAL;
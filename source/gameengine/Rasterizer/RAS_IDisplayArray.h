@@ -40,11 +40,22 @@ class RAS_IDisplayArray {
 
   enum Type { NORMAL, BATCHING };
 
+  /// State of the vertex and index storage shared with the buffers exported to python.
+  struct StorageExport {
+    /// False once the storage was freed or reallocated, no buffer can be exported anymore.
+    bool valid;
+    /// Number of buffers currently exported.
+    unsigned int exports;
+  };
+
  protected:
   /// The display array primitive type.
   PrimitiveType m_type;
   /// Modification flag.
   unsigned short m_modifiedFlag;
+  /// Range of the modified vertices, empty when m_modifiedBegin >= m_modifiedEnd.
+  unsigned int m_modifiedBegin;
+  unsigned int m_modifiedEnd;
   /// The vertex format used.
   RAS_VertexFormat m_format;
 
@@ -54,9 +65,14 @@ class RAS_IDisplayArray {
   std::vector<RAS_IVertex *> m_vertexPtrs;
   /// The indices used for rendering.
   std::vector<unsigned int> m_indices;
+  /// Export state of the current storage, created on demand.
+  std::shared_ptr<StorageExport> m_storageExport;
 
   RAS_IDisplayArray(const RAS_IDisplayArray &other);
 
+  /// Invalidate the buffers exported on the storage, called before it's freed or reallocated.
+  void InvalidateStorageExport();
+
  public:
   RAS_IDisplayArray(PrimitiveType type, const RAS_VertexFormat &format);
   virtual ~RAS_IDisplayArray();
@@ -112,6 +128,9 @@ class RAS_IDisplayArray {
 
   inline void AddIndex(const unsigned int index)
   {
+    if (m_storageExport) {
+      InvalidateStorageExport();
+    }
     m_indices.push_back(index);
   }
 
@@ -140,7 +159,30 @@ class RAS_IDisplayArray {
                                     const unsigned int *rgba,
                                     const MT_Vector3 &normal) = 0;
 
+  /// Resize the vertex list, the new vertices are uninitialized.
+  virtual void ResizeVertices(unsigned int count) = 0;
+
+  /** Return the export state of the current vertex and index storage, it's invalidated when the
+   * storage is freed or reallocated.
+   */
+  const std::shared_ptr<StorageExport> &GetStorageExport();
+
+  /// Return the size of the vertex data copied by GetVertexData, the virtual table excluded.
+  unsigned int GetVertexDataSize() const;
+  /// Copy the data of all the vertices to a buffer of vertex count * GetVertexDataSize() bytes.
+  void GetVertexData(char *data) const;
+  /** Replace the vertices, their infos and the indices.
+   * \param vertexData The vertex data written by GetVertexData for a display array of the
+   * same vertex type.
+   */
+  void SetData(const char *vertexData,
+               const RAS_VertexInfo *infos,
+               unsigned int vertexCount,
+               const unsigned int *indices,
+               unsigned int indexCount);
+
   /** Copy vertex data from an other display array. Different vertex type is allowed.
+   * Only the modified range of the other display array is copied if it is not empty.
    * \param other The other display array to copy from.
    * \param flag The flag coresponding to datas to copy.
    */
@@ -169,12 +211,22 @@ class RAS_IDisplayArray {
 
   /// Return display array modified flag.
   unsigned short GetModifiedFlag() const;
-  /** Mix display array modified flag with a new flag.
+  /** Mix display array modified flag with a new flag, all the vertices are modified.
    * \param flag The flag to mix.
    */
   void AppendModifiedFlag(unsigned short flag);
-  /// Set the display array modified flag.
+  /** Mix display array modified flag with a new flag for a range of vertices.
+   * \param flag The flag to mix.
+   * \param begin The first modified vertex.
+   * \param end The vertex after the last modified vertex.
+   */
+  void AppendModifiedRange(unsigned short flag, unsigned int begin, unsigned int end);
+  /** Set the display array modified flag, the modified range covers all the vertices
+   * or none of them when the flag is NONE_MODIFIED.
+   */
   void SetModifiedFlag(unsigned short flag);
+  /// Return the range of modified vertices, begin is not less than end when empty.
+  void GetModifiedRange(unsigned int &begin, unsigned int &end) const;
 
   /// Return the vertex format used.
   const RAS_VertexFormat &GetFormat() const;
@@ -184,6 +184,27 @@ RAS_Polygon *RAS_MeshObject::AddPolygon(RAS_MeshMaterial *meshmat,
   return &m_polygons.back();
 }
 
+RAS_Polygon *RAS_MeshObject::AddPolygonNoIndices(RAS_MeshMaterial *meshmat,
+                                                 int numverts,
+                                                 const unsigned int indices[4],
+                                                 bool visible,
+                                                 bool collider,
+                                                 bool twoside)
+{
+  RAS_Polygon poly(meshmat->GetBucket(), meshmat->GetDisplayArray(), numverts);
+
+  poly.SetVisible(visible);
+  poly.SetCollider(collider);
+  poly.SetTwoside(twoside);
+
+  for (unsigned short i = 0; i < numverts; ++i) {
+    poly.SetVertexOffset(i, indices[i]);
+  }
+
+  m_polygons.push_back(poly);
+  return &m_polygons.back();
+}
+
 unsigned int RAS_MeshObject::AddVertex(RAS_MeshMaterial *meshmat,
                                        const MT_Vector3 &xyz,
                                        const MT_Vector2 *const uvs,
@@ -133,6 +133,13 @@ class RAS_MeshObject {
                                   bool visible,
                                   bool collider,
                                   bool twoside);
+  /// Add a polygon whose indices are already in the display array, e.g loaded from a cache.
+  RAS_Polygon *AddPolygonNoIndices(RAS_MeshMaterial *meshmat,
+                                   int numverts,
+                                   const unsigned int indices[4],
+                                   bool visible,
+                                   bool collider,
+                                   bool twoside);
   virtual unsigned int AddVertex(RAS_MeshMaterial *meshmat,
                                  const MT_Vector3 &xyz,
                                  const MT_Vector2 *const uvs,
@@ -11,3 +11,13 @@ CM_ThreadSpinLock &SG_Familly::GetMutex()
 {
   return m_mutex;
 }
+
+SG_Familly::RelationState SG_Familly::GetRelationState() const
+{
+  return m_relationState;
+}
+
+void SG_Familly::SetRelationState(RelationState state)
+{
+  m_relationState = state;
+}
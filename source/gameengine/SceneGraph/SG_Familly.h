@@ -10,12 +10,27 @@
 #include "CM_Thread.h"
 
 class SG_Familly {
+ public:
+  /// Usage of slow or vertex parent relations in the familly, deciding its update threading.
+  enum RelationState {
+    RELATION_UNKNOWN = 0,
+    /// The familly can be updated in parallel of the other famillies.
+    RELATION_PARALLEL,
+    /// The familly uses slow or vertex parents and is updated serially.
+    RELATION_SERIAL
+  };
+
  private:
   CM_ThreadSpinLock m_mutex;
+  RelationState m_relationState = RELATION_UNKNOWN;
 
  public:
   SG_Familly() = default;
   ~SG_Familly() = default;
 
   CM_ThreadSpinLock &GetMutex();
+
+  RelationState GetRelationState() const;
+  /// Set the relation state, reset to unknown when a parent relation or the hierarchy changes.
+  void SetRelationState(RelationState state);
 };
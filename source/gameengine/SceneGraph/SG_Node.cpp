@@ -29,7 +29,8 @@ SG_Node::SG_Node(void *clientobj, void *clientinfo, SG_Callbacks &callbacks)
       m_parent_relation(nullptr),
       m_familly(new SG_Familly()),
       m_modified(true),
-      m_dirty(DIRTY_NONE)
+      m_dirty(DIRTY_NONE),
+      m_updateStamp(0)
 {
 }
 
@@ -48,7 +49,8 @@ SG_Node::SG_Node(const SG_Node &other)
       m_worldScaling(other.m_worldScaling),
       m_parent_relation(other.m_parent_relation->NewCopy()),
       m_familly(new SG_Familly()),
-      m_dirty(DIRTY_NONE)
+      m_dirty(DIRTY_NONE),
+      m_updateStamp(0)
 {
 }
 
@@ -202,6 +204,7 @@ void SG_Node::AddChild(SG_Node *child)
 void SG_Node::RemoveChild(SG_Node *child)
 {
   CM_ListRemoveIfFound(m_children, child);
+  m_familly->SetRelationState(SG_Familly::RELATION_UNKNOWN);
 }
 
 void SG_Node::UpdateWorldData(double time, bool parentUpdated)
@@ -371,8 +374,14 @@ void SG_Node::SetControllerTime(double time)
 
 void SG_Node::ClearModified()
 {
+  const bool renderDirty = (m_dirty & DIRTY_RENDER);
   m_modified = false;
   m_dirty = DIRTY_ALL;
+
+  // Notify only once until the render flag is cleared.
+  if (!renderDirty) {
+    ActivateRenderDirtyCallback();
+  }
 }
 
 void SG_Node::SetModified()
@@ -386,9 +395,18 @@ void SG_Node::ClearDirty(DirtyFlag flag)
   m_dirty &= ~flag;
 }
 
+void SG_Node::SetRenderDirty()
+{
+  if (!(m_dirty & DIRTY_RENDER)) {
+    m_dirty |= DIRTY_RENDER;
+    ActivateRenderDirtyCallback();
+  }
+}
+
 void SG_Node::SetParentRelation(SG_ParentRelation *relation)
 {
   m_parent_relation.reset(relation);
+  m_familly->SetRelationState(SG_Familly::RELATION_UNKNOWN);
   SetModified();
 }
 
@@ -569,12 +587,25 @@ void SG_Node::SetFamilly(const std::shared_ptr<SG_Familly> &familly)
 {
   BLI_assert(familly != nullptr);
 
+  // Both famillies gain or lose nodes.
+  m_familly->SetRelationState(SG_Familly::RELATION_UNKNOWN);
+  familly->SetRelationState(SG_Familly::RELATION_UNKNOWN);
   m_familly = familly;
   for (SG_Node *child : m_children) {
     child->SetFamilly(m_familly);
   }
 }
 
+unsigned int SG_Node::GetUpdateStamp() const
+{
+  return m_updateStamp;
+}
+
+void SG_Node::SetUpdateStamp(unsigned int stamp)
+{
+  m_updateStamp = stamp;
+}
+
 bool SG_Node::IsModified()
 {
   return m_modified;
@@ -641,3 +672,11 @@ void SG_Node::ActivateRecheduleUpdateCallback()
     m_callbacks.m_reschedulefunc(this, m_SGclientObject, m_SGclientInfo);
   }
 }
+
+void SG_Node::ActivateRenderDirtyCallback()
+{
+  if (m_callbacks.m_renderdirtyfunc) {
+    // Call client provided render dirty func.
+    m_callbacks.m_renderdirtyfunc(this, m_SGclientObject, m_SGclientInfo);
+  }
+}
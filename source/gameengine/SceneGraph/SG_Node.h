@@ -26,6 +26,7 @@ typedef void *(*SG_DestructionNewCallback)(SG_Node *sgnode, void *clientobj, voi
 typedef void (*SG_UpdateTransformCallback)(SG_Node *sgnode, void *clientobj, void *clientinfo);
 typedef bool (*SG_ScheduleUpdateCallback)(SG_Node *sgnode, void *clientobj, void *clientinfo);
 typedef bool (*SG_RescheduleUpdateCallback)(SG_Node *sgnode, void *clientobj, void *clientinfo);
+typedef void (*SG_RenderDirtyCallback)(SG_Node *sgnode, void *clientobj, void *clientinfo);
 
 /**
  * SG_Callbacks hold 2 call backs to the outside world.
@@ -48,7 +49,8 @@ struct SG_Callbacks {
         m_destructionfunc(nullptr),
         m_updatefunc(nullptr),
         m_schedulefunc(nullptr),
-        m_reschedulefunc(nullptr)
+        m_reschedulefunc(nullptr),
+        m_renderdirtyfunc(nullptr)
   {
   }
 
@@ -56,12 +58,14 @@ struct SG_Callbacks {
                SG_DestructionNewCallback destructfunc,
                SG_UpdateTransformCallback updatefunc,
                SG_ScheduleUpdateCallback schedulefunc,
-               SG_RescheduleUpdateCallback reschedulefunc)
+               SG_RescheduleUpdateCallback reschedulefunc,
+               SG_RenderDirtyCallback renderdirtyfunc)
       : m_replicafunc(repfunc),
         m_destructionfunc(destructfunc),
         m_updatefunc(updatefunc),
         m_schedulefunc(schedulefunc),
-        m_reschedulefunc(reschedulefunc)
+        m_reschedulefunc(reschedulefunc),
+        m_renderdirtyfunc(renderdirtyfunc)
   {
   }
 
@@ -70,6 +74,8 @@ struct SG_Callbacks {
   SG_UpdateTransformCallback m_updatefunc;
   SG_ScheduleUpdateCallback m_schedulefunc;
   SG_RescheduleUpdateCallback m_reschedulefunc;
+  /// Called when the node world transform changed and wasn't yet tagged for render.
+  SG_RenderDirtyCallback m_renderdirtyfunc;
 };
 
 typedef std::vector<SG_Node *> NodeList;
@@ -267,6 +273,8 @@ class SG_Node : public SG_QList {
   void ClearModified();
   void SetModified();
   void ClearDirty(DirtyFlag flag);
+  /// Tag the node to be rendered again without changing its transform.
+  void SetRenderDirty();
 
   /**
    * Define the relationship this node has with it's parent
@@ -320,6 +328,10 @@ class SG_Node : public SG_QList {
   const std::shared_ptr<SG_Familly> &GetFamilly() const;
   void SetFamilly(const std::shared_ptr<SG_Familly> &familly);
 
+  /// Stamp of the last scene graph update which scheduled this node.
+  unsigned int GetUpdateStamp() const;
+  void SetUpdateStamp(unsigned int stamp);
+
   bool IsModified();
   bool IsDirty(DirtyFlag flag);
 
@@ -335,6 +347,7 @@ class SG_Node : public SG_QList {
   void ActivateUpdateTransformCallback();
   bool ActivateScheduleUpdateCallback();
   void ActivateRecheduleUpdateCallback();
+  void ActivateRenderDirtyCallback();
 
   /**
    * Update the world coordinates of this spatial node. This also informs
@@ -377,4 +390,5 @@ class SG_Node : public SG_QList {
 
   bool m_modified;
   unsigned short m_dirty;
+  unsigned int m_updateStamp;
 };
@@ -54,6 +54,14 @@ class FilterBase {
     return filter(src, x, y, size, pixSize, convertPrevious(src, x, y, size, pixSize));
   }
 
+  /// convert row of pixels to destination buffer
+  template<class SRC>
+  void convertRow(SRC src, short y, short *size, unsigned int pixSize, unsigned int *dst)
+  {
+    convertPreviousRow(src, y, size, pixSize, dst);
+    filterRow(src, y, size, pixSize, dst);
+  }
+
   /// get previous filter
   PyFilter *getPrevious(void)
   {
@@ -98,6 +106,32 @@ class FilterBase {
     return val;
   }
 
+  /// filter row, source byte buffer, destination contains pixels from previous filters
+  virtual void filterRow(
+      unsigned char *src, short y, short *size, unsigned int pixSize, unsigned int *dst)
+  {
+    tFilterRow(src, y, size, pixSize, dst);
+  }
+  /// filter row, source int buffer
+  virtual void filterRow(
+      unsigned int *src, short y, short *size, unsigned int pixSize, unsigned int *dst)
+  {
+    tFilterRow(src, y, size, pixSize, dst);
+  }
+  /// filter row, source float buffer
+  virtual void filterRow(float *src, short y, short *size, unsigned int pixSize, unsigned int *dst)
+  {
+    tFilterRow(src, y, size, pixSize, dst);
+  }
+
+  /// filter row pixel by pixel, used by filters without row implementation
+  template<class SRC>
+  void tFilterRow(SRC src, short y, short *size, unsigned int pixSize, unsigned int *dst)
+  {
+    for (short x = 0; x < size[0]; ++x, src += pixSize)
+      dst[x] = filter(src, x, y, size, pixSize, dst[x]);
+  }
+
   /// get source pixel size
   virtual unsigned int getPixelSize(void)
   {
@@ -114,6 +148,19 @@ class FilterBase {
     // otherwise return converted pixel
     return m_previous->m_filter->convert(src, x, y, size, pixSize);
   }
+
+  /// get converted row from previous filters
+  template<class SRC>
+  void convertPreviousRow(SRC src, short y, short *size, unsigned int pixSize, unsigned int *dst)
+  {
+    // if previous filter doesn't exists, copy source pixels
+    if (m_previous == nullptr)
+      for (short x = 0; x < size[0]; ++x, src += pixSize)
+        dst[x] = *src;
+    // otherwise convert row with previous filters
+    else
+      m_previous->m_filter->convertRow(src, y, size, pixSize, dst);
+  }
 };
 
 // list of python filter types
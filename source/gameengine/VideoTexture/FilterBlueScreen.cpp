@@ -7,6 +7,10 @@
 
 #include "FilterBlueScreen.h"
 
+#include <algorithm>
+
+#include "BLI_simd.h"
+
 // implementation FilterBlueScreen
 
 // constructor
@@ -38,6 +42,45 @@ void FilterBlueScreen::setLimits(unsigned short minLimit, unsigned short maxLimi
   m_limitDist = m_squareLimits[1] - m_squareLimits[0];
 }
 
+// filter row, alpha of 4 pixels is calculated at once
+void FilterBlueScreen::filterPixels(unsigned int *dst, short width)
+{
+  short x = 0;
+#ifdef BLI_HAVE_SSE2
+  // red & blue, green & alpha as 16 bits pairs to square their differences
+  const __m128i maskRB = _mm_set1_epi32(0x00FF00FF);
+  const __m128i maskG = _mm_set1_epi32(0xFF);
+  const __m128i maskRGB = _mm_set1_epi32(0x00FFFFFF);
+  const __m128i colorRB = _mm_set1_epi32(m_color[0] | (m_color[2] << 16));
+  const __m128i colorG = _mm_set1_epi32(m_color[1]);
+  // distances are at most 3 * 255^2, larger limits compare the same as signed values
+  const __m128i limitMin = _mm_set1_epi32(int(std::min(m_squareLimits[0], 1u << 20)));
+  const __m128i limitMax = _mm_set1_epi32(int(std::min(m_squareLimits[1], 1u << 20)));
+  const __m128i opaque = _mm_set1_epi32(0xFF);
+  const __m128d limitDist = _mm_set1_pd(double(m_limitDist));
+  for (; x + 4 <= width; x += 4) {
+    __m128i pix = _mm_loadu_si128((const __m128i *)(dst + x));
+    __m128i difRB = _mm_sub_epi16(_mm_and_si128(pix, maskRB), colorRB);
+    __m128i difG = _mm_sub_epi16(_mm_and_si128(_mm_srli_epi32(pix, 8), maskG), colorG);
+    __m128i dist = _mm_add_epi32(_mm_madd_epi16(difRB, difRB), _mm_madd_epi16(difG, difG));
+    // alpha between limits, the quotient is exact in double precision
+    __m128i scaled = _mm_slli_epi32(_mm_sub_epi32(dist, limitMin), 8);
+    __m128d low = _mm_div_pd(_mm_cvtepi32_pd(scaled), limitDist);
+    __m128d high = _mm_div_pd(_mm_cvtepi32_pd(_mm_unpackhi_epi64(scaled, scaled)), limitDist);
+    __m128i alpha = _mm_unpacklo_epi64(_mm_cvttpd_epi32(low), _mm_cvttpd_epi32(high));
+    // fully opaque from maximal limit, fully transparent up to minimal limit
+    __m128i belowMax = _mm_cmpgt_epi32(limitMax, dist);
+    alpha = _mm_or_si128(_mm_and_si128(belowMax, _mm_and_si128(alpha, maskG)),
+                         _mm_andnot_si128(belowMax, opaque));
+    alpha = _mm_and_si128(_mm_cmpgt_epi32(dist, limitMin), alpha);
+    pix = _mm_or_si128(_mm_and_si128(pix, maskRGB), _mm_slli_epi32(alpha, 24));
+    _mm_storeu_si128((__m128i *)(dst + x), pix);
+  }
+#endif
+  for (; x < width; ++x)
+    dst[x] = tFilter(dst + x, x, 0, nullptr, 1, dst[x]);
+}
+
 // cast Filter pointer to FilterBlueScreen
 inline FilterBlueScreen *getFilter(PyFilter *self)
 {
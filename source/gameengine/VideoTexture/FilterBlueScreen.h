@@ -88,4 +88,20 @@ class FilterBlueScreen : public FilterBase {
   {
     return tFilter(src, x, y, size, pixSize, val);
   }
+
+  /// filter row of pixels converted by previous filters
+  void filterPixels(unsigned int *dst, short width);
+
+  /// virtual row filtering function for byte source
+  virtual void filterRow(
+      unsigned char *src, short y, short *size, unsigned int pixSize, unsigned int *dst)
+  {
+    filterPixels(dst, size[0]);
+  }
+  /// virtual row filtering function for unsigned int source
+  virtual void filterRow(
+      unsigned int *src, short y, short *size, unsigned int pixSize, unsigned int *dst)
+  {
+    filterPixels(dst, size[0]);
+  }
 };
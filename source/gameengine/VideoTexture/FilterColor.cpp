@@ -7,8 +7,34 @@
 
 #include "FilterColor.h"
 
+#include "BLI_simd.h"
+
 // implementation FilterGray
 
+// filter row, gray value of 4 pixels is calculated at once
+void FilterGray::filterPixels(unsigned int *dst, short width)
+{
+  short x = 0;
+#ifdef BLI_HAVE_SSE2
+  // red & blue, green & alpha as 16 bits pairs multiplied by their weights
+  const __m128i maskRB = _mm_set1_epi32(0x00FF00FF);
+  const __m128i weightsRB = _mm_set1_epi32((28 << 16) | 77);
+  const __m128i weightsGA = _mm_set1_epi32(151);
+  const __m128i maskA = _mm_set1_epi32(int(0xFF000000));
+  for (; x + 4 <= width; x += 4) {
+    __m128i pix = _mm_loadu_si128((const __m128i *)(dst + x));
+    __m128i gray = _mm_add_epi32(
+        _mm_madd_epi16(_mm_and_si128(pix, maskRB), weightsRB),
+        _mm_madd_epi16(_mm_and_si128(_mm_srli_epi32(pix, 8), maskRB), weightsGA));
+    gray = _mm_srli_epi32(gray, 8);
+    gray = _mm_or_si128(gray, _mm_or_si128(_mm_slli_epi32(gray, 8), _mm_slli_epi32(gray, 16)));
+    _mm_storeu_si128((__m128i *)(dst + x), _mm_or_si128(gray, _mm_and_si128(pix, maskA)));
+  }
+#endif
+  for (; x < width; ++x)
+    dst[x] = tFilter(dst + x, x, 0, nullptr, 1, dst[x]);
+}
+
 // attributes structure
 static PyGetSetDef filterGrayGetSets[] = {  // attributes from FilterBase class
     {(char *)"previous",
@@ -79,6 +105,46 @@ void FilterColor::setMatrix(ColorMatrix &mat)
       m_matrix[r][c] = mat[r][c];
 }
 
+#ifdef BLI_HAVE_SSE2
+// pack two 16 bits weights to multiply pairs of color components
+static int packWeights(short low, short high)
+{
+  return int(((unsigned int)(unsigned short)high << 16) | (unsigned short)low);
+}
+#endif
+
+// filter row, color of 4 pixels is calculated at once
+void FilterColor::filterPixels(unsigned int *dst, short width)
+{
+  short x = 0;
+#ifdef BLI_HAVE_SSE2
+  // red & blue, green & alpha as 16 bits pairs multiplied by the matrix rows
+  const __m128i maskRB = _mm_set1_epi32(0x00FF00FF);
+  const __m128i maskC = _mm_set1_epi32(0xFF);
+  __m128i weightsRB[4], weightsGA[4], offsets[4];
+  for (int r = 0; r < 4; ++r) {
+    weightsRB[r] = _mm_set1_epi32(packWeights(m_matrix[r][0], m_matrix[r][2]));
+    weightsGA[r] = _mm_set1_epi32(packWeights(m_matrix[r][1], m_matrix[r][3]));
+    offsets[r] = _mm_set1_epi32(m_matrix[r][4]);
+  }
+  for (; x + 4 <= width; x += 4) {
+    __m128i pix = _mm_loadu_si128((const __m128i *)(dst + x));
+    __m128i pixRB = _mm_and_si128(pix, maskRB);
+    __m128i pixGA = _mm_and_si128(_mm_srli_epi32(pix, 8), maskRB);
+    __m128i color = _mm_setzero_si128();
+    for (int r = 0; r < 4; ++r) {
+      __m128i comp = _mm_add_epi32(_mm_madd_epi16(pixRB, weightsRB[r]),
+                                   _mm_madd_epi16(pixGA, weightsGA[r]));
+      comp = _mm_and_si128(_mm_srai_epi32(_mm_add_epi32(comp, offsets[r]), 8), maskC);
+      color = _mm_or_si128(color, _mm_slli_epi32(comp, 8 * r));
+    }
+    _mm_storeu_si128((__m128i *)(dst + x), color);
+  }
+#endif
+  for (; x < width; ++x)
+    dst[x] = tFilter(dst + x, x, 0, nullptr, 1, dst[x]);
+}
+
 // cast Filter pointer to FilterColor
 inline FilterColor *getFilterColor(PyFilter *self)
 {
@@ -213,6 +279,7 @@ FilterLevel::FilterLevel(void)
     levels[r][1] = 0xFF;
     levels[r][2] = 0xFF;
   }
+  updateTable();
 }
 
 // set color levels
@@ -224,6 +291,31 @@ void FilterLevel::setLevels(ColorLevel &lev)
       levels[r][c] = lev[r][c];
     levels[r][2] = lev[r][0] < lev[r][1] ? lev[r][1] - lev[r][0] : 1;
   }
+  updateTable();
+}
+
+// calculate table of levels
+void FilterLevel::updateTable(void)
+{
+  for (int r = 0; r < 4; ++r) {
+    for (unsigned int col = 0; col < 256; ++col) {
+      unsigned int val = 0;
+      VT_C(val, r) = col;
+      m_table[r][col] = calcColor(val, r);
+    }
+  }
+}
+
+// filter row, levels are read from table
+void FilterLevel::filterPixels(unsigned int *dst, short width)
+{
+  unsigned char *dstByte = (unsigned char *)dst;
+  for (short x = 0; x < width; ++x, dstByte += 4) {
+    dstByte[0] = m_table[0][dstByte[0]];
+    dstByte[1] = m_table[1][dstByte[1]];
+    dstByte[2] = m_table[2][dstByte[2]];
+    dstByte[3] = m_table[3][dstByte[3]];
+  }
 }
 
 // cast Filter pointer to FilterLevel
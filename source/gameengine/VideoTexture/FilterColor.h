@@ -53,6 +53,22 @@ class FilterGray : public FilterBase {
   {
     return tFilter(src, x, y, size, pixSize, val);
   }
+
+  /// filter row of pixels converted by previous filters
+  void filterPixels(unsigned int *dst, short width);
+
+  /// virtual row filtering function for byte source
+  virtual void filterRow(
+      unsigned char *src, short y, short *size, unsigned int pixSize, unsigned int *dst)
+  {
+    filterPixels(dst, size[0]);
+  }
+  /// virtual row filtering function for unsigned int source
+  virtual void filterRow(
+      unsigned int *src, short y, short *size, unsigned int pixSize, unsigned int *dst)
+  {
+    filterPixels(dst, size[0]);
+  }
 };
 
 /// type for color matrix
@@ -117,6 +133,22 @@ class FilterColor : public FilterBase {
   {
     return tFilter(src, x, y, size, pixSize, val);
   }
+
+  /// filter row of pixels converted by previous filters
+  void filterPixels(unsigned int *dst, short width);
+
+  /// virtual row filtering function for byte source
+  virtual void filterRow(
+      unsigned char *src, short y, short *size, unsigned int pixSize, unsigned int *dst)
+  {
+    filterPixels(dst, size[0]);
+  }
+  /// virtual row filtering function for unsigned int source
+  virtual void filterRow(
+      unsigned int *src, short y, short *size, unsigned int pixSize, unsigned int *dst)
+  {
+    filterPixels(dst, size[0]);
+  }
 };
 
 /// type for color levels
@@ -143,6 +175,11 @@ class FilterLevel : public FilterBase {
  protected:
   ///  color calculation matrix
   ColorLevel levels;
+  /// levels of each color component value, calculated when levels are set
+  unsigned char m_table[4][256];
+
+  /// calculate table of levels
+  void updateTable(void);
 
   /// calculate one color component
   unsigned int calcColor(unsigned int val, short idx)
@@ -184,4 +221,20 @@ class FilterLevel : public FilterBase {
   {
     return tFilter(src, x, y, size, pixSize, val);
   }
+
+  /// filter row of pixels converted by previous filters
+  void filterPixels(unsigned int *dst, short width);
+
+  /// virtual row filtering function for byte source
+  virtual void filterRow(
+      unsigned char *src, short y, short *size, unsigned int pixSize, unsigned int *dst)
+  {
+    filterPixels(dst, size[0]);
+  }
+  /// virtual row filtering function for unsigned int source
+  virtual void filterRow(
+      unsigned int *src, short y, short *size, unsigned int pixSize, unsigned int *dst)
+  {
+    filterPixels(dst, size[0]);
+  }
 };
@@ -9,8 +9,26 @@
 
 #include "FilterSource.h"
 
+#include <cstring>
+#include <vector>
+
+#include "BLI_simd.h"
+
 // FilterRGB24
 
+// convert row
+void FilterRGB24::filterRow(
+    unsigned char *src, short y, short *size, unsigned int pixSize, unsigned int *dst)
+{
+  unsigned char *dstByte = (unsigned char *)dst;
+  for (short x = 0; x < size[0]; ++x, src += pixSize, dstByte += 4) {
+    dstByte[0] = src[0];
+    dstByte[1] = src[1];
+    dstByte[2] = src[2];
+    dstByte[3] = 0xFF;
+  }
+}
+
 // define python type
 PyTypeObject FilterRGB24Type = {
     PyVarObject_HEAD_INIT(nullptr, 0) "VideoTexture.FilterRGB24", /*tp_name*/
@@ -54,6 +72,13 @@ PyTypeObject FilterRGB24Type = {
 
 // FilterRGBA32
 
+// convert row, the source is already in the image format
+void FilterRGBA32::filterRow(
+    unsigned char *src, short y, short *size, unsigned int pixSize, unsigned int *dst)
+{
+  memcpy(dst, src, size[0] * sizeof(unsigned int));
+}
+
 // define python type
 PyTypeObject FilterRGBA32Type = {
     PyVarObject_HEAD_INIT(nullptr, 0) "VideoTexture.FilterRGBA32", /*tp_name*/
@@ -97,6 +122,19 @@ PyTypeObject FilterRGBA32Type = {
 
 // FilterBGR24
 
+// convert row
+void FilterBGR24::filterRow(
+    unsigned char *src, short y, short *size, unsigned int pixSize, unsigned int *dst)
+{
+  unsigned char *dstByte = (unsigned char *)dst;
+  for (short x = 0; x < size[0]; ++x, src += pixSize, dstByte += 4) {
+    dstByte[0] = src[2];
+    dstByte[1] = src[1];
+    dstByte[2] = src[0];
+    dstByte[3] = 0xFF;
+  }
+}
+
 // define python type
 PyTypeObject FilterBGR24Type = {
     PyVarObject_HEAD_INIT(nullptr, 0) "VideoTexture.FilterBGR24", /*tp_name*/
@@ -137,3 +175,77 @@ PyTypeObject FilterBGR24Type = {
     0,                                                            /* tp_alloc */
     Filter_allocNew,                                              /* tp_new */
 };
+
+// FilterBGRA32
+
+// convert row, swap red and blue of 4 pixels at once
+void FilterBGRA32::filterRow(
+    unsigned char *src, short y, short *size, unsigned int pixSize, unsigned int *dst)
+{
+  short x = 0;
+#ifdef BLI_HAVE_SSE2
+  const __m128i maskGA = _mm_set1_epi32(int(0xFF00FF00));
+  const __m128i maskR = _mm_set1_epi32(0xFF);
+  for (; x + 4 <= size[0]; x += 4, src += 4 * pixSize) {
+    __m128i pix = _mm_loadu_si128((const __m128i *)src);
+    __m128i red = _mm_and_si128(_mm_srli_epi32(pix, 16), maskR);
+    __m128i blue = _mm_slli_epi32(_mm_and_si128(pix, maskR), 16);
+    pix = _mm_or_si128(_mm_and_si128(pix, maskGA), _mm_or_si128(red, blue));
+    _mm_storeu_si128((__m128i *)(dst + x), pix);
+  }
+#endif
+  unsigned char *dstByte = (unsigned char *)(dst + x);
+  for (; x < size[0]; ++x, src += pixSize, dstByte += 4) {
+    dstByte[0] = src[2];
+    dstByte[1] = src[1];
+    dstByte[2] = src[0];
+    dstByte[3] = src[3];
+  }
+}
+
+// FilterYV12
+
+// convert row, U & V values are interpolated once per row instead of once per pixel
+void FilterYV12::filterRow(
+    unsigned char *src, short y, short *size, unsigned int pixSize, unsigned int *dst)
+{
+  // U & V values of the row, vertically interpolated on odd rows
+  short sizeUV = (size[0] + 1) >> 1;
+  std::vector<int> rowU(sizeUV);
+  std::vector<int> rowV(sizeUV);
+  long offset = m_pitchUV * (y >> 1);
+  for (short idx = 0; idx < sizeUV; ++idx) {
+    if ((y & 1) == 1) {
+      rowU[idx] = interpolEV(m_buffU + offset + idx, y, size[1]);
+      rowV[idx] = interpolEV(m_buffV + offset + idx, y, size[1]);
+    }
+    else {
+      rowU[idx] = m_buffU[offset + idx];
+      rowV[idx] = m_buffV[offset + idx];
+    }
+  }
+
+  unsigned char *dstByte = (unsigned char *)dst;
+  for (short x = 0; x < size[0]; ++x, src += pixSize, dstByte += 4) {
+    // get modified YUV -> CDE: C = Y - 16; D = U - 128; E = V - 128
+    int c = *src - 16;
+    int d, e;
+    // odd pixels need horizontal interpolation
+    if ((x & 1) == 1) {
+      d = interpolRow(rowU.data(), x, size[0]) - 128;
+      e = interpolRow(rowV.data(), x, size[0]) - 128;
+    }
+    else {
+      d = rowU[x >> 1] - 128;
+      e = rowV[x >> 1] - 128;
+    }
+    // convert to RGB as in filter()
+    int red = (298 * c + 409 * e + 128) >> 8;
+    int green = (298 * c - 100 * d - 208 * e) >> 8;
+    int blue = (298 * c + 516 * d + 128) >> 8;
+    dstByte[0] = red >= 0x100 ? 0xFF : red < 0 ? 0 : red;
+    dstByte[1] = green >= 0x100 ? 0xFF : green < 0 ? 0 : green;
+    dstByte[2] = blue >= 0x100 ? 0xFF : blue < 0 ? 0 : blue;
+    dstByte[3] = 0xFF;
+  }
+}
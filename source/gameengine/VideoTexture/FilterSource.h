@@ -36,6 +36,10 @@ class FilterRGB24 : public FilterBase {
     VT_RGBA(val, src[0], src[1], src[2], 0xFF);
     return val;
   }
+
+  /// filter row, source byte buffer
+  virtual void filterRow(
+      unsigned char *src, short y, short *size, unsigned int pixSize, unsigned int *dst);
 };
 
 /// class for RGBA32 conversion
@@ -68,6 +72,10 @@ class FilterRGBA32 : public FilterBase {
       return val;
     }
   }
+
+  /// filter row, source byte buffer
+  virtual void filterRow(
+      unsigned char *src, short y, short *size, unsigned int pixSize, unsigned int *dst);
 };
 
 /// class for BGRA32 conversion
@@ -96,6 +104,10 @@ class FilterBGRA32 : public FilterBase {
     VT_RGBA(val, src[2], src[1], src[0], src[3]);
     return val;
   }
+
+  /// filter row, source byte buffer
+  virtual void filterRow(
+      unsigned char *src, short y, short *size, unsigned int pixSize, unsigned int *dst);
 };
 
 /// class for BGR24 conversion
@@ -124,6 +136,10 @@ class FilterBGR24 : public FilterBase {
     VT_RGBA(val, src[2], src[1], src[0], 0xFF);
     return val;
   }
+
+  /// filter row, source byte buffer
+  virtual void filterRow(
+      unsigned char *src, short y, short *size, unsigned int pixSize, unsigned int *dst);
 };
 
 /// class for Z_buffer conversion
@@ -379,4 +395,16 @@ class FilterYV12 : public FilterBase {
     VT_RGBA(val, red, green, blue, 0xFF);
     return val;
   }
+
+  /// horizontal interpolation of a row of U or V values on the position of an odd pixel
+  int interpolRow(const int *row, short x, short size)
+  {
+    short idx = x >> 1;
+    int c = x < size - 2 ? row[idx + 1] : row[idx];
+    return interpol(x > 1 ? row[idx - 1] : row[idx], row[idx], c, x < size - 4 ? row[idx + 2] : c);
+  }
+
+  /// filter row, source byte buffer
+  virtual void filterRow(
+      unsigned char *src, short y, short *size, unsigned int pixSize, unsigned int *dst);
 };
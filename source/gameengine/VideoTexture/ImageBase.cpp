@@ -8,6 +8,8 @@
 #include "ImageBase.h"
 
 #include <epoxy/gl.h>
+#include "BLI_math_base.h"
+#include "BLI_task.h"
 #include "MEM_guardedalloc.h"
 #include "bgl.h"
 
@@ -30,9 +32,37 @@ ExpDesc InvalidColorChannelDesc(
 ExpDesc InvalidImageModeDesc(InvalidImageMode,
                              "Invalid image mode, only RGBA and BGRA are supported");
 
+// rows converted by the tasks of ImageBase::convRows
+template<class SRC> struct ConvRowsData {
+  FilterBase *filter;
+  SRC srcBuff;
+  short *srcSize;
+  unsigned int pixSize;
+  unsigned int *dstBuff;
+  bool flip;
+};
+
+// convert one row of the image
+template<class SRC>
+static void conv_rows_func(void *__restrict userdata,
+                           int y,
+                           const TaskParallelTLS *__restrict /*tls*/)
+{
+  ConvRowsData<SRC> *data = static_cast<ConvRowsData<SRC> *>(userdata);
+  const long width = data->srcSize[0];
+  // source row, the last row comes first when flipping
+  const short srcY = data->flip ? data->srcSize[1] - 1 - y : y;
+  data->filter->convertRow(data->srcBuff + srcY * width * data->pixSize,
+                           srcY,
+                           data->srcSize,
+                           data->pixSize,
+                           data->dstBuff + y * width);
+}
+
 // constructor
 ImageBase::ImageBase(bool staticSrc)
     : m_image(nullptr),
+      m_sharedImage(nullptr),
       m_imgSize(0),
       m_internalFormat(GL_RGBA8),
       m_avail(false),
@@ -89,20 +119,22 @@ unsigned int *ImageBase::getImage(unsigned int texId, double ts)
     calcImage(texId, ts);
   }
   // if image is available, return it, otherwise nullptr
-  return m_avail ? m_image : nullptr;
+  if (!m_avail)
+    return nullptr;
+  return (m_sharedImage != nullptr) ? m_sharedImage : m_image;
 }
 
 bool ImageBase::loadImage(unsigned int *buffer, unsigned int size, unsigned int format, double ts)
 {
-  unsigned int *d, *s, v, len;
-  if (getImage(0, ts) != nullptr && size >= getBuffSize()) {
+  unsigned int *d, *s, *image, v, len;
+  if ((image = getImage(0, ts)) != nullptr && size >= getBuffSize()) {
     switch (format) {
       case GL_RGBA:
-        memcpy(buffer, m_image, getBuffSize());
+        memcpy(buffer, image, getBuffSize());
         break;
       case GL_BGRA:
         len = (unsigned int)m_size[0] * m_size[1];
-        for (s = m_image, d = buffer; len; len--) {
+        for (s = image, d = buffer; len; len--) {
           v = *s++;
           *d++ = VT_SWAPBR(v);
         }
@@ -192,6 +224,17 @@ void ImageBase::swapImageBR()
   }
 }
 
+unsigned int *ImageBase::unshareImage(void)
+{
+  if (m_sharedImage != nullptr) {
+    // keep the current image once the source reuses its buffer
+    if (m_avail)
+      memcpy(m_image, m_sharedImage, getBuffSize());
+    m_sharedImage = nullptr;
+  }
+  return m_image;
+}
+
 // initialize image data
 void ImageBase::init(short width, short height)
 {
@@ -291,6 +334,22 @@ bool ImageBase::loopDetect(ImageBase *img)
   return false;
 }
 
+// convert image of the same size row by row
+template<class SRC> void ImageBase::convRows(FilterBase &filter, SRC srcBuff, short *srcSize)
+{
+  ConvRowsData<SRC> data = {
+      &filter, srcBuff, srcSize, filter.firstPixelSize(), m_image, m_flip};
+  // split rows across threads by blocks of at least 16k pixels
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = max_ii(1, 16384 / max_ii(1, srcSize[0]));
+  BLI_task_parallel_range(0, srcSize[1], &data, conv_rows_func<SRC>, &settings);
+}
+
+template void ImageBase::convRows(FilterBase &filter, unsigned char *srcBuff, short *srcSize);
+template void ImageBase::convRows(FilterBase &filter, unsigned int *srcBuff, short *srcSize);
+template void ImageBase::convRows(FilterBase &filter, float *srcBuff, short *srcSize);
+
 // ImageSource class implementation
 
 // constructor
@@ -758,6 +817,8 @@ static int Image_getbuffer(PyImage *self, Py_buffer *view, int flags)
     PyErr_SetString(PyExc_BufferError, "Image buffer is not available");
     return -1;
   }
+  // the exported buffer must outlive the buffer shared by the source
+  image = self->m_image->unshareImage();
   if (view == nullptr) {
     self->m_image->m_exports++;
     return 0;
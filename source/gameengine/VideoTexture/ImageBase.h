@@ -123,12 +123,17 @@ class ImageBase {
   /// swap the B and R channel in-place in the image buffer
   void swapImageBR();
 
+  /// copy the shared image in the image buffer and stop sharing it, return the image buffer
+  unsigned int *unshareImage(void);
+
   /// number of buffer pointing to m_image, public because not handled by this class
   int m_exports;
 
  protected:
   /// image buffer
   unsigned int *m_image;
+  /// buffer owned by the source returned instead of m_image, valid until the next calcImage
+  unsigned int *m_sharedImage;
   /// image buffer size
   unsigned int m_imgSize;
   /// Image internal format type.
@@ -180,6 +185,9 @@ class ImageBase {
   /// perform loop detection
   bool loopDetect(ImageBase *img);
 
+  /// convert image of the same size row by row, rows are split across threads
+  template<class SRC> void convRows(FilterBase &filter, SRC srcBuff, short *srcSize);
+
   /// template for image conversion
   template<class FLT, class SRC> void convImage(FLT &filter, SRC srcBuff, short *srcSize)
   {
@@ -187,25 +195,9 @@ class ImageBase {
     unsigned int *dstBuff = m_image;
     // pixel size from filter
     unsigned int pixSize = filter.firstPixelSize();
-    // if no scaling is needed
+    // if no scaling is needed, convert whole rows (flipped if required)
     if (srcSize[0] == m_size[0] && srcSize[1] == m_size[1])
-      // if flipping isn't required
-      if (!m_flip)
-        // copy bitmap
-        for (short y = 0; y < m_size[1]; ++y)
-          for (short x = 0; x < m_size[0]; ++x, ++dstBuff, srcBuff += pixSize)
-            // copy pixel
-            *dstBuff = filter.convert(srcBuff, x, y, srcSize, pixSize);
-      // otherwise flip image top to bottom
-      else {
-        // go to last row of image
-        srcBuff += srcSize[0] * (srcSize[1] - 1) * pixSize;
-        // copy bitmap
-        for (short y = m_size[1] - 1; y >= 0; --y, srcBuff -= 2 * srcSize[0] * pixSize)
-          for (short x = 0; x < m_size[0]; ++x, ++dstBuff, srcBuff += pixSize)
-            // copy pixel
-            *dstBuff = filter.convert(srcBuff, x, y, srcSize, pixSize);
-      }
+      convRows(filter, srcBuff, srcSize);
     // else scale picture (nearest neighbor)
     else {
       // interpolation accumulator
@@ -432,6 +432,8 @@ EXP_PYMETHODDEF_DOC(Texture, refresh, "Refresh texture from source")
           }
           // load texture for rendering
           loadTexture(m_actTex, texture, size, m_mipmap, m_source->m_image->GetInternalFormat());
+          // the texture content changed without touching the scene graph
+          engine->RequestRender();
         }
         // refresh texture source, if required
         if (refreshSource) {
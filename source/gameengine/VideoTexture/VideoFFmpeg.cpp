@@ -52,9 +52,11 @@ VideoFFmpeg::VideoFFmpeg(HRESULT *hRslt)
       m_frame(nullptr),
       m_frameDeinterlaced(nullptr),
       m_frameRGB(nullptr),
+      m_frameRGBBottomUp(false),
       m_imgConvertCtx(nullptr),
       m_deinterlace(false),
       m_preseek(0),
+      m_cacheSize(CACHE_FRAME_SIZE),
       m_videoStream(-1),
       m_baseFrameRate(25.0),
       m_lastFrame(-1),
@@ -69,7 +71,9 @@ VideoFFmpeg::VideoFFmpeg(HRESULT *hRslt)
       m_isThreaded(false),
       m_isStreaming(false),
       m_stopThread(false),
-      m_cacheStarted(false)
+      m_cacheStarted(false),
+      m_bottomUp(false),
+      m_sharedFrame(nullptr)
 {
   // set video format
   m_format = RGB24;
@@ -102,6 +106,7 @@ void VideoFFmpeg::refresh(void)
 bool VideoFFmpeg::release()
 {
   // release
+  unshareFrame();
   stopCache();
 
   if (m_codecCtx) {
@@ -139,30 +144,17 @@ AVFrame *VideoFFmpeg::allocFrameRGB()
 {
   AVFrame *frame;
   frame = av_frame_alloc();
-  if (m_format == RGBA32) {
-    av_image_fill_arrays(
-        frame->data,
-        frame->linesize,
-        (uint8_t *)MEM_callocN(
-            av_image_get_buffer_size(AV_PIX_FMT_RGBA, m_codecCtx->width, m_codecCtx->height, 1),
-            "ffmpeg rgba"),
-        AV_PIX_FMT_RGBA,
-        m_codecCtx->width,
-        m_codecCtx->height,
-        1);
-  }
-  else {
-    av_image_fill_arrays(
-        frame->data,
-        frame->linesize,
-        (uint8_t *)MEM_callocN(
-            av_image_get_buffer_size(AV_PIX_FMT_RGB24, m_codecCtx->width, m_codecCtx->height, 1),
-            "ffmpeg rgb"),
-        AV_PIX_FMT_RGB24,
-        m_codecCtx->width,
-        m_codecCtx->height,
-        1);
-  }
+  // no row padding: the frame can be used as image buffer
+  av_image_fill_arrays(
+      frame->data,
+      frame->linesize,
+      (uint8_t *)MEM_callocN(
+          av_image_get_buffer_size(AV_PIX_FMT_RGBA, m_codecCtx->width, m_codecCtx->height, 1),
+          "ffmpeg rgba"),
+      AV_PIX_FMT_RGBA,
+      m_codecCtx->width,
+      m_codecCtx->height,
+      1);
   return frame;
 }
 
@@ -283,38 +275,21 @@ int VideoFFmpeg::openStream(const char *filename,
       m_codecCtx->height,
       1);
 
-  // check if the pixel format supports Alpha
-  if (m_codecCtx->pix_fmt == AV_PIX_FMT_RGB32 || m_codecCtx->pix_fmt == AV_PIX_FMT_BGR32 ||
-      m_codecCtx->pix_fmt == AV_PIX_FMT_RGB32_1 || m_codecCtx->pix_fmt == AV_PIX_FMT_BGR32_1) {
-    // allocate buffer to store final decoded frame
-    m_format = RGBA32;
-    // allocate sws context
-    m_imgConvertCtx = sws_getContext(m_codecCtx->width,
-                                     m_codecCtx->height,
-                                     m_codecCtx->pix_fmt,
-                                     m_codecCtx->width,
-                                     m_codecCtx->height,
-                                     AV_PIX_FMT_RGBA,
-                                     SWS_FAST_BILINEAR,
-                                     nullptr,
-                                     nullptr,
-                                     nullptr);
-  }
-  else {
-    // allocate buffer to store final decoded frame
-    m_format = RGB24;
-    // allocate sws context
-    m_imgConvertCtx = sws_getContext(m_codecCtx->width,
-                                     m_codecCtx->height,
-                                     m_codecCtx->pix_fmt,
-                                     m_codecCtx->width,
-                                     m_codecCtx->height,
-                                     AV_PIX_FMT_RGB24,
-                                     SWS_FAST_BILINEAR,
-                                     nullptr,
-                                     nullptr,
-                                     nullptr);
-  }
+  // always decode to RGBA (opaque formats get an alpha of 255), this is the image format
+  // so that the decoded frame can be used as image without copy
+  m_format = RGBA32;
+  // allocate sws context
+  m_imgConvertCtx = sws_getContext(m_codecCtx->width,
+                                   m_codecCtx->height,
+                                   m_codecCtx->pix_fmt,
+                                   m_codecCtx->width,
+                                   m_codecCtx->height,
+                                   AV_PIX_FMT_RGBA,
+                                   SWS_FAST_BILINEAR,
+                                   nullptr,
+                                   nullptr,
+                                   nullptr);
+  // allocate buffer to store final decoded frame
   m_frameRGB = allocFrameRGB();
 
   if (!m_imgConvertCtx) {
@@ -341,7 +316,8 @@ int VideoFFmpeg::openStream(const char *filename,
  * The main thread is responsible for positioning the frame pointer in the
  * file correctly before calling startCache() which starts this thread.
  * The cache is organized in two layers: 1) a cache of 20-30 undecoded packets to keep
- * memory and CPU low 2) a cache of 5 decoded frames.
+ * memory and CPU low 2) a cache of m_cacheSize decoded frames, one of them may be held out
+ * of the queues while it is used as image.
  * If the main thread does not find the frame in the cache (because the video has restarted
  * or because the GE is lagging), it stops the cache with StopCache() (this is a synchronous
  * function: it sends a signal to stop the cache thread and wait for confirmation), then
@@ -430,14 +406,9 @@ void *VideoFFmpeg::cacheThread(void *data)
                 input = video->m_frameDeinterlaced;
               }
             }
-            // convert to RGB24
-            sws_scale(video->m_imgConvertCtx,
-                      input->data,
-                      input->linesize,
-                      0,
-                      video->m_codecCtx->height,
-                      currentFrame->frame->data,
-                      currentFrame->frame->linesize);
+            // convert to RGBA, the row order may change before the frame is displayed
+            currentFrame->bottomUp = video->m_bottomUp;
+            video->convertFrame(input, currentFrame->frame, currentFrame->bottomUp);
             // move frame to queue, this frame is necessarily the next one
             video->m_curPosition = (long)((cachePacket->packet.dts - startTs) *
                                               (video->m_baseFrameRate * timeBase) +
@@ -482,7 +453,7 @@ bool VideoFFmpeg::startCache()
 {
   if (!m_cacheStarted && m_isThreaded) {
     m_stopThread = false;
-    for (int i = 0; i < CACHE_FRAME_SIZE; i++) {
+    for (int i = 0; i < m_cacheSize; i++) {
       CacheFrame *frame = new CacheFrame();
       frame->frame = allocFrameRGB();
       BLI_addtail(&m_frameCacheFree, frame);
@@ -503,6 +474,8 @@ void VideoFFmpeg::stopCache()
   if (m_cacheStarted) {
     m_stopThread = true;
     BLI_threadpool_end(&m_thread);
+    // the shared frame is freed with the others
+    unshareFrame();
     // now delete the cache
     CacheFrame *frame;
     CachePacket *packet;
@@ -546,6 +519,99 @@ void VideoFFmpeg::releaseFrame(AVFrame *frame)
   pthread_mutex_unlock(&m_cacheMutex);
 }
 
+void VideoFFmpeg::convertFrame(AVFrame *input, AVFrame *output, bool bottomUp)
+{
+  if (!bottomUp) {
+    sws_scale(m_imgConvertCtx,
+              input->data,
+              input->linesize,
+              0,
+              m_codecCtx->height,
+              output->data,
+              output->linesize);
+    return;
+  }
+  // start from the last row with a negative stride, the texture expects the bottom row first
+  uint8_t *data[4] = {
+      output->data[0] + output->linesize[0] * (m_codecCtx->height - 1), nullptr, nullptr, nullptr};
+  int linesize[4] = {-output->linesize[0], 0, 0, 0};
+  sws_scale(
+      m_imgConvertCtx, input->data, input->linesize, 0, m_codecCtx->height, data, linesize);
+}
+
+bool VideoFFmpeg::isFrameBottomUp(AVFrame *frame)
+{
+  if (frame == m_frameRGB) {
+    return m_frameRGBBottomUp;
+  }
+  // this frame MUST be the first one of the queue
+  pthread_mutex_lock(&m_cacheMutex);
+  CacheFrame *cacheFrame = (CacheFrame *)m_frameCacheBase.first;
+  assert(cacheFrame != nullptr && cacheFrame->frame == frame);
+  bool bottomUp = cacheFrame->bottomUp;
+  pthread_mutex_unlock(&m_cacheMutex);
+  return bottomUp;
+}
+
+void VideoFFmpeg::flipFrame(AVFrame *frame)
+{
+  const int rowSize = frame->linesize[0];
+  uint8_t *row = (uint8_t *)MEM_mallocN(rowSize, "ffmpeg row");
+  uint8_t *top = frame->data[0];
+  uint8_t *bottom = top + rowSize * (m_codecCtx->height - 1);
+  for (; top < bottom; top += rowSize, bottom -= rowSize) {
+    memcpy(row, top, rowSize);
+    memcpy(top, bottom, rowSize);
+    memcpy(bottom, row, rowSize);
+  }
+  MEM_freeN(row);
+}
+
+bool VideoFFmpeg::canShareFrame(void)
+{
+  // the frame is used as is: no filter, no scaling and the default flip, and python must
+  // not hold a buffer on the image (the exported buffer would not be updated)
+  return !m_isImage && m_pyfilter == nullptr && m_flip && m_exports == 0 &&
+         m_size[0] == m_orgSize[0] && m_size[1] == m_orgSize[1];
+}
+
+void VideoFFmpeg::shareFrame(AVFrame *frame)
+{
+  // the previous frame is not used anymore
+  unshareFrame();
+  if (frame != m_frameRGB) {
+    // this frame MUST be the first one of the queue, keep it until the next one is shared
+    pthread_mutex_lock(&m_cacheMutex);
+    m_sharedFrame = (CacheFrame *)m_frameCacheBase.first;
+    assert(m_sharedFrame != nullptr && m_sharedFrame->frame == frame);
+    BLI_remlink(&m_frameCacheBase, m_sharedFrame);
+    pthread_mutex_unlock(&m_cacheMutex);
+  }
+  m_sharedImage = (unsigned int *)frame->data[0];
+  m_avail = true;
+}
+
+void VideoFFmpeg::unshareFrame(void)
+{
+  unshareImage();
+  if (m_sharedFrame != nullptr) {
+    pthread_mutex_lock(&m_cacheMutex);
+    BLI_addtail(&m_frameCacheFree, m_sharedFrame);
+    pthread_mutex_unlock(&m_cacheMutex);
+    m_sharedFrame = nullptr;
+  }
+}
+
+void VideoFFmpeg::setCacheSize(int cacheSize)
+{
+  // the decoding thread needs a free frame while one is used as image
+  if (cacheSize >= 2 && cacheSize != m_cacheSize) {
+    m_cacheSize = cacheSize;
+    // restart the cache with the new size on next frame
+    stopCache();
+  }
+}
+
 // open video file
 void VideoFFmpeg::openFile(char *filename)
 {
@@ -819,10 +885,26 @@ void VideoFFmpeg::calcImage(unsigned int texId, double ts)
         m_lastFrame = actFrame;
         // init image, if needed
         init(short(m_codecCtx->width), short(m_codecCtx->height));
-        // process image
-        process((BYTE *)(frame->data[0]));
-        // finished with the frame, release it so that cache can reuse it
-        releaseFrame(frame);
+        // shared frames are bottom up, the filters expect the rows top down
+        bool share = canShareFrame();
+        // the next frames are converted in the right order
+        m_bottomUp = share;
+        if (isFrameBottomUp(frame) != share) {
+          // frame decoded ahead before the filter, size or flip changed
+          flipFrame(frame);
+        }
+        if (share) {
+          // use the frame as image, it is released when the next frame is shared
+          shareFrame(frame);
+        }
+        else {
+          // the image is overwritten, stop sharing the previous frame
+          unshareFrame();
+          // process image
+          process((BYTE *)(frame->data[0]));
+          // finished with the frame, release it so that cache can reuse it
+          releaseFrame(frame);
+        }
         // in case it is an image, automatically stop reading it
         if (m_isImage) {
           m_status = SourceStopped;
@@ -1032,14 +1114,9 @@ AVFrame *VideoFFmpeg::grabFrame(long position)
             input = m_frameDeinterlaced;
           }
         }
-        // convert to RGB24
-        sws_scale(m_imgConvertCtx,
-                  input->data,
-                  input->linesize,
-                  0,
-                  m_codecCtx->height,
-                  m_frameRGB->data,
-                  m_frameRGB->linesize);
+        // convert to RGBA
+        m_frameRGBBottomUp = m_bottomUp;
+        convertFrame(input, m_frameRGB, m_frameRGBBottomUp);
         av_packet_unref(&packet);
         frameLoaded = true;
         break;
@@ -1138,6 +1215,29 @@ static int VideoFFmpeg_setPreseek(PyImage *self, PyObject *value, void *closure)
   return 0;
 }
 
+static PyObject *VideoFFmpeg_getCacheSize(PyImage *self, void *closure)
+{
+  return Py_BuildValue("i", getFFmpeg(self)->getCacheSize());
+}
+
+// set cache size
+static int VideoFFmpeg_setCacheSize(PyImage *self, PyObject *value, void *closure)
+{
+  // check validity of parameter
+  if (value == nullptr || !PyLong_Check(value)) {
+    PyErr_SetString(PyExc_TypeError, "The value must be an integer");
+    return -1;
+  }
+  if (PyLong_AsLong(value) < 2) {
+    PyErr_SetString(PyExc_ValueError, "The cache must hold at least 2 frames");
+    return -1;
+  }
+  // set cache size
+  getFFmpeg(self)->setCacheSize(PyLong_AsLong(value));
+  // success
+  return 0;
+}
+
 // get deinterlace
 static PyObject *VideoFFmpeg_getDeinterlace(PyImage *self, void *closure)
 {
@@ -1214,6 +1314,11 @@ static PyGetSetDef videoGetSets[] = {  // methods from VideoBase class
      (setter)VideoFFmpeg_setPreseek,
      (char *)"nb of frames of preseek",
      nullptr},
+    {(char *)"cachesize",
+     (getter)VideoFFmpeg_getCacheSize,
+     (setter)VideoFFmpeg_setCacheSize,
+     (char *)"nb of decoded frames in cache",
+     nullptr},
     {(char *)"deinterlace",
      (getter)VideoFFmpeg_getDeinterlace,
      (setter)VideoFFmpeg_setDeinterlace,
@@ -13,6 +13,7 @@
 #    include <inttypes.h>
 #  endif
 
+#  include <atomic>
 #  include <pthread.h>
 
 #  include "BLI_blenlib.h"
@@ -27,6 +28,7 @@ extern "C" {
 
 #  include "VideoBase.h"
 
+// default number of decoded frames in the cache
 #  define CACHE_FRAME_SIZE 10
 #  define CACHE_PACKET_SIZE 30
 
@@ -69,6 +71,11 @@ class VideoFFmpeg : public VideoBase {
     if (preseek >= 0)
       m_preseek = preseek;
   }
+  int getCacheSize(void)
+  {
+    return m_cacheSize;
+  }
+  void setCacheSize(int cacheSize);
   bool getDeinterlace(void)
   {
     return m_deinterlace;
@@ -89,14 +96,18 @@ class VideoFFmpeg : public VideoBase {
   AVFrame *m_frame;
   // deinterlaced frame if codec requires it
   AVFrame *m_frameDeinterlaced;
-  // decoded RGB24 frame if codec requires it
+  // decoded RGBA frame when not caching
   AVFrame *m_frameRGB;
+  // are the rows of m_frameRGB stored bottom up?
+  bool m_frameRGBBottomUp;
   // conversion from raw to RGB is done with sws_scale
   struct SwsContext *m_imgConvertCtx;
   // should the codec be deinterlaced?
   bool m_deinterlace;
   // number of frame of preseek
   int m_preseek;
+  // number of decoded frames in the cache
+  int m_cacheSize;
   // order number of stream holding the video in format context
   int m_videoStream;
 
@@ -161,6 +172,21 @@ class VideoFFmpeg : public VideoBase {
   /// in case of caching, put the frame back in free queue
   void releaseFrame(AVFrame *frame);
 
+  /// convert a decoded frame to RGBA, rows are stored bottom up as expected by textures or top
+  /// down as expected by the filters
+  void convertFrame(AVFrame *input, AVFrame *output, bool bottomUp);
+  /// are the rows of a frame returned by grabFrame stored bottom up?
+  bool isFrameBottomUp(AVFrame *frame);
+  /// reverse the row order of a converted frame
+  void flipFrame(AVFrame *frame);
+
+  /// can the image point to the converted frame instead of copying it
+  bool canShareFrame(void);
+  /// use the converted frame as image, in case of caching it is kept out of the queues
+  void shareFrame(AVFrame *frame);
+  /// copy back the shared frame in the image and put it back in free queue
+  void unshareFrame(void);
+
   /// start thread to load the video file/capture/stream
   bool startCache();
   void stopCache();
@@ -170,6 +196,8 @@ class VideoFFmpeg : public VideoBase {
     Link link;
     long framePosition;
     AVFrame *frame;
+    // row order the frame was converted with
+    bool bottomUp;
   } CacheFrame;
   typedef struct {
     Link link;
@@ -178,12 +206,16 @@ class VideoFFmpeg : public VideoBase {
 
   bool m_stopThread;
   bool m_cacheStarted;
+  // row order of the next converted frames, set by calcImage and read by the cache thread
+  std::atomic<bool> m_bottomUp;
   ListBase m_thread;
   ListBase m_frameCacheBase;   // list of frames that are ready
   ListBase m_frameCacheFree;   // list of frames that are unused
   ListBase m_packetCacheBase;  // list of packets that are ready for decoding
   ListBase m_packetCacheFree;  // list of packets that are unused
   pthread_mutex_t m_cacheMutex;
+  // cached frame used as image, out of both queues
+  CacheFrame *m_sharedFrame;
 
   AVFrame *allocFrameRGB();
   static void *cacheThread(void *);
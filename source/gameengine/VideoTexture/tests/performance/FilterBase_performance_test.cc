@@ -0,0 +1,161 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file FilterBase_performance_test.cc
+ *  \ingroup bgevideotex
+ */
+
+/* Compare the row kernels of the VideoTexture filters (FilterBase::convertRow) with the per
+ * pixel conversion calling filter() they replace: both must give the same pixels bit for bit,
+ * the row conversion is timed against the per pixel one. */
+
+#include "testing/testing.h"
+
+#include <cstdlib>
+#include <vector>
+
+#include "PIL_time_utildefines.h"
+
+#include "FilterBlueScreen.h"
+#include "FilterColor.h"
+#include "FilterSource.h"
+
+#define NUM_REPEATS 5
+
+/* Odd sizes exercise the scalar tail of the kernels. */
+static const short sizes[][2] = {{1920, 1080}, {1921, 1081}, {7, 7}, {8, 8}};
+
+static std::vector<unsigned char> random_buffer(size_t size)
+{
+  std::vector<unsigned char> buffer(size);
+  for (unsigned char &c : buffer) {
+    c = rand() & 0xFF;
+  }
+  return buffer;
+}
+
+/* Convert the source with the filter chain ending by last, per pixel then per row. */
+template<class SRC>
+static void check_filter(
+    const char *name, FilterBase &last, SRC src, short width, short height, unsigned int pixSize)
+{
+  short size[2] = {width, height};
+  std::vector<unsigned int> pixels(width * height);
+  std::vector<unsigned int> rows(width * height);
+
+  printf("\n%s %dx%d\n", name, width, height);
+  TIMEIT_START(pixel);
+  for (int i = 0; i < NUM_REPEATS; ++i) {
+    for (short y = 0; y < height; ++y) {
+      for (short x = 0; x < width; ++x) {
+        const int index = y * width + x;
+        pixels[index] = last.convert(src + index * pixSize, x, y, size, pixSize);
+      }
+    }
+  }
+  TIMEIT_END(pixel);
+
+  TIMEIT_START(row);
+  for (int i = 0; i < NUM_REPEATS; ++i) {
+    for (short y = 0; y < height; ++y) {
+      last.convertRow(src + y * width * pixSize, y, size, pixSize, rows.data() + y * width);
+    }
+  }
+  TIMEIT_END(row);
+
+  int mismatches = 0;
+  for (int i = 0; i < width * height; ++i) {
+    if (pixels[i] != rows[i]) {
+      ++mismatches;
+    }
+  }
+  EXPECT_EQ(mismatches, 0) << name << " " << width << "x" << height;
+}
+
+/* Run a filter taking its pixels from a BGRA32 source filter. */
+template<class FLT>
+static void check_chained_filter(const char *name, FLT &filter, unsigned char *src)
+{
+  FilterBGRA32 first;
+  PyFilter previous;
+  previous.m_filter = &first;
+
+  filter.setPrevious(&previous, false);
+  for (const short *size : sizes) {
+    check_filter(name, filter, src, size[0], size[1], 4);
+  }
+  filter.setPrevious(nullptr, false);
+}
+
+TEST(videotexture_filter, SourceRowVsPixel)
+{
+  srand(1);
+  std::vector<unsigned char> src = random_buffer(sizes[1][0] * sizes[1][1] * 4);
+
+  FilterRGB24 rgb24;
+  FilterBGR24 bgr24;
+  FilterRGBA32 rgba32;
+  FilterBGRA32 bgra32;
+  for (const short *size : sizes) {
+    check_filter("RGB24", rgb24, src.data(), size[0], size[1], 3);
+    check_filter("BGR24", bgr24, src.data(), size[0], size[1], 3);
+    check_filter("RGBA32", rgba32, src.data(), size[0], size[1], 4);
+    check_filter("BGRA32", bgra32, src.data(), size[0], size[1], 4);
+  }
+
+  for (const short *size : sizes) {
+    short buffSize[2] = {size[0], size[1]};
+    // Luminance plane followed by the two chrominance planes.
+    std::vector<unsigned char> yuv = random_buffer(size[0] * size[1] * 2);
+    FilterYV12 yv12;
+    yv12.setBuffs(yuv.data(), buffSize);
+    check_filter("YV12", yv12, yuv.data(), size[0], size[1], 1);
+  }
+}
+
+TEST(videotexture_filter, ColorRowVsPixel)
+{
+  srand(1);
+  std::vector<unsigned char> src = random_buffer(sizes[1][0] * sizes[1][1] * 4);
+
+  FilterGray gray;
+  check_chained_filter("Gray", gray, src.data());
+
+  // The last matrix overflows the 16 bits color components.
+  for (int i = 0; i < 5; ++i) {
+    ColorMatrix matrix;
+    for (int r = 0; r < 4; ++r) {
+      for (int c = 0; c < 5; ++c) {
+        matrix[r][c] = short((rand() % 1200) - 600) * (i == 4 ? 50 : 1);
+      }
+    }
+    FilterColor color;
+    color.setMatrix(matrix);
+    check_chained_filter("Color", color, src.data());
+  }
+
+  for (int i = 0; i < 5; ++i) {
+    ColorLevel levels;
+    for (int r = 0; r < 4; ++r) {
+      levels[r][0] = rand() % 256;
+      levels[r][1] = rand() % 300;
+    }
+    FilterLevel level;
+    level.setLevels(levels);
+    check_chained_filter("Level", level, src.data());
+  }
+}
+
+TEST(videotexture_filter, BlueScreenRowVsPixel)
+{
+  srand(1);
+  std::vector<unsigned char> src = random_buffer(sizes[1][0] * sizes[1][1] * 4);
+
+  const unsigned short limits[][2] = {
+      {64, 64}, {0, 300}, {100, 200}, {500, 65535}, {65535, 65535}, {20, 21}};
+  for (const unsigned short *limit : limits) {
+    FilterBlueScreen blueScreen;
+    blueScreen.setColor(rand() & 0xFF, rand() & 0xFF, rand() & 0xFF);
+    blueScreen.setLimits(limit[0], limit[1]);
+    check_chained_filter("BlueScreen", blueScreen, src.data());
+  }
+}
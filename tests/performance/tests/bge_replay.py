@@ -0,0 +1,117 @@
+# SPDX-License-Identifier: Apache-2.0
+
+import api
+import pathlib
+import tempfile
+
+# Rigid bodies falling in a grid and pushed by the game logic.
+NUM_BODIES = 400
+RECORD_FRAMES = 600
+STATISTICS_KEY = "Frame statistics over "
+
+# Game logic run every frame, pushing some bodies up until the end of the record.
+GAME_SCRIPT = f'''
+import bge
+
+logic = bge.logic
+scene = logic.getCurrentScene()
+
+if not hasattr(logic, "benchBodies"):
+    logic.benchBodies = [obj for obj in scene.objects if obj.name.startswith("Body")]
+    logic.benchFrame = 0
+
+# Deterministic choice of the pushed bodies, the replay must run the same logic.
+for i in range(logic.benchFrame % 10, len(logic.benchBodies), 10):
+    logic.benchBodies[i].applyImpulse(logic.benchBodies[i].worldPosition, (0.0, 0.0, 0.5))
+
+logic.benchFrame += 1
+if logic.benchFrame == {RECORD_FRAMES}:
+    logic.endGame()
+'''
+
+
+def _create_scene(args):
+    import bpy
+
+    bpy.ops.wm.read_factory_settings(use_empty=True)
+    scene = bpy.context.scene
+    scene.game_settings.use_frame_rate = False
+    collection = scene.collection
+
+    bpy.ops.mesh.primitive_plane_add(size=200.0)
+    ground = bpy.context.active_object
+    ground.game.physics_type = 'STATIC'
+
+    bpy.ops.mesh.primitive_cube_add(size=1.0)
+    template = bpy.context.active_object
+    mesh = template.data
+    bpy.data.objects.remove(template)
+
+    side = int(args['bodies'] ** 0.5)
+    for i in range(args['bodies']):
+        body = bpy.data.objects.new(f"Body{i}", mesh)
+        collection.objects.link(body)
+        body.location = (2.0 * (i % side), 2.0 * (i // side), 2.0 + (i % 3))
+        body.game.physics_type = 'RIGID_BODY'
+        body.game.use_collision_bounds = True
+        body.game.collision_bounds_type = 'BOX'
+
+    text = bpy.data.texts.new("bench.py")
+    text.write(args['script'])
+
+    logic = bpy.data.objects.new("Logic", None)
+    collection.objects.link(logic)
+    bpy.ops.logic.sensor_add(type='ALWAYS', object=logic.name)
+    bpy.ops.logic.controller_add(type='PYTHON', object=logic.name)
+    sensor = logic.game.sensors[0]
+    sensor.use_pulse_true_level = True
+    controller = logic.game.controllers[0]
+    controller.mode = 'SCRIPT'
+    controller.text = text
+    controller.link(sensor=sensor)
+
+    bpy.ops.wm.save_as_mainfile(filepath=args['filepath'])
+    return {}
+
+
+class BGEReplayTest(api.Test):
+    def name(self):
+        return f"replay_{NUM_BODIES}_bodies"
+
+    def category(self):
+        return "bge"
+
+    def run(self, env, device_id):
+        with tempfile.TemporaryDirectory() as tmpdir:
+            filepath = str(pathlib.Path(tmpdir) / "bge_replay.blend")
+            recordpath = str(pathlib.Path(tmpdir) / "bge_replay.rec")
+            args = {'filepath': filepath,
+                    'bodies': NUM_BODIES,
+                    'script': GAME_SCRIPT}
+            env.run_in_blender(_create_scene, args)
+
+            player = env.blender_executable.parent / env.blender_executable.name.replace(
+                'blender', 'blenderplayer')
+            # Record the clock and inputs once, then time the replay of the same frames.
+            env.call([player, '-g', 'noaudio', '-g', 'input_record', '=', recordpath,
+                      '--headless', filepath], env.base_dir)
+            lines = env.call([player, '-g', 'noaudio', '-g', 'input_replay', '=', recordpath,
+                              '--headless', filepath], env.base_dir)
+
+        # The replay prints a line per profiling category after the statistics header, in ms.
+        statistics = False
+        for line in lines:
+            line = line.strip()
+            if line.startswith(STATISTICS_KEY):
+                statistics = True
+            elif statistics and line.startswith("Total:"):
+                mean, median, p95, p99, maximum = [float(value) * 1e-3
+                                                   for value in line.split()[1:]]
+                return {'time': mean, 'median_time': median, 'p95_time': p95,
+                        'p99_time': p99, 'max_time': maximum}
+
+        raise Exception("No frame statistics in the replay output")
+
+
+def generate(env):
+    return [BGEReplayTest()]
@@ -0,0 +1,117 @@
+# SPDX-License-Identifier: Apache-2.0
+
+import api
+import pathlib
+import tempfile
+
+# Each familly is a root with two children having two children each.
+NUM_FAMILLIES = 1000
+# Famillies with a slow parent, updated serially.
+NUM_SLOW_FAMILLIES = 50
+WARMUP_FRAMES = 50
+RECORD_FRAMES = 500
+LOG_KEY = "BGE_SCENE_GRAPH: "
+
+# Game logic run every frame, rotating all the roots so that all famillies are updated.
+GAME_SCRIPT = f'''
+import bge
+import time
+
+logic = bge.logic
+scene = logic.getCurrentScene()
+
+if not hasattr(logic, "benchRoots"):
+    logic.benchRoots = [obj for obj in scene.objects if obj.name.startswith("Root")]
+    logic.benchFrame = 0
+    logic.benchSceneGraph = 0.0
+
+for obj in logic.benchRoots:
+    obj.applyRotation((0.0, 0.0, 0.01))
+
+logic.benchFrame += 1
+if logic.benchFrame == {WARMUP_FRAMES}:
+    logic.benchStart = time.perf_counter()
+elif logic.benchFrame > {WARMUP_FRAMES}:
+    # Average of the last frames in milliseconds.
+    logic.benchSceneGraph += logic.getSceneProfileInfo()[scene.name]["Scenegraph:"][0]
+
+if logic.benchFrame == {WARMUP_FRAMES + RECORD_FRAMES}:
+    elapsed = time.perf_counter() - logic.benchStart
+    print("\\n{LOG_KEY}" + str(logic.benchSceneGraph * 1e-3 / {RECORD_FRAMES}) + " " +
+          str(elapsed / {RECORD_FRAMES}) + "\\n")
+    logic.endGame()
+'''
+
+
+def _create_scene(args):
+    import bpy
+
+    bpy.ops.wm.read_factory_settings(use_empty=True)
+    scene = bpy.context.scene
+    scene.game_settings.use_frame_rate = False
+    collection = scene.collection
+
+    def add_empty(name, parent=None):
+        obj = bpy.data.objects.new(name, None)
+        collection.objects.link(obj)
+        obj.parent = parent
+        return obj
+
+    for i in range(args['famillies'] + args['slow_famillies']):
+        root = add_empty(f"Root{i}")
+        root.location = (i % 100, i // 100, 0.0)
+        for j in range(2):
+            child = add_empty(f"Child{i}_{j}", root)
+            child.location = (0.0, 0.0, 1.0 + j)
+            child.use_slow_parent = (i >= args['famillies'] and j == 0)
+            for k in range(2):
+                leaf = add_empty(f"Leaf{i}_{j}_{k}", child)
+                leaf.location = (0.5 * k, 0.0, 1.0)
+
+    text = bpy.data.texts.new("bench.py")
+    text.write(args['script'])
+
+    logic = add_empty("Logic")
+    bpy.ops.logic.sensor_add(type='ALWAYS', object=logic.name)
+    bpy.ops.logic.controller_add(type='PYTHON', object=logic.name)
+    sensor = logic.game.sensors[0]
+    sensor.use_pulse_true_level = True
+    controller = logic.game.controllers[0]
+    controller.mode = 'SCRIPT'
+    controller.text = text
+    controller.link(sensor=sensor)
+
+    bpy.ops.wm.save_as_mainfile(filepath=args['filepath'])
+    return {}
+
+
+class BGESceneGraphTest(api.Test):
+    def name(self):
+        return f"scene_graph_{NUM_FAMILLIES}_famillies"
+
+    def category(self):
+        return "bge"
+
+    def run(self, env, device_id):
+        with tempfile.TemporaryDirectory() as tmpdir:
+            filepath = str(pathlib.Path(tmpdir) / "bge_scene_graph.blend")
+            args = {'filepath': filepath,
+                    'famillies': NUM_FAMILLIES,
+                    'slow_famillies': NUM_SLOW_FAMILLIES,
+                    'script': GAME_SCRIPT}
+            env.run_in_blender(_create_scene, args)
+
+            player = env.blender_executable.parent / env.blender_executable.name.replace(
+                'blender', 'blenderplayer')
+            lines = env.call([player, '-g', 'noaudio', '--headless', filepath], env.base_dir)
+
+        for line in lines:
+            if line.startswith(LOG_KEY):
+                scene_graph_time, frame_time = line[len(LOG_KEY):].split()
+                return {'time': float(scene_graph_time), 'frame_time': float(frame_time)}
+
+        raise Exception("No scene graph timing in the player output")
+
+
+def generate(env):
+    return [BGESceneGraphTest()]